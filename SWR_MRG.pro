@@ -1,65 +1,18 @@
-QT       += core gui
-
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
-
-CONFIG += c++17
-CONFIG += "lang-zh_CN"
-
-RC_ICONS = res/SWR.ico
-
-# You can make your code fail to compile if it uses deprecated APIs.
-# In order to do so, uncomment the following line.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-SOURCES += \
-    src/main.cpp \
-    src/mainwindow.cpp \
-    src/mypushbutton.cpp \
-    src/point.cpp \
-    src/robot.cpp
-
-HEADERS += \
-    inc/craft.h \
-    inc/mainwindow.h \
-    inc/mypushbutton.h \
-    inc/point.h \
-    inc/robot.h \
-    lib/agp/include/AGP.h \
-    lib/hans/include/HR_Pro.h \
-    lib/duco/shared/include/DucoCobot.h \
-    lib/jaka/inc_of_c++/JAKAZuRobot.h \
-    lib/jaka/inc_of_c++/jkerr.h \
-    lib/jaka/inc_of_c++/jktypes.h
-
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
-
-RESOURCES += \
-    res/logo.qrc
-
-FORMS += \
-    res/mainwindow.ui
-
-INCLUDEPATH += \
-    $$PWD/inc \
-    $$PWD/lib/agp/include
-
-# Hans
-win32: LIBS += -L$$PWD/lib/hans/x64/Release/ -lHR_Pro
-
-INCLUDEPATH += $$PWD/lib/hans/include
-DEPENDPATH += $$PWD/lib/hans/x64/Release
-
-# Duco
-win32: LIBS += -L$$PWD/lib/duco/shared/VS2019/win64/release/ -lDucoCobotAPI
-
-INCLUDEPATH += $$PWD/lib/duco/shared/include
-DEPENDPATH += $$PWD/lib/duco/shared/VS2019/win64/release
-
-# Jaka
-win32: LIBS += -L$$PWD/lib/jaka/x64/ -ljakaAPI
-
-INCLUDEPATH += $$PWD/lib/jaka/inc_of_c++
-DEPENDPATH += $$PWD/lib/jaka/x64
+TEMPLATE = subdirs
+
+# core：机器人、点位、工艺等核心代码（共享库 swrcore，插件同样链接它，不依赖 Qt Widgets）
+# gui：触摸屏界面
+# runner：命令行运行器 swr-run
+# viewer：运行记录查看器 swr-view
+# plugins：机器人后端插件（各自链接厂商SDK，运行时按配置加载）
+SUBDIRS += \
+    core \
+    gui \
+    runner \
+    viewer \
+    plugins
+
+gui.depends = core
+runner.depends = core
+viewer.depends = core
+plugins.depends = core
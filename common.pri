@@ -0,0 +1,14 @@
+CONFIG += c++17
+CONFIG += "lang-zh_CN"
+
+# You can make your code fail to compile if it uses deprecated APIs.
+# In order to do so, uncomment the following line.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+# 所有目标输出到同一目录
+SWR_OUT = $$shadowed($$PWD)/out
+DESTDIR = $$SWR_OUT
+
+INCLUDEPATH += \
+    $$PWD/inc \
+    $$PWD/lib/agp/include
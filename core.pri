@@ -0,0 +1,4 @@
+# 链接核心库（厂商SDK由各机器人后端插件链接）
+QT += network
+LIBS += -L$$SWR_OUT -lswrcore
+unix: QMAKE_RPATHDIR += $$SWR_OUT
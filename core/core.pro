@@ -0,0 +1,56 @@
+QT = core gui network
+
+TEMPLATE = lib
+TARGET = swrcore
+# 共享库：机器人后端插件与程序共用核心库中的全局状态
+DEFINES += SWRCORE_LIBRARY
+
+include(../common.pri)
+
+SOURCES += \
+    ../src/callstats.cpp \
+    ../src/coverage.cpp \
+    ../src/craftstore.cpp \
+    ../src/forcefeed.cpp \
+    ../src/mesh.cpp \
+    ../src/metrics.cpp \
+    ../src/pathplan.cpp \
+    ../src/point.cpp \
+    ../src/pointcloud.cpp \
+    ../src/probe.cpp \
+    ../src/registration.cpp \
+    ../src/removal.cpp \
+    ../src/robot.cpp \
+    ../src/robotplugin.cpp \
+    ../src/runlog.cpp \
+    ../src/simrobot.cpp \
+    ../src/spline.cpp \
+    ../src/sweep.cpp \
+    ../src/teachrecord.cpp \
+    ../src/trace.cpp
+
+HEADERS += \
+    ../inc/callstats.h \
+    ../inc/coverage.h \
+    ../inc/craft.h \
+    ../inc/craftstore.h \
+    ../inc/forcefeed.h \
+    ../inc/mesh.h \
+    ../inc/metrics.h \
+    ../inc/pathplan.h \
+    ../inc/point.h \
+    ../inc/pointcloud.h \
+    ../inc/probe.h \
+    ../inc/registration.h \
+    ../inc/removal.h \
+    ../inc/robot.h \
+    ../inc/robotplugin.h \
+    ../inc/runlog.h \
+    ../inc/simrobot.h \
+    ../inc/spline.h \
+    ../inc/sweep.h \
+    ../inc/swrcore_global.h \
+    ../inc/teachrecord.h \
+    ../inc/textparse.h \
+    ../inc/trace.h \
+    ../lib/agp/include/AGP.h
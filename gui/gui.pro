@@ -0,0 +1,30 @@
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = SWR_MRG
+
+RC_ICONS = ../res/SWR.ico
+
+include(../common.pri)
+include(../core.pri)
+
+SOURCES += \
+    ../src/main.cpp \
+    ../src/mainwindow.cpp \
+    ../src/mypushbutton.cpp
+
+HEADERS += \
+    ../inc/mainwindow.h \
+    ../inc/mypushbutton.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
+
+RESOURCES += \
+    ../res/logo.qrc
+
+FORMS += \
+    ../res/mainwindow.ui
@@ -0,0 +1,101 @@
+﻿#ifndef CALLSTATS_H
+#define CALLSTATS_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <chrono>
+
+#include "swrcore_global.h"
+#include "trace.h"
+
+// 一个调用名的耗时统计，时间单位 μs
+struct CallSummary {
+    QString name;
+    quint64 count;  // 调用次数
+    quint64 errors; // 出错次数（返回值非0）
+    double mean;
+    double p50;
+    double p90;
+    double p99;
+    double p999;
+    double max;
+    double total; // 总耗时，ms
+};
+
+// 外部调用（华沿、节卡 SDK，AGP）耗时统计：每个调用名一个对数分桶
+// 直方图（每个2的幂区间再分16档，相对误差约6%），各桶原子累加，可多线程记录。
+// 关闭时每次调用只多一次原子读。记录时间线时各调用同时作为事件写入
+class SWRCORE_EXPORT CallStats {
+  public:
+    static void SetEnabled(bool isEnabled);
+    static bool IsEnabled() {
+        return isEnabled.load(std::memory_order_relaxed);
+    }
+    // 调用名编号，同名返回同一编号，超过上限返回-1
+    static int Register(const char *name);
+    static const char *Name(int id);
+    static void Record(int id, qint64 nanoseconds, bool isError);
+    static void Reset();
+    // 有调用记录的统计，按总耗时降序
+    static QVector<CallSummary> Summaries();
+    // JSON：各调用的统计和非空桶（下界 ns、次数）
+    static QByteArray ToJson();
+    static bool SaveJson(const QString &fileName);
+
+    // 计时执行 func，返回值非0计为错误（各 SDK 均以0表示成功）
+    template <typename F> static auto Time(int id, F &&func) -> decltype(func()) {
+        bool isStats = IsEnabled();
+        bool isTrace = Trace::IsEnabled();
+        if (!isStats && !isTrace) {
+            return func();
+        }
+        Trace::Clock::time_point start = Trace::Clock::now();
+        auto result = func();
+        Finish(id, start, result != 0, isStats, isTrace);
+        return result;
+    }
+    // 记录一次计时结束的调用
+    static void Finish(int id, Trace::Clock::time_point start, bool isError,
+                       bool isStats, bool isTrace);
+
+  private:
+    static std::atomic<bool> isEnabled;
+};
+
+// 作用域计时，析构时按 *errorFlag 判断是否出错
+class CallTimer {
+  public:
+    CallTimer(int id, const bool *errorFlag)
+        : id(id), errorFlag(errorFlag), isStats(CallStats::IsEnabled()),
+          isTrace(Trace::IsEnabled()) {
+        if (isStats || isTrace) {
+            start = Trace::Clock::now();
+        }
+    }
+    ~CallTimer() {
+        if (isStats || isTrace) {
+            CallStats::Finish(id, start, *errorFlag, isStats, isTrace);
+        }
+    }
+
+  private:
+    int id;
+    const bool *errorFlag;
+    bool isStats;
+    bool isTrace;
+    Trace::Clock::time_point start;
+};
+
+// 调用点首次执行时注册调用名，之后直接使用编号
+#define CALL_ID(name)                                                          \
+    ([] {                                                                      \
+        static const int callId = CallStats::Register(name);                   \
+        return callId;                                                         \
+    }())
+// 计时执行表达式，如 CALL_STATS("HRIF_GrpStop", HRIF_GrpStop(0, 0))
+#define CALL_STATS(name, ...)                                                  \
+    CallStats::Time(CALL_ID(name), [&] { return __VA_ARGS__; })
+
+#endif // CALLSTATS_H
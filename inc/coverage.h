@@ -0,0 +1,89 @@
+﻿#ifndef COVERAGE_H
+#define COVERAGE_H
+
+#include <QString>
+#include <QVector3D>
+#include <QVector>
+#include <functional>
+#include <vector>
+
+#include "pathplan.h"
+#include "swrcore_global.h"
+
+// 覆盖分析参数（settings.ini [Coverage]）
+struct SWRCORE_EXPORT CoverageParams {
+    CoverageParams();
+
+    double cellSize;    // 网格边长，mm
+    double depth;       // 打磨片压入深度，mm（倾斜时接触区为弓形）
+    double target;      // 判定为完全覆盖的覆盖率，%
+    int maxOffsetCount; // 推荐偏移次数的搜索上限
+};
+
+// 未覆盖区域（区域内四连通的未覆盖网格）
+struct CoverageGap {
+    int cells;        // 网格数
+    double area;      // 面积，mm²
+    QVector3D center; // 中心（区域平面上）
+};
+
+// 覆盖网格：建立在起始点、结束点、起始偏移点所在平面上，
+// x 沿起始点->结束点，y 垂直于 x 指向起始偏移点一侧，四周各留一个打磨片半径
+struct SWRCORE_EXPORT CoverageMap {
+    CoverageMap();
+
+    QVector3D origin;          // 网格 (0, 0) 角点
+    QVector3D xAxis;           // x 方向（单位向量）
+    QVector3D yAxis;           // y 方向（单位向量）
+    double cellSize;           // 网格边长，mm
+    int width;                 // x 方向网格数
+    int height;                // y 方向网格数
+    QVector<quint16> passes;   // 每格被打磨的遍数，按行存放
+    QVector<quint8> mask;      // 是否在打磨区域内
+    int regionCells;           // 区域内网格数
+    int coveredCells;          // 区域内已覆盖网格数
+    int maxPasses;             // 区域内最大遍数
+    double coverage;           // 覆盖率，%
+    QVector<CoverageGap> gaps; // 未覆盖区域，按面积降序
+};
+
+// 打磨片在一个采样位姿下的接触区（切平面上从接触点起的弓形）。网格 (i, j)
+// 中心沿网格法向投影到切平面后，沿接触区前进方向的坐标为
+// along0 + alongX·i + alongY·j，横向坐标 across 同理
+struct ContactPatch {
+    float along0, alongX, alongY;
+    float across0, acrossX, acrossY;
+    float cosTilt;              // 打磨片倾角余弦
+    float length;               // 接触区沿前进方向的长度，mm
+    float dwell;                // 该采样代表的停留时间，s
+    int pass;                   // 所属遍数编号
+    int minX, maxX, minY, maxY; // 覆盖的网格范围
+};
+
+// 覆盖分析：把路径打磨阶段打磨片的接触区光栅化到区域网格上
+class SWRCORE_EXPORT CoverageAnalyzer {
+  public:
+    // 在区域四角所在平面上建立空网格（含区域掩码）
+    static bool InitMap(const QVector<QVector3D> &corners, double discRadius,
+                        double cellSize, CoverageMap &map);
+    // 按半个网格采样路径打磨阶段的接触段，depth 为打磨片压入深度，mm
+    static QVector<ContactPatch> SamplePath(const QVector<PathSegment> &path,
+                                            const CoverageMap &map,
+                                            double discRadius, double depth);
+    // 接触区按网格分块（块内保持路径顺序），多线程对每块调用
+    // func(left, bottom, right, top, patchIndices)，各块互不重叠
+    static void ForEachTile(
+        const CoverageMap &map, const QVector<ContactPatch> &patches,
+        const std::function<void(int, int, int, int, const std::vector<int> &)>
+            &func);
+
+    // corners 为区域四角（起始点、结束点、结束偏移点、起始偏移点），
+    // path 为 Robot::GeneratePath 生成的打磨侧路径
+    static bool Analyze(const QVector<PathSegment> &path,
+                        const QVector<QVector3D> &corners, double discRadius,
+                        const CoverageParams &params, CoverageMap &map);
+    // 热力图（PNG）：区域外灰色，未覆盖红色，遍数越多颜色越深
+    static bool SaveHeatmap(const CoverageMap &map, const QString &fileName);
+};
+
+#endif // COVERAGE_H
@@ -19,7 +19,11 @@ enum PolishWay {
     CylinderWay_Horizontal_Concave,
     CylinderWay_Vertical_Concave,
     ZLineWay,
-    SpiralLineWay
+    SpiralLineWay,
+    SplineWay,
+    SphereWay,
+    CloudWay,
+    MeshWay
 };
 // 偏移方向（工具坐标系X、Y、Z方向）
 enum OffsetDirection { OffsetX, OffsetY, OffsetZ };
@@ -45,9 +49,11 @@ class Craft {
     int raiseCount;         // 中途抬起次数
     int floatCount;         // 浮动次数
     int transitionRadius;   // 过渡半径，mm
+    int overlapRatio;       // 相邻行重叠率，%
     bool isMirror;          // 圆柱打磨是否采用镜像
 
     friend class MainWindow;
+    friend class CraftStore;
     friend class Robot;
     friend class HansRobot;
     friend class DucoRobot;
@@ -0,0 +1,60 @@
+﻿#ifndef CRAFTSTORE_H
+#define CRAFTSTORE_H
+
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <unordered_map>
+
+#include "craft.h"
+#include "swrcore_global.h"
+
+// 工艺参数库
+// 目录结构：index.log 为追加式索引日志（+新增、=改名、-删除），
+// 每份工艺单独保存为 <key>.ini，写入均通过 QSaveFile 原子替换。
+// 启动时只回放索引，工艺详情在首次访问时才加载。
+// 编号即 keys 中的位置，删除只留空位（O(1)），下次 Open 时再压实，
+// 因此编号在两次 Open 之间保持不变，界面通过条目数据保存编号。
+class SWRCORE_EXPORT CraftStore {
+  public:
+    CraftStore();
+
+    bool Open(const QString &dirPath);       // 打开工艺库目录
+    bool Import(const QString &iniFileName); // 从旧版 config.ini 导入
+
+    int Size() const;                     // 工艺数量
+    int Capacity() const;                 // 编号上限（含已删除的空位）
+    bool IsValid(int index) const;        // 编号是否对应未删除的工艺
+    int First() const;                    // 第一份工艺的编号，没有时为 -1
+    QString Name(int index) const;        // 工艺名（不加载详情）
+    // 读取/修改工艺（按需加载，修改需调用 Save 保存）。编号无效时返回
+    // craftID 为空的占位工艺，不缓存、不能保存
+    const Craft &At(int index);
+    Craft &operator[](int index);
+    bool Save(int index);                 // 保存单份工艺
+    int Append(const Craft &craft);       // 新增工艺，返回编号
+    bool Remove(int index);               // 删除工艺
+
+    static Craft DefaultCraft();                            // 默认工艺
+    static QMap<QString, QString> ToMap(const Craft &craft); // 工艺转键值
+    static Craft FromMap(const QMap<QString, QString> &map); // 键值转工艺
+
+  private:
+    QString CraftFileName(int key) const;
+    bool Load(int key);
+    bool WriteCraft(int key, const Craft &craft);
+    bool AppendIndex(const QString &line);
+    bool CompactIndex();
+
+    QString dir;                // 工艺库目录
+    QVector<int> keys;          // 工艺顺序（文件编号，0 为已删除的空位）
+    QHash<int, QString> names;  // 文件编号 -> 工艺名
+    std::unordered_map<int, Craft> cache; // 已加载的工艺（插入后引用保持有效）
+    Craft invalidCraft;         // 无效编号返回的占位工艺
+    int count;                  // 未删除的工艺数量
+    int nextKey;                // 下一个文件编号
+    int garbageCount;           // 索引日志中的失效记录数
+};
+
+#endif // CRAFTSTORE_H
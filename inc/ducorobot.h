@@ -0,0 +1,62 @@
+﻿#ifndef DUCOROBOT_H
+#define DUCOROBOT_H
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+#include "robot.h"
+
+#include "DucoCobot.h"
+
+// 新松机器人（DucoCobot RPC SDK），编译为机器人后端插件 swr-duco。
+// 连接在对象生命周期内保持；运动以非阻塞方式下发并按任务 ID 排队，
+// 由任务状态判断完成，不再阻塞等待或忙等
+class DucoRobot : public Robot {
+  public:
+    DucoRobot();
+    ~DucoRobot();
+
+    bool RobotConnect(QString robotIP); // 连接机器人
+    bool GetTcpPoint(Point &point);     // 获取点位
+    bool RobotTeach(int pos);           // 开始示教
+    bool CloseFreeDriver();             // 结束示教
+    bool Stop();                        // 急停
+    bool IsRobotElectrified();          // 是否上电
+    bool IsRobotEnabled();              // 是否使能
+    bool IsRobotMoved();                // 是否正在移动
+    void OpenWeb(QString ip);           // 打开网页示教器
+    void MoveTcpL(const Point &point, double dVelocity, double dAcc,
+                  double dRadius); // 直线运动
+    void MoveTcpC(const Point &auxPoint, const Point &endPoint,
+                  double dVelocity, double dAcc,
+                  double dRadius);           // 圆弧运动
+    bool GetJointPos(double *joints);    // 获取关节位置，°
+    int GetCurrentSegment();             // 最早未完成任务的路径段编号
+    bool SetSpeedOverride(double ratio); // 设置速度倍率
+    int Capabilities() const;            // 支持伺服运动
+    bool ServoTcpPath(const QVector<Point> &points,
+                      double period); // 伺服运动（servoj_pose）
+    bool AbortMotion();                  // 中止当前运动
+
+  private:
+    // 已下发未完成的非阻塞运动
+    struct MotionTask {
+        int32_t id;  // 控制器返回的任务 ID
+        int segment; // 下发时的路径段编号
+    };
+
+    // 点位（mm、°）转为 SDK 位姿（m、rad）
+    static std::vector<double> ToPose(const Point &point);
+    bool UpdateTasks();       // 移除已结束的任务，返回是否仍有任务
+    bool WaitQueue();         // 等待队列有空位，急停时返回 false
+    void AddTask(int32_t id); // 记录新下发的任务
+
+    DucoRPC::DucoCobot *ducoCobot; // RPC 连接，首次连接时创建
+    std::string connectedIP;       // 已连接的地址
+    std::atomic<bool> isConnected; // 连接是否已打开
+    std::deque<MotionTask> tasks;  // 未完成的运动任务，按下发顺序
+    std::recursive_mutex rpcMutex; // 保护 RPC 连接和任务队列
+};
+
+#endif // DUCOROBOT_H
@@ -0,0 +1,46 @@
+﻿#ifndef FORCEFEED_H
+#define FORCEFEED_H
+
+#include "swrcore_global.h"
+
+// 力自适应进给参数（settings.ini [ForceFeed]）
+struct SWRCORE_EXPORT ForceFeedParams {
+    ForceFeedParams();
+
+    bool isEnabled;     // 是否启用
+    double targetForce; // 目标压力，N（0 表示使用工艺的设定压力）
+    double band;        // 死区半宽，N，压力在目标±死区内不调整
+    double kp;          // 比例增益，1/N
+    double ki;          // 积分增益，1/(N·s)
+    double maxRate;     // 速度倍率最大变化率，1/s
+    double floor;       // 速度倍率下限（相对工艺移动速度）
+    double ceiling;     // 速度倍率上限（相对工艺移动速度，可大于1）
+    double filterTime;  // 压力一阶滤波时间常数，s
+};
+
+// 力自适应进给控制器：压力偏大时降速，偏小时提速
+// 输出为相对工艺移动速度的倍率，带死区、积分抗饱和、变化率限制和上下限
+class SWRCORE_EXPORT ForceFeedController {
+  public:
+    ForceFeedController();
+
+    void SetParams(const ForceFeedParams &params);
+    const ForceFeedParams &Params() const;
+    bool IsEnabled() const;
+    double SpeedScale() const; // 下发速度放大系数，即倍率上限（不小于1）
+
+    void Start(double targetForce);         // 开始控制，倍率从1开始
+    double Update(double force, double dt); // 输入压力和周期（s），返回倍率
+    double Ratio() const;                   // 当前倍率
+    double Override() const;                // 对应的控制器速度比，(0, 1]
+
+  private:
+    ForceFeedParams params;
+    double target;   // 目标压力，N
+    double filtered; // 滤波后的压力，N
+    double integral; // 误差积分，N·s
+    double ratio;    // 当前倍率
+    bool isStarted;  // 是否已有滤波初值
+};
+
+#endif // FORCEFEED_H
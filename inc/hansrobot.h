@@ -0,0 +1,55 @@
+﻿#ifndef HANSROBOT_H
+#define HANSROBOT_H
+
+#include "robot.h"
+
+// 大族机器人（HR_Pro SDK），编译为机器人后端插件 swr-hans
+class HansRobot : public Robot {
+  public:
+    HansRobot();
+    ~HansRobot();
+
+    bool RobotConnect(QString robotIP);
+    bool RobotTeach(int pos);
+    bool GetTcpPoint(Point &point);
+    // void MoveBefore(const Craft &craft, bool isAGPRun);
+    // void MoveAfter(const Craft &craft, Point point);
+    // void MoveLine(const Craft &craft);
+    // void MoveArc(const Craft &craft);
+    // Point MoveRegionArc1(const Craft &craft);
+    // Point MoveRegionArc2(const Craft &craft);
+    // void MoveZLine(const Craft &craft);
+    // void MoveSpiralLine(const Craft &craft);
+    bool IsRobotElectrified();
+    bool IsRobotEnabled();
+    bool IsRobotMoved();
+    bool CloseFreeDriver();
+    // void Run(const Craft &craft, bool isAGPRun);
+    bool Stop();
+    bool GetJointPos(double *joints);
+    int GetCurrentSegment();
+    bool SetSpeedOverride(double ratio);
+    bool MoveTcpPath(const QVector<Point> &points, double dVelocity,
+                     double dAcc);
+    int Capabilities() const;
+    bool ServoTcpPath(const QVector<Point> &points, double period);
+    bool AbortMotion();
+
+    void OpenWeb(QString ip); // 打开网页示教器
+    void MoveTcpL(const Point &point, double velocity, double acc,
+                  double radius); // 直线运动
+    void MoveTcpC(const Point &auxPoint, const Point &endPoint, double velocity,
+                  double acc,
+                  double radius); // 圆弧运动
+
+  private:
+    void BeginPathOverride(); // 进入轨迹或伺服运动，轨迹速度比取当前速度比
+    void EndPathOverride();   // 退出时复位轨迹速度比，并同步全局速度比
+
+    std::atomic<bool> isPathMoving; // 是否正在执行轨迹或伺服运动
+    std::mutex overrideMutex;       // 保护速度比状态（采样线程同时写入）
+    double speedOverride;           // 最近请求的速度比
+    double globalOverride;          // 已写入控制器的全局速度比
+};
+
+#endif // HANSROBOT_H
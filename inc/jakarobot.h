@@ -0,0 +1,60 @@
+﻿#ifndef JAKAROBOT_H
+#define JAKAROBOT_H
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+#include "JAKAZuRobot.h"
+#include "robot.h"
+
+// 节卡机器人（JAKAZuRobot SDK），编译为机器人后端插件 swr-jaka。
+// 运动以非阻塞方式下发，在途运动数有上限，按 get_robot_status 的状态和
+// TCP 位置判断完成
+class JakaRobot : public Robot {
+  public:
+    JakaRobot();
+    ~JakaRobot();
+
+    bool RobotConnect(QString robotIP); // 连接机器人
+    bool GetTcpPoint(Point &point);     // 获取点位
+    bool RobotTeach(int pos);           // 开始示教
+    bool CloseFreeDriver();             // 结束示教
+    bool Stop();                        // 急停
+    bool IsRobotElectrified();          // 是否上电
+    bool IsRobotEnabled();              // 是否使能
+    bool IsRobotMoved();                // 是否正在移动
+    void OpenWeb(QString ip);           // 打开网页示教器
+    void MoveTcpL(const Point &point, double dVelocity, double dAcc,
+                  double dRadius); // 直线运动
+    void MoveTcpC(const Point &auxPoint, const Point &endPoint,
+                  double dVelocity, double dAcc,
+                  double dRadius);           // 圆弧运动
+    bool GetJointPos(double *joints); // 获取关节位置，°
+    int GetCurrentSegment();             // 最早未完成运动的路径段编号
+    bool SetSpeedOverride(double ratio); // 设置速度倍率
+    int Capabilities() const;            // 支持伺服运动
+    bool ServoTcpPath(const QVector<Point> &points,
+                      double period); // 伺服运动（servo_p）
+    bool AbortMotion();                  // 中止当前运动
+
+  private:
+    // 已下发未完成的非阻塞运动
+    struct Motion {
+        QVector3D begin; // 起点，mm
+        QVector3D end;   // 终点，mm
+        bool isArc;      // 圆弧只按到达终点判断完成
+        int segment;     // 下发时的路径段编号
+        std::chrono::steady_clock::time_point issued; // 下发时间
+    };
+
+    bool UpdateMotions(); // 移除已完成的运动，返回是否仍有运动
+    bool WaitPipeline();  // 等待在途运动少于上限，急停时返回 false
+    void AddMotion(const Point &endPoint, bool isArc); // 记录新下发的运动
+
+    JAKAZuRobot jakaRobot;
+    std::deque<Motion> motions;       // 在途运动，按下发顺序
+    std::recursive_mutex motionMutex; // 保护在途运动队列
+};
+
+#endif // JAKAROBOT_H
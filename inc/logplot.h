@@ -0,0 +1,55 @@
+﻿#ifndef LOGPLOT_H
+#define LOGPLOT_H
+
+#include <QWidget>
+
+#include "runlog.h"
+
+// 运行记录曲线：力、速度、主轴转速、路径偏差分通道绘制
+// 绘制时按像素列取最小/最大值，视图较大时直接使用抽稀金字塔，
+// 只有放大到少量记录时才读取原始记录，文件始终保持内存映射。
+class LogPlot : public QWidget {
+    Q_OBJECT
+  public:
+    enum AxisMode {
+        TimeAxis, // 横轴为时间，s
+        ArcAxis   // 横轴为弧长，mm
+    };
+
+    explicit LogPlot(QWidget *parent = nullptr);
+
+    bool Open(const QString &fileName); // 打开记录文件
+    void Close();                       // 关闭记录文件
+    const RunLogReader &Reader() const;
+    void SetAxisMode(int mode);         // 切换横轴
+    void ResetView();                   // 显示全部
+
+  protected:
+    void paintEvent(QPaintEvent *event);
+    void wheelEvent(QWheelEvent *event);
+    void mousePressEvent(QMouseEvent *event);
+    void mouseMoveEvent(QMouseEvent *event);
+    void mouseReleaseEvent(QMouseEvent *event);
+    void mouseDoubleClickEvent(QMouseEvent *event);
+
+  private:
+    double AxisLength() const;
+    double BucketX(const RunLogBucket &bucket) const;
+    int FirstBucket(const QVector<RunLogBucket> &level, double x) const;
+    void Accumulate(int width, QVector<float> *colMin,
+                    QVector<float> *colMax) const;
+    void AccumulateRecords(int width, QVector<float> *colMin,
+                           QVector<float> *colMax) const;
+    QRect PlotRect() const;
+    void ClampView();
+
+    RunLogReader reader; // 记录文件
+    RunLogIndex index;   // 抽稀金字塔
+    int axisMode;        // 横轴类型
+    double viewBegin;    // 视图起点
+    double viewEnd;      // 视图终点
+    bool isDragging;     // 正在拖动
+    int dragX;           // 上次拖动位置
+};
+
+#endif // LOGPLOT_H
@@ -6,6 +6,7 @@
 #include <QPushButton>
 #include <QVector>
 
+#include "craftstore.h"
 #include "robot.h"
 
 QT_BEGIN_NAMESPACE
@@ -38,6 +39,8 @@ class MainWindow : public QMainWindow {
     void ConnectAGP();
 
     void AddHistoryPoint(const QString &strPoint);
+    void UpdatePointButtons(const QStringList &points);
+    void UpdateCallStats();
 
   private slots:
     void on_btnDrag_clicked();
@@ -64,11 +67,23 @@ class MainWindow : public QMainWindow {
     void on_btnClear_clicked();
     void on_btnClearMid_clicked();
     void on_btnDelLastMid_clicked();
+    void on_btnRecordPath_clicked();
+    void on_btnReference_clicked();
+    void on_btnRegister_clicked();
+    void on_btnProbe_clicked();
     void on_btnOpenWeb_clicked();
     void on_btnMoveToPoint_clicked();
     void on_btnClearHistory_clicked();
     void on_btnCoverPoint_clicked();
     void on_btnStop2_clicked();
+    void on_btnSaveProgram_clicked();
+    void on_btnLoadProgram_clicked();
+    void on_btnLoadCloud_clicked();
+    void on_btnLoadMesh_clicked();
+    void on_btnStatsEnable_clicked();
+    void on_btnStatsRefresh_clicked();
+    void on_btnStatsReset_clicked();
+    void on_btnStatsExport_clicked();
 
     void on_leCutinSpeed_editingFinished();
     void on_leMoveSpeed_editingFinished();
@@ -84,6 +99,7 @@ class MainWindow : public QMainWindow {
     void on_leAddOffsetCount_editingFinished();
     void on_leRaiseCount_editingFinished();
     void on_leFloatCount_editingFinished();
+    void on_leOverlapRatio_editingFinished();
     void on_leTransitionRadius_editingFinished();
 
     void on_cmbCraftID_currentIndexChanged(int index);
@@ -95,10 +111,8 @@ class MainWindow : public QMainWindow {
 
 private:
     Ui::MainWindow *ui;
-    HansRobot robot; // 大族机器人
-    // DucoRobot robot;       // 新松机器人
-    // JakaRobot robot;                // 节卡机器人
-    QVector<Craft> crafts;          // 工艺参数列表
+    Robot *robot;                   // 机器人（按 [Robot] Backend 加载）
+    CraftStore crafts;              // 工艺参数库
     int lastPageIdx;                // 上一个页面编号
     int currCraftIdx;               // 当前工艺参数编号
     QElapsedTimer midPressDuration; // 中间点长按时间间隔，单位：ms
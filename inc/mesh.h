@@ -0,0 +1,64 @@
+﻿#ifndef MESH_H
+#define MESH_H
+
+#include <QString>
+#include <QVector3D>
+#include <QVector>
+
+#include "swrcore_global.h"
+
+// 平面与网格的交线
+struct MeshPolyline {
+    QVector<QVector3D> points;  // 交点（网格边上）
+    QVector<QVector3D> normals; // 交点处法向（相邻两面法向平均），朝外
+    bool isClosed;              // 是否闭合
+};
+
+// 三角网格：顶点焊接后的索引半边结构，面 f 的半边为 3f、3f+1、3f+2，
+// 半边 h 起点为 indices[h]，终点为同一面的下一个顶点；BVH 加速平面求交
+class SWRCORE_EXPORT Mesh {
+  public:
+    Mesh();
+
+    bool Load(const QString &fileName); // 读取 STL（二进制或文本）
+    void Clear();
+    bool IsEmpty() const;
+    int FaceCount() const;
+    int VertexCount() const;
+    QString FileName() const;
+    const QVector3D &Vertex(int index) const;
+    const QVector3D &FaceNormal(int face) const; // 按顶点顺序（右手）朝外
+
+    // 平面 dot(normal, x) = offset 与网格的交线
+    QVector<MeshPolyline> Slice(const QVector3D &normal, double offset) const;
+    // 一组平行平面多线程求交，结果与 offsets 一一对应
+    QVector<QVector<MeshPolyline>> Slice(const QVector3D &normal,
+                                         const QVector<double> &offsets) const;
+
+  private:
+    // BVH 节点：叶节点 count > 0，面为 faceOrder[first, first + count)；
+    // 内部节点左子节点紧随其后，右子节点为 first
+    struct BvhNode {
+        QVector3D minPos;
+        QVector3D maxPos;
+        int first;
+        int count;
+    };
+
+    bool LoadBinary(const QByteArray &data);
+    bool LoadAscii(const QByteArray &data);
+    void Build(const QVector<QVector3D> &corners);
+    void BuildBvh(int first, int count);
+    void QueryPlane(const QVector3D &normal, double offset,
+                    QVector<int> &faces) const;
+
+    QString fileName;
+    QVector<QVector3D> vertices;    // 顶点
+    QVector<int> indices;           // 每面三个顶点索引
+    QVector<int> twins;             // 半边的对边，边界（或非流形）为-1
+    QVector<QVector3D> faceNormals; // 面法向
+    QVector<BvhNode> nodes;         // BVH 节点
+    QVector<int> faceOrder;         // BVH 叶节点面序
+};
+
+#endif // MESH_H
@@ -0,0 +1,51 @@
+﻿#ifndef METRICS_H
+#define METRICS_H
+
+#include <QByteArray>
+#include <QString>
+#include <atomic>
+#include <thread>
+
+#include "swrcore_global.h"
+
+// 运行指标：运行线程、采样线程以原子量无锁更新，指标服务只读，
+// 抓取不会阻塞运动
+class SWRCORE_EXPORT RunMetrics {
+  public:
+    static void SetEnabled(bool isEnabled);
+    static bool IsEnabled();
+
+    // 一次运行开始、结束，中途有停止事件的运行不计完成件数
+    static void BeginCycle(const QString &craftID);
+    static void EndCycle(double seconds);
+    static void AddStop();
+    // 已规划未下发的路径段数
+    static void SetPendingSegments(int count);
+    // 已下发未执行完的路径段数（控制器有执行位置反馈时）
+    static void SetQueueDepth(int depth);
+    // 打磨头实测压力 N、温度 ℃、转速 r/min
+    static void SetAGP(double force, double temperature, double speed);
+
+    // Prometheus 文本格式，含 SDK、AGP 调用耗时分位数（CallStats）
+    static QByteArray Prometheus();
+};
+
+// 本机 HTTP 指标服务：GET /metrics 返回 Prometheus 文本格式，
+// 在独立线程中以阻塞方式逐个处理连接
+class SWRCORE_EXPORT MetricsServer {
+  public:
+    MetricsServer();
+    ~MetricsServer();
+
+    bool Start(quint16 port); // 只监听 127.0.0.1
+    void Stop();
+    bool IsRunning() const;
+
+  private:
+    void Serve(quint16 port, std::atomic<int> *state);
+
+    std::thread server;
+    std::atomic<bool> isRunning;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,99 @@
+﻿#ifndef PATHPLAN_H
+#define PATHPLAN_H
+
+#include <QVector>
+
+#include "point.h"
+#include "swrcore_global.h"
+
+// 路径段所属阶段
+enum PathPhase {
+    ApproachPhase, // 进刀（安全点、切入）
+    PolishPhase,   // 打磨
+    RetractPhase   // 退刀
+};
+
+// 路径段，点位为打磨侧点位（尚未换算到TCP）
+struct PathSegment {
+    bool isArc;      // 是否为圆弧
+    Point auxPoint;  // 圆弧中间点
+    Point endPoint;  // 终点
+    double velocity; // 速度，mm/s
+    double acc;      // 加速度
+    double radius;   // 过渡半径，mm
+    int phase;       // 所属阶段（PathPhase）
+    bool isContact;  // 是否为接触打磨段（打磨阶段中不含空移、切入和抬起）
+    bool isStreamed; // 是否属于连续轨迹（样条采样点）
+};
+
+// 曲率进给规划参数（settings.ini [FeedPlan]）
+struct SWRCORE_EXPORT FeedPlanParams {
+    FeedPlanParams();
+
+    bool isEnabled;         // 是否启用
+    double contactSpeed;    // 目标接触线速度，mm/s（0 表示使用工艺移动速度）
+    double maxSpeed;        // TCP线速度上限，mm/s
+    double minSpeed;        // TCP线速度下限，mm/s
+    double maxAngularSpeed; // 姿态角速度上限，°/s
+};
+
+// 过渡半径规划参数（settings.ini [BlendPlan]）
+struct SWRCORE_EXPORT BlendPlanParams {
+    BlendPlanParams();
+
+    bool isEnabled;   // 是否启用
+    double maxRadius; // 过渡半径上限，mm
+    double tolerance; // 允许的路径偏差，mm
+};
+
+// 路径压缩参数（settings.ini [Compress]）
+struct SWRCORE_EXPORT CompressParams {
+    CompressParams();
+
+    bool isEnabled;      // 是否启用
+    double tolerance;    // 允许的位置偏差，mm
+    double rotTolerance; // 允许的姿态偏差，°
+    double maxArcAngle;  // 单段圆弧的圆心角上限，°
+};
+
+// 路径规划：Run 先生成完整路径，经各规划步骤修改后再下发
+class SWRCORE_EXPORT PathPlanner {
+  public:
+    // 曲率进给：按接触侧与TCP侧轨迹长度之比换算每段TCP速度，
+    // 使接触线速度恒定，再按姿态角速度和线速度上下限约束。只修改接触段
+    static void PlanFeed(QVector<PathSegment> &path, double toolOffset,
+                         double contactSpeed, const FeedPlanParams &params);
+    // 过渡半径：每个路点取 min(上限, 前后段长度的一半, 偏差/tan(φ/4))，
+    // φ 为前后段切线夹角，首段和末段为0
+    static void PlanBlend(QVector<PathSegment> &path, double toolOffset,
+                          const BlendPlanParams &params);
+    // 路径压缩：同阶段、同速度、同接触状态的连续直线段（密集点位）在位置
+    // 和姿态偏差内合并为尽量少的直线和圆弧段。先按 Douglas–Peucker 求直线
+    // 分段，再把相邻直线段贪心合并为三点圆弧；isStreamKept 为真时保留连续
+    // 轨迹段供整体上传或伺服下发。返回减少的段数
+    static int Compress(QVector<PathSegment> &path,
+                        const CompressParams &params, bool isStreamKept);
+    // 估算路径运行时间，s：每段按梯形速度曲线，过渡半径大于0或连续轨迹的
+    // 路点不停顿（不计该端的加减速），首段起点取第一个路点
+    static double EstimateDuration(const QVector<PathSegment> &path,
+                                   double toolOffset);
+    // 伺服下发：连续轨迹（TCP点位，首点为起点）按梯形速度曲线每隔 period
+    // 秒取一个位姿，位置沿折线插值，姿态按最近的角度差插值，末点为终点
+    static QVector<Point> SampleServo(const QVector<Point> &points,
+                                      double velocity, double acc,
+                                      double period);
+
+    // 路径段长度，start 为起点；radius 返回圆弧半径（直线为0）
+    static double SegmentLength(const Point &start, const PathSegment &segment,
+                                double *radius = nullptr);
+    // 路径段起点、终点处的运动方向（单位向量）
+    static QVector3D StartTangent(const Point &start,
+                                  const PathSegment &segment);
+    static QVector3D EndTangent(const Point &start, const PathSegment &segment);
+    // 两个姿态之间的夹角，°
+    static double RotationAngle(const QVector3D &rot1, const QVector3D &rot2);
+    // 打磨侧点位换算到TCP
+    static Point ToTcp(const Point &point, double toolOffset);
+};
+
+#endif // PATHPLAN_H
@@ -7,6 +7,7 @@
 #include <QtMath>
 
 #include "craft.h"
+#include "swrcore_global.h"
 
 // 长度单位（毫米，米）
 enum LengthUnit { MM, M };
@@ -14,7 +15,7 @@ enum LengthUnit { MM, M };
 enum AngleUnit { Deg, Rad };
 
 #pragma execution_character_set("utf-8")
-class Point {
+class SWRCORE_EXPORT Point {
   public:
     Point();
     Point(float x, float y, float z, float rx, float ry, float rz);
@@ -24,6 +25,7 @@ class Point {
     Point PosRelByTool(const OffsetDirection &direction,
                        const double &offset) const;
     QString toString() const;
+    static bool fromString(const QString &str, Point &point);
 
     void operator+=(const Point &point);
 
@@ -34,11 +36,14 @@ class Point {
     static QVector3D calculateCircumcenter(const QVector3D &A,
                                            const QVector3D &B,
                                            const QVector3D &C);
-    // 四点求球心
+    // 四点求球心，四点近似共面（混合积小于三边长之积的千分之一）时返回A
     static QVector3D calculateSpherecenter(const QVector3D &A,
                                            const QVector3D &B,
                                            const QVector3D &C,
                                            const QVector3D &D);
+    // 最小二乘拟合球面，至少四点（四点时为外接球）
+    static bool fitSphere(const QVector<QVector3D> &points, QVector3D &center,
+                          float &radius);
     // 欧拉角转旋转矩阵
     static QMatrix3x3 toRotationMatrix(const QVector3D &rotation);
     // 计算指定旋转轴和夹角的旋转矩阵
@@ -66,9 +71,12 @@ class Point {
     friend class HansRobot;
     friend class DucoRobot;
     friend class JakaRobot;
+    friend class SimRobot;
+    friend class PathPlanner;
+    friend class FrameRegistration;
 };
 
-class PointSet {
+class SWRCORE_EXPORT PointSet {
   public:
     PointSet();
 
@@ -88,6 +96,7 @@ class PointSet {
     bool isBeginOffsetPointRecorded; // 起始偏移点是否记录
     Point endOffsetPoint;            // 结束偏移点
     bool isEndOffsetPointRecorded;   // 结束偏移点是否记录
+    QVector<Point> referencePoints;  // 配准基准点（工件上的特征点）
 
     friend class Robot;
     friend class HansRobot;
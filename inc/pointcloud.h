@@ -0,0 +1,47 @@
+﻿#ifndef POINTCLOUD_H
+#define POINTCLOUD_H
+
+#include <QString>
+#include <QVector3D>
+#include <QVector>
+
+#include "swrcore_global.h"
+
+// 工件扫描点云：读入后建立KD树（点按树序重排），并行PCA估计法向
+class SWRCORE_EXPORT PointCloud {
+  public:
+    PointCloud();
+
+    // 读取 PLY（ascii / binary_little_endian）或 XYZ 文本，k 为估计法向的近邻数
+    bool Load(const QString &fileName, int k = 16);
+    void Clear();
+    bool IsEmpty() const;
+    int Count() const;
+    QString FileName() const;
+    const QVector3D &Position(int index) const;
+    const QVector3D &Normal(int index) const; // 单位法向，方向未定
+
+    // k近邻，按距离升序写入 indices/distances（距离平方），返回找到的个数
+    int KNearest(const QVector3D &point, int k, int *indices,
+                 float *distances) const;
+    // 沿 direction 将 origin 投影到局部拟合平面上，normal 与 direction 同向；
+    // 最近点距离超过 maxGap（无扫描数据）时返回 false
+    bool Project(const QVector3D &origin, const QVector3D &direction, int k,
+                 double maxGap, QVector3D &point, QVector3D &normal) const;
+
+  private:
+    bool LoadXyz(const QByteArray &data);
+    bool LoadPly(const QByteArray &data);
+    void BuildIndex(int *order, quint8 *axisData, int lo, int hi, int depth);
+    void SearchIndex(int lo, int hi, const QVector3D &point, int k,
+                     int *indices, float *distances, int &found) const;
+    void EstimateNormals(int k);
+
+    QString fileName;
+    QVector<QVector3D> positions; // 点坐标，按KD树序排列，mm
+    QVector<QVector3D> normals;   // 法向
+    QVector<quint8> axes;         // 各节点（区间中点）的分割轴
+    bool hasNormals;              // 文件是否自带法向
+};
+
+#endif // POINTCLOUD_H
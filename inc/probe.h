@@ -0,0 +1,37 @@
+﻿#ifndef PROBE_H
+#define PROBE_H
+
+#include "swrcore_global.h"
+
+// 触碰探测参数（settings.ini [Probe]）
+struct SWRCORE_EXPORT ProbeParams {
+    ProbeParams();
+
+    double speed;      // 探测速度，mm/s
+    double approach;   // 探测起点到名义接触点的距离（沿工具Z轴反向），mm
+    double overtravel; // 越过名义接触点的最大探测距离，mm
+    int interval;      // 打磨头采样周期，ms
+    int force;         // 探测时打磨头的设定力，N
+    double posDrop;    // 判定接触的打磨头缩回量，mm
+    double forceRise;  // 判定接触的压力增量，N
+};
+
+// 接触判定：前若干个采样取平均作为基线（打磨头悬空），之后缩回量或压力增量
+// 超过阈值，且连续两个采样满足时判定为接触
+class SWRCORE_EXPORT ContactDetector {
+  public:
+    ContactDetector();
+
+    void Reset(const ProbeParams &params);
+    bool Update(double agpPos, double force); // 追加采样，返回是否接触
+
+  private:
+    double posDrop;   // 缩回量阈值，mm
+    double forceRise; // 压力增量阈值，N
+    int baseCount;    // 基线已累计的采样数
+    double basePos;   // 基线打磨头位置，mm
+    double baseForce; // 基线压力，N
+    int hits;         // 连续满足阈值的采样数
+};
+
+#endif // PROBE_H
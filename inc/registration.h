@@ -0,0 +1,43 @@
+﻿#ifndef REGISTRATION_H
+#define REGISTRATION_H
+
+#include <QGenericMatrix>
+#include <QVector3D>
+#include <QVector>
+
+#include "point.h"
+#include "swrcore_global.h"
+
+// 工件坐标系配准参数（settings.ini [Registration]）
+struct SWRCORE_EXPORT RegistrationParams {
+    RegistrationParams();
+
+    double maxResidual; // 允许的最大配准残差，mm
+    double minSpread;   // 基准点偏离其主方向直线的最小均方根距离，mm
+};
+
+// 刚体变换 x' = rotation·x + translation 及配准残差
+struct SWRCORE_EXPORT RigidTransform {
+    RigidTransform();
+
+    QMatrix3x3 rotation;   // 旋转矩阵
+    QVector3D translation; // 平移，mm
+    double rms;            // 基准点残差均方根，mm
+    double maxError;       // 基准点最大残差，mm
+};
+
+// 工件坐标系配准：由示教时和重新装夹后一一对应的基准点求刚体变换，
+// 再把程序中的全部位姿一次变换到新位置
+class SWRCORE_EXPORT FrameRegistration {
+  public:
+    // 最小二乘刚体变换（Kabsch 问题，用 Horn 四元数闭式解），
+    // 至少三个不共线的点，from[i] 变换后应与 to[i] 重合
+    static bool Solve(const QVector<QVector3D> &from,
+                      const QVector<QVector3D> &to,
+                      const RegistrationParams &params,
+                      RigidTransform &transform);
+    // 批量变换位姿：位置 R·p+t，姿态左乘 R
+    static void Apply(const RigidTransform &transform, QVector<Point> &points);
+};
+
+#endif // REGISTRATION_H
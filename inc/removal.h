@@ -0,0 +1,43 @@
+﻿#ifndef REMOVAL_H
+#define REMOVAL_H
+
+#include "coverage.h"
+#include "swrcore_global.h"
+
+// 材料去除仿真参数（settings.ini [Removal]）
+struct SWRCORE_EXPORT RemovalParams {
+    RemovalParams();
+
+    double coefficient; // Preston 系数 k，mm²/N
+    double target;      // 目标去除深度，μm
+};
+
+// 去除深度网格，几何与覆盖网格相同
+struct SWRCORE_EXPORT RemovalMap {
+    RemovalMap();
+
+    CoverageMap grid;      // 网格几何和区域掩码（不统计遍数）
+    QVector<float> depths; // 每格去除深度，μm，按行存放
+    double minDepth;       // 区域内最小去除深度，μm
+    double meanDepth;      // 区域内平均去除深度，μm
+    double maxDepth;       // 区域内最大去除深度，μm
+    int shortCells;        // 区域内未达到目标深度的网格数
+    double speedScale; // 区域内处处达到目标深度时进给速度可放大的倍数
+};
+
+// 材料去除仿真：Preston 方程 dh/dt = k·p·v，p 为设定力除以接触区面积，
+// v 为打磨片上该点的转动线速度 ω·r（忽略进给速度），按每个采样的停留时间累加
+class SWRCORE_EXPORT RemovalSimulator {
+  public:
+    // force 为设定力，N；rotateSpeed 为转速，r/min
+    static bool Simulate(const QVector<PathSegment> &path,
+                         const QVector<QVector3D> &corners, double discRadius,
+                         double force, double rotateSpeed,
+                         const CoverageParams &gridParams,
+                         const RemovalParams &params, RemovalMap &map);
+    // 热力图（PNG）：区域外灰色，未达到目标深度红色，去除越深颜色越深
+    static bool SaveHeatmap(const RemovalMap &map, double target,
+                            const QString &fileName);
+};
+
+#endif // REMOVAL_H
@@ -2,19 +2,65 @@
 #define ROBOT_H
 
 #include "AGP.h"
-#include "DucoCobot.h"
-#include "JAKAZuRobot.h"
+#include "coverage.h"
+#include "forcefeed.h"
+#include "mesh.h"
+#include "metrics.h"
+#include "pathplan.h"
+#include "pointcloud.h"
+#include "probe.h"
+#include "registration.h"
+#include "removal.h"
+#include "spline.h"
+#include "sweep.h"
+#include "teachrecord.h"
+#include "swrcore_global.h"
 #include "point.h"
+#include "runlog.h"
 
-class Robot {
+#include <mutex>
+#include <thread>
+
+#include "callstats.h"
+
+// AGP 调用计时（AGP.h 为厂商代码，不在其中插桩），调用后 agp->err 为真计为错误
+#define AGP_CALL(method, ...)                                                  \
+    [&] {                                                                      \
+        CallTimer timer(CALL_ID("AGP::" #method), &agp->err);                  \
+        return agp->method(__VA_ARGS__);                                       \
+    }()
+
+// 控制器支持的快速运动方式（Robot::Capabilities 的位）
+enum RobotCapability {
+    PathUploadCapability = 0x01, // 连续轨迹整体下发（MoveTcpPath）
+    ServoCapability = 0x02       // 按固定周期流式下发位姿（ServoTcpPath）
+};
+
+// 连续轨迹的执行方式（settings.ini [Motion] Mode）
+enum class ExecutionMode {
+    AutoMode,       // 按控制器能力自动选择
+    WaypointMode,   // 逐点下发（MoveTcpL），所有控制器都支持
+    PathUploadMode, // 整条轨迹上传后执行
+    ServoMode       // 伺服流式下发
+};
+
+// 一段连续打磨轨迹（打磨侧点位），isLinked 为真时从上一段终点贴着工件直接移入，
+// 否则先抬刀再切入
+struct PolishRun {
+    QVector<Point> points;
+    bool isLinked;
+};
+
+class SWRCORE_EXPORT Robot {
   public:
     Robot();
-    ~Robot();
+    virtual ~Robot();
 
     bool AGPConnect(QString agpIP);                  // 连接打磨头
     void AGPRun(const Craft &craft, bool isRotated); // 打磨头运行
     void AGPStop();                                  // 打磨头停止
     bool IsAGPEnabled();                             // 打磨头是否使能
+    void LoadSettings(const QString &fileName);      // 读取运行参数
 
     virtual bool RobotConnect(QString robotIP) = 0; // 连接机器人
     virtual bool GetTcpPoint(Point &point) = 0;     // 获取TCP点位
@@ -30,6 +76,18 @@ class Robot {
     virtual void MoveTcpC(const Point &auxPoint, const Point &endPoint,
                           double dVelocity, double dAcc,
                           double dRadius) = 0; // 圆弧运动
+    virtual bool GetJointPos(double *joints);    // 获取关节位置，°
+    virtual int GetCurrentSegment();             // 正在执行的路径段编号
+    virtual bool SetSpeedOverride(double ratio); // 设置控制器速度比
+    virtual bool MoveTcpPath(const QVector<Point> &points, double dVelocity,
+                             double dAcc); // 连续轨迹运动，不支持时返回false
+    virtual int Capabilities() const; // 支持的快速运动方式（RobotCapability）
+    // 伺服运动：每隔 period 秒下发一个TCP位姿，不支持时返回false
+    virtual bool ServoTcpPath(const QVector<Point> &points, double period);
+    // 只中止当前运动：不停打磨头、不置停止标志、不计急停，不支持时返回false
+    virtual bool AbortMotion();
+    // 按控制器能力和 [Motion] Mode 选择路径中连续轨迹的执行方式
+    ExecutionMode SelectExecutionMode(const QVector<PathSegment> &path) const;
 
     bool GetPoint(Point &point);
     bool GetSafePoint(QString &strPoint);
@@ -42,15 +100,37 @@ class Robot {
     bool ClearPoints();
     bool ClearMidPoints();
     int DelLastMidPoint();
-    bool CheckAllPoints(const PolishWay &way);
+    bool StartTeachRecord(); // 自由拖拽时开始连续录制TCP位姿和打磨头位置
+    // 结束录制，把轨迹转换为起始点、中间点、结束点
+    bool StopTeachRecord(QString &tip);
+    bool IsTeachRecording() const; // 是否正在录制
+    // 记录配准基准点（工件上的特征点），返回基准点数，读取失败返回-1
+    int AddReferencePoint(QString &strPoint);
+    // 重新装夹后按相同顺序测量基准点，返回已测量数，读取失败返回-1
+    int AddTouchPoint(QString &strPoint);
+    int ReferenceCount() const; // 基准点数
+    int TouchCount() const;     // 已测量的基准点数
+    void ClearTouchPoints();
+    // 由基准点和测量点求工件坐标系变换，一次变换程序中的全部点位
+    bool RegisterProgram(QString &tip);
+    // 用打磨头依次触碰探测全部基准点，结果替换已测量的基准点
+    bool ProbeReferencePoints(QString &tip);
+    bool CheckAllPoints(const PolishWay &way, QString &tip);
     void CoverPoint(QString &strPoint);
+    QStringList GetRecordedPoints() const; // 已记录点位（历史点格式）
+    bool SaveProgram(const QString &fileName, const Craft &craft) const;
+    bool LoadProgram(const QString &fileName, Craft &craft);
+    bool LoadCloud(const QString &fileName); // 导入工件扫描点云
+    int CloudSize() const;                   // 点云点数，未导入为0
+    bool LoadMesh(const QString &fileName);  // 导入工件 STL 模型
+    int MeshSize() const;                    // 模型面数，未导入为0
 
     void MoveL(const Point &point, double dVelocity, double dAcc,
                double dRadius);
     void MoveC(const Point &auxPoint, const Point &endPoint, double dVelocity,
                double dAcc, double dRadius);
     void MoveToPoint(const QStringList &coordinates);
-    void MoveBefore(const Craft &craft, bool isAGPRun);
+    void MoveBefore(const Craft &craft);
     void MoveAfter(const Craft &craft, Point point);
     void MoveLine(const Craft &craft);
     void MoveArc(const Craft &craft);
@@ -63,7 +143,27 @@ class Robot {
     Point MoveCylinderVertical(const Craft &craft, bool isConvex);
     void MoveZLine(const Craft &craft);
     void MoveSpiralLine(const Craft &craft);
+    void MoveSpline(const Craft &craft);
+    Point MoveSphere(const Craft &craft);
+    Point MoveCloud(const Craft &craft);
+    Point MoveMesh(const Craft &craft);
     void Run(const Craft &craft, bool isAGPRun);
+    // 只生成完整路径（进刀、打磨、退刀）不运动，打磨段移动速度乘以 speedScale
+    QVector<PathSegment> GeneratePath(const Craft &craft,
+                                      double speedScale = 1);
+    // 按当前点位生成路径，统计起始点、结束点、偏移点围成区域的覆盖情况
+    bool AnalyzeCoverage(const Craft &craft, CoverageMap &map);
+    // 达到覆盖率要求的最小偏移次数，不适用或找不到时返回-1
+    int SuggestOffsetCount(const Craft &craft);
+    // 按当前点位生成并规划路径，仿真区域内的材料去除深度
+    bool SimulateRemoval(const Craft &craft, RemovalMap &map);
+    double RemovalTarget() const; // 目标去除深度，μm
+    // 按当前点位扫描 [Sweep] 中的工艺参数组合，结果按节拍升序并标记
+    // Pareto 前沿，组合数超过上限或无法评价时返回 false
+    bool Sweep(const Craft &craft, QVector<SweepResult> &results);
+    double SweepMinQuality() const; // 可接受的最低质量，%
+    // 按扫描结果修改工艺参数得到的新工艺（工艺名附加参数）
+    static Craft SweepCraft(const Craft &craft, const SweepResult &result);
 
   protected:
     AGP *agp;                 // AGP
@@ -74,93 +174,79 @@ class Robot {
     QVector3D newRotInv;      // 倾斜指定角度后的姿态
     QVector3D translationInv; // 变换姿态后需要的平移量
     std::atomic<bool> isStop; // 是否停止
+    std::atomic<int> segmentIndex; // 最近下发的路径段编号
+    std::recursive_mutex agpMutex; // 打磨头通信锁（采样线程共用连接）
+    bool isSegmentTracked;         // 执行位置反馈是否可用（GetCurrentSegment）
+
+  private:
+    void StartRecorder(const Craft &craft);
+    void StopRecorder();
+    void RecordLoop(RunLogWriter *writer);
+    void UpdateForceFeed(const RunLogRecord &record, double dt);
+    void MarkContactSegment(int segment, bool isContact);
+    void TeachLoop();
+    bool ProbePoint(const Point &nominal, QVector3D &measured);
+    void PlanPath(QVector<PathSegment> &path, double moveSpeed,
+                  double speedScale);
+    void ExecutePath(const QVector<PathSegment> &path);
+    bool MovePath(const QVector<Point> &points, double dVelocity, double dAcc);
+    bool ServoPath(const QVector<Point> &points, double dVelocity,
+                   double dAcc);
+    bool RegionCorners(QVector<QVector3D> &corners) const;
+    Point SurfacePose(const Craft &craft, const QVector3D &surface,
+                      const QVector3D &normal, const QVector3D &direction);
+    Point MoveRuns(const Craft &craft, const QVector<PolishRun> &runs);
+
+    bool isRunLogEnabled;                // 是否记录运行数据
+    QString runLogDir;                   // 运行记录目录
+    int runLogInterval;                  // 采样周期，ms
+    QString traceDir;                    // 运行时间线目录（空为不记录）
+    std::thread recorder;                // 采样线程
+    std::atomic<bool> isRecording;       // 采样线程是否运行
+    ForceFeedController forceFeed;       // 力自适应进给
+    std::atomic<bool> isForceFeedOn;     // 本次运行是否启用力自适应进给
+    QVector<bool> contactSegments;       // 按路径段编号记录是否为接触段
+    std::mutex contactMutex;             // 保护 contactSegments（采样线程读取）
+    double feedScale;                    // 本次运行接触段下发速度的放大系数
+    double forceFeedTarget;              // 目标压力，N
+    double forceFeedContact;             // 接触判定压力，N
+    bool isForceFeedControlling;         // 控制器是否正在调节
+    double lastOverride;                 // 最近下发的速度比
+    QVector<PathSegment> *capturePath;   // 非空时 MoveL/MoveC 只记录不下发
+    int capturePhase;                    // 当前记录的路径阶段
+    bool isCaptureContact;               // 当前记录的是否为接触打磨段
+    bool isCaptureStreamed;              // 当前记录的是否为连续轨迹
+    double splineStep;                   // 样条采样间距，mm
+    bool isSphereSpiral;                 // 球面路径是否为螺旋线（否则为纬线圈）
+    double sphereStep;                   // 球面螺旋线采样间距，mm
+    PointCloud cloud;                    // 工件扫描点云
+    bool isCloudRaster;                  // 点云路径是否单向（否则往复）
+    double cloudStep;                    // 点云路径采样间距，mm
+    int cloudNeighbors;                  // 法向估计、曲面投影的近邻数
+    double cloudGap;                     // 投影点到最近扫描点的距离上限，mm
+    Mesh mesh;                           // 工件 STL 模型（机器人基坐标系）
+    bool isMeshRaster;                   // 模型切片路径是否单向（否则往复）
+    double meshStep;                     // 模型切片路径最小点距，mm
+    FeedPlanParams feedPlanParams;       // 曲率进给规划参数
+    BlendPlanParams blendPlanParams;     // 过渡半径规划参数
+    CompressParams compressParams;       // 路径压缩参数
+    CoverageParams coverageParams;       // 覆盖分析参数
+    RemovalParams removalParams;         // 材料去除仿真参数
+    SweepParams sweepParams;             // 参数扫描设置
+    MetricsServer metricsServer;         // 本机指标服务
+    ExecutionMode executionMode;         // 设定的连续轨迹执行方式
+    double servoPeriod;                  // 伺服下发周期，s
+    TeachParams teachParams;             // 拖拽示教录制参数
+    TeachBuffer teachBuffer;             // 拖拽示教采样缓冲区
+    std::thread teachRecorder;           // 拖拽示教采样线程
+    std::atomic<bool> isTeachRecording;  // 拖拽示教采样线程是否运行
+    RegistrationParams registerParams;   // 工件坐标系配准参数
+    QVector<QVector3D> touchPoints;      // 重新装夹后测量的基准点
+    ProbeParams probeParams;             // 触碰探测参数
 
   public:
     int discThickness; // 打磨片厚度，mm
     int teachPos;      // 示教点参考位置，mm
 };
 
-class HansRobot : public Robot {
-  public:
-    HansRobot();
-    ~HansRobot();
-
-    bool RobotConnect(QString robotIP);
-    bool RobotTeach(int pos);
-    bool GetTcpPoint(Point &point);
-    // void MoveBefore(const Craft &craft, bool isAGPRun);
-    // void MoveAfter(const Craft &craft, Point point);
-    // void MoveLine(const Craft &craft);
-    // void MoveArc(const Craft &craft);
-    // Point MoveRegionArc1(const Craft &craft);
-    // Point MoveRegionArc2(const Craft &craft);
-    // void MoveZLine(const Craft &craft);
-    // void MoveSpiralLine(const Craft &craft);
-    bool IsRobotElectrified();
-    bool IsRobotEnabled();
-    bool IsRobotMoved();
-    bool CloseFreeDriver();
-    // void Run(const Craft &craft, bool isAGPRun);
-    bool Stop();
-
-    void OpenWeb(QString ip); // 打开网页示教器
-    void MoveTcpL(const Point &point, double velocity, double acc,
-                  double radius); // 直线运动
-    void MoveTcpC(const Point &auxPoint, const Point &endPoint, double velocity,
-                  double acc,
-                  double radius); // 圆弧运动
-};
-/*
-class DucoRobot : public Robot {
-  public:
-    DucoRobot();
-    ~DucoRobot();
-
-    bool RobotConnect(QString robotIP);
-    bool RobotTeach(int pos);
-    bool GetTcpPoint(Point &point);
-    void MoveBefore(DucoRPC::DucoCobot *robot, const Craft &craft,
-                    bool isAGPRun);
-    void MoveAfter(DucoRPC::DucoCobot *robot, const Craft &craft, Point point);
-    void MoveLine(DucoRPC::DucoCobot *robot, const Craft &craft);
-    void MoveArc(DucoRPC::DucoCobot *robot, const Craft &craft);
-    Point MoveRegionArc1(const Craft &craft);
-    Point MoveRegionArc2(const Craft &craft);
-    void MoveZLine(const Craft &craft);
-    void MoveSpiralLine(const Craft &craft);
-    bool IsRobotEnabled();
-    bool IsRobotMoved();
-    bool CloseFreeDriver();
-    void Run(const Craft &craft, bool isAGPRun);
-    bool Stop();
-    void OpenWeb(QString ip);
-
-  private:
-    DucoRPC::DucoCobot *ducoCobot;
-};
-*/
-class JakaRobot : public Robot {
-  public:
-    JakaRobot();
-    ~JakaRobot();
-
-    bool RobotConnect(QString robotIP); // 连接机器人
-    bool GetTcpPoint(Point &point);     // 获取点位
-    bool RobotTeach(int pos);           // 开始示教
-    bool CloseFreeDriver();             // 结束示教
-    bool Stop();                        // 急停
-    bool IsRobotElectrified();          // 是否上电
-    bool IsRobotEnabled();              // 是否使能
-    bool IsRobotMoved();                // 是否正在移动
-    void OpenWeb(QString ip);           // 打开网页示教器
-    void MoveTcpL(const Point &point, double dVelocity, double dAcc,
-                  double dRadius); // 直线运动
-    void MoveTcpC(const Point &auxPoint, const Point &endPoint,
-                  double dVelocity, double dAcc,
-                  double dRadius); // 圆弧运动
-
-  private:
-    JAKAZuRobot jakaRobot;
-};
-
 #endif // ROBOT_H
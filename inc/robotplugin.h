@@ -0,0 +1,33 @@
+﻿#ifndef ROBOTPLUGIN_H
+#define ROBOTPLUGIN_H
+
+#include <QStringList>
+
+#include "robot.h"
+
+// 插件接口版本，Robot 的虚函数或成员布局变化时加一
+constexpr int robotPluginVersion = 9;
+
+// 机器人后端插件：共享库 swr-<名称> 放在程序目录的 robots 子目录下，
+// 用此宏导出版本号和创建函数，返回的对象由调用方 delete
+#define SWR_ROBOT_PLUGIN(RobotClass)                                           \
+    extern "C" Q_DECL_EXPORT int SWR_RobotPluginVersion() {                    \
+        return robotPluginVersion;                                             \
+    }                                                                          \
+    extern "C" Q_DECL_EXPORT Robot *SWR_CreateRobot() {                        \
+        return new RobotClass();                                               \
+    }
+
+// 按名称创建机器人后端，只加载选中的插件及其厂商 SDK
+class SWRCORE_EXPORT RobotFactory {
+  public:
+    // sim 为内置仿真机器人，其余加载插件；失败时返回 nullptr，error 为原因
+    static Robot *Create(const QString &name, QString &error);
+    // settings.ini [Robot] Backend，缺省为 hans
+    static QString Backend(const QString &settingsFile);
+    // 可用的后端名称（sim 和插件目录中的插件）
+    static QStringList Available();
+    static QString PluginDir(); // 插件目录
+};
+
+#endif // ROBOTPLUGIN_H
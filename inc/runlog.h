@@ -0,0 +1,136 @@
+﻿#ifndef RUNLOG_H
+#define RUNLOG_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+#include "swrcore_global.h"
+
+// 运行记录文件：64字节文件头 + 定长记录，追加写入
+constexpr char runLogMagic[8] = {'S', 'W', 'R', 'L', 'O', 'G', '0', '1'};
+
+#pragma pack(push, 1)
+struct RunLogHeader {
+    char magic[8];       // 文件标识 SWRLOG01
+    quint32 recordSize;  // 单条记录字节数
+    quint32 headerSize;  // 文件头字节数
+    qint64 startTime;    // 开始时间，ms（UTC）
+    qint64 recordCount;  // 记录数量
+    char craftID[28];    // 工艺名，UTF-8
+    float referencePos;  // 示教点参考位置，mm
+};
+
+struct RunLogRecord {
+    qint64 timestamp;  // 距开始时间，us
+    float tcp[6];      // TCP位姿，mm、°
+    float joint[6];    // 关节位置，°
+    float force;       // 打磨头压力，N
+    float agpPos;      // 打磨头位置，mm
+    float speed;       // 主轴转速，r/min
+    float temperature; // 打磨头温度
+    qint32 segment;    // 当前路径段编号
+    quint32 flags;     // 有效标志（RunLogFlag）
+};
+#pragma pack(pop)
+
+static_assert(sizeof(RunLogHeader) == 64, "RunLogHeader size");
+static_assert(sizeof(RunLogRecord) == 80, "RunLogRecord size");
+
+// 记录有效标志
+enum RunLogFlag {
+    RecordValid = 0x01, // 记录已写入
+    TcpValid = 0x02,    // TCP位姿有效
+    JointValid = 0x04,  // 关节位置有效
+    AGPValid = 0x08     // 打磨头数据有效
+};
+
+// 运行记录写入：文件按块预分配并内存映射，追加时只做一次内存拷贝
+class SWRCORE_EXPORT RunLogWriter {
+  public:
+    RunLogWriter();
+    ~RunLogWriter();
+
+    bool Open(const QString &fileName, const QString &craftID,
+              float referencePos);
+    bool Append(const RunLogRecord &record);
+    void Close();
+    bool IsOpen() const;
+    qint64 Count() const;
+
+  private:
+    bool MapChunk();
+    bool WriteCount();
+
+    QFile file;
+    uchar *chunk;        // 当前映射块
+    qint64 chunkOffset;  // 当前映射块在文件中的偏移
+    qint64 chunkUsed;    // 当前映射块已写记录数
+    qint64 recordCount;  // 已写记录总数
+};
+
+// 运行记录读取：整个文件只读映射，按需换页，不整体读入内存
+class SWRCORE_EXPORT RunLogReader {
+  public:
+    RunLogReader();
+    ~RunLogReader();
+
+    bool Open(const QString &fileName);
+    void Close();
+    bool IsOpen() const;
+    const RunLogHeader &Header() const;
+    qint64 Count() const;
+    const RunLogRecord &At(qint64 index) const;
+
+  private:
+    QFile file;
+    uchar *data;         // 映射地址
+    RunLogHeader header; // 文件头
+    qint64 count;        // 有效记录数
+};
+
+// 绘图通道
+enum RunLogChannel {
+    ForceChannel,     // 打磨头压力，N
+    SpeedChannel,     // TCP速度，mm/s
+    SpindleChannel,   // 主轴转速，r/min
+    DeviationChannel, // 路径偏差（打磨头位置 - 参考位置），mm
+    ChannelCount
+};
+
+// 抽稀桶：一段连续记录的起点坐标及各通道最小/最大值
+struct RunLogBucket {
+    qint64 first;              // 首条记录编号
+    qint64 count;              // 记录数量
+    double time;               // 起点时间，s
+    double arc;                // 起点弧长，mm
+    float min[ChannelCount];   // 各通道最小值
+    float max[ChannelCount];   // 各通道最大值
+};
+
+// 最小/最大值金字塔：第0层每桶固定条数，逐层两两合并
+class SWRCORE_EXPORT RunLogIndex {
+  public:
+    RunLogIndex();
+
+    void Build(const RunLogReader &reader, int bucketSize = 256);
+    void Clear();
+    int LevelCount() const;
+    const QVector<RunLogBucket> &Level(int level) const;
+    double Duration() const;  // 总时长，s
+    double ArcLength() const; // 总弧长，mm
+
+    // 计算单条记录的通道值，无效时返回 NaN
+    static float Value(const RunLogRecord &record, const RunLogRecord &prev,
+                       int channel, float referencePos);
+    // 相邻两条记录之间的TCP移动距离，mm
+    static double Distance(const RunLogRecord &record,
+                           const RunLogRecord &prev);
+
+  private:
+    QVector<QVector<RunLogBucket>> levels;
+    double duration;
+    double arcLength;
+};
+
+#endif // RUNLOG_H
@@ -0,0 +1,46 @@
+﻿#ifndef SIMROBOT_H
+#define SIMROBOT_H
+
+#include "robot.h"
+#include "swrcore_global.h"
+
+// 仿真机器人：不连接控制器，按指令即时更新TCP位姿并估算运动时间
+class SWRCORE_EXPORT SimRobot : public Robot {
+  public:
+    SimRobot();
+    ~SimRobot();
+
+    bool RobotConnect(QString robotIP); // 连接机器人
+    bool GetTcpPoint(Point &point);     // 获取点位
+    bool RobotTeach(int pos);           // 开始示教
+    bool CloseFreeDriver();             // 结束示教
+    bool Stop();                        // 急停
+    bool IsRobotElectrified();          // 是否上电
+    bool IsRobotEnabled();              // 是否使能
+    bool IsRobotMoved();                // 是否正在移动
+    void OpenWeb(QString ip);           // 打开网页示教器
+    void MoveTcpL(const Point &point, double dVelocity, double dAcc,
+                  double dRadius); // 直线运动
+    void MoveTcpC(const Point &auxPoint, const Point &endPoint,
+                  double dVelocity, double dAcc,
+                  double dRadius); // 圆弧运动
+    bool MoveTcpPath(const QVector<Point> &points, double dVelocity,
+                     double dAcc); // 连续轨迹运动
+    int Capabilities() const;      // 支持全部快速运动方式
+    bool ServoTcpPath(const QVector<Point> &points,
+                      double period); // 伺服运动
+    bool AbortMotion();            // 中止当前运动
+
+    double MotionTime() const;   // 累计运动时间，s
+    double MotionLength() const; // 累计运动长度，mm
+    int MotionCount() const;     // 运动指令数量
+    void ResetStatistics();      // 清空统计
+
+  private:
+    Point tcpPoint;      // 当前TCP位姿
+    double motionTime;   // 累计运动时间，s
+    double motionLength; // 累计运动长度，mm
+    int motionCount;     // 运动指令数量
+};
+
+#endif // SIMROBOT_H
@@ -0,0 +1,30 @@
+﻿#ifndef SPLINE_H
+#define SPLINE_H
+
+#include <QVector3D>
+#include <QVector>
+
+#include "swrcore_global.h"
+
+// 三次样条（自然边界，C2连续），参数为累计弦长
+class SWRCORE_EXPORT CubicSpline {
+  public:
+    CubicSpline();
+
+    bool Fit(const QVector<QVector3D> &points); // 拟合，至少两个不重合点
+    QVector3D Evaluate(double t) const;         // 参数 t 处的位置
+    double ParamLength() const;                 // 参数总长（弦长之和）
+    double Length() const;                      // 曲线弧长，mm
+
+    // 按弧长等间距重采样，返回采样点（含首末点）
+    QVector<QVector3D> Resample(double step) const;
+
+  private:
+    QVector<double> knots;       // 节点参数
+    QVector<QVector3D> values;   // 节点位置
+    QVector<QVector3D> moments;  // 节点二阶导数
+    QVector<double> arcParams;   // 弧长表：参数
+    QVector<double> arcLengths;  // 弧长表：累计弧长
+};
+
+#endif // SPLINE_H
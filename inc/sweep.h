@@ -0,0 +1,77 @@
+﻿#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <QString>
+#include <QVector>
+#include <vector>
+
+#include "pathplan.h"
+#include "swrcore_global.h"
+
+// 扫描范围 min 到 max，步长 step（settings.ini 中写作 "min,max,step"），
+// 为空时使用工艺中的当前值
+struct SWRCORE_EXPORT SweepRange {
+    SweepRange();
+
+    // 解析 "min,max,step" 或单个值，格式错误返回 false
+    bool Parse(const QString &text);
+    // 范围内的取值，为空时返回 {value}
+    QVector<int> Values(int value) const;
+
+    int min, max, step;
+};
+
+// 参数扫描设置（settings.ini [Sweep]）
+struct SWRCORE_EXPORT SweepParams {
+    SweepParams();
+
+    SweepRange moveSpeed;        // 移动速度，mm/s
+    SweepRange offsetCount;      // 偏移次数（仅按偏移次数分行的打磨方式）
+    SweepRange grindAngle;       // 打磨角度，°
+    SweepRange transitionRadius; // 过渡半径，mm
+    bool isRemovalMetric; // 以去除深度达标比例评价质量（否则为覆盖率）
+    double minQuality;    // 可接受的最低质量，%
+    int maxVariants;      // 组合数上限
+};
+
+// 一个工艺变体的评价结果
+struct SweepResult {
+    int moveSpeed;
+    int offsetCount;
+    int grindAngle;
+    int transitionRadius;
+    double cycleTime; // 估算节拍，s
+    double quality;   // 覆盖率或去除深度达标比例，%
+    bool isPareto;    // 是否在节拍-质量 Pareto 前沿上
+};
+
+// 同一几何（偏移次数、打磨角度）下各变体共享的路径和评价数据
+struct SweepGeometry {
+    int offsetCount;
+    int grindAngle;
+    QVector<PathSegment> path; // 参考速度下生成的路径（未规划）
+    double referenceSpeed;     // 仿真去除时的接触速度，mm/s
+    double coverage;           // 覆盖率，%
+    std::vector<float> depths; // 参考速度下区域内各格去除深度，升序，μm
+};
+
+// 参数扫描：几何相同的变体共享路径，速度和过渡半径只改写路径段，
+// 各变体在线程池中并行规划、估算节拍和质量
+class SWRCORE_EXPORT SweepEngine {
+  public:
+    // 评估所有 几何 × 移动速度 × 过渡半径 组合；feed/blend 为路径规划参数，
+    // removalTarget 为目标去除深度（μm，仅去除深度评价时使用）
+    static QVector<SweepResult>
+    Evaluate(const QVector<SweepGeometry> &geometries,
+             const QVector<int> &moveSpeeds,
+             const QVector<int> &transitionRadii, const SweepParams &params,
+             double toolOffset, const FeedPlanParams &feed,
+             const BlendPlanParams &blend, double removalTarget);
+    // 按节拍升序排列并标记 Pareto 前沿（节拍越短、质量越高越好）
+    static void MarkPareto(QVector<SweepResult> &results);
+    // 节拍最短的可接受变体（在 Pareto 前沿上），没有时返回 -1
+    static int Fastest(const QVector<SweepResult> &results,
+                       double minQuality);
+};
+
+#endif // SWEEP_H
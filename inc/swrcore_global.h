@@ -0,0 +1,14 @@
+﻿#ifndef SWRCORE_GLOBAL_H
+#define SWRCORE_GLOBAL_H
+
+#include <QtGlobal>
+
+// 核心库为共享库，界面、命令行工具和机器人后端插件共用同一份调用统计、
+// 时间线、运行指标等全局状态
+#if defined(SWRCORE_LIBRARY)
+#define SWRCORE_EXPORT Q_DECL_EXPORT
+#else
+#define SWRCORE_EXPORT Q_DECL_IMPORT
+#endif
+
+#endif // SWRCORE_GLOBAL_H
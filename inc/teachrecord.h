@@ -0,0 +1,43 @@
+﻿#ifndef TEACHRECORD_H
+#define TEACHRECORD_H
+
+#include <QVector>
+
+#include "point.h"
+#include "swrcore_global.h"
+
+// 拖拽示教录制参数（settings.ini [Teach]）
+struct SWRCORE_EXPORT TeachParams {
+    TeachParams();
+
+    int interval;    // 采样周期，ms
+    double duration; // 可保存的录制时长，s，超出后覆盖最早的采样
+    double step;     // 转换为中间点时的最小点距，mm
+};
+
+// 拖拽示教采样
+struct TeachSample {
+    qint64 timestamp; // 相对录制开始的时间，μs
+    Point tcp;        // TCP 位姿
+    double agpPos;    // 打磨头位置，mm
+};
+
+// 定长环形缓冲区：采样线程写入，写满后覆盖最早的采样，录制结束后读取
+class SWRCORE_EXPORT TeachBuffer {
+  public:
+    TeachBuffer();
+
+    void Reset(int capacity);             // 清空并分配容量
+    void Push(const TeachSample &sample); // 追加采样
+    int Size() const;                     // 保存的采样数
+    int Dropped() const;                  // 被覆盖的采样数
+    QVector<TeachSample> Samples() const; // 按时间顺序取出全部采样
+
+  private:
+    QVector<TeachSample> samples;
+    int head;    // 下一个写入位置
+    int count;   // 保存的采样数
+    int dropped; // 被覆盖的采样数
+};
+
+#endif // TEACHRECORD_H
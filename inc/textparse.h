@@ -0,0 +1,75 @@
+﻿#ifndef TEXTPARSE_H
+#define TEXTPARSE_H
+
+#include <QtMath>
+
+// 不依赖区域设置的数值解析（strtod 受 LC_NUMERIC 影响），p 前移到数值之后
+inline bool ParseNumber(const char *&p, const char *end, double &value) {
+    const char *q = p;
+    bool isNegative = false;
+    if (q < end && (*q == '-' || *q == '+')) {
+        isNegative = *q == '-';
+        ++q;
+    }
+    double mantissa = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    while (q < end && *q >= '0' && *q <= '9') {
+        mantissa = mantissa * 10 + (*q - '0');
+        hasDigits = true;
+        ++q;
+    }
+    if (q < end && *q == '.') {
+        ++q;
+        while (q < end && *q >= '0' && *q <= '9') {
+            mantissa = mantissa * 10 + (*q - '0');
+            --exponent;
+            hasDigits = true;
+            ++q;
+        }
+    }
+    if (!hasDigits) {
+        return false;
+    }
+    if (q < end && (*q == 'e' || *q == 'E')) {
+        const char *e = q + 1;
+        bool isExpNegative = false;
+        if (e < end && (*e == '-' || *e == '+')) {
+            isExpNegative = *e == '-';
+            ++e;
+        }
+        if (e < end && *e >= '0' && *e <= '9') {
+            int digits = 0;
+            while (e < end && *e >= '0' && *e <= '9') {
+                digits = qMin(digits * 10 + (*e - '0'), 999);
+                ++e;
+            }
+            exponent += isExpNegative ? -digits : digits;
+            q = e;
+        }
+    }
+    value = mantissa * qPow(10.0, exponent);
+    if (isNegative) {
+        value = -value;
+    }
+    p = q;
+    return true;
+}
+
+// 解析一行中的数值（空格、制表符或逗号分隔），返回个数
+inline int ParseNumbers(const char *p, const char *end, double *values,
+                     int capacity) {
+    int count = 0;
+    while (count < capacity) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r')) {
+            ++p;
+        }
+        if (p >= end || !ParseNumber(p, end, values[count])) {
+            break;
+        }
+        ++count;
+    }
+    return count;
+}
+
+#endif // TEXTPARSE_H
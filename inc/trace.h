@@ -0,0 +1,55 @@
+﻿#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+#include <chrono>
+
+#include "swrcore_global.h"
+
+// 运行时间线：各线程把完整事件（名称、开始时间、时长）写入各自的定长缓冲，
+// 写入不加锁；导出为 Chrome Trace Event JSON，可在 Perfetto 或
+// chrome://tracing 中查看。关闭时每个事件点只多一次原子读
+class SWRCORE_EXPORT Trace {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    // 清空已记录的事件并开始记录（应在各线程空闲时调用）
+    static void Start();
+    static void Stop();
+    static bool IsEnabled();
+    // 当前线程在时间线上的名称，name 须为常量字符串
+    static void SetThreadName(const char *name);
+    // 记录一个完整事件，name、category 须为常量字符串，arg < 0 表示无参数
+    static void Complete(const char *name, const char *category,
+                         Clock::time_point begin, Clock::time_point end,
+                         qint64 arg = -1);
+    // 缓冲已满而丢弃的事件数
+    static int DroppedEvents();
+    static bool SaveJson(const QString &fileName);
+};
+
+// 作用域事件：构造时计时，析构时记录
+class TraceScope {
+  public:
+    TraceScope(const char *name, const char *category, qint64 arg = -1)
+        : name(name), category(category), arg(arg),
+          isActive(Trace::IsEnabled()) {
+        if (isActive) {
+            begin = Trace::Clock::now();
+        }
+    }
+    ~TraceScope() {
+        if (isActive) {
+            Trace::Complete(name, category, begin, Trace::Clock::now(), arg);
+        }
+    }
+
+  private:
+    const char *name;
+    const char *category;
+    qint64 arg;
+    bool isActive;
+    Trace::Clock::time_point begin;
+};
+
+#endif // TRACE_H
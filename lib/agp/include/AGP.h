@@ -123,6 +123,8 @@ class AGP {
     int16_t ReadMode();
     int16_t ReadErr();
     int16_t ReadTemp();
+    // 一次读取状态、速度、力、位置、模式、错误、温度（地址21~27）
+    bool ReadInputs(int16_t *values);
 
   private:
     bool _connected{};
@@ -403,6 +405,17 @@ inline int16_t AGP::ReadTemp() {
     return temp;
 }
 
+inline bool AGP::ReadInputs(int16_t *values) {
+    if (!is_connected())
+        return false;
+    uint16_t temp[7];
+    if (modbus_read_input_registers(21, 7, temp) != 0 || err)
+        return false;
+    for (int i = 0; i < 7; i++)
+        values[i] = (int16_t)temp[i];
+    return true;
+}
+
 /**
  * Modbus Request Builder
  * @param to_send   Message Buffer to Be Sent
@@ -0,0 +1,15 @@
+TARGET = swr-duco
+
+include(../plugin.pri)
+
+INCLUDEPATH += $$PWD/../../lib/duco/shared/include
+
+win32: LIBS += -L$$PWD/../../lib/duco/shared/VS2019/win64/release/ -lDucoCobotAPI
+DEPENDPATH += $$PWD/../../lib/duco/shared/VS2019/win64/release
+
+SOURCES += \
+    ../../src/ducorobot.cpp
+
+HEADERS += \
+    ../../inc/ducorobot.h \
+    ../../lib/duco/shared/include/DucoCobot.h
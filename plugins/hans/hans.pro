@@ -0,0 +1,15 @@
+TARGET = swr-hans
+
+include(../plugin.pri)
+
+INCLUDEPATH += $$PWD/../../lib/hans/include
+
+win32: LIBS += -L$$PWD/../../lib/hans/x64/Release/ -lHR_Pro
+DEPENDPATH += $$PWD/../../lib/hans/x64/Release
+
+SOURCES += \
+    ../../src/hansrobot.cpp
+
+HEADERS += \
+    ../../inc/hansrobot.h \
+    ../../lib/hans/include/HR_Pro.h
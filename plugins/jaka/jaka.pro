@@ -0,0 +1,17 @@
+TARGET = swr-jaka
+
+include(../plugin.pri)
+
+INCLUDEPATH += $$PWD/../../lib/jaka/inc_of_c++
+
+win32: LIBS += -L$$PWD/../../lib/jaka/x64/ -ljakaAPI
+DEPENDPATH += $$PWD/../../lib/jaka/x64
+
+SOURCES += \
+    ../../src/jakarobot.cpp
+
+HEADERS += \
+    ../../inc/jakarobot.h \
+    ../../lib/jaka/inc_of_c++/JAKAZuRobot.h \
+    ../../lib/jaka/inc_of_c++/jkerr.h \
+    ../../lib/jaka/inc_of_c++/jktypes.h
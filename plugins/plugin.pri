@@ -0,0 +1,10 @@
+# 机器人后端插件公共设置
+QT = core gui network
+
+TEMPLATE = lib
+CONFIG += plugin
+
+include($$PWD/../common.pri)
+include($$PWD/../core.pri)
+
+DESTDIR = $$SWR_OUT/robots
@@ -0,0 +1,7 @@
+TEMPLATE = subdirs
+
+# 机器人后端插件，输出到程序目录的 robots 子目录
+SUBDIRS += \
+    duco \
+    hans \
+    jaka
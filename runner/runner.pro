@@ -0,0 +1,12 @@
+QT = core gui
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = swr-run
+
+include(../common.pri)
+include(../core.pri)
+
+SOURCES += \
+    ../src/runner.cpp
@@ -0,0 +1,232 @@
+﻿#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <mutex>
+
+#include "callstats.h"
+
+// 小于32 ns 每 ns 一桶，之后每个2的幂区间16桶，最后一桶约 2^41 ns（半小时）
+constexpr int exactBuckets = 32;
+constexpr int subBuckets = 16;
+constexpr int bucketCount = exactBuckets + 36 * subBuckets;
+constexpr int maxCalls = 128;
+
+struct CallEntry {
+    std::atomic<quint64> count;
+    std::atomic<quint64> errors;
+    std::atomic<quint64> sum;
+    std::atomic<quint64> max;
+    std::atomic<quint64> buckets[bucketCount];
+};
+
+// 静态存储零初始化，记录时无需加锁
+static CallEntry entries[maxCalls];
+static QByteArray names[maxCalls];
+static std::atomic<int> callCount(0);
+static std::mutex registerMutex;
+
+std::atomic<bool> CallStats::isEnabled(false);
+
+static int BucketIndex(quint64 value) {
+    if (value < (quint64)exactBuckets) {
+        return (int)value;
+    }
+    int msb = 63 - qCountLeadingZeroBits(value);
+    int index = exactBuckets + (msb - 5) * subBuckets +
+                (int)((value >> (msb - 4)) & (subBuckets - 1));
+    return qMin(index, bucketCount - 1);
+}
+
+// 桶的下界，ns；upper 返回上界
+static quint64 BucketLower(int index, quint64 *upper = nullptr) {
+    if (index < exactBuckets) {
+        if (upper != nullptr) {
+            *upper = index + 1;
+        }
+        return index;
+    }
+    int msb = (index - exactBuckets) / subBuckets + 5;
+    quint64 sub = (index - exactBuckets) % subBuckets;
+    if (upper != nullptr) {
+        *upper = (subBuckets + sub + 1) << (msb - 4);
+    }
+    return (subBuckets + sub) << (msb - 4);
+}
+
+void CallStats::SetEnabled(bool isEnabled) {
+    CallStats::isEnabled.store(isEnabled, std::memory_order_relaxed);
+}
+
+int CallStats::Register(const char *name) {
+    std::lock_guard<std::mutex> lock(registerMutex);
+    int count = callCount.load();
+    for (int i = 0; i < count; ++i) {
+        if (names[i] == name) {
+            return i;
+        }
+    }
+    if (count >= maxCalls) {
+        return -1;
+    }
+    names[count] = name;
+    callCount.store(count + 1);
+    return count;
+}
+
+const char *CallStats::Name(int id) {
+    return id >= 0 && id < callCount.load() ? names[id].constData() : "?";
+}
+
+void CallStats::Finish(int id, Trace::Clock::time_point start, bool isError,
+                       bool isStats, bool isTrace) {
+    Trace::Clock::time_point end = Trace::Clock::now();
+    if (isStats) {
+        Record(id,
+               std::chrono::duration_cast<std::chrono::nanoseconds>(end -
+                                                                    start)
+                   .count(),
+               isError);
+    }
+    if (isTrace) {
+        Trace::Complete(Name(id), "sdk", start, end);
+    }
+}
+
+void CallStats::Record(int id, qint64 nanoseconds, bool isError) {
+    if (id < 0 || id >= maxCalls) {
+        return;
+    }
+    CallEntry &entry = entries[id];
+    quint64 value = (quint64)qMax<qint64>(0, nanoseconds);
+    entry.count.fetch_add(1, std::memory_order_relaxed);
+    if (isError) {
+        entry.errors.fetch_add(1, std::memory_order_relaxed);
+    }
+    entry.sum.fetch_add(value, std::memory_order_relaxed);
+    entry.buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    quint64 max = entry.max.load(std::memory_order_relaxed);
+    while (value > max && !entry.max.compare_exchange_weak(
+                              max, value, std::memory_order_relaxed)) {
+    }
+}
+
+void CallStats::Reset() {
+    int count = callCount.load();
+    for (int i = 0; i < count; ++i) {
+        CallEntry &entry = entries[i];
+        entry.count.store(0);
+        entry.errors.store(0);
+        entry.sum.store(0);
+        entry.max.store(0);
+        for (std::atomic<quint64> &bucket : entry.buckets) {
+            bucket.store(0);
+        }
+    }
+}
+
+// 直方图中第 rank 个（从1计）样本所在桶的中点，μs
+static double BucketValue(const quint64 *buckets, quint64 rank,
+                          quint64 max) {
+    quint64 seen = 0;
+    for (int b = 0; b < bucketCount; ++b) {
+        seen += buckets[b];
+        if (seen >= rank) {
+            quint64 upper;
+            quint64 lower = BucketLower(b, &upper);
+            return qMin<double>((lower + upper) / 2.0, max) / 1000;
+        }
+    }
+    return max / 1000.0;
+}
+
+// 复制编号 id 的各桶并统计，没有调用记录时返回 false。
+// 计数以桶为准（记录中途读取时各字段可能差一次）
+static bool Summarize(int id, quint64 *buckets, CallSummary &summary) {
+    const CallEntry &entry = entries[id];
+    quint64 total = 0;
+    for (int b = 0; b < bucketCount; ++b) {
+        buckets[b] = entry.buckets[b].load(std::memory_order_relaxed);
+        total += buckets[b];
+    }
+    if (total == 0) {
+        return false;
+    }
+    quint64 max = entry.max.load(std::memory_order_relaxed);
+    summary.name = QString::fromUtf8(names[id]);
+    summary.count = total;
+    summary.errors = entry.errors.load(std::memory_order_relaxed);
+    summary.total = entry.sum.load(std::memory_order_relaxed) / 1e6;
+    summary.mean = summary.total * 1000 / total;
+    summary.p50 = BucketValue(buckets, (total * 50 + 99) / 100, max);
+    summary.p90 = BucketValue(buckets, (total * 90 + 99) / 100, max);
+    summary.p99 = BucketValue(buckets, (total * 99 + 99) / 100, max);
+    summary.p999 = BucketValue(buckets, (total * 999 + 999) / 1000, max);
+    summary.max = max / 1000.0;
+    return true;
+}
+
+QVector<CallSummary> CallStats::Summaries() {
+    QVector<CallSummary> summaries;
+    quint64 buckets[bucketCount];
+    int count = callCount.load();
+    for (int i = 0; i < count; ++i) {
+        CallSummary summary;
+        if (Summarize(i, buckets, summary)) {
+            summaries.append(summary);
+        }
+    }
+    std::sort(summaries.begin(), summaries.end(),
+              [](const CallSummary &a, const CallSummary &b) {
+                  return a.total > b.total;
+              });
+    return summaries;
+}
+
+QByteArray CallStats::ToJson() {
+    QJsonArray calls;
+    quint64 buckets[bucketCount];
+    int count = callCount.load();
+    for (int i = 0; i < count; ++i) {
+        CallSummary summary;
+        if (!Summarize(i, buckets, summary)) {
+            continue;
+        }
+        QJsonObject call;
+        call["name"] = summary.name;
+        call["count"] = (double)summary.count;
+        call["errors"] = (double)summary.errors;
+        call["meanUs"] = summary.mean;
+        call["p50Us"] = summary.p50;
+        call["p90Us"] = summary.p90;
+        call["p99Us"] = summary.p99;
+        call["p999Us"] = summary.p999;
+        call["maxUs"] = summary.max;
+        call["totalMs"] = summary.total;
+        // 非空桶，供离线合并或重新计算分位数
+        QJsonArray nonEmpty;
+        for (int b = 0; b < bucketCount; ++b) {
+            if (buckets[b] > 0) {
+                nonEmpty.append(
+                    QJsonArray{(double)BucketLower(b), (double)buckets[b]});
+            }
+        }
+        call["buckets"] = nonEmpty;
+        calls.append(call);
+    }
+    QJsonObject root;
+    root["enabled"] = IsEnabled();
+    root["calls"] = calls;
+    return QJsonDocument(root).toJson();
+}
+
+bool CallStats::SaveJson(const QString &fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    QByteArray json = ToJson();
+    return file.write(json) == json.size();
+}
@@ -0,0 +1,449 @@
+﻿#include <QImage>
+#include <QPointF>
+#include <QtMath>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "coverage.h"
+
+// 分块边长（网格数），每个线程每次处理一块
+constexpr int tileSize = 64;
+// 网格数上限，超过时认为网格边长设置过小
+constexpr int maxCells = 20000000;
+// 相邻打磨段切线夹角超过此值（°）视为新的一遍
+constexpr double passAngle = 45;
+// 沿工具Z轴分量超过此比例的移动视为抬刀或切入
+constexpr double liftRatio = 0.7;
+
+CoverageParams::CoverageParams()
+    : cellSize(1), depth(0.5), target(99.5), maxOffsetCount(50) {}
+
+CoverageMap::CoverageMap()
+    : cellSize(1), width(0), height(0), regionCells(0), coveredCells(0),
+      maxPasses(0), coverage(0) {}
+
+static QVector3D ToolZ(const QVector3D &rot) {
+    QMatrix3x3 R = Point::toRotationMatrix(rot);
+    return QVector3D(R(0, 2), R(1, 2), R(2, 2));
+}
+
+// 由打磨侧位姿和运动方向求接触区：工具Z轴绕（法向×运动方向）倾斜，
+// 去掉工具Z轴在运动方向上的分量即为表面法向。接触点为打磨片边缘最低点，
+// 压入 depth 后的接触区为弓形，沿 forward（接触点指向打磨片中心）展开
+static bool MakePatch(const QVector3D &pos, const QVector3D &toolZ,
+                      const QVector3D &tangent, double radius, double depth,
+                      const CoverageMap &map, ContactPatch &patch) {
+    QVector3D normal =
+        toolZ - tangent * QVector3D::dotProduct(tangent, toolZ);
+    if (normal.length() < 1e-3) {
+        return false;
+    }
+    normal.normalize();
+    float cosTilt = QVector3D::dotProduct(normal, toolZ);
+    QVector3D gridNormal = QVector3D::crossProduct(map.xAxis, map.yAxis);
+    float facing = QVector3D::dotProduct(normal, gridNormal);
+    // 打磨片过于倾斜或表面相对网格过陡（约78°）时不计
+    if (cosTilt < 0.1f || qAbs(facing) < 0.2f) {
+        return false;
+    }
+    // 打磨片平面内最靠近工件的方向，不倾斜时取运动方向
+    QVector3D down = normal - toolZ * cosTilt;
+    float sinTilt = down.length();
+    if (sinTilt < 1e-4f) {
+        down = tangent - toolZ * QVector3D::dotProduct(tangent, toolZ);
+        if (down.length() < 1e-3) {
+            return false;
+        }
+    }
+    down.normalize();
+    double reach = 2 * radius;
+    if (sinTilt > 1e-6f) {
+        reach = qMin(reach, depth / sinTilt);
+    }
+    QVector3D contact = pos + down * radius;
+    QVector3D forward =
+        -(down - normal * QVector3D::dotProduct(normal, down)).normalized();
+    QVector3D side = QVector3D::crossProduct(toolZ, down).normalized();
+    patch.cosTilt = cosTilt;
+    patch.length = reach * cosTilt;
+
+    // 网格点沿网格法向投影到切平面：offset·F 即切平面上沿 forward 的坐标
+    QVector3D F =
+        forward - gridNormal * (QVector3D::dotProduct(forward, gridNormal) /
+                                facing);
+    QVector3D S =
+        side - gridNormal * (QVector3D::dotProduct(side, gridNormal) / facing);
+    double cell = map.cellSize;
+    QVector3D base =
+        map.origin + (map.xAxis + map.yAxis) * (0.5 * cell) - contact;
+    patch.along0 = QVector3D::dotProduct(base, F);
+    patch.alongX = QVector3D::dotProduct(map.xAxis, F) * cell;
+    patch.alongY = QVector3D::dotProduct(map.yAxis, F) * cell;
+    patch.across0 = QVector3D::dotProduct(base, S);
+    patch.acrossX = QVector3D::dotProduct(map.xAxis, S) * cell;
+    patch.acrossY = QVector3D::dotProduct(map.yAxis, S) * cell;
+
+    // 接触区外接矩形沿网格法向投影到网格上
+    double x0 = map.width, x1 = -1, y0 = map.height, y1 = -1;
+    for (int a = 0; a < 2; ++a) {
+        for (int b = -1; b <= 1; b += 2) {
+            QVector3D corner = contact + forward * (a * patch.length) +
+                               side * (b * radius) - map.origin;
+            double x = QVector3D::dotProduct(corner, map.xAxis) / cell;
+            double y = QVector3D::dotProduct(corner, map.yAxis) / cell;
+            x0 = qMin(x0, x);
+            x1 = qMax(x1, x);
+            y0 = qMin(y0, y);
+            y1 = qMax(y1, y);
+        }
+    }
+    patch.minX = qMax(0, qFloor(x0));
+    patch.maxX = qMin(map.width - 1, qFloor(x1));
+    patch.minY = qMax(0, qFloor(y0));
+    patch.maxY = qMin(map.height - 1, qFloor(y1));
+    return patch.minX <= patch.maxX && patch.minY <= patch.maxY;
+}
+
+// 点是否在多边形内（射线法）
+static bool IsInPolygon(const QVector<QPointF> &polygon, double x, double y) {
+    bool isInside = false;
+    for (int i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        const QPointF &a = polygon.at(i);
+        const QPointF &b = polygon.at(j);
+        if ((a.y() > y) != (b.y() > y) &&
+            x < (b.x() - a.x()) * (y - a.y()) / (b.y() - a.y()) + a.x()) {
+            isInside = !isInside;
+        }
+    }
+    return isInside;
+}
+
+bool CoverageAnalyzer::InitMap(const QVector<QVector3D> &corners,
+                               double discRadius, double cellSize,
+                               CoverageMap &map) {
+    if (corners.size() != 4 || discRadius <= 0) {
+        return false;
+    }
+    const QVector3D &A = corners.at(0);
+    QVector3D xAxis = (corners.at(1) - A).normalized();
+    QVector3D yAxis =
+        corners.at(3) - A -
+        xAxis * QVector3D::dotProduct(xAxis, corners.at(3) - A);
+    if (xAxis.isNull() || yAxis.length() < 1e-3) {
+        return false;
+    }
+    yAxis.normalize();
+    QVector<QPointF> polygon;
+    double minX = 0, maxX = 0, minY = 0, maxY = 0;
+    for (const QVector3D &corner : corners) {
+        QPointF point(QVector3D::dotProduct(corner - A, xAxis),
+                      QVector3D::dotProduct(corner - A, yAxis));
+        polygon.append(point);
+        minX = qMin(minX, point.x());
+        maxX = qMax(maxX, point.x());
+        minY = qMin(minY, point.y());
+        maxY = qMax(maxY, point.y());
+    }
+    double cell = qMax(0.1, cellSize);
+    minX -= discRadius;
+    minY -= discRadius;
+    int width = qCeil((maxX + discRadius - minX) / cell);
+    int height = qCeil((maxY + discRadius - minY) / cell);
+    if ((qint64)width * height > maxCells) {
+        return false;
+    }
+    for (QPointF &point : polygon) {
+        point -= QPointF(minX, minY);
+    }
+    map = CoverageMap();
+    map.origin = A + xAxis * minX + yAxis * minY;
+    map.xAxis = xAxis;
+    map.yAxis = yAxis;
+    map.cellSize = cell;
+    map.width = width;
+    map.height = height;
+    map.passes.fill(0, width * height);
+    map.mask.fill(0, width * height);
+    for (int j = 0; j < height; ++j) {
+        for (int i = 0; i < width; ++i) {
+            if (IsInPolygon(polygon, (i + 0.5) * cell, (j + 0.5) * cell)) {
+                map.mask[j * width + i] = 1;
+                ++map.regionCells;
+            }
+        }
+    }
+    return true;
+}
+
+QVector<ContactPatch>
+CoverageAnalyzer::SamplePath(const QVector<PathSegment> &path,
+                             const CoverageMap &map, double discRadius,
+                             double depth) {
+    QVector<ContactPatch> patches;
+    // 打磨段是否贴着工件：沿工具Z轴的移动（抬刀、切入）累计为高度，
+    // 其余移动视为平行于工件，打磨阶段的最低高度即接触高度
+    QVector<double> heights(path.size(), 0);
+    double contactHeight = 0;
+    bool hasContact = false;
+    for (int i = 1; i < path.size(); ++i) {
+        const PathSegment &segment = path.at(i);
+        const Point &start = path.at(i - 1).endPoint;
+        QVector3D axis =
+            (ToolZ(start.rot) + ToolZ(segment.endPoint.rot)).normalized();
+        QVector3D offset = segment.endPoint.pos - start.pos;
+        double lift = -QVector3D::dotProduct(offset, axis);
+        heights[i] = heights.at(i - 1) +
+                     (qAbs(lift) > liftRatio * offset.length() ? lift : 0);
+        if (segment.phase != PathPhase::PolishPhase) {
+            continue;
+        }
+        if (!hasContact || heights.at(i) < contactHeight) {
+            contactHeight = heights.at(i);
+            hasContact = true;
+        }
+    }
+    double tolerance = qMax(1.0, 2 * depth);
+
+    // 每段按不超过半个网格等分，在各等分中点采样，停留时间为等分长度除以段速度
+    double step = map.cellSize / 2;
+    int pass = -1;
+    bool isPrevContact = false;
+    QVector3D prevTangent;
+    for (int i = 1; i < path.size(); ++i) {
+        const PathSegment &segment = path.at(i);
+        const Point &start = path.at(i - 1).endPoint;
+        bool isContact = segment.phase == PathPhase::PolishPhase &&
+                         heights.at(i - 1) <= contactHeight + tolerance &&
+                         heights.at(i) <= contactHeight + tolerance;
+        double radius = 0;
+        double length = PathPlanner::SegmentLength(start, segment, &radius);
+        if (!isContact || length < 1e-3 || segment.velocity <= 0) {
+            isPrevContact = isContact && isPrevContact;
+            continue;
+        }
+        QVector3D startTangent = PathPlanner::StartTangent(start, segment);
+        if (!isPrevContact ||
+            QVector3D::dotProduct(prevTangent, startTangent) <
+                qCos(qDegreesToRadians(passAngle))) {
+            ++pass;
+        }
+        isPrevContact = true;
+        prevTangent = PathPlanner::EndTangent(start, segment);
+
+        QVector3D startZ = ToolZ(start.rot);
+        QVector3D endZ = ToolZ(segment.endPoint.rot);
+        int count = qMax(1, qCeil(length / step));
+        float dwell = length / count / segment.velocity;
+        // 圆弧按圆心角参数化，姿态在起点->中间点->终点之间插值
+        QVector3D center, e1, e2, auxZ;
+        double midAngle = 0, endAngle = 0;
+        bool isArc = segment.isArc && radius > 0;
+        if (isArc) {
+            const QVector3D &B = segment.auxPoint.pos;
+            const QVector3D &C = segment.endPoint.pos;
+            center = Point::calculateCircumcenter(start.pos, B, C);
+            QVector3D axis =
+                QVector3D::crossProduct(B - start.pos, C - B).normalized();
+            e1 = (start.pos - center).normalized();
+            e2 = QVector3D::crossProduct(axis, e1);
+            auto angleOf = [&](const QVector3D &X) {
+                double angle = qAtan2(QVector3D::dotProduct(X - center, e2),
+                                      QVector3D::dotProduct(X - center, e1));
+                return angle < 0 ? angle + 2 * M_PI : angle;
+            };
+            midAngle = angleOf(B);
+            endAngle = angleOf(C);
+            auxZ = ToolZ(segment.auxPoint.rot);
+        }
+        for (int k = 0; k < count; ++k) {
+            double t = (k + 0.5) / count;
+            QVector3D pos, toolZ, tangent;
+            if (isArc) {
+                double angle = endAngle * t;
+                pos = center + (e1 * qCos(angle) + e2 * qSin(angle)) * radius;
+                tangent = e2 * qCos(angle) - e1 * qSin(angle);
+                toolZ = angle <= midAngle
+                            ? startZ + (auxZ - startZ) * (angle / midAngle)
+                            : auxZ + (endZ - auxZ) * ((angle - midAngle) /
+                                                      (endAngle - midAngle));
+            } else {
+                pos = start.pos + (segment.endPoint.pos - start.pos) * t;
+                tangent = (segment.endPoint.pos - start.pos) / length;
+                toolZ = startZ + (endZ - startZ) * t;
+            }
+            ContactPatch patch;
+            if (MakePatch(pos, toolZ.normalized(), tangent, discRadius, depth,
+                          map, patch)) {
+                patch.dwell = dwell;
+                patch.pass = pass;
+                patches.append(patch);
+            }
+        }
+    }
+    return patches;
+}
+
+void CoverageAnalyzer::ForEachTile(
+    const CoverageMap &map, const QVector<ContactPatch> &patches,
+    const std::function<void(int, int, int, int, const std::vector<int> &)>
+        &func) {
+    int tilesX = (map.width + tileSize - 1) / tileSize;
+    int tilesY = (map.height + tileSize - 1) / tileSize;
+    std::vector<std::vector<int>> tiles(tilesX * tilesY);
+    for (int p = 0; p < patches.size(); ++p) {
+        const ContactPatch &patch = patches.at(p);
+        for (int ty = patch.minY / tileSize; ty <= patch.maxY / tileSize;
+             ++ty) {
+            for (int tx = patch.minX / tileSize; tx <= patch.maxX / tileSize;
+                 ++tx) {
+                tiles[ty * tilesX + tx].push_back(p);
+            }
+        }
+    }
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        int index;
+        while ((index = next.fetch_add(1)) < (int)tiles.size()) {
+            int left = index % tilesX * tileSize;
+            int bottom = index / tilesX * tileSize;
+            func(left, bottom, qMin(map.width, left + tileSize) - 1,
+                 qMin(map.height, bottom + tileSize) - 1, tiles.at(index));
+        }
+    };
+    int threadCount = qBound(1, (int)std::thread::hardware_concurrency(),
+                             (int)tiles.size());
+    std::vector<std::thread> threads;
+    for (int t = 1; t < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+bool CoverageAnalyzer::Analyze(const QVector<PathSegment> &path,
+                               const QVector<QVector3D> &corners,
+                               double discRadius, const CoverageParams &params,
+                               CoverageMap &map) {
+    if (path.size() < 2 ||
+        !InitMap(corners, discRadius, params.cellSize, map)) {
+        return false;
+    }
+    QVector<ContactPatch> patches =
+        SamplePath(path, map, discRadius, params.depth);
+    int width = map.width;
+    int height = map.height;
+    quint16 *output = map.passes.data();
+    ForEachTile(map, patches, [&](int left, int bottom, int right, int top,
+                                  const std::vector<int> &indices) {
+        // 每格最近一次计入的遍数编号，同一遍的相邻采样只计一次
+        std::vector<int> lastPass(tileSize * tileSize, -1);
+        for (int p : indices) {
+            const ContactPatch &patch = patches.at(p);
+            for (int j = qMax(bottom, patch.minY); j <= qMin(top, patch.maxY);
+                 ++j) {
+                for (int i = qMax(left, patch.minX);
+                     i <= qMin(right, patch.maxX); ++i) {
+                    int &last = lastPass[(j - bottom) * tileSize + (i - left)];
+                    if (last == patch.pass) {
+                        continue;
+                    }
+                    float along =
+                        patch.along0 + patch.alongX * i + patch.alongY * j;
+                    float across =
+                        patch.across0 + patch.acrossX * i + patch.acrossY * j;
+                    // 换算回打磨片平面内到边缘的距离，与弦半宽比较
+                    float rim = along / patch.cosTilt;
+                    if (along >= 0 && along <= patch.length &&
+                        across * across <= rim * (2 * discRadius - rim)) {
+                        last = patch.pass;
+                        quint16 &value = output[j * width + i];
+                        value = qMin(value + 1, 0xFFFF);
+                    }
+                }
+            }
+        }
+    });
+
+    // 统计覆盖率和未覆盖区域
+    for (int c = 0; c < map.passes.size(); ++c) {
+        if (map.mask.at(c) && map.passes.at(c) > 0) {
+            ++map.coveredCells;
+            map.maxPasses = qMax(map.maxPasses, (int)map.passes.at(c));
+        }
+    }
+    map.coverage =
+        map.regionCells > 0 ? 100.0 * map.coveredCells / map.regionCells : 0;
+    QVector<quint8> visited(map.passes.size(), 0);
+    QVector<int> queue;
+    for (int c = 0; c < map.passes.size(); ++c) {
+        if (!map.mask.at(c) || map.passes.at(c) > 0 || visited.at(c)) {
+            continue;
+        }
+        queue.clear();
+        queue.append(c);
+        visited[c] = 1;
+        double sumX = 0, sumY = 0;
+        for (int q = 0; q < queue.size(); ++q) {
+            int i = queue.at(q) % width;
+            int j = queue.at(q) / width;
+            sumX += i + 0.5;
+            sumY += j + 0.5;
+            const int neighbors[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+            for (const auto &d : neighbors) {
+                int ni = i + d[0];
+                int nj = j + d[1];
+                if (ni < 0 || nj < 0 || ni >= width || nj >= height) {
+                    continue;
+                }
+                int n = nj * width + ni;
+                if (map.mask.at(n) && map.passes.at(n) == 0 && !visited.at(n)) {
+                    visited[n] = 1;
+                    queue.append(n);
+                }
+            }
+        }
+        CoverageGap gap;
+        gap.cells = queue.size();
+        gap.area = gap.cells * map.cellSize * map.cellSize;
+        gap.center = map.origin +
+                     map.xAxis * (sumX / gap.cells * map.cellSize) +
+                     map.yAxis * (sumY / gap.cells * map.cellSize);
+        map.gaps.append(gap);
+    }
+    std::sort(map.gaps.begin(), map.gaps.end(),
+              [](const CoverageGap &a, const CoverageGap &b) {
+                  return a.cells > b.cells;
+              });
+    return true;
+}
+
+bool CoverageAnalyzer::SaveHeatmap(const CoverageMap &map,
+                                   const QString &fileName) {
+    if (map.width <= 0 || map.height <= 0) {
+        return false;
+    }
+    QImage image(map.width, map.height, QImage::Format_RGB32);
+    for (int j = 0; j < map.height; ++j) {
+        // 图像 y 向下，网格 y 向上
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(map.height - 1 - j));
+        for (int i = 0; i < map.width; ++i) {
+            int index = j * map.width + i;
+            int passes = map.passes.at(index);
+            if (!map.mask.at(index)) {
+                line[i] = passes > 0 ? qRgb(150, 150, 150) : qRgb(90, 90, 90);
+            } else if (passes == 0) {
+                line[i] = qRgb(220, 40, 40);
+            } else {
+                double t = map.maxPasses > 1
+                               ? (double)(passes - 1) / (map.maxPasses - 1)
+                               : 0;
+                line[i] = qRgb(qRound(200 - 180 * t), qRound(235 - 155 * t),
+                               qRound(200 - 40 * t));
+            }
+        }
+    }
+    return image.save(fileName, "PNG");
+}
@@ -0,0 +1,374 @@
+﻿#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QSettings>
+#include <QTextStream>
+#include <QUrl>
+
+#include "craftstore.h"
+
+const QString indexFileName = "index.log";
+
+CraftStore::CraftStore() : count(0), nextKey(1), garbageCount(0) {}
+
+bool CraftStore::Open(const QString &dirPath) {
+    dir = dirPath;
+    keys.clear();
+    names.clear();
+    cache.clear();
+    count = 0;
+    nextKey = 1;
+    garbageCount = 0;
+    if (!QDir().mkpath(dir)) {
+        return false;
+    }
+    QFile file(dir + "/" + indexFileName);
+    if (!file.exists()) {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    // 回放索引日志，删除先留空位，回放结束后一次压实
+    QHash<int, int> slots; // 文件编号 -> keys 中的位置
+    int lineCount = 0;
+    qint64 validSize = 0; // 最后一条完整记录的结尾
+    bool isTorn = false;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        if (!line.endsWith('\n')) {
+            isTorn = true;
+            break;
+        }
+        validSize = file.pos();
+        line.chop(1);
+        if (line.size() < 2) {
+            continue;
+        }
+        ++lineCount;
+        char op = line.at(0);
+        int sep = line.indexOf('\t');
+        bool ok = false;
+        int key = line.mid(1, sep < 0 ? -1 : sep - 1).toInt(&ok);
+        if (!ok) {
+            continue;
+        }
+        QString name =
+            sep < 0 ? QString() : QUrl::fromPercentEncoding(line.mid(sep + 1));
+        switch (op) {
+        case '+':
+            if (!names.contains(key)) {
+                slots.insert(key, keys.size());
+                keys.append(key);
+            }
+            names[key] = name;
+            break;
+        case '=':
+            if (names.contains(key)) {
+                names[key] = name;
+            }
+            break;
+        case '-':
+            if (names.remove(key) > 0) {
+                keys[slots.take(key)] = 0;
+            }
+            break;
+        default:
+            break;
+        }
+        nextKey = qMax(nextKey, key + 1);
+    }
+    file.close();
+    // 末尾不完整的记录（写入中断）截掉，否则之后追加的记录会与之粘连
+    if (isTorn && !file.resize(validSize)) {
+        return false;
+    }
+    keys.removeAll(0);
+    count = keys.size();
+    garbageCount = lineCount - count;
+    // 失效记录过多时压缩索引
+    if (garbageCount > keys.size() + 64) {
+        CompactIndex();
+    }
+    return true;
+}
+
+bool CraftStore::Import(const QString &iniFileName) {
+    if (!QFile::exists(iniFileName)) {
+        return false;
+    }
+    QSettings settings(iniFileName, QSettings::IniFormat);
+    int size = settings.beginReadArray("CraftParameter");
+    for (int i = 0; i < size; ++i) {
+        settings.setArrayIndex(i);
+        QMap<QString, QString> map;
+        for (const QString &name : settings.childKeys()) {
+            map.insert(name, settings.value(name).toString());
+        }
+        if (Append(FromMap(map)) < 0) {
+            settings.endArray();
+            return false;
+        }
+    }
+    settings.endArray();
+    return size > 0;
+}
+
+int CraftStore::Size() const { return count; }
+
+int CraftStore::Capacity() const { return keys.size(); }
+
+bool CraftStore::IsValid(int index) const {
+    return index >= 0 && index < keys.size() && keys.at(index) != 0;
+}
+
+int CraftStore::First() const {
+    for (int i = 0; i < keys.size(); ++i) {
+        if (keys.at(i) != 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+QString CraftStore::Name(int index) const {
+    return IsValid(index) ? names.value(keys.at(index)) : QString();
+}
+
+const Craft &CraftStore::At(int index) { return (*this)[index]; }
+
+Craft &CraftStore::operator[](int index) {
+    if (!IsValid(index)) {
+        // 每次重置，调用方对占位工艺的修改不会带到下一次
+        invalidCraft = DefaultCraft();
+        invalidCraft.craftID.clear();
+        return invalidCraft;
+    }
+    int key = keys.at(index);
+    if (cache.find(key) == cache.end() && !Load(key)) {
+        // 工艺文件丢失时以默认参数代替，保存后即恢复
+        Craft craft = DefaultCraft();
+        craft.craftID = names.value(key);
+        cache.emplace(key, craft);
+    }
+    return cache.at(key);
+}
+
+bool CraftStore::Save(int index) {
+    if (!IsValid(index)) {
+        return false;
+    }
+    int key = keys.at(index);
+    const Craft &craft = At(index);
+    if (!WriteCraft(key, craft)) {
+        return false;
+    }
+    if (names.value(key) != craft.craftID) {
+        if (!AppendIndex(QString("=%1\t").arg(key) +
+                         QUrl::toPercentEncoding(craft.craftID))) {
+            return false;
+        }
+        names[key] = craft.craftID;
+        ++garbageCount;
+    }
+    return true;
+}
+
+int CraftStore::Append(const Craft &craft) {
+    int key = nextKey;
+    // 先写工艺文件再写索引，中断时最多留下一个无索引的孤立文件
+    if (!WriteCraft(key, craft)) {
+        return -1;
+    }
+    if (!AppendIndex(QString("+%1\t").arg(key) +
+                     QUrl::toPercentEncoding(craft.craftID))) {
+        QFile::remove(CraftFileName(key));
+        return -1;
+    }
+    ++nextKey;
+    keys.append(key);
+    ++count;
+    names[key] = craft.craftID;
+    cache[key] = craft;
+    return keys.size() - 1;
+}
+
+bool CraftStore::Remove(int index) {
+    if (!IsValid(index)) {
+        return false;
+    }
+    int key = keys.at(index);
+    if (!AppendIndex(QString("-%1").arg(key))) {
+        return false;
+    }
+    QFile::remove(CraftFileName(key));
+    keys[index] = 0;
+    --count;
+    names.remove(key);
+    cache.erase(key);
+    garbageCount += 2;
+    return true;
+}
+
+Craft CraftStore::DefaultCraft() {
+    Craft craft;
+    craft.craftID = "一";
+    craft.mode = PolishMode::MomentMode;
+    craft.way = PolishWay::ArcWay;
+    craft.teachPointReferPos = 7;
+    craft.cutinSpeed = 20;
+    craft.moveSpeed = 80;
+    craft.rotateSpeed = 4500;
+    craft.contactForce = 10;
+    craft.settingForce = 80;
+    craft.transitionTime = 1500;
+    craft.transitionRadius = 0;
+    craft.discRadius = 50;
+    craft.discThickness = 8;
+    craft.grindAngle = 0;
+    craft.offsetCount = 0;
+    craft.addOffsetCount = 0;
+    craft.raiseCount = 0;
+    craft.floatCount = 0;
+    craft.overlapRatio = 30;
+    craft.isMirror = false;
+    return craft;
+}
+
+QMap<QString, QString> CraftStore::ToMap(const Craft &craft) {
+    QMap<QString, QString> map;
+    map.insert("CraftName", craft.craftID);
+    map.insert("PolishMode", QString::number(craft.mode));
+    map.insert("PolishWay", QString::number(craft.way));
+    map.insert("TeachingPointReferencePosition",
+               QString::number(craft.teachPointReferPos));
+    map.insert("CutinSpeed", QString::number(craft.cutinSpeed));
+    map.insert("MovingSpeed", QString::number(craft.moveSpeed));
+    map.insert("RotationSpeed", QString::number(craft.rotateSpeed));
+    map.insert("ContactForce", QString::number(craft.contactForce));
+    map.insert("SettingForce", QString::number(craft.settingForce));
+    map.insert("TransitionTime", QString::number(craft.transitionTime));
+    map.insert("TransitionRadius", QString::number(craft.transitionRadius));
+    map.insert("DiscRadius", QString::number(craft.discRadius));
+    map.insert("DiscThickness", QString::number(craft.discThickness));
+    map.insert("GrindAngle", QString::number(craft.grindAngle));
+    map.insert("OffsetCount", QString::number(craft.offsetCount));
+    map.insert("AddOffsetCount", QString::number(craft.addOffsetCount));
+    map.insert("RaiseCount", QString::number(craft.raiseCount));
+    map.insert("FloatCount", QString::number(craft.floatCount));
+    map.insert("OverlapRatio", QString::number(craft.overlapRatio));
+    map.insert("IsMirror", craft.isMirror ? "true" : "false");
+    return map;
+}
+
+Craft CraftStore::FromMap(const QMap<QString, QString> &map) {
+    // 缺失的键保留默认值，兼容新增字段
+    Craft craft = DefaultCraft();
+    auto readInt = [&map](const QString &name, int &value) {
+        bool ok = false;
+        int v = map.value(name).toInt(&ok);
+        if (ok) {
+            value = v;
+        }
+    };
+    if (map.contains("CraftName")) {
+        craft.craftID = map.value("CraftName");
+    }
+    int mode = craft.mode;
+    readInt("PolishMode", mode);
+    craft.mode = (PolishMode)mode;
+    int way = craft.way;
+    readInt("PolishWay", way);
+    craft.way = (PolishWay)way;
+    readInt("TeachingPointReferencePosition", craft.teachPointReferPos);
+    readInt("CutinSpeed", craft.cutinSpeed);
+    readInt("MovingSpeed", craft.moveSpeed);
+    readInt("RotationSpeed", craft.rotateSpeed);
+    readInt("ContactForce", craft.contactForce);
+    readInt("SettingForce", craft.settingForce);
+    readInt("TransitionTime", craft.transitionTime);
+    readInt("TransitionRadius", craft.transitionRadius);
+    readInt("DiscRadius", craft.discRadius);
+    readInt("DiscThickness", craft.discThickness);
+    readInt("GrindAngle", craft.grindAngle);
+    readInt("OffsetCount", craft.offsetCount);
+    readInt("AddOffsetCount", craft.addOffsetCount);
+    readInt("RaiseCount", craft.raiseCount);
+    readInt("FloatCount", craft.floatCount);
+    readInt("OverlapRatio", craft.overlapRatio);
+    if (map.contains("IsMirror")) {
+        craft.isMirror = map.value("IsMirror") == "true";
+    }
+    return craft;
+}
+
+QString CraftStore::CraftFileName(int key) const {
+    return QString("%1/%2.ini").arg(dir).arg(key);
+}
+
+bool CraftStore::Load(int key) {
+    QFile file(CraftFileName(key));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+    QMap<QString, QString> map;
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        int sep = line.indexOf('=');
+        if (sep > 0) {
+            map.insert(line.left(sep).trimmed(), line.mid(sep + 1));
+        }
+    }
+    file.close();
+    cache[key] = FromMap(map);
+    return true;
+}
+
+bool CraftStore::WriteCraft(int key, const Craft &craft) {
+    // 写临时文件后原子替换，断电不会留下半份工艺
+    QSaveFile file(CraftFileName(key));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    const QMap<QString, QString> map = ToMap(craft);
+    for (auto it = map.cbegin(); it != map.cend(); ++it) {
+        out << it.key() << "=" << it.value() << "\n";
+    }
+    out.flush();
+    return file.commit();
+}
+
+bool CraftStore::AppendIndex(const QString &line) {
+    QFile file(dir + "/" + indexFileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+    QByteArray data = line.toUtf8() + '\n';
+    bool ok = file.write(data) == data.size() && file.flush();
+    file.close();
+    return ok;
+}
+
+bool CraftStore::CompactIndex() {
+    QSaveFile file(dir + "/" + indexFileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    for (int key : keys) {
+        if (key == 0) {
+            continue;
+        }
+        QByteArray line = QString("+%1\t").arg(key).toUtf8() +
+                          QUrl::toPercentEncoding(names.value(key)) + '\n';
+        file.write(line);
+    }
+    if (!file.commit()) {
+        return false;
+    }
+    garbageCount = 0;
+    return true;
+}
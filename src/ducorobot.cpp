@@ -0,0 +1,385 @@
+﻿#include <QDesktopServices>
+#include <QThread>
+#include <QUrl>
+#include <QtMath>
+#include <chrono>
+#include <thread>
+
+#include "callstats.h"
+#include "ducorobot.h"
+#include "robotplugin.h"
+
+// RPC 端口
+constexpr int ducoPort = 7003;
+// 控制器同时排队的非阻塞运动上限，超过时等待前面的任务完成
+constexpr int maxQueuedTasks = 16;
+// 伺服运动的关节速度上限，rad/s，及关节加速度上限，rad/s²
+constexpr double servoJointVelocity = 3.14;
+constexpr double servoJointAcc = 12.56;
+
+// 新松 SDK 调用计时。返回值含义因接口而异（任务 ID、任务状态、是否运动），
+// 不按返回值计错误，由调用点检查
+template <typename F>
+static auto DucoCall(int id, F &&func) -> decltype(func()) {
+    const bool isError = false;
+    CallTimer timer(id, &isError);
+    return func();
+}
+
+// 调用期间持有 rpcMutex：RPC 连接不能被运行线程和记录线程同时使用
+#define DUCO_CALL(method, ...)                                                 \
+    DucoCall(CALL_ID("DucoCobot::" #method), [&] {                             \
+        std::lock_guard<std::recursive_mutex> rpcLock(rpcMutex);               \
+        return ducoCobot->method(__VA_ARGS__);                                 \
+    })
+
+std::vector<double> DucoRobot::ToPose(const Point &point) {
+    return {point.pos.x() * 0.001,
+            point.pos.y() * 0.001,
+            point.pos.z() * 0.001,
+            qDegreesToRadians(point.rot.x()),
+            qDegreesToRadians(point.rot.y()),
+            qDegreesToRadians(point.rot.z())};
+}
+
+DucoRobot::DucoRobot() : ducoCobot(nullptr), isConnected(false) {
+    isSegmentTracked = true;
+}
+
+DucoRobot::~DucoRobot() {
+    if (ducoCobot != nullptr) {
+        if (isConnected) {
+            ducoCobot->end_teach_mode(true);
+            ducoCobot->close();
+        }
+        delete ducoCobot;
+        ducoCobot = nullptr;
+    }
+}
+
+bool DucoRobot::RobotConnect(QString robotIP) {
+    std::lock_guard<std::recursive_mutex> lock(rpcMutex);
+    std::string ip = robotIP.toStdString();
+    // 同一地址复用已打开的连接，换地址时重建
+    if (ducoCobot != nullptr && ip != connectedIP) {
+        if (isConnected) {
+            ducoCobot->close();
+        }
+        delete ducoCobot;
+        ducoCobot = nullptr;
+        isConnected = false;
+    }
+    if (ducoCobot == nullptr) {
+        ducoCobot = new DucoRPC::DucoCobot(ip, ducoPort);
+        connectedIP = ip;
+    }
+    if (!isConnected) {
+        if (DUCO_CALL(open) != 0) {
+            return false;
+        }
+        isConnected = true;
+    }
+    tasks.clear();
+    // 机器人上电
+    DUCO_CALL(power_on, true);
+    // 机器人使能
+    DUCO_CALL(enable, true);
+    // 设置速度比
+    DUCO_CALL(speed, 100);
+    return true;
+}
+
+bool DucoRobot::GetTcpPoint(Point &point) {
+    if (!isConnected) {
+        return false;
+    }
+    std::vector<double> data;
+    DUCO_CALL(get_tcp_pose, data);
+    if (data.size() < 6) {
+        return false;
+    }
+    point.pos.setX(data.at(0) * 1000);
+    point.pos.setY(data.at(1) * 1000);
+    point.pos.setZ(data.at(2) * 1000);
+    point.rot.setX(qRound(qRadiansToDegrees(data.at(3)) * 1000.0) / 1000.0);
+    point.rot.setY(qRound(qRadiansToDegrees(data.at(4)) * 1000.0) / 1000.0);
+    point.rot.setZ(qRound(qRadiansToDegrees(data.at(5)) * 1000.0) / 1000.0);
+    return true;
+}
+
+bool DucoRobot::RobotTeach(int pos) {
+    if (!isConnected) {
+        return false;
+    }
+    if (!isTeach) {
+        if (agp != nullptr) {
+            std::lock_guard<std::recursive_mutex> lock(agpMutex);
+            // 设置AGP默认参数
+            AGP_CALL(Control, FUNC::RESET);
+            AGP_CALL(Control, FUNC::ENABLE);
+            AGP_CALL(SetMode, MODE::PosMode);
+            AGP_CALL(SetPos, pos * 100);
+            AGP_CALL(SetForce, 200);
+            AGP_CALL(SetTouchForce, 0);
+            AGP_CALL(SetRampTime, 0);
+            if (!IsAGPEnabled()) {
+                AGP_CALL(Control, FUNC::ENABLE);
+            }
+        }
+        if (!IsRobotEnabled()) {
+            // 机器人使能
+            DUCO_CALL(enable, true);
+            if (!IsRobotEnabled()) {
+                return isTeach;
+            }
+        }
+        // 启用自由拖拽，阻塞调用返回任务结束时的状态
+        if (DUCO_CALL(teach_mode, true) == DucoRPC::TaskState::ST_Finished) {
+            isTeach = true;
+        }
+    } else {
+        // 关闭自由拖拽
+        if (DUCO_CALL(end_teach_mode, true) ==
+            DucoRPC::TaskState::ST_Finished) {
+            isTeach = false;
+        }
+    }
+    return isTeach;
+}
+
+bool DucoRobot::CloseFreeDriver() {
+    if (!isConnected) {
+        return false;
+    }
+    // 关闭自由拖拽
+    if (DUCO_CALL(end_teach_mode, true) == DucoRPC::TaskState::ST_Finished) {
+        isTeach = false;
+        return true;
+    }
+    return false;
+}
+
+bool DucoRobot::Stop() {
+    // 机器人停止
+    isStop.store(true);
+    RunMetrics::AddStop();
+    if (isConnected) {
+        DUCO_CALL(stop, true);
+    }
+    {
+        // 已下发的任务随停止一并取消
+        std::lock_guard<std::recursive_mutex> lock(rpcMutex);
+        tasks.clear();
+    }
+    // AGP停止
+    std::lock_guard<std::recursive_mutex> lock(agpMutex);
+    if (agp != nullptr) {
+        AGP_CALL(SetSpeed, 0);
+    }
+    // AGP复位
+    if (agp != nullptr) {
+        AGP_CALL(Control, FUNC::RESET);
+    }
+    // 自由拖拽复位
+    isTeach = false;
+
+    return true;
+}
+
+bool DucoRobot::AbortMotion() {
+    if (!isConnected) {
+        return false;
+    }
+    bool isStopped = DUCO_CALL(stop, true) == DucoRPC::TaskState::ST_Finished;
+    // 已下发的任务随中止一并取消
+    std::lock_guard<std::recursive_mutex> lock(rpcMutex);
+    tasks.clear();
+    return isStopped;
+}
+
+bool DucoRobot::IsRobotElectrified() {
+    if (!isConnected) {
+        return false;
+    }
+    std::vector<int8_t> state;
+    DUCO_CALL(get_robot_state, state);
+    return !state.empty() && state.at(0) >= DucoRPC::StateRobot::SR_Disable;
+}
+
+bool DucoRobot::IsRobotEnabled() {
+    if (!isConnected) {
+        return false;
+    }
+    std::vector<int8_t> state;
+    DUCO_CALL(get_robot_state, state);
+    return !state.empty() && state.at(0) == DucoRPC::StateRobot::SR_Enable;
+}
+
+bool DucoRobot::IsRobotMoved() {
+    if (!isConnected) {
+        return false;
+    }
+    // 队列中有未完成的任务即在运动，队列为空时再查询控制器
+    if (UpdateTasks()) {
+        return true;
+    }
+    return DUCO_CALL(robotmoving);
+}
+
+void DucoRobot::OpenWeb(QString ip) {
+    QDesktopServices::openUrl(QUrl("http://" + ip + ":7000"));
+}
+
+void DucoRobot::MoveTcpL(const Point &point, double dVelocity, double dAcc,
+                         double dRadius) {
+    if (!isConnected || !WaitQueue()) {
+        return;
+    }
+    // 定义运动速度，m/s
+    double v = dVelocity * 0.001;
+    // 定义运动加速度，m/s²
+    double a = dAcc > 0 ? dAcc * 0.001 : 2;
+    // 定义过渡半径，m
+    double r = dRadius * 0.001;
+    // 不指定参考关节位置
+    std::vector<double> qNear;
+    // 非阻塞下发，返回任务 ID
+    int32_t id = DUCO_CALL(movel, ToPose(point), v, a, r, qNear, "TCP_AGP",
+                           "default", false);
+    AddTask(id);
+}
+
+void DucoRobot::MoveTcpC(const Point &auxPoint, const Point &endPoint,
+                         double dVelocity, double dAcc, double dRadius) {
+    if (!isConnected || !WaitQueue()) {
+        return;
+    }
+    double v = dVelocity * 0.001;
+    double a = dAcc > 0 ? dAcc * 0.001 : 2;
+    double r = dRadius * 0.001;
+    // 姿态随圆弧变化
+    int mode = 1;
+    std::vector<double> qNear;
+    int32_t id = DUCO_CALL(movec, ToPose(auxPoint), ToPose(endPoint), v, a, r,
+                           mode, qNear, "TCP_AGP", "default", false);
+    AddTask(id);
+}
+
+bool DucoRobot::GetJointPos(double *joints) {
+    if (!isConnected) {
+        return false;
+    }
+    std::vector<double> data;
+    DUCO_CALL(get_actual_joints_position, data);
+    if (data.size() < 6) {
+        return false;
+    }
+    for (int i = 0; i < 6; ++i) {
+        joints[i] = qRadiansToDegrees(data.at(i));
+    }
+    return true;
+}
+
+int DucoRobot::GetCurrentSegment() {
+    std::lock_guard<std::recursive_mutex> lock(rpcMutex);
+    // 最早未完成的任务即正在执行的运动
+    if (isConnected && UpdateTasks()) {
+        return tasks.front().segment;
+    }
+    return Robot::GetCurrentSegment();
+}
+
+bool DucoRobot::SetSpeedOverride(double ratio) {
+    if (!isConnected) {
+        return false;
+    }
+    // 速度比范围 1~100，返回任务结束时的状态
+    return DUCO_CALL(speed, qBound(0.01, ratio, 1.0) * 100) ==
+           DucoRPC::TaskState::ST_Finished;
+}
+
+int DucoRobot::Capabilities() const {
+    // spline 单次最多 50 个点，长轨迹需分段且段间停顿，不作为整条上传使用
+    return ServoCapability;
+}
+
+bool DucoRobot::ServoTcpPath(const QVector<Point> &points, double period) {
+    if (!isConnected) {
+        return false;
+    }
+    // 伺服运动需从静止开始，等待之前的路点运动完成
+    while (IsRobotMoved()) {
+        if (isStop.load()) {
+            return true;
+        }
+        QThread::msleep(20);
+    }
+    using namespace std::chrono;
+    const steady_clock::duration step =
+        duration_cast<steady_clock::duration>(duration<double>(period));
+    steady_clock::time_point next = steady_clock::now();
+    std::vector<double> qNear;
+    for (int i = 0; i < points.size() && !isStop.load(); ++i) {
+        // 非阻塞下发，控制器跟随最新目标位姿，任务不入队
+        int32_t id = DUCO_CALL(servoj_pose, ToPose(points.at(i)),
+                               servoJointVelocity, servoJointAcc, qNear,
+                               "TCP_AGP", "default", false);
+        if (id < 0) {
+            // 首点失败时机器人未动，可改为逐点下发；中途失败则停止运行
+            if (i > 0) {
+                Stop();
+                return true;
+            }
+            return false;
+        }
+        next += step;
+        std::this_thread::sleep_until(next);
+    }
+    // 等待伺服运动完成，之后的路点才能下发
+    while (!isStop.load() && DUCO_CALL(robotmoving)) {
+        QThread::msleep(20);
+    }
+    return true;
+}
+
+bool DucoRobot::UpdateTasks() {
+    std::lock_guard<std::recursive_mutex> lock(rpcMutex);
+    // 任务按下发顺序执行，遇到未结束的任务即可停止查询
+    while (!tasks.empty()) {
+        int32_t state = DUCO_CALL(get_noneblock_taskstate, tasks.front().id);
+        if (state < DucoRPC::TaskState::ST_Stopped) {
+            break;
+        }
+        tasks.pop_front();
+    }
+    return !tasks.empty();
+}
+
+bool DucoRobot::WaitQueue() {
+    while (!isStop.load()) {
+        {
+            std::lock_guard<std::recursive_mutex> lock(rpcMutex);
+            if (static_cast<int>(tasks.size()) >= maxQueuedTasks) {
+                UpdateTasks();
+            }
+            if (static_cast<int>(tasks.size()) < maxQueuedTasks) {
+                return true;
+            }
+        }
+        // 等待时不持有锁，记录线程仍可读取位姿
+        QThread::msleep(10);
+    }
+    return false;
+}
+
+void DucoRobot::AddTask(int32_t id) {
+    // 下发失败时不入队，由控制器状态反映
+    if (id < 0) {
+        return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(rpcMutex);
+    tasks.push_back({id, segmentIndex.load()});
+}
+
+// 插件入口
+SWR_ROBOT_PLUGIN(DucoRobot)
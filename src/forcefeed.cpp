@@ -0,0 +1,74 @@
+﻿#include <QtGlobal>
+
+#include "forcefeed.h"
+
+ForceFeedParams::ForceFeedParams()
+    : isEnabled(false), targetForce(0), band(5), kp(0.02), ki(0.05),
+      maxRate(0.5), floor(0.3), ceiling(1.2), filterTime(0.05) {}
+
+ForceFeedController::ForceFeedController()
+    : target(0), filtered(0), integral(0), ratio(1), isStarted(false) {}
+
+void ForceFeedController::SetParams(const ForceFeedParams &params) {
+    this->params = params;
+    // 参数容错：上下限必须包含1，变化率和时间常数非负
+    this->params.floor = qBound(0.01, params.floor, 1.0);
+    this->params.ceiling = qMax(1.0, params.ceiling);
+    this->params.band = qMax(0.0, params.band);
+    this->params.maxRate = qMax(0.0, params.maxRate);
+    this->params.filterTime = qMax(0.0, params.filterTime);
+}
+
+const ForceFeedParams &ForceFeedController::Params() const { return params; }
+
+bool ForceFeedController::IsEnabled() const { return params.isEnabled; }
+
+double ForceFeedController::SpeedScale() const { return params.ceiling; }
+
+void ForceFeedController::Start(double targetForce) {
+    target = params.targetForce > 0 ? params.targetForce : targetForce;
+    filtered = target;
+    integral = 0;
+    ratio = 1;
+    isStarted = false;
+}
+
+double ForceFeedController::Update(double force, double dt) {
+    if (dt <= 0) {
+        return ratio;
+    }
+    // 一阶低通滤波，首个采样直接作为初值
+    if (!isStarted) {
+        filtered = force;
+        isStarted = true;
+    } else {
+        filtered += (force - filtered) * dt / (params.filterTime + dt);
+    }
+    // 死区：目标±band 内误差为0，带外只计超出部分
+    double error = filtered - target;
+    if (qAbs(error) <= params.band) {
+        error = 0;
+    } else {
+        error -= error > 0 ? params.band : -params.band;
+    }
+    // 压力偏大 -> 倍率减小
+    double newIntegral = integral + error * dt;
+    double desired = 1 - params.kp * error - params.ki * newIntegral;
+    if (desired > params.floor && desired < params.ceiling) {
+        integral = newIntegral; // 饱和时停止积分
+    } else {
+        desired = 1 - params.kp * error - params.ki * integral;
+    }
+    desired = qBound(params.floor, desired, params.ceiling);
+    // 变化率限制
+    double step = params.maxRate * dt;
+    ratio += qBound(-step, desired - ratio, step);
+    ratio = qBound(params.floor, ratio, params.ceiling);
+    return ratio;
+}
+
+double ForceFeedController::Ratio() const { return ratio; }
+
+double ForceFeedController::Override() const {
+    return ratio / SpeedScale();
+}
@@ -0,0 +1,1533 @@
+﻿#include <QDesktopServices>
+#include <QThread>
+#include <QUrl>
+#include <chrono>
+#include <thread>
+
+#include "callstats.h"
+#include "hansrobot.h"
+#include "robotplugin.h"
+
+#include "HR_Pro.h"
+
+// 华沿 SDK 调用计时：同名宏展开时不再递归，调用点保持原样
+#define HRIF_Connect(...) CALL_STATS("HRIF_Connect", HRIF_Connect(__VA_ARGS__))
+#define HRIF_DelPath(...) CALL_STATS("HRIF_DelPath", HRIF_DelPath(__VA_ARGS__))
+#define HRIF_Electrify(...)                                                    \
+    CALL_STATS("HRIF_Electrify", HRIF_Electrify(__VA_ARGS__))
+#define HRIF_EndPushMovePath(...)                                              \
+    CALL_STATS("HRIF_EndPushMovePath", HRIF_EndPushMovePath(__VA_ARGS__))
+#define HRIF_GrpCloseFreeDriver(...)                                           \
+    CALL_STATS("HRIF_GrpCloseFreeDriver", HRIF_GrpCloseFreeDriver(__VA_ARGS__))
+#define HRIF_GrpDisable(...)                                                   \
+    CALL_STATS("HRIF_GrpDisable", HRIF_GrpDisable(__VA_ARGS__))
+#define HRIF_GrpEnable(...)                                                    \
+    CALL_STATS("HRIF_GrpEnable", HRIF_GrpEnable(__VA_ARGS__))
+#define HRIF_GrpOpenFreeDriver(...)                                            \
+    CALL_STATS("HRIF_GrpOpenFreeDriver", HRIF_GrpOpenFreeDriver(__VA_ARGS__))
+#define HRIF_GrpReset(...)                                                     \
+    CALL_STATS("HRIF_GrpReset", HRIF_GrpReset(__VA_ARGS__))
+#define HRIF_GrpStop(...) CALL_STATS("HRIF_GrpStop", HRIF_GrpStop(__VA_ARGS__))
+#define HRIF_InitMovePathL(...)                                                \
+    CALL_STATS("HRIF_InitMovePathL", HRIF_InitMovePathL(__VA_ARGS__))
+#define HRIF_MovePathL(...)                                                    \
+    CALL_STATS("HRIF_MovePathL", HRIF_MovePathL(__VA_ARGS__))
+#define HRIF_PushMovePathL(...)                                                \
+    CALL_STATS("HRIF_PushMovePathL", HRIF_PushMovePathL(__VA_ARGS__))
+#define HRIF_PushServoP(...)                                                   \
+    CALL_STATS("HRIF_PushServoP", HRIF_PushServoP(__VA_ARGS__))
+#define HRIF_ReadActJointPos(...)                                              \
+    CALL_STATS("HRIF_ReadActJointPos", HRIF_ReadActJointPos(__VA_ARGS__))
+#define HRIF_ReadActTcpPos(...)                                                \
+    CALL_STATS("HRIF_ReadActTcpPos", HRIF_ReadActTcpPos(__VA_ARGS__))
+#define HRIF_ReadCurTCP(...)                                                   \
+    CALL_STATS("HRIF_ReadCurTCP", HRIF_ReadCurTCP(__VA_ARGS__))
+#define HRIF_ReadCurWaypointID(...)                                            \
+    CALL_STATS("HRIF_ReadCurWaypointID", HRIF_ReadCurWaypointID(__VA_ARGS__))
+#define HRIF_ReadPathState(...)                                                \
+    CALL_STATS("HRIF_ReadPathState", HRIF_ReadPathState(__VA_ARGS__))
+#define HRIF_ReadRobotFlags(...)                                               \
+    CALL_STATS("HRIF_ReadRobotFlags", HRIF_ReadRobotFlags(__VA_ARGS__))
+#define HRIF_ReadRobotState(...)                                               \
+    CALL_STATS("HRIF_ReadRobotState", HRIF_ReadRobotState(__VA_ARGS__))
+#define HRIF_ReadTrackProcess(...)                                             \
+    CALL_STATS("HRIF_ReadTrackProcess", HRIF_ReadTrackProcess(__VA_ARGS__))
+#define HRIF_SetMovePathOverride(...)                                          \
+    CALL_STATS("HRIF_SetMovePathOverride", HRIF_SetMovePathOverride(__VA_ARGS__))
+#define HRIF_SetOverride(...)                                                  \
+    CALL_STATS("HRIF_SetOverride", HRIF_SetOverride(__VA_ARGS__))
+#define HRIF_SetTCPByName(...)                                                 \
+    CALL_STATS("HRIF_SetTCPByName", HRIF_SetTCPByName(__VA_ARGS__))
+#define HRIF_StartServo(...)                                                   \
+    CALL_STATS("HRIF_StartServo", HRIF_StartServo(__VA_ARGS__))
+#define HRIF_WayPoint(...)                                                     \
+    CALL_STATS("HRIF_WayPoint", HRIF_WayPoint(__VA_ARGS__))
+#define HRIF_WayPoint2(...)                                                    \
+    CALL_STATS("HRIF_WayPoint2", HRIF_WayPoint2(__VA_ARGS__))
+
+// 伺服前瞻时间，s
+constexpr double servoLookahead = 0.1;
+
+HansRobot::HansRobot()
+    : isPathMoving(false), speedOverride(1), globalOverride(1) {
+    isSegmentTracked = true;
+}
+
+HansRobot::~HansRobot() {
+    HRIF_GrpCloseFreeDriver(0, 0);
+    HRIF_GrpDisable(0, 0);
+}
+
+bool HansRobot::RobotConnect(QString robotIP) {
+    int nRet = -1;
+    std::string ip = robotIP.toStdString();
+    const char *hostname = ip.c_str();
+    unsigned short nPort = 10003;
+    nRet = HRIF_Connect(0, hostname, nPort);
+    if (nRet == 0) {
+        // 机器人上电
+        HRIF_Electrify(0);
+        // 机器人使能
+        HRIF_GrpEnable(0, 0);
+        // 设置速度比
+        SetSpeedOverride(1.0);
+        return true;
+    }
+    return false;
+}
+
+bool HansRobot::IsRobotElectrified() {
+    // 定义需要读取的机器人状态变量
+    int nMovingState = 0;
+    int nEnableState = 0;
+    int nErrorState = 0;
+    int nErrorCode = 0;
+    int nErrorAxis = 0;
+    int nBreaking = 0;
+    int nPause = 0;
+    int nEmergencyStop = 0;
+    int nSaftyGuard = 0;
+    int nElectrify = 0;
+    int nIsConnectToBox = 0;
+    int nBlendingDone = 0;
+    int nInPos = 0;
+    // 读取状态
+    HRIF_ReadRobotState(0, 0, nMovingState, nEnableState, nErrorState,
+                        nErrorCode, nErrorAxis, nBreaking, nPause,
+                        nEmergencyStop, nSaftyGuard, nElectrify,
+                        nIsConnectToBox, nBlendingDone, nInPos);
+    return nElectrify == 1 ? true : false;
+}
+
+bool HansRobot::IsRobotEnabled() {
+    // 定义需要读取的机器人状态变量
+    int nMovingState = 0;
+    int nEnableState = 0;
+    int nErrorState = 0;
+    int nErrorCode = 0;
+    int nErrorAxis = 0;
+    int nBreaking = 0;
+    int nPause = 0;
+    int nBlendingDone = 0;
+    // 读取状态
+    HRIF_ReadRobotFlags(0, 0, nMovingState, nEnableState, nErrorState,
+                        nErrorCode, nErrorAxis, nBreaking, nPause,
+                        nBlendingDone);
+    return nEnableState == 1 ? true : false;
+}
+
+bool HansRobot::IsRobotMoved() {
+    // 定义需要读取的机器人状态变量
+    int nMovingState = 0;
+    int nEnableState = 0;
+    int nErrorState = 0;
+    int nErrorCode = 0;
+    int nErrorAxis = 0;
+    int nBreaking = 0;
+    int nPause = 0;
+    int nBlendingDone = 0;
+    // 读取状态
+    HRIF_ReadRobotFlags(0, 0, nMovingState, nEnableState, nErrorState,
+                        nErrorCode, nErrorAxis, nBreaking, nPause,
+                        nBlendingDone);
+    return nMovingState == 1 ? true : false;
+}
+
+bool HansRobot::RobotTeach(int pos) {
+    if (!isTeach) {
+        if (agp != nullptr) {
+            std::lock_guard<std::recursive_mutex> lock(agpMutex);
+            // 设置AGP默认参数
+            AGP_CALL(Control, FUNC::RESET);
+            AGP_CALL(Control, FUNC::ENABLE);
+            AGP_CALL(SetMode, MODE::PosMode);
+            AGP_CALL(SetPos, pos * 100);
+            AGP_CALL(SetForce, 200);
+            AGP_CALL(SetTouchForce, 0);
+            AGP_CALL(SetRampTime, 0);
+            if (!IsAGPEnabled()) {
+                AGP_CALL(Control, FUNC::ENABLE);
+            }
+        }
+        if (!IsRobotElectrified()) {
+            // 机器人上电
+            HRIF_Electrify(0);
+            if (!IsRobotElectrified()) {
+                return isTeach;
+            }
+        }
+        if (!IsRobotEnabled()) {
+            // 机器人使能
+            HRIF_GrpEnable(0, 0);
+            QThread::msleep(1500);
+            if (!IsRobotEnabled()) {
+                return isTeach;
+            }
+        }
+        // 设置速度比
+        SetSpeedOverride(1.0);
+        // 启用自由拖拽
+        int nRet = HRIF_GrpOpenFreeDriver(0, 0);
+        if (nRet == 0) {
+            isTeach = true;
+        }
+    } else {
+        // 关闭自由拖拽
+        int nRet = HRIF_GrpCloseFreeDriver(0, 0);
+        if (nRet == 0) {
+            isTeach = false;
+        }
+    }
+    return isTeach;
+}
+
+bool HansRobot::CloseFreeDriver() {
+    // 关闭自由拖拽
+    int nRet = HRIF_GrpCloseFreeDriver(0, 0);
+    if (nRet == 0) {
+        isTeach = false;
+        return true;
+    }
+    return false;
+}
+
+bool HansRobot::GetTcpPoint(Point &point) {
+    // 获取位姿信息
+    // int nRet = HRIF_ReadCmdTcpPos(0, 0, point.x, point.y, point.z, point.rx,
+    //                               point.ry, point.rz);
+    double x = 0;
+    double y = 0;
+    double z = 0;
+    double rx = 0;
+    double ry = 0;
+    double rz = 0;
+    int nRet = HRIF_ReadActTcpPos(0, 0, x, y, z, rx, ry, rz);
+    if (nRet == 0) {
+        point.pos.setX(x);
+        point.pos.setY(y);
+        point.pos.setZ(z);
+        point.rot.setX(rx);
+        point.rot.setY(ry);
+        point.rot.setZ(rz);
+        return true;
+    } else {
+        return false;
+    }
+}
+/*
+void HansRobot::MoveBefore(const Craft &craft, bool isAGPRun) {
+    // 定义运动类型
+    int nMoveType = 1;
+    // 定义空间目标位置
+    Point point;
+    // 定义关节目标位置
+    double dJ1 = 0;
+    double dJ2 = 0;
+    double dJ3 = 0;
+    double dJ4 = 0;
+    double dJ5 = 0;
+    double dJ6 = 0;
+    // 定义工具坐标变量
+    string sTcpName = "TCP_AGP";
+    // 定义用户坐标变量
+    string sUcsName = "Base";
+    // 定义运动速度
+    double dVelocity = defaultVelocity;
+    // 定义运动加速度
+    double dAcc = 2000;
+    // 定义过渡半径
+    double dRadius = 1;
+    // 定义是否使用关节角度
+    int nIsUseJoint = 1;
+    // 定义是否使用检测 DI 停止
+    int nIsSeek = 0;
+    // 定义检测的 DI 索引
+    int nIOBit = 0;
+    // 定义检测的 DI 状态
+    int nIOState = 0;
+    // 定义路点 ID
+    string strCmdID = "0";
+    // 偏移
+    OffsetDirection direction = craft.offsetDirection;
+    double offset = craft.offsetDistance;
+    // 移到安全点
+    point = pointSet.safePoint;
+    HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(), point.pos.z(),
+                  point.rot.x(), point.rot.y(), point.rot.z(), dJ1, dJ2, dJ3,
+                  dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+                  nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+    // AGP运行
+    AGPRun(craft, isAGPRun);
+    // 移到起始辅助点
+    point = pointSet.auxBeginPoint.PosRelByTool(direction, offset);
+    HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(), point.pos.z(),
+                  point.rot.x(), point.rot.y(), point.rot.z(), dJ1, dJ2, dJ3,
+                  dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+                  nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+    // 移到起始点
+    point = pointSet.beginPoint.PosRelByTool(direction, offset);
+    dVelocity = craft.cutinSpeed;
+    HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(), point.pos.z(),
+                  point.rot.x(), point.rot.y(), point.rot.z(), dJ1, dJ2, dJ3,
+                  dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+                  nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+}
+
+void HansRobot::MoveAfter(const Craft &craft, Point point) {
+    // 定义运动类型
+    int nMoveType = 1;
+    // 定义关节目标位置
+    double dJ1 = 0;
+    double dJ2 = 0;
+    double dJ3 = 0;
+    double dJ4 = 0;
+    double dJ5 = 0;
+    double dJ6 = 0;
+    // 定义工具坐标变量
+    string sTcpName = "TCP_AGP";
+    // 定义用户坐标变量
+    string sUcsName = "Base";
+    // 定义运动速度
+    double dVelocity = craft.cutinSpeed;
+    // 定义运动加速度
+    double dAcc = 2000;
+    // 定义过渡半径
+    double dRadius = 1;
+    // 定义是否使用关节角度
+    int nIsUseJoint = 1;
+    // 定义是否使用检测 DI 停止
+    int nIsSeek = 0;
+    // 定义检测的 DI 索引
+    int nIOBit = 0;
+    // 定义检测的 DI 状态
+    int nIOState = 0;
+    // 定义路点 ID
+    string strCmdID = "0";
+    // 移到结束辅助点
+    HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(), point.pos.z(),
+                  point.rot.x(), point.rot.y(), point.rot.z(), dJ1, dJ2, dJ3,
+                  dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+                  nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+    // 移到安全点
+    point = pointSet.safePoint;
+    // 定义运动速度
+    dVelocity = defaultVelocity;
+    HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(), point.pos.z(),
+                  point.rot.x(), point.rot.y(), point.rot.z(), dJ1, dJ2, dJ3,
+                  dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+                  nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+}
+
+void HansRobot::MoveLine(const Craft &craft) {
+    // 定义运动类型
+    int nMoveType = 1;
+    // 定义关节目标位置
+    double dJ1 = 0;
+    double dJ2 = 0;
+    double dJ3 = 0;
+    double dJ4 = 0;
+    double dJ5 = 0;
+    double dJ6 = 0;
+    // 定义工具坐标变量
+    string sTcpName = "TCP_AGP";
+    // 定义用户坐标变量
+    string sUcsName = "Base";
+    // 定义运动速度
+    double dVelocity = craft.moveSpeed;
+    // 定义运动加速度
+    double dAcc = 100;
+    // 定义过渡半径
+    double dRadius = 1;
+    // 定义是否使用关节角度
+    int nIsUseJoint = 1;
+    // 定义是否使用检测 DI 停止
+    int nIsSeek = 0;
+    // 定义检测的 DI 索引
+    int nIOBit = 0;
+    // 定义检测的 DI 状态
+    int nIOState = 0;
+    // 定义路点 ID
+    string strCmdID = "0";
+    // 偏移
+    OffsetDirection direction = craft.offsetDirection;
+    double offset = craft.offsetDistance;
+
+    Point point;
+    for (int i = 0; i < pointSet.midPoints.size(); ++i) {
+        // 定义空间目标位置
+        point = pointSet.midPoints[i].PosRelByTool(direction, offset);
+        // 执行路点运动
+        HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
+                      point.pos.z(), point.rot.x(), point.rot.y(),
+                      point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                      sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
+                      nIOBit, nIOState, strCmdID);
+    }
+    // 移到结束点
+    point = pointSet.endPoint.PosRelByTool(direction, offset);
+    HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(), point.pos.z(),
+                  point.rot.x(), point.rot.y(), point.rot.z(), dJ1, dJ2, dJ3,
+                  dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+                  nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+}
+
+void HansRobot::MoveArc(const Craft &craft) {
+    // 定义运动类型
+    int nMoveType = 2;
+    // 定义关节目标位置
+    double dJ1 = 0;
+    double dJ2 = 0;
+    double dJ3 = 0;
+    double dJ4 = 0;
+    double dJ5 = 0;
+    double dJ6 = 0;
+    // 定义工具坐标变量
+    string sTcpName = "TCP_AGP";
+    // 定义用户坐标变量
+    string sUcsName = "Base";
+    // 定义运动速度
+    double dVelocity = craft.moveSpeed;
+    // 定义运动加速度
+    double dAcc = 100;
+    // 定义过渡半径
+    double dRadius = 1;
+    // 定义是否使用关节角度
+    int nIsUseJoint = 1;
+    // 定义是否使用检测 DI 停止
+    int nIsSeek = 0;
+    // 定义检测的 DI 索引
+    int nIOBit = 0;
+    // 定义检测的 DI 状态
+    int nIOState = 0;
+    // 定义路点 ID
+    string strCmdID = "0";
+    // 偏移
+    OffsetDirection direction = craft.offsetDirection;
+    double offset = craft.offsetDistance;
+    // 定义空间目标位置
+    Point posMidRel = pointSet.auxPoint.PosRelByTool(direction, offset);
+    Point posEndRel = pointSet.endPoint.PosRelByTool(direction, offset);
+    // 执行路点运动
+    HRIF_WayPoint2(0, 0, nMoveType, posEndRel.pos.x(), posEndRel.pos.y(),
+                   posEndRel.pos.z(), posEndRel.rot.x(), posEndRel.rot.y(),
+                   posEndRel.rot.z(), posMidRel.pos.x(), posMidRel.pos.y(),
+                   posMidRel.pos.z(), posMidRel.rot.x(), posMidRel.rot.y(),
+                   posMidRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                   sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
+                   nIOBit, nIOState, strCmdID);
+}
+
+// 平面圆弧
+// Position HansRobot::MoveRegionArc(double offset, OffsetDirection direction)
+// {
+//     // 定义运动类型
+//     int nMoveType = 2;
+//     // 定义关节目标位置
+//     double dJ1 = 0;
+//     double dJ2 = 0;
+//     double dJ3 = 0;
+//     double dJ4 = 0;
+//     double dJ5 = 0;
+//     double dJ6 = 0;
+//     // 定义工具坐标变量
+//     string sTcpName = "TCP_AGP";
+//     // 定义用户坐标变量
+//     string sUcsName = "Base";
+//     // 定义运动速度
+//     double dVelocity = crafts.at(currCraftIdx).moveSpeed;
+//     // 定义运动加速度
+//     double dAcc = 100;
+//     // 定义过渡半径
+//     double dRadius = 1;
+//     // 定义是否使用关节角度
+//     int nIsUseJoint = 1;
+//     // 定义是否使用检测 DI 停止
+//     int nIsSeek = 0;
+//     // 定义检测的 DI 索引
+//     int nIOBit = 0;
+//     // 定义检测的 DI 状态
+//     int nIOState = 0;
+//     // 定义路点 ID
+//     string strCmdID = "0";
+//     // 计算单次偏移量
+//     int count = crafts.at(currCraftIdx).offsetCount;
+//     Position beginOffset = (beginOffsetPoint - beginPoint) / count;
+//     Position endOffset = (endOffsetPoint - endPoint) / count;
+//     Position midOffset = (beginOffset + endOffset) / 2;
+//     // 定义空间目标位置
+//     Position posBeginRel = PosRelByTool(beginPoint, offset, direction);
+//     Position posEndRel = PosRelByTool(endPoint, offset, direction);
+//     Position posMidRel = PosRelByTool(auxPoint, offset, direction);
+//     // 正向圆弧运动
+//     HRIF_WayPoint2(0, 0, nMoveType, posEndRel.x, posEndRel.y, posEndRel.z,
+//                    posBeginRel.rx, posBeginRel.ry, posBeginRel.rz,
+//                    posMidRel.x, posMidRel.y, posMidRel.z, posBeginRel.rx,
+//                    posBeginRel.ry, posBeginRel.rz, dJ1, dJ2, dJ3, dJ4, dJ5,
+//                    dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+//                    nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+//     Position pos;
+//     for (int i = 0; i < count; ++i) {
+//         if (i % 2 == 0) {
+//             // 抬高
+//             pos = posEndRel;
+//             pos.rx = posBeginRel.rx;
+//             pos.ry = posBeginRel.ry;
+//             pos.rz = posBeginRel.rz;
+//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
+//             nMoveType = 1;
+//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
+//             pos.ry,
+//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+//                           nIsSeek, nIOBit, nIOState, strCmdID);
+//             // 改变位姿
+//             posBeginRel += beginOffset;
+//             posEndRel += endOffset;
+//             posMidRel += midOffset;
+//             pos = posEndRel;
+//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
+//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
+//             pos.ry,
+//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+//                           nIsSeek, nIOBit, nIOState, strCmdID);
+//             // 压低
+//             HRIF_WayPoint(0, 0, nMoveType, posEndRel.x, posEndRel.y,
+//                           posEndRel.z, posEndRel.rx, posEndRel.ry,
+//                           posEndRel.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6,
+//                           sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+//                           nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+//             // 反向圆弧运动
+//             nMoveType = 2;
+//             HRIF_WayPoint2(0, 0, nMoveType, posBeginRel.x, posBeginRel.y,
+//                            posBeginRel.z, posEndRel.rx, posEndRel.ry,
+//                            posEndRel.rz, posMidRel.x, posMidRel.y,
+//                            posMidRel.z, posEndRel.rx, posEndRel.ry,
+//                            posEndRel.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6,
+//                            sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+//                            nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+//         } else {
+//             // 抬高
+//             pos = posBeginRel;
+//             pos.rx = posEndRel.rx;
+//             pos.ry = posEndRel.ry;
+//             pos.rz = posEndRel.rz;
+//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
+//             nMoveType = 1;
+//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
+//             pos.ry,
+//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+//                           nIsSeek, nIOBit, nIOState, strCmdID);
+//             // 改变位姿
+//             posBeginRel += beginOffset;
+//             posEndRel += endOffset;
+//             posMidRel += midOffset;
+//             pos = posBeginRel;
+//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
+//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
+//             pos.ry,
+//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+//                           nIsSeek, nIOBit, nIOState, strCmdID);
+//             // 压低
+//             HRIF_WayPoint(0, 0, nMoveType, posBeginRel.x, posBeginRel.y,
+//                           posBeginRel.z, posBeginRel.rx, posBeginRel.ry,
+//                           posBeginRel.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6,
+//                           sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+//                           nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+//             // 正向圆弧运动
+//             nMoveType = 2;
+//             HRIF_WayPoint2(0, 0, nMoveType, posEndRel.x, posEndRel.y,
+//                            posEndRel.z, posBeginRel.rx, posBeginRel.ry,
+//                            posBeginRel.rz, posMidRel.x, posMidRel.y,
+//                            posMidRel.z, posBeginRel.rx, posBeginRel.ry,
+//                            posBeginRel.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6,
+//                            sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+//                            nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+//         }
+//     }
+//     return count % 2 == 0
+//                ? Position{posEndRel.x,    posEndRel.y,    posEndRel.z,
+//                           posBeginRel.rx, posBeginRel.ry, posBeginRel.rz}
+//                : Position{posBeginRel.x, posBeginRel.y, posBeginRel.z,
+//                           posEndRel.rx,  posEndRel.ry,  posEndRel.rz};
+// }
+
+// 柱面圆弧，辅助点姿态取平均
+// Position HansRobot::MoveRegionArc(double offset, OffsetDirection direction)
+// {
+//     // 定义运动类型
+//     int nMoveType = 2;
+//     // 定义关节目标位置
+//     double dJ1 = 0;
+//     double dJ2 = 0;
+//     double dJ3 = 0;
+//     double dJ4 = 0;
+//     double dJ5 = 0;
+//     double dJ6 = 0;
+//     // 定义工具坐标变量
+//     string sTcpName = "TCP_AGP";
+//     // 定义用户坐标变量
+//     string sUcsName = "Base";
+//     // 定义运动速度
+//     double dVelocity = crafts.at(currCraftIdx).moveSpeed;
+//     // 定义运动加速度
+//     double dAcc = 100;
+//     // 定义过渡半径
+//     double dRadius = 1;
+//     // 定义是否使用关节角度
+//     int nIsUseJoint = 1;
+//     // 定义是否使用检测 DI 停止
+//     int nIsSeek = 0;
+//     // 定义检测的 DI 索引
+//     int nIOBit = 0;
+//     // 定义检测的 DI 状态
+//     int nIOState = 0;
+//     // 定义路点 ID
+//     string strCmdID = "0";
+//     // 计算单次偏移量
+//     int count = crafts.at(currCraftIdx).offsetCount;
+//     Position beginOffset = (beginOffsetPoint - beginPoint) / count;
+//     Position endOffset = (endOffsetPoint - endPoint) / count;
+//     Position midOffset = (beginOffset + endOffset) / 2;
+//     // 定义空间目标位置
+//     Position posBeginRel = PosRelByTool(beginPoint, offset, direction);
+//     Position posEndRel = PosRelByTool(endPoint, offset, direction);
+//     Position posMidRel = PosRelByTool(auxPoint, offset, direction);
+//     // 正向圆弧运动，辅助点姿态取起始和结束点姿态的平均值
+//     HRIF_WayPoint2(0, 0, nMoveType, posEndRel.x, posEndRel.y, posEndRel.z,
+//                    posEndRel.rx, posEndRel.ry, posEndRel.rz, posMidRel.x,
+//                    posMidRel.y, posMidRel.z,
+//                    (posBeginRel.rx + posEndRel.rx) / 2,
+//                    (posBeginRel.ry + posEndRel.ry) / 2,
+//                    (posBeginRel.rz + posEndRel.rz) / 2, dJ1, dJ2, dJ3, dJ4,
+//                    dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+//                    nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+//     Position pos;
+//     for (int i = 0; i < count; ++i) {
+//         if (i % 2 == 0) { // 反向
+//             // 抬高
+//             pos = posEndRel;
+//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
+//             nMoveType = 1;
+//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
+//             pos.ry,
+//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+//                           nIsSeek, nIOBit, nIOState, strCmdID);
+//             // 改变位姿
+//             posBeginRel += beginOffset;
+//             posEndRel += endOffset;
+//             posMidRel += midOffset;
+//             pos = posEndRel;
+//             pos.rx = endOffsetPoint.rx;
+//             pos.ry = endOffsetPoint.ry;
+//             pos.rz = endOffsetPoint.rz;
+//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
+//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
+//             pos.ry,
+//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+//                           nIsSeek, nIOBit, nIOState, strCmdID);
+//             // 压低
+//             pos = posEndRel;
+//             pos.rx = endOffsetPoint.rx;
+//             pos.ry = endOffsetPoint.ry;
+//             pos.rz = endOffsetPoint.rz;
+//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
+//             pos.ry,
+//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+//                           nIsSeek, nIOBit, nIOState, strCmdID);
+//             // 反向圆弧运动
+//             nMoveType = 2;
+//             HRIF_WayPoint2(
+//                 0, 0, nMoveType, posBeginRel.x, posBeginRel.y, posBeginRel.z,
+//                 beginOffsetPoint.rx, beginOffsetPoint.ry,
+//                 beginOffsetPoint.rz, posMidRel.x, posMidRel.y, posMidRel.z,
+//                 (beginOffsetPoint.rx + endOffsetPoint.rx) / 2,
+//                 (beginOffsetPoint.ry + endOffsetPoint.ry) / 2,
+//                 (beginOffsetPoint.rz + endOffsetPoint.rz) / 2, dJ1, dJ2, dJ3,
+//                 dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+//                 nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+//         } else { // 正向
+//             // 抬高
+//             pos = posBeginRel;
+//             pos.rx = beginOffsetPoint.rx;
+//             pos.ry = beginOffsetPoint.ry;
+//             pos.rz = beginOffsetPoint.rz;
+//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
+//             nMoveType = 1;
+//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
+//             pos.ry,
+//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+//                           nIsSeek, nIOBit, nIOState, strCmdID);
+//             // 改变位姿
+//             posBeginRel += beginOffset;
+//             posEndRel += endOffset;
+//             posMidRel += midOffset;
+//             pos = posBeginRel;
+//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
+//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
+//             pos.ry,
+//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+//                           nIsSeek, nIOBit, nIOState, strCmdID);
+//             // 压低
+//             pos = posBeginRel;
+//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
+//             pos.ry,
+//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+//                           nIsSeek, nIOBit, nIOState, strCmdID);
+//             // 正向圆弧运动
+//             nMoveType = 2;
+//             HRIF_WayPoint2(
+//                 0, 0, nMoveType, posEndRel.x, posEndRel.y, posEndRel.z,
+//                 posEndRel.rx, posEndRel.ry, posEndRel.rz, posMidRel.x,
+//                 posMidRel.y, posMidRel.z, (posBeginRel.rx + posEndRel.rx) /
+//                 2, (posBeginRel.ry + posEndRel.ry) / 2, (posBeginRel.rz +
+//                 posEndRel.rz) / 2, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+//                 sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
+//                 nIOBit, nIOState, strCmdID);
+//         }
+//     }
+//     return count % 2 == 0 ? Position{posEndRel.x,  posEndRel.y,  posEndRel.z,
+//                                      posEndRel.rx, posEndRel.ry,
+//                                      posEndRel.rz}
+//                           : Position{posBeginRel.x,       posBeginRel.y,
+//                                      posBeginRel.z, beginOffsetPoint.rx,
+//                                      beginOffsetPoint.ry,
+//                                      beginOffsetPoint.rz};
+// }
+
+// 柱面圆弧，辅助点姿态不取平均
+Point HansRobot::MoveRegionArc1(const Craft &craft) {
+    // 定义运动类型
+    int nMoveType = 2;
+    // 定义关节目标位置
+    double dJ1 = 0;
+    double dJ2 = 0;
+    double dJ3 = 0;
+    double dJ4 = 0;
+    double dJ5 = 0;
+    double dJ6 = 0;
+    // 定义工具坐标变量
+    string sTcpName = "TCP_AGP";
+    // 定义用户坐标变量
+    string sUcsName = "Base";
+    // 定义运动速度
+    double dVelocity = craft.moveSpeed;
+    // 定义运动加速度
+    double dAcc = 100;
+    // 定义过渡半径
+    double dRadius = 1;
+    // 定义是否使用关节角度
+    int nIsUseJoint = 1;
+    // 定义是否使用检测 DI 停止
+    int nIsSeek = 0;
+    // 定义检测的 DI 索引
+    int nIOBit = 0;
+    // 定义检测的 DI 状态
+    int nIOState = 0;
+    // 定义路点 ID
+    string strCmdID = "0";
+    // 偏移
+    OffsetDirection direction = craft.offsetDirection;
+    double offset = craft.offsetDistance;
+    // 计算单次偏移量
+    int count = craft.offsetCount;
+    Point beginOffset;
+    beginOffset.pos =
+        (pointSet.beginOffsetPoint.pos - pointSet.beginPoint.pos) / count;
+    Point endOffset;
+    endOffset.pos =
+        (pointSet.endOffsetPoint.pos - pointSet.endPoint.pos) / count;
+    Point midOffset;
+    midOffset.pos = (beginOffset.pos + endOffset.pos) / 2;
+    // 定义空间目标位置
+    Point posBeginRel = pointSet.beginPoint.PosRelByTool(direction, offset);
+    Point posEndRel = pointSet.endPoint.PosRelByTool(direction, offset);
+    Point posMidRel = pointSet.auxPoint.PosRelByTool(direction, offset);
+    // 正向圆弧运动
+    HRIF_WayPoint2(0, 0, nMoveType, posEndRel.pos.x(), posEndRel.pos.y(),
+                   posEndRel.pos.z(), posEndRel.rot.x(), posEndRel.rot.y(),
+                   posEndRel.rot.z(), posMidRel.pos.x(), posMidRel.pos.y(),
+                   posMidRel.pos.z(), posMidRel.rot.x(), posMidRel.rot.y(),
+                   posMidRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                   sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
+                   nIOBit, nIOState, strCmdID);
+    Point point;
+    for (int i = 0; i < count; ++i) {
+        if (i % 2 == 0) { // 反向
+            // 抬高
+            point = posEndRel;
+            point = point.PosRelByTool(defaultDirection, defaultOffset);
+            nMoveType = 1;
+            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
+                          point.pos.z(), point.rot.x(), point.rot.y(),
+                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+                          nIsSeek, nIOBit, nIOState, strCmdID);
+            // 改变位姿
+            posBeginRel += beginOffset;
+            posEndRel += endOffset;
+            posMidRel += midOffset;
+            point = posEndRel;
+            point.rot.setX(pointSet.endOffsetPoint.rot.x());
+            point.rot.setY(pointSet.endOffsetPoint.rot.y());
+            point.rot.setZ(pointSet.endOffsetPoint.rot.z());
+            point = point.PosRelByTool(defaultDirection, defaultOffset);
+            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
+                          point.pos.z(), point.rot.x(), point.rot.y(),
+                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+                          nIsSeek, nIOBit, nIOState, strCmdID);
+            // 压低
+            point = posEndRel;
+            point.rot.setX(pointSet.endOffsetPoint.rot.x());
+            point.rot.setY(pointSet.endOffsetPoint.rot.y());
+            point.rot.setZ(pointSet.endOffsetPoint.rot.z());
+            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
+                          point.pos.z(), point.rot.x(), point.rot.y(),
+                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+                          nIsSeek, nIOBit, nIOState, strCmdID);
+            // 反向圆弧运动
+            nMoveType = 2;
+            HRIF_WayPoint2(0, 0, nMoveType, posBeginRel.pos.x(),
+                           posBeginRel.pos.y(), posBeginRel.pos.z(),
+                           pointSet.beginOffsetPoint.rot.x(),
+                           pointSet.beginOffsetPoint.rot.y(),
+                           pointSet.beginOffsetPoint.rot.z(), posMidRel.pos.x(),
+                           posMidRel.pos.y(), posMidRel.pos.z(),
+                           (posMidRel.rot.x() - posBeginRel.rot.x() +
+                            pointSet.beginOffsetPoint.rot.x()),
+                           (posMidRel.rot.y() - posBeginRel.rot.y() +
+                            pointSet.beginOffsetPoint.rot.y()),
+                           (posMidRel.rot.z() - posBeginRel.rot.z() +
+                            pointSet.beginOffsetPoint.rot.z()),
+                           dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName, sUcsName,
+                           dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
+                           nIOBit, nIOState, strCmdID);
+        } else { // 正向
+            // 抬高
+            point = posBeginRel;
+            point.rot.setX(pointSet.beginOffsetPoint.rot.x());
+            point.rot.setY(pointSet.beginOffsetPoint.rot.y());
+            point.rot.setZ(pointSet.beginOffsetPoint.rot.z());
+            point = point.PosRelByTool(defaultDirection, defaultOffset);
+            nMoveType = 1;
+            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
+                          point.pos.z(), point.rot.x(), point.rot.y(),
+                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+                          nIsSeek, nIOBit, nIOState, strCmdID);
+            // 改变位姿
+            posBeginRel += beginOffset;
+            posEndRel += endOffset;
+            posMidRel += midOffset;
+            point = posBeginRel;
+            point = point.PosRelByTool(defaultDirection, defaultOffset);
+            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
+                          point.pos.z(), point.rot.x(), point.rot.y(),
+                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+                          nIsSeek, nIOBit, nIOState, strCmdID);
+            // 压低
+            point = posBeginRel;
+            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
+                          point.pos.z(), point.rot.x(), point.rot.y(),
+                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+                          nIsSeek, nIOBit, nIOState, strCmdID);
+            // 正向圆弧运动
+            nMoveType = 2;
+            HRIF_WayPoint2(
+                0, 0, nMoveType, posEndRel.pos.x(), posEndRel.pos.y(),
+                posEndRel.pos.z(), posEndRel.rot.x(), posEndRel.rot.y(),
+                posEndRel.rot.z(), posMidRel.pos.x(), posMidRel.pos.y(),
+                posMidRel.pos.z(), posMidRel.rot.x(), posMidRel.rot.y(),
+                posMidRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
+                nIOBit, nIOState, strCmdID);
+        }
+    }
+    return count % 2 == 0
+               ? Point{posEndRel.pos.x(), posEndRel.pos.y(), posEndRel.pos.z(),
+                       posEndRel.rot.x(), posEndRel.rot.y(), posEndRel.rot.z()}
+               : Point{posBeginRel.pos.x(),
+                       posBeginRel.pos.y(),
+                       posBeginRel.pos.z(),
+                       pointSet.beginOffsetPoint.rot.x(),
+                       pointSet.beginOffsetPoint.rot.y(),
+                       pointSet.beginOffsetPoint.rot.z()};
+}
+
+Point HansRobot::MoveRegionArc2(const Craft &craft) {
+    // 定义运动类型
+    int nMoveType = 2;
+    // 定义关节目标位置
+    double dJ1 = 0;
+    double dJ2 = 0;
+    double dJ3 = 0;
+    double dJ4 = 0;
+    double dJ5 = 0;
+    double dJ6 = 0;
+    // 定义工具坐标变量
+    string sTcpName = "TCP_AGP";
+    // 定义用户坐标变量
+    string sUcsName = "Base";
+    // 定义运动速度
+    double dVelocity = craft.moveSpeed;
+    // 定义运动加速度
+    double dAcc = 100;
+    // 定义过渡半径
+    double dRadius = 1;
+    // 定义是否使用关节角度
+    int nIsUseJoint = 1;
+    // 定义是否使用检测 DI 停止
+    int nIsSeek = 0;
+    // 定义检测的 DI 索引
+    int nIOBit = 0;
+    // 定义检测的 DI 状态
+    int nIOState = 0;
+    // 定义路点 ID
+    string strCmdID = "0";
+    // 偏移
+    OffsetDirection direction = craft.offsetDirection;
+    double offset = craft.offsetDistance;
+    // 计算单次偏移量
+    int count = craft.offsetCount;
+    Point beginOffset;
+    beginOffset.pos =
+        (pointSet.beginOffsetPoint.pos - pointSet.beginPoint.pos) / count;
+    Point endOffset;
+    endOffset.pos =
+        (pointSet.endOffsetPoint.pos - pointSet.endPoint.pos) / count;
+    Point midOffset;
+    midOffset.pos = (beginOffset.pos + endOffset.pos) / 2;
+    // 定义空间目标位置
+    Point posBeginRel = pointSet.beginPoint.PosRelByTool(direction, offset);
+    Point posEndRel = pointSet.endPoint.PosRelByTool(direction, offset);
+    Point posMidRel = pointSet.auxPoint.PosRelByTool(direction, offset);
+    // 正向圆弧运动
+    HRIF_WayPoint2(0, 0, nMoveType, posEndRel.pos.x(), posEndRel.pos.y(),
+                   posEndRel.pos.z(), posEndRel.rot.x(), posEndRel.rot.y(),
+                   posEndRel.rot.z(), posMidRel.pos.x(), posMidRel.pos.y(),
+                   posMidRel.pos.z(), posMidRel.rot.x(), posMidRel.rot.y(),
+                   posMidRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                   sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
+                   nIOBit, nIOState, strCmdID);
+    Point point;
+    for (int i = 0; i < count; ++i) {
+        if (i % 2 == 0) { // 反向
+            // 抬高
+            point = posEndRel;
+            point = point.PosRelByTool(defaultDirection, defaultOffset);
+            nMoveType = 1;
+            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
+                          point.pos.z(), point.rot.x(), point.rot.y(),
+                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+                          nIsSeek, nIOBit, nIOState, strCmdID);
+            // 改变位姿
+            posBeginRel += beginOffset;
+            posEndRel += endOffset;
+            posMidRel += midOffset;
+            point = posEndRel;
+            point.rot.setX(pointSet.endOffsetPoint.rot.x());
+            point.rot.setY(pointSet.endOffsetPoint.rot.y());
+            point.rot.setZ(pointSet.endOffsetPoint.rot.z());
+            point = point.PosRelByTool(defaultDirection, defaultOffset);
+            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
+                          point.pos.z(), point.rot.x(), point.rot.y(),
+                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+                          nIsSeek, nIOBit, nIOState, strCmdID);
+            // 压低
+            point = posEndRel;
+            point.rot.setX(pointSet.endOffsetPoint.rot.x());
+            point.rot.setY(pointSet.endOffsetPoint.rot.y());
+            point.rot.setZ(pointSet.endOffsetPoint.rot.z());
+            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
+                          point.pos.z(), point.rot.x(), point.rot.y(),
+                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+                          nIsSeek, nIOBit, nIOState, strCmdID);
+            // 反向圆弧运动
+            nMoveType = 2;
+            HRIF_WayPoint2(0, 0, nMoveType, posBeginRel.pos.x(),
+                           posBeginRel.pos.y(), posBeginRel.pos.z(),
+                           pointSet.beginOffsetPoint.rot.x(),
+                           pointSet.beginOffsetPoint.rot.y(),
+                           pointSet.beginOffsetPoint.rot.z(), posMidRel.pos.x(),
+                           posMidRel.pos.y(), posMidRel.pos.z(),
+                           (posMidRel.rot.x() - posBeginRel.rot.x() +
+                            pointSet.beginOffsetPoint.rot.x()),
+                           (posMidRel.rot.y() - posBeginRel.rot.y() +
+                            pointSet.beginOffsetPoint.rot.y()),
+                           (posMidRel.rot.z() - posBeginRel.rot.z() +
+                            pointSet.beginOffsetPoint.rot.z()),
+                           dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName, sUcsName,
+                           dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
+                           nIOBit, nIOState, strCmdID);
+        } else { // 正向
+            // 抬高
+            point = posBeginRel;
+            point.rot.setX(pointSet.beginOffsetPoint.rot.x());
+            point.rot.setY(pointSet.beginOffsetPoint.rot.y());
+            point.rot.setZ(pointSet.beginOffsetPoint.rot.z());
+            point = point.PosRelByTool(defaultDirection, defaultOffset);
+            nMoveType = 1;
+            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
+                          point.pos.z(), point.rot.x(), point.rot.y(),
+                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+                          nIsSeek, nIOBit, nIOState, strCmdID);
+            // 改变位姿
+            posBeginRel += beginOffset;
+            posEndRel += endOffset;
+            posMidRel += midOffset;
+            point = posBeginRel;
+            point = point.PosRelByTool(defaultDirection, defaultOffset);
+            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
+                          point.pos.z(), point.rot.x(), point.rot.y(),
+                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+                          nIsSeek, nIOBit, nIOState, strCmdID);
+            // 压低
+            point = posBeginRel;
+            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
+                          point.pos.z(), point.rot.x(), point.rot.y(),
+                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
+                          nIsSeek, nIOBit, nIOState, strCmdID);
+            // 正向圆弧运动
+            nMoveType = 2;
+            HRIF_WayPoint2(
+                0, 0, nMoveType, posEndRel.pos.x(), posEndRel.pos.y(),
+                posEndRel.pos.z(), posEndRel.rot.x(), posEndRel.rot.y(),
+                posEndRel.rot.z(), posMidRel.pos.x(), posMidRel.pos.y(),
+                posMidRel.pos.z(), posMidRel.rot.x(), posMidRel.rot.y(),
+                posMidRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
+                nIOBit, nIOState, strCmdID);
+        }
+    }
+    return count % 2 == 0
+               ? Point{posEndRel.pos.x(), posEndRel.pos.y(), posEndRel.pos.z(),
+                       posEndRel.rot.x(), posEndRel.rot.y(), posEndRel.rot.z()}
+               : Point{posBeginRel.pos.x(),
+                       posBeginRel.pos.y(),
+                       posBeginRel.pos.z(),
+                       pointSet.beginOffsetPoint.rot.x(),
+                       pointSet.beginOffsetPoint.rot.y(),
+                       pointSet.beginOffsetPoint.rot.z()};
+}
+
+void HansRobot::MoveZLine(const Craft &craft) {
+    // 定义运动类型
+    int nMoveType = 1;
+    // 定义关节目标位置
+    double dJ1 = 0;
+    double dJ2 = 0;
+    double dJ3 = 0;
+    double dJ4 = 0;
+    double dJ5 = 0;
+    double dJ6 = 0;
+    // 定义工具坐标变量
+    string sTcpName = "TCP_AGP";
+    // 定义用户坐标变量
+    string sUcsName = "Base";
+    // 定义运动速度
+    double dVelocity = craft.moveSpeed;
+    // 定义运动加速度
+    double dAcc = 100;
+    // 定义过渡半径
+    double dRadius = 1;
+    // 定义是否使用关节角度
+    int nIsUseJoint = 1;
+    // 定义是否使用检测 DI 停止
+    int nIsSeek = 0;
+    // 定义检测的 DI 索引
+    int nIOBit = 0;
+    // 定义检测的 DI 状态
+    int nIOState = 0;
+    // 定义路点 ID
+    string strCmdID = "0";
+
+    // 偏移
+    OffsetDirection direction = craft.offsetDirection;
+    double offset = craft.offsetDistance;
+    int size = craft.offsetCount + 1;
+    float factor = 1.0 / size;
+
+    Point point = pointSet.beginPoint;
+    Point pointRel;
+    Point pointOffset;
+    pointOffset.pos = pointSet.auxPoint.pos - pointSet.beginPoint.pos;
+    pointOffset.rot = pointSet.auxPoint.rot - pointSet.beginPoint.rot;
+    for (int i = 1; i <= size; ++i) {
+        point += pointOffset;
+        pointRel = point.PosRelByTool(direction, offset);
+        HRIF_WayPoint(0, 0, nMoveType, pointRel.pos.x(), pointRel.pos.y(),
+                      pointRel.pos.z(), pointRel.rot.x(), pointRel.rot.y(),
+                      pointRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                      sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
+                      nIOBit, nIOState, strCmdID);
+        point =
+            Point::scale(pointSet.beginPoint, pointSet.endPoint, factor * i);
+        pointRel = point.PosRelByTool(direction, offset);
+        HRIF_WayPoint(0, 0, nMoveType, pointRel.pos.x(), pointRel.pos.y(),
+                      pointRel.pos.z(), pointRel.rot.x(), pointRel.rot.y(),
+                      pointRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                      sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
+                      nIOBit, nIOState, strCmdID);
+    }
+}
+
+void HansRobot::MoveSpiralLine(const Craft &craft) {
+    // 定义运动类型
+    int nMoveType = 2;
+    // 定义关节目标位置
+    double dJ1 = 0;
+    double dJ2 = 0;
+    double dJ3 = 0;
+    double dJ4 = 0;
+    double dJ5 = 0;
+    double dJ6 = 0;
+    // 定义工具坐标变量
+    string sTcpName = "TCP_AGP";
+    // 定义用户坐标变量
+    string sUcsName = "Base";
+    // 定义运动速度
+    double dVelocity = craft.moveSpeed;
+    // 定义运动加速度
+    double dAcc = 100;
+    // 定义过渡半径
+    double dRadius = 1;
+    // 定义是否使用关节角度
+    int nIsUseJoint = 1;
+    // 定义是否使用检测 DI 停止
+    int nIsSeek = 0;
+    // 定义检测的 DI 索引
+    int nIOBit = 0;
+    // 定义检测的 DI 状态
+    int nIOState = 0;
+    // 定义路点 ID
+    string strCmdID = "0";
+
+    // 偏移
+    OffsetDirection direction = craft.offsetDirection;
+    double offset = craft.offsetDistance;
+    int size = craft.offsetCount + 1;
+    float factor = 1.0 / (2 * size + 2);
+
+    // 定义空间目标位置
+    Point pointEnd =
+        Point::scale(pointSet.beginPoint, pointSet.endPoint, factor * 4);
+    QVector3D O = Point::calculateCircumcenter(
+        pointSet.beginPoint.pos, pointSet.auxPoint.pos, pointEnd.pos);
+    Point pointAux =
+        Point::scale(pointSet.beginPoint, pointSet.endPoint, factor * 2);
+    QVector3D temp = (pointAux.pos - O);
+    QVector3D upOffset =
+        temp.normalized() * pointSet.beginPoint.pos.distanceToPoint(O) - temp;
+    QVector3D downOffset = temp * (-0.5);
+    pointAux.pos += upOffset;
+    Point pointEndRel = pointEnd.PosRelByTool(direction, offset);
+    Point pointAuxRel = pointAux.PosRelByTool(direction, offset);
+    // 执行路点运动
+    HRIF_WayPoint2(0, 0, nMoveType, pointEndRel.pos.x(), pointEndRel.pos.y(),
+                   pointEndRel.pos.z(), pointEndRel.rot.x(),
+                   pointEndRel.rot.y(), pointEndRel.rot.z(),
+                   pointAuxRel.pos.x(), pointAuxRel.pos.y(),
+                   pointAuxRel.pos.z(), pointAuxRel.rot.x(),
+                   pointAuxRel.rot.y(), pointAuxRel.rot.z(), dJ1, dJ2, dJ3, dJ4,
+                   dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+                   nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+    for (int i = 1; i < size; ++i) {
+        // 小圆弧
+        pointEnd = Point::scale(pointSet.beginPoint, pointSet.endPoint,
+                                factor * (2 * i));
+        pointAux = Point::scale(pointSet.beginPoint, pointSet.endPoint,
+                                factor * (2 * i + 1));
+        pointAux.pos += downOffset;
+        pointEndRel = pointEnd.PosRelByTool(direction, offset);
+        pointAuxRel = pointAux.PosRelByTool(direction, offset);
+        HRIF_WayPoint2(
+            0, 0, nMoveType, pointEndRel.pos.x(), pointEndRel.pos.y(),
+            pointEndRel.pos.z(), pointEndRel.rot.x(), pointEndRel.rot.y(),
+            pointEndRel.rot.z(), pointAuxRel.pos.x(), pointAuxRel.pos.y(),
+            pointAuxRel.pos.z(), pointAuxRel.rot.x(), pointAuxRel.rot.y(),
+            pointAuxRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+            sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek, nIOBit,
+            nIOState, strCmdID);
+        // 大圆弧
+        pointEnd = Point::scale(pointSet.beginPoint, pointSet.endPoint,
+                                factor * (2 * i + 4));
+        pointAux = Point::scale(pointSet.beginPoint, pointSet.endPoint,
+                                factor * (2 * i + 2));
+        pointAux.pos += upOffset;
+        pointEndRel = pointEnd.PosRelByTool(direction, offset);
+        pointAuxRel = pointAux.PosRelByTool(direction, offset);
+        HRIF_WayPoint2(
+            0, 0, nMoveType, pointEndRel.pos.x(), pointEndRel.pos.y(),
+            pointEndRel.pos.z(), pointEndRel.rot.x(), pointEndRel.rot.y(),
+            pointEndRel.rot.z(), pointAuxRel.pos.x(), pointAuxRel.pos.y(),
+            pointAuxRel.pos.z(), pointAuxRel.rot.x(), pointAuxRel.rot.y(),
+            pointAuxRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+            sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek, nIOBit,
+            nIOState, strCmdID);
+    }
+}
+
+void HansRobot::Run(const Craft &craft, bool isAGPRun) {
+    // QThread::msleep(100);
+    MoveBefore(craft, isAGPRun);
+    // 偏移
+    OffsetDirection direction = craft.offsetDirection;
+    double offset = craft.offsetDistance;
+    Point point = pointSet.auxEndPoint.PosRelByTool(direction, offset);
+    // 选择打磨方式
+    switch (craft.way) {
+    case PolishWay::ArcWay:
+        MoveArc(craft);
+        break;
+    case PolishWay::LineWay:
+        MoveLine(craft);
+        break;
+    case PolishWay::RegionArcWay1:
+        point = MoveRegionArc1(craft);
+        point = point.PosRelByTool(defaultDirection, defaultOffset);
+        break;
+    case PolishWay::RegionArcWay2:
+        point = MoveRegionArc2(craft);
+        point = point.PosRelByTool(defaultDirection, defaultOffset);
+        break;
+    case PolishWay::ZLineWay:
+        MoveZLine(craft);
+        break;
+    case PolishWay::SpiralLineWay:
+        MoveSpiralLine(craft);
+        break;
+    default:
+        break;
+    }
+    MoveAfter(craft, point);
+}
+*/
+bool HansRobot::Stop() {
+    // 机器人停止
+    isStop.store(true);
+    RunMetrics::AddStop();
+    HRIF_GrpStop(0, 0);
+    // HRIF_StopScript(0);
+    // AGP停止
+    std::lock_guard<std::recursive_mutex> lock(agpMutex);
+    if (agp != nullptr) {
+        AGP_CALL(SetSpeed, 0);
+    }
+    // 机器人复位
+    HRIF_GrpReset(0, 0);
+    // AGP复位
+    if (agp != nullptr) {
+        AGP_CALL(Control, FUNC::RESET);
+    }
+    // 自由拖拽复位
+    isTeach = false;
+
+    return true;
+}
+
+bool HansRobot::AbortMotion() {
+    // 停止并复位机器人，打磨头和停止标志保持不变
+    return HRIF_GrpStop(0, 0) == 0 && HRIF_GrpReset(0, 0) == 0;
+}
+
+bool HansRobot::GetJointPos(double *joints) {
+    int nRet = HRIF_ReadActJointPos(0, 0, joints[0], joints[1], joints[2],
+                                    joints[3], joints[4], joints[5]);
+    return nRet == 0;
+}
+
+int HansRobot::GetCurrentSegment() {
+    // 轨迹运动中路点 ID 不更新，直接使用轨迹的路径段编号
+    if (isPathMoving.load()) {
+        return Robot::GetCurrentSegment();
+    }
+    // 路点 ID 即下发时的路径段编号
+    string strCurWaypointID;
+    int nRet = HRIF_ReadCurWaypointID(0, 0, strCurWaypointID);
+    bool ok = false;
+    int id = QString::fromStdString(strCurWaypointID).toInt(&ok);
+    if (nRet != 0 || !ok) {
+        return Robot::GetCurrentSegment();
+    }
+    return id;
+}
+
+bool HansRobot::SetSpeedOverride(double ratio) {
+    ratio = qBound(0.01, ratio, 1.0);
+    std::lock_guard<std::mutex> lock(overrideMutex);
+    speedOverride = ratio;
+    if (isPathMoving.load()) {
+        // 轨迹运动使用单独的速度比，范围 1~100
+        return HRIF_SetMovePathOverride(0, 0, ratio * 100) == 0;
+    }
+    if (HRIF_SetOverride(0, 0, ratio) != 0) {
+        return false;
+    }
+    globalOverride = ratio;
+    return true;
+}
+
+void HansRobot::BeginPathOverride() {
+    std::lock_guard<std::mutex> lock(overrideMutex);
+    isPathMoving.store(true);
+    // 轨迹速度比从当前速度比开始，不沿用上一条轨迹的值
+    HRIF_SetMovePathOverride(0, 0, speedOverride * 100);
+}
+
+void HansRobot::EndPathOverride() {
+    std::lock_guard<std::mutex> lock(overrideMutex);
+    isPathMoving.store(false);
+    HRIF_SetMovePathOverride(0, 0, 100);
+    // 轨迹运动中请求的速度比只写入了轨迹速度比，同步到全局速度比
+    if (globalOverride != speedOverride &&
+        HRIF_SetOverride(0, 0, speedOverride) == 0) {
+        globalOverride = speedOverride;
+    }
+}
+
+bool HansRobot::MoveTcpPath(const QVector<Point> &points, double dVelocity,
+                            double dAcc) {
+    // 轨迹运动需从静止开始，等待之前的路点运动完成
+    while (IsRobotMoved()) {
+        if (isStop.load()) {
+            return true;
+        }
+        QThread::msleep(20);
+    }
+    // 定义轨迹名称
+    string sPathName = "SWR_Spline";
+    // 定义工具坐标变量
+    string sTcpName = "TCP_AGP";
+    // 定义用户坐标变量
+    string sUcsName = "Base";
+    // 定义运动加加速度
+    double dJerk = dAcc * 10;
+    HRIF_DelPath(0, 0, sPathName);
+    if (HRIF_InitMovePathL(0, 0, sPathName, dVelocity, dAcc, dJerk, sUcsName,
+                           sTcpName) != 0) {
+        return false;
+    }
+    for (const Point &point : points) {
+        if (HRIF_PushMovePathL(0, 0, sPathName, point.pos.x(), point.pos.y(),
+                               point.pos.z(), point.rot.x(), point.rot.y(),
+                               point.rot.z()) != 0) {
+            return false;
+        }
+    }
+    if (HRIF_EndPushMovePath(0, 0, sPathName) != 0) {
+        return false;
+    }
+    // 等待轨迹计算完成（状态 3 完成，5 出错）
+    int nStateJ = 0;
+    int nErrorCodeJ = 0;
+    int nStateL = 0;
+    int nErrorCodeL = 0;
+    for (int i = 0; i < 500; ++i) {
+        if (HRIF_ReadPathState(0, 0, sPathName, nStateJ, nErrorCodeJ, nStateL,
+                               nErrorCodeL) != 0 ||
+            nStateL == 5) {
+            return false;
+        }
+        if (nStateL == 3) {
+            break;
+        }
+        QThread::msleep(20);
+    }
+    if (nStateL != 3) {
+        return false;
+    }
+    // 轨迹速度比在开始运动前设定
+    BeginPathOverride();
+    if (HRIF_MovePathL(0, 0, sPathName) != 0) {
+        EndPathOverride();
+        return false;
+    }
+    // 等待轨迹运动完成，之后的路点才能下发
+    double dProcess = 0;
+    int nIndex = 0;
+    while (!isStop.load()) {
+        if (HRIF_ReadTrackProcess(0, 0, dProcess, nIndex) == 0 &&
+            dProcess > 0.999999) {
+            break;
+        }
+        QThread::msleep(20);
+    }
+    EndPathOverride();
+    return true;
+}
+
+int HansRobot::Capabilities() const {
+    return PathUploadCapability | ServoCapability;
+}
+
+bool HansRobot::ServoTcpPath(const QVector<Point> &points, double period) {
+    // 伺服运动需从静止开始，等待之前的路点运动完成
+    while (IsRobotMoved()) {
+        if (isStop.load()) {
+            return true;
+        }
+        QThread::msleep(20);
+    }
+    // 伺服位姿为 TCP_AGP 在基坐标系下的位姿
+    if (HRIF_SetTCPByName(0, 0, "TCP_AGP") != 0) {
+        return false;
+    }
+    vector<double> vecTcp(6, 0);
+    vector<double> vecUcs(6, 0);
+    if (HRIF_ReadCurTCP(0, 0, vecTcp[0], vecTcp[1], vecTcp[2], vecTcp[3],
+                        vecTcp[4], vecTcp[5]) != 0 ||
+        HRIF_StartServo(0, 0, period, servoLookahead) != 0) {
+        return false;
+    }
+    BeginPathOverride();
+    using namespace std::chrono;
+    const steady_clock::duration step =
+        duration_cast<steady_clock::duration>(duration<double>(period));
+    steady_clock::time_point next = steady_clock::now();
+    for (int i = 0; i < points.size() && !isStop.load(); ++i) {
+        const Point &point = points.at(i);
+        vector<double> vecCoord{point.pos.x(), point.pos.y(), point.pos.z(),
+                                point.rot.x(), point.rot.y(), point.rot.z()};
+        if (HRIF_PushServoP(0, 0, vecCoord, vecUcs, vecTcp) != 0) {
+            EndPathOverride();
+            // 首点失败时机器人未动，可改为逐点下发；中途失败则停止运行
+            if (i > 0) {
+                Stop();
+                return true;
+            }
+            return false;
+        }
+        next += step;
+        std::this_thread::sleep_until(next);
+    }
+    // 等待伺服运动完成，之后的路点才能下发
+    while (!isStop.load() && IsRobotMoved()) {
+        QThread::msleep(20);
+    }
+    EndPathOverride();
+    return true;
+}
+
+void HansRobot::OpenWeb(QString ip) {
+    QDesktopServices::openUrl(QUrl("http://" + ip + "/dist"));
+}
+
+void HansRobot::MoveTcpL(const Point &point, double velocity, double acc,
+                         double radius) {
+    // 定义运动类型
+    int nMoveType = 1;
+    // 定义关节目标位置
+    double dJ1 = 0;
+    double dJ2 = 0;
+    double dJ3 = 0;
+    double dJ4 = 0;
+    double dJ5 = 0;
+    double dJ6 = 0;
+    // 定义工具坐标变量
+    string sTcpName = "TCP_AGP";
+    // 定义用户坐标变量
+    string sUcsName = "Base";
+    // 定义运动速度
+    double dVelocity = velocity;
+    // 定义运动加速度
+    double dAcc = 1000;
+    // 定义过渡半径
+    double dRadius = radius;
+    // 定义是否使用关节角度
+    int nIsUseJoint = 1;
+    // 定义是否使用检测 DI 停止
+    int nIsSeek = 0;
+    // 定义检测的 DI 索引
+    int nIOBit = 0;
+    // 定义检测的 DI 状态
+    int nIOState = 0;
+    // 定义路点 ID（路径段编号）
+    string strCmdID = std::to_string(segmentIndex.load());
+    // 直线运动
+    HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(), point.pos.z(),
+                  point.rot.x(), point.rot.y(), point.rot.z(), dJ1, dJ2, dJ3,
+                  dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
+                  nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
+}
+
+void HansRobot::MoveTcpC(const Point &auxPoint, const Point &endPoint,
+                         double velocity, double acc, double radius) {
+    // 定义运动类型
+    int nMoveType = 2;
+    // 定义关节目标位置
+    double dJ1 = 0;
+    double dJ2 = 0;
+    double dJ3 = 0;
+    double dJ4 = 0;
+    double dJ5 = 0;
+    double dJ6 = 0;
+    // 定义工具坐标变量
+    string sTcpName = "TCP_AGP";
+    // 定义用户坐标变量
+    string sUcsName = "Base";
+    // 定义运动速度
+    double dVelocity = velocity;
+    // 定义运动加速度
+    double dAcc = 1000;
+    // 定义过渡半径
+    double dRadius = radius;
+    // 定义是否使用关节角度
+    int nIsUseJoint = 1;
+    // 定义是否使用检测 DI 停止
+    int nIsSeek = 0;
+    // 定义检测的 DI 索引
+    int nIOBit = 0;
+    // 定义检测的 DI 状态
+    int nIOState = 0;
+    // 定义路点 ID（路径段编号）
+    string strCmdID = std::to_string(segmentIndex.load());
+    // 圆弧运动
+    HRIF_WayPoint2(0, 0, nMoveType, endPoint.pos.x(), endPoint.pos.y(),
+                   endPoint.pos.z(), endPoint.rot.x(), endPoint.rot.y(),
+                   endPoint.rot.z(), auxPoint.pos.x(), auxPoint.pos.y(),
+                   auxPoint.pos.z(), auxPoint.rot.x(), auxPoint.rot.y(),
+                   auxPoint.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
+                   sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
+                   nIOBit, nIOState, strCmdID);
+}
+
+// 插件入口
+SWR_ROBOT_PLUGIN(HansRobot)
@@ -0,0 +1,387 @@
+﻿#include <QThread>
+#include <QtMath>
+#include <chrono>
+#include <thread>
+
+#include "callstats.h"
+#include "jakarobot.h"
+#include "robotplugin.h"
+
+// 节卡 SDK 调用计时
+#define JAKA_CALL(method, ...)                                                 \
+    CALL_STATS("JAKAZuRobot::" #method, jakaRobot.method(__VA_ARGS__))
+
+// 在途运动上限：保证控制器始终有后续运动可以过渡，又不会积压过多
+constexpr int maxMotionsInFlight = 8;
+// 队列满时查询状态的间隔，ms
+constexpr int pipelinePollInterval = 5;
+// 判断到达终点的距离，mm
+constexpr double reachTolerance = 1;
+// 状态数据相对下发的滞后，期间不以到位标志判断完成
+constexpr std::chrono::milliseconds statusDelay(100);
+
+JakaRobot::JakaRobot() { isSegmentTracked = true; }
+
+JakaRobot::~JakaRobot() {
+    JAKA_CALL(drag_mode_enable, FALSE);
+    // jakaRobot.disable_robot();
+    // jakaRobot.login_out();
+}
+
+bool JakaRobot::RobotConnect(QString robotIP) {
+    std::string ip = robotIP.toStdString();
+    const char *hostname = ip.c_str();
+    // 连接机器人
+    errno_t ret = JAKA_CALL(login_in, hostname);
+    if (ret != ERR_SUCC) {
+        return false;
+    }
+    // 机器人上电
+    // jakaRobot.power_on();
+    // 机器人使能
+    // jakaRobot.enable_robot();
+    // 设置速度比
+    // jakaRobot.set_rapidrate(1.0);
+    return true;
+}
+
+bool JakaRobot::GetTcpPoint(Point &point) {
+    CartesianPose tcp_pos;
+    errno_t ret = JAKA_CALL(get_tcp_position, &tcp_pos);
+    if (ret != ERR_SUCC) {
+        return false;
+    }
+    point.pos.setX(tcp_pos.tran.x);
+    point.pos.setY(tcp_pos.tran.y);
+    point.pos.setZ(tcp_pos.tran.z);
+    point.rot.setX(qRound(qRadiansToDegrees(tcp_pos.rpy.rx) * 1000.0) / 1000.0);
+    point.rot.setY(qRound(qRadiansToDegrees(tcp_pos.rpy.ry) * 1000.0) / 1000.0);
+    point.rot.setZ(qRound(qRadiansToDegrees(tcp_pos.rpy.rz) * 1000.0) / 1000.0);
+    return true;
+}
+
+bool JakaRobot::RobotTeach(int pos) {
+    if (!isTeach) {
+        if (agp != nullptr) {
+            std::lock_guard<std::recursive_mutex> lock(agpMutex);
+            // 设置AGP默认参数
+            AGP_CALL(Control, FUNC::RESET);
+            AGP_CALL(Control, FUNC::ENABLE);
+            AGP_CALL(SetMode, MODE::PosMode);
+            AGP_CALL(SetPos, pos * 100);
+            AGP_CALL(SetForce, 200);
+            AGP_CALL(SetTouchForce, 0);
+            AGP_CALL(SetRampTime, 0);
+            if (!IsAGPEnabled()) {
+                AGP_CALL(Control, FUNC::ENABLE);
+            }
+        }
+        // if (!IsRobotElectrified()) {
+        //     // 机器人上电
+        //     jakaRobot.power_on();
+        //     if (!IsRobotElectrified()) {
+        //         return isTeach;
+        //     }
+        // }
+        if (!IsRobotEnabled()) {
+            // 机器人使能
+            JAKA_CALL(enable_robot);
+            // QThread::msleep(1500);
+            if (!IsRobotEnabled()) {
+                return isTeach;
+            }
+        }
+        // 启用自由拖拽
+        errno_t ret = JAKA_CALL(drag_mode_enable, TRUE);
+        if (ret == ERR_SUCC) {
+            isTeach = true;
+        }
+    } else {
+        // 关闭自由拖拽
+        errno_t ret = JAKA_CALL(drag_mode_enable, FALSE);
+        if (ret == ERR_SUCC) {
+            isTeach = false;
+        }
+    }
+    return isTeach;
+}
+
+bool JakaRobot::CloseFreeDriver() {
+    // 关闭自由拖拽
+    errno_t ret = JAKA_CALL(drag_mode_enable, FALSE);
+    if (ret == ERR_SUCC) {
+        isTeach = false;
+        return true;
+    }
+    return false;
+}
+
+bool JakaRobot::Stop() {
+    // 机器人停止
+    isStop.store(true);
+    RunMetrics::AddStop();
+    JAKA_CALL(motion_abort);
+    {
+        // 在途运动随停止一并取消
+        std::lock_guard<std::recursive_mutex> lock(motionMutex);
+        motions.clear();
+    }
+    // AGP停止
+    std::lock_guard<std::recursive_mutex> lock(agpMutex);
+    if (agp != nullptr) {
+        AGP_CALL(SetSpeed, 0);
+    }
+    // 机器人复位
+    // jakaRobot.disable_robot();
+    // AGP复位
+    if (agp != nullptr) {
+        AGP_CALL(Control, FUNC::RESET);
+    }
+    // 自由拖拽复位
+    isTeach = false;
+
+    return true;
+}
+
+bool JakaRobot::IsRobotElectrified() {
+    RobotStatus robstatus;
+    JAKA_CALL(get_robot_status, &robstatus);
+
+    return robstatus.powered_on;
+}
+
+bool JakaRobot::IsRobotEnabled() {
+    RobotStatus robstatus;
+    JAKA_CALL(get_robot_status, &robstatus);
+
+    return robstatus.enabled;
+}
+
+bool JakaRobot::IsRobotMoved() {
+    // 有在途运动即在运动，没有时再查询到位标志（点动、伺服运动）
+    if (UpdateMotions()) {
+        return true;
+    }
+    BOOL in_pos;
+    JAKA_CALL(is_in_pos, &in_pos);
+
+    return !in_pos;
+}
+
+void JakaRobot::OpenWeb(QString ip) {}
+
+bool JakaRobot::GetJointPos(double *joints) {
+    JointValue jointPos;
+    errno_t ret = JAKA_CALL(get_joint_position, &jointPos);
+    if (ret != ERR_SUCC) {
+        return false;
+    }
+    for (int i = 0; i < 6; ++i) {
+        joints[i] = qRadiansToDegrees(jointPos.jVal[i]);
+    }
+    return true;
+}
+
+int JakaRobot::GetCurrentSegment() {
+    std::lock_guard<std::recursive_mutex> lock(motionMutex);
+    // 最早未完成的运动即正在执行的运动
+    if (UpdateMotions()) {
+        return motions.front().segment;
+    }
+    return Robot::GetCurrentSegment();
+}
+
+bool JakaRobot::SetSpeedOverride(double ratio) {
+    return JAKA_CALL(set_rapidrate, qBound(0.01, ratio, 1.0)) == ERR_SUCC;
+}
+
+bool JakaRobot::AbortMotion() {
+    errno_t ret = JAKA_CALL(motion_abort);
+    // 在途运动随中止一并取消
+    std::lock_guard<std::recursive_mutex> lock(motionMutex);
+    motions.clear();
+    return ret == ERR_SUCC;
+}
+
+int JakaRobot::Capabilities() const { return ServoCapability; }
+
+bool JakaRobot::ServoTcpPath(const QVector<Point> &points, double period) {
+    // 伺服运动需从静止开始，等待之前的路点运动完成
+    while (IsRobotMoved()) {
+        if (isStop.load()) {
+            return true;
+        }
+        QThread::msleep(20);
+    }
+    // 控制器插补周期为 8ms，下发周期取其整数倍
+    unsigned int stepNum = qMax(1, qRound(period / 0.008));
+    if (JAKA_CALL(servo_move_enable, TRUE) != ERR_SUCC) {
+        JAKA_CALL(servo_move_enable, FALSE);
+        return false;
+    }
+    using namespace std::chrono;
+    const steady_clock::duration step = microseconds(stepNum * 8000);
+    steady_clock::time_point next = steady_clock::now();
+    int failedIndex = -1;
+    for (int i = 0; i < points.size() && !isStop.load(); ++i) {
+        const Point &point = points.at(i);
+        CartesianPose pos;
+        pos.tran.x = point.pos.x();
+        pos.tran.y = point.pos.y();
+        pos.tran.z = point.pos.z();
+        pos.rpy.rx = qDegreesToRadians(point.rot.x());
+        pos.rpy.ry = qDegreesToRadians(point.rot.y());
+        pos.rpy.rz = qDegreesToRadians(point.rot.z());
+        if (JAKA_CALL(servo_p, &pos, MoveMode::ABS, stepNum) != ERR_SUCC) {
+            failedIndex = i;
+            break;
+        }
+        next += step;
+        std::this_thread::sleep_until(next);
+    }
+    // 与华沿、新松一致，等待末点到位后再退出伺服模式并返回
+    if (failedIndex < 0) {
+        while (!isStop.load() && IsRobotMoved()) {
+            QThread::msleep(20);
+        }
+    }
+    JAKA_CALL(servo_move_enable, FALSE);
+    // 首点失败时机器人未动，可改为逐点下发；中途失败则停止运行
+    if (failedIndex == 0) {
+        return false;
+    } else if (failedIndex > 0) {
+        Stop();
+    }
+    return true;
+}
+
+void JakaRobot::MoveTcpL(const Point &point, double dVelocity, double dAcc,
+                         double dRadius) {
+    if (!WaitPipeline()) {
+        return;
+    }
+    CartesianPose pos;
+    pos.tran.x = point.pos.x();
+    pos.tran.y = point.pos.y();
+    pos.tran.z = point.pos.z();
+    pos.rpy.rx = qDegreesToRadians(point.rot.x());
+    pos.rpy.ry = qDegreesToRadians(point.rot.y());
+    pos.rpy.rz = qDegreesToRadians(point.rot.z());
+
+    errno_t ret = JAKA_CALL(linear_move, &pos, MoveMode::ABS, FALSE, dVelocity,
+                            dAcc, 0.1, NULL, 3.14 / 10, 12.56 / 10);
+    if (ret == ERR_SUCC) {
+        AddMotion(point, false);
+    }
+}
+
+void JakaRobot::MoveTcpC(const Point &auxPoint, const Point &endPoint,
+                         double dVelocity, double dAcc, double dRadius) {
+    if (!WaitPipeline()) {
+        return;
+    }
+    CartesianPose midPos, endPos;
+    midPos.tran.x = auxPoint.pos.x();
+    midPos.tran.y = auxPoint.pos.y();
+    midPos.tran.z = auxPoint.pos.z();
+    midPos.rpy.rx = qDegreesToRadians(auxPoint.rot.x());
+    midPos.rpy.ry = qDegreesToRadians(auxPoint.rot.y());
+    midPos.rpy.rz = qDegreesToRadians(auxPoint.rot.z());
+
+    endPos.tran.x = endPoint.pos.x();
+    endPos.tran.y = endPoint.pos.y();
+    endPos.tran.z = endPoint.pos.z();
+    endPos.rpy.rx = qDegreesToRadians(endPoint.rot.x());
+    endPos.rpy.ry = qDegreesToRadians(endPoint.rot.y());
+    endPos.rpy.rz = qDegreesToRadians(endPoint.rot.z());
+
+    errno_t ret = JAKA_CALL(circular_move, &endPos, &midPos, MoveMode::ABS,
+                            FALSE, dVelocity, dAcc, 0.1, NULL);
+    if (ret == ERR_SUCC) {
+        AddMotion(endPoint, true);
+    }
+}
+
+bool JakaRobot::UpdateMotions() {
+    std::lock_guard<std::recursive_mutex> lock(motionMutex);
+    if (motions.empty()) {
+        return false;
+    }
+    RobotStatus status;
+    if (JAKA_CALL(get_robot_status, &status) != ERR_SUCC) {
+        return true;
+    }
+    // 出错、碰撞或急停时控制器不再执行后续运动
+    if (status.errcode != 0 || status.protective_stop != 0 ||
+        status.emergency_stop != 0) {
+        motions.clear();
+        return false;
+    }
+    // 到位标志表示全部运动已完成，最后一个运动刚下发时状态可能尚未刷新
+    bool isSettled =
+        std::chrono::steady_clock::now() - motions.back().issued > statusDelay;
+    if (status.inpos != 0 && isSettled) {
+        motions.clear();
+        return false;
+    }
+    // 按 TCP 位置推进：到达终点附近，或直线运动已越过终点前的位置。
+    // 最后一个运动只按到位标志完成
+    QVector3D tcp(status.cartesiantran_position[0],
+                  status.cartesiantran_position[1],
+                  status.cartesiantran_position[2]);
+    while (motions.size() > 1) {
+        const Motion &motion = motions.front();
+        bool isReached = tcp.distanceToPoint(motion.end) <= reachTolerance;
+        QVector3D direction = motion.end - motion.begin;
+        double length = direction.length();
+        if (!isReached && !motion.isArc && length > reachTolerance) {
+            double along =
+                QVector3D::dotProduct(tcp - motion.begin, direction) / length;
+            isReached = along >= length - reachTolerance;
+        }
+        if (!isReached) {
+            break;
+        }
+        motions.pop_front();
+    }
+    return true;
+}
+
+bool JakaRobot::WaitPipeline() {
+    while (!isStop.load()) {
+        {
+            std::lock_guard<std::recursive_mutex> lock(motionMutex);
+            if (static_cast<int>(motions.size()) >= maxMotionsInFlight) {
+                UpdateMotions();
+            }
+            if (static_cast<int>(motions.size()) < maxMotionsInFlight) {
+                return true;
+            }
+        }
+        // 前面的运动完成后立即补充，控制器队列不会断流
+        QThread::msleep(pipelinePollInterval);
+    }
+    return false;
+}
+
+void JakaRobot::AddMotion(const Point &endPoint, bool isArc) {
+    std::lock_guard<std::recursive_mutex> lock(motionMutex);
+    Motion motion;
+    // 起点为上一个运动的终点，队列为空时为当前位置
+    Point current;
+    if (!motions.empty()) {
+        motion.begin = motions.back().end;
+    } else if (GetTcpPoint(current)) {
+        motion.begin = current.pos;
+    } else {
+        motion.begin = endPoint.pos;
+    }
+    motion.end = endPoint.pos;
+    motion.isArc = isArc;
+    motion.segment = segmentIndex.load();
+    motion.issued = std::chrono::steady_clock::now();
+    motions.push_back(motion);
+}
+
+// 插件入口
+SWR_ROBOT_PLUGIN(JakaRobot)
@@ -0,0 +1,286 @@
+﻿#include <QMouseEvent>
+#include <QPainter>
+#include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "logplot.h"
+
+// 通道名称及颜色
+static const char *channelNames[ChannelCount] = {"压力 N", "速度 mm/s",
+                                                 "转速 r/min", "偏差 mm"};
+static const QColor channelColors[ChannelCount] = {
+    QColor(200, 40, 40), QColor(30, 110, 200), QColor(40, 150, 60),
+    QColor(150, 80, 180)};
+
+LogPlot::LogPlot(QWidget *parent)
+    : QWidget(parent), axisMode(TimeAxis), viewBegin(0), viewEnd(0),
+      isDragging(false), dragX(0) {
+    setMinimumSize(400, 300);
+}
+
+bool LogPlot::Open(const QString &fileName) {
+    Close();
+    if (!reader.Open(fileName)) {
+        return false;
+    }
+    index.Build(reader);
+    ResetView();
+    return true;
+}
+
+void LogPlot::Close() {
+    index.Clear();
+    reader.Close();
+    viewBegin = viewEnd = 0;
+    update();
+}
+
+const RunLogReader &LogPlot::Reader() const { return reader; }
+
+void LogPlot::SetAxisMode(int mode) {
+    if (mode == axisMode) {
+        return;
+    }
+    axisMode = mode;
+    ResetView();
+}
+
+void LogPlot::ResetView() {
+    viewBegin = 0;
+    viewEnd = AxisLength();
+    update();
+}
+
+double LogPlot::AxisLength() const {
+    return axisMode == ArcAxis ? index.ArcLength() : index.Duration();
+}
+
+double LogPlot::BucketX(const RunLogBucket &bucket) const {
+    return axisMode == ArcAxis ? bucket.arc : bucket.time;
+}
+
+int LogPlot::FirstBucket(const QVector<RunLogBucket> &level, double x) const {
+    // 起点不大于 x 的最后一个桶
+    auto it = std::upper_bound(
+        level.cbegin(), level.cend(), x,
+        [this](double v, const RunLogBucket &b) { return v < BucketX(b); });
+    return qMax(0, int(it - level.cbegin()) - 1);
+}
+
+void LogPlot::Accumulate(int width, QVector<float> *colMin,
+                         QVector<float> *colMax) const {
+    // 从最粗的层开始，找到视图内桶数不少于像素列数的层
+    for (int l = index.LevelCount() - 1; l >= 0; --l) {
+        const QVector<RunLogBucket> &level = index.Level(l);
+        int begin = FirstBucket(level, viewBegin);
+        int end = FirstBucket(level, viewEnd) + 1;
+        if (end - begin < width) {
+            continue;
+        }
+        double span = viewEnd - viewBegin;
+        for (int i = begin; i < end; ++i) {
+            const RunLogBucket &bucket = level.at(i);
+            int px = qBound(0, int((BucketX(bucket) - viewBegin) / span * width),
+                            width - 1);
+            for (int c = 0; c < ChannelCount; ++c) {
+                if (bucket.min[c] > bucket.max[c]) {
+                    continue; // 该桶内无有效值
+                }
+                colMin[c][px] = qMin(colMin[c][px], bucket.min[c]);
+                colMax[c][px] = qMax(colMax[c][px], bucket.max[c]);
+            }
+        }
+        return;
+    }
+    // 放大到第0层也不足一列一桶，改用原始记录（数量有上限）
+    AccumulateRecords(width, colMin, colMax);
+}
+
+void LogPlot::AccumulateRecords(int width, QVector<float> *colMin,
+                                QVector<float> *colMax) const {
+    const QVector<RunLogBucket> &level = index.Level(0);
+    const RunLogBucket &first = level.at(FirstBucket(level, viewBegin));
+    const RunLogBucket &last = level.at(FirstBucket(level, viewEnd));
+    const float referencePos = reader.Header().referencePos;
+    double span = viewEnd - viewBegin;
+    double arc = first.arc;
+    for (qint64 i = qMax((qint64)1, first.first); i < last.first + last.count;
+         ++i) {
+        const RunLogRecord &record = reader.At(i);
+        const RunLogRecord &prev = reader.At(i - 1);
+        if (i > first.first) {
+            arc += RunLogIndex::Distance(record, prev);
+        }
+        double x = axisMode == ArcAxis ? arc : record.timestamp / 1e6;
+        if (x < viewBegin || x > viewEnd) {
+            continue;
+        }
+        int px = qBound(0, int((x - viewBegin) / span * width), width - 1);
+        for (int c = 0; c < ChannelCount; ++c) {
+            float v = RunLogIndex::Value(record, prev, c, referencePos);
+            if (v == v) {
+                colMin[c][px] = qMin(colMin[c][px], v);
+                colMax[c][px] = qMax(colMax[c][px], v);
+            }
+        }
+    }
+}
+
+QRect LogPlot::PlotRect() const {
+    return rect().adjusted(80, 10, -10, -24);
+}
+
+void LogPlot::ClampView() {
+    double length = AxisLength();
+    double span = qMin(viewEnd - viewBegin, length);
+    if (viewBegin < 0) {
+        viewBegin = 0;
+    }
+    if (viewBegin + span > length) {
+        viewBegin = length - span;
+    }
+    viewEnd = viewBegin + span;
+}
+
+void LogPlot::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+    if (!reader.IsOpen() || index.LevelCount() == 0 ||
+        viewEnd <= viewBegin) {
+        painter.drawText(rect(), Qt::AlignCenter, "无数据");
+        return;
+    }
+
+    QRect plot = PlotRect();
+    int width = plot.width();
+    const float inf = std::numeric_limits<float>::infinity();
+    QVector<float> colMin[ChannelCount];
+    QVector<float> colMax[ChannelCount];
+    for (int c = 0; c < ChannelCount; ++c) {
+        colMin[c].fill(inf, width);
+        colMax[c].fill(-inf, width);
+    }
+    Accumulate(width, colMin, colMax);
+
+    int stripHeight = plot.height() / ChannelCount;
+    for (int c = 0; c < ChannelCount; ++c) {
+        QRect strip(plot.left(), plot.top() + c * stripHeight, width,
+                    stripHeight - 6);
+        painter.setPen(Qt::lightGray);
+        painter.drawRect(strip);
+        painter.setPen(Qt::black);
+        painter.drawText(QRect(0, strip.top(), plot.left() - 4, strip.height()),
+                         Qt::AlignRight | Qt::AlignVCenter,
+                         channelNames[c]);
+
+        // 纵轴按视图内数据自动缩放
+        float lo = inf, hi = -inf;
+        for (int px = 0; px < width; ++px) {
+            lo = qMin(lo, colMin[c][px]);
+            hi = qMax(hi, colMax[c][px]);
+        }
+        if (lo > hi) {
+            continue;
+        }
+        if (hi - lo < 1e-3f) {
+            lo -= 0.5f;
+            hi += 0.5f;
+        }
+        float pad = (hi - lo) * 0.05f;
+        lo -= pad;
+        hi += pad;
+        painter.drawText(QRect(0, strip.top(), plot.left() - 4, 14),
+                         Qt::AlignRight, QString::number(hi, 'g', 4));
+        painter.drawText(
+            QRect(0, strip.bottom() - 14, plot.left() - 4, 14),
+            Qt::AlignRight, QString::number(lo, 'g', 4));
+
+        auto toY = [&strip, lo, hi](float v) {
+            return strip.bottom() - int((v - lo) / (hi - lo) * strip.height());
+        };
+        // 每列画一条竖线，并与前一列衔接，保证曲线连续
+        QVector<QLine> lines;
+        lines.reserve(width);
+        int prevMin = 0, prevMax = 0;
+        bool hasPrev = false;
+        for (int px = 0; px < width; ++px) {
+            if (colMin[c][px] > colMax[c][px]) {
+                hasPrev = false;
+                continue;
+            }
+            int yMax = toY(colMax[c][px]);
+            int yMin = toY(colMin[c][px]);
+            int top = yMax, bottom = yMin;
+            if (hasPrev) {
+                top = qMin(top, prevMin);
+                bottom = qMax(bottom, prevMax);
+            }
+            lines.append(QLine(plot.left() + px, top, plot.left() + px, bottom));
+            prevMin = yMin;
+            prevMax = yMax;
+            hasPrev = true;
+        }
+        painter.setPen(channelColors[c]);
+        painter.drawLines(lines);
+    }
+
+    // 横轴刻度
+    painter.setPen(Qt::black);
+    QString unit = axisMode == ArcAxis ? " mm" : " s";
+    QRect axis(plot.left(), plot.bottom() - 16, width, 20);
+    painter.drawText(axis, Qt::AlignLeft | Qt::AlignBottom,
+                     QString::number(viewBegin, 'f', 2) + unit);
+    painter.drawText(axis, Qt::AlignHCenter | Qt::AlignBottom,
+                     QString::number((viewBegin + viewEnd) / 2, 'f', 2) + unit);
+    painter.drawText(axis, Qt::AlignRight | Qt::AlignBottom,
+                     QString::number(viewEnd, 'f', 2) + unit);
+}
+
+void LogPlot::wheelEvent(QWheelEvent *event) {
+    QRect plot = PlotRect();
+    double span = viewEnd - viewBegin;
+    if (span <= 0 || plot.width() <= 0) {
+        return;
+    }
+    // 以光标位置为中心缩放
+    double anchor = viewBegin + (event->position().x() - plot.left()) /
+                                    plot.width() * span;
+    double factor = event->angleDelta().y() > 0 ? 0.8 : 1.25;
+    double minSpan = qMax(AxisLength() * 1e-6, 1e-3);
+    double newSpan = qBound(minSpan, span * factor, AxisLength());
+    viewBegin = anchor - (anchor - viewBegin) * newSpan / span;
+    viewEnd = viewBegin + newSpan;
+    ClampView();
+    update();
+    event->accept();
+}
+
+void LogPlot::mousePressEvent(QMouseEvent *event) {
+    if (event->button() == Qt::LeftButton) {
+        isDragging = true;
+        dragX = event->x();
+    }
+}
+
+void LogPlot::mouseMoveEvent(QMouseEvent *event) {
+    if (!isDragging || PlotRect().width() <= 0) {
+        return;
+    }
+    double shift = double(dragX - event->x()) / PlotRect().width() *
+                   (viewEnd - viewBegin);
+    dragX = event->x();
+    viewBegin += shift;
+    viewEnd += shift;
+    ClampView();
+    update();
+}
+
+void LogPlot::mouseReleaseEvent(QMouseEvent *event) {
+    if (event->button() == Qt::LeftButton) {
+        isDragging = false;
+    }
+}
+
+void LogPlot::mouseDoubleClickEvent(QMouseEvent *) { ResetView(); }
@@ -1,11 +1,14 @@
-﻿#include <QDebug>
-#include <QFile>
+﻿#include <QApplication>
+#include <QDebug>
+#include <QFileDialog>
 #include <QMessageBox>
 #include <QSettings>
-#include <QTextStream>
 #include <QThread>
 
+#include "callstats.h"
 #include "mainwindow.h"
+#include "robotplugin.h"
+#include "simrobot.h"
 #include "ui_mainwindow.h"
 
 const QColor defaultColor(173, 49, 34);
@@ -14,80 +17,65 @@ const QColor goldColor("gold");
 const QColor greyColor("grey");
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), ui(new Ui::MainWindow), lastPageIdx(0),
-      currCraftIdx(0) {
+    : QMainWindow(parent), ui(new Ui::MainWindow), robot(nullptr),
+      lastPageIdx(0), currCraftIdx(-1) {
     ui->setupUi(this);
     InitButtons();
+    // 按运行参数加载机器人后端，失败时使用仿真机器人，界面仍可编辑工艺
+    QString settingsFile =
+        QCoreApplication::applicationDirPath() + "/settings.ini";
+    QString backend = RobotFactory::Backend(settingsFile);
+    QString error;
+    robot = RobotFactory::Create(backend, error);
+    if (robot == nullptr) {
+        robot = new SimRobot();
+        QMessageBox::warning(NULL, "提示", error + "\n已改用仿真机器人");
+    }
+    QSettings settings(settingsFile, QSettings::IniFormat);
+    settings.setIniCodec("UTF-8");
+    settings.beginGroup("Robot");
+    QString robotIP = settings.value("IP").toString();
+    QString agpIP = settings.value("AGPIP").toString();
+    settings.endGroup();
+    if (!robotIP.isEmpty()) {
+        ui->leRobotIP->setText(robotIP);
+    }
+    if (!agpIP.isEmpty()) {
+        ui->leAGPIP->setText(agpIP);
+    }
     // ui->lblAddOffsetCount->setVisible(false);
     // ui->leAddOffsetCount->setVisible(false);
-    // 读取工艺参数文件
-    QString fileName = QCoreApplication::applicationDirPath();
+    // 打开工艺参数库
+    QString dirName = QCoreApplication::applicationDirPath();
     // QString fileName =
     //     QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
-    fileName += "/config.ini";
-    if (!QFile::exists(fileName)) {
-        // 打开文件用于写入，如果文件不存在则创建它
-        QFile file(fileName);
-        if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            QTextStream out(&file);
-            out.setCodec("UTF-8"); // 设置编码，确保文本文件以UTF-8编码保存
-            // 将字符串写入文件
-            out << QString(
-                "[CraftParameter]\nsize=1\n1\\CraftName=\\x4e00\n1\\PolishMode="
-                "0\n1\\PolishWay=0\n1\\TeachingPointReferencePosition="
-                "7\n1\\CutinSpeed=20\n1\\MovingSpeed=80\n1\\RotationSpeed="
-                "4500\n1\\ContactForce=10\n1\\SettingForce="
-                "80\n1\\TransitionTime=1500\n1\\TransitionRadius="
-                "0\n1\\DiscRadius=50\n1\\DiscThickness=8\n1\\GrindAngle="
-                "0\n1\\OffsetCount=0\n1\\AddOffsetCount=0\n1\\RaiseCount="
-                "0\n1\\FloatCount=0\n1\\IsMirror=false\n");
-            // 关闭文件
-            file.close();
-        } else {
-            // 如果文件无法打开，可以在这里处理错误
+    if (!crafts.Open(dirName + "/crafts")) {
+        setEnabled(false);
+        QMessageBox::critical(NULL, "提示", "无法打开工艺参数库");
+        return;
+    }
+    if (crafts.Size() == 0) {
+        // 首次启动时导入旧版工艺参数文件，没有则创建默认工艺
+        if (!crafts.Import(dirName + "/config.ini") &&
+            crafts.Append(CraftStore::DefaultCraft()) < 0) {
             setEnabled(false);
             QMessageBox::critical(NULL, "提示", "无法创建工艺参数文件");
             return;
         }
     }
-    QSettings settings(fileName, QSettings::IniFormat);
-    int size = settings.beginReadArray("CraftParameter");
-    if (size == 0) {
-        return;
-    }
-    // 读取所有工艺参数
+    // 添加工艺编号，条目数据为工艺库中的编号
+    int size = crafts.Capacity();
     for (int i = 0; i < size; ++i) {
-        settings.setArrayIndex(i);
-        Craft craft;
-        craft.craftID = settings.value("CraftName").toString();
-        craft.mode = (PolishMode)settings.value("PolishMode").toInt();
-        craft.way = (PolishWay)settings.value("PolishWay").toInt();
-        craft.teachPointReferPos =
-            settings.value("TeachingPointReferencePosition").toInt();
-        craft.cutinSpeed = settings.value("CutinSpeed").toInt();
-        craft.moveSpeed = settings.value("MovingSpeed").toInt();
-        craft.rotateSpeed = settings.value("RotationSpeed").toInt();
-        craft.contactForce = settings.value("ContactForce").toInt();
-        craft.settingForce = settings.value("SettingForce").toInt();
-        craft.transitionTime = settings.value("TransitionTime").toInt();
-        craft.transitionRadius = settings.value("TransitionRadius").toInt();
-        craft.discRadius = settings.value("DiscRadius").toInt();
-        craft.discThickness = settings.value("DiscThickness").toInt();
-        craft.grindAngle = settings.value("GrindAngle").toInt();
-        craft.offsetCount = settings.value("OffsetCount").toInt();
-        craft.addOffsetCount = settings.value("AddOffsetCount").toInt();
-        craft.raiseCount = settings.value("RaiseCount").toInt();
-        craft.floatCount = settings.value("FloatCount").toInt();
-        craft.isMirror = settings.value("IsMirror").toBool();
-        crafts.append(craft);
-    }
-    settings.endArray();
-    // 添加工艺编号
-    for (int i = 0; i < size; ++i) {
-        ui->cmbCraftID->addItem(crafts.at(i).craftID);
+        if (crafts.IsValid(i)) {
+            ui->cmbCraftID->addItem(crafts.Name(i), i);
+        }
     }
+    currCraftIdx = crafts.First();
+    // 读取运行参数
+    robot->LoadSettings(settingsFile);
+    UpdateCallStats();
     // 打磨方式首页界面设置
-    SetPolishWay(crafts.at(0).way);
+    SetPolishWay(crafts.At(currCraftIdx).way);
     // 设置验证器
     SetValidator();
     // 连接机器人
@@ -99,93 +87,65 @@ MainWindow::MainWindow(QWidget *parent)
     // Point::test();
 }
 
-MainWindow::~MainWindow() { delete ui; }
+MainWindow::~MainWindow() {
+    delete robot;
+    delete ui;
+}
 
 void MainWindow::SavePara(int index) {
     // 保存工艺参数
-    QString fileName = QCoreApplication::applicationDirPath();
-    fileName += "/config.ini";
-    QSettings settings(fileName, QSettings::IniFormat);
-    settings.beginWriteArray("CraftParameter");
-    settings.setArrayIndex(index);
-    settings.setValue("CraftName", crafts.at(index).craftID);
-    settings.setValue("PolishMode", crafts.at(index).mode);
-    settings.setValue("PolishWay", crafts.at(index).way);
-    settings.setValue("TeachingPointReferencePosition",
-                      crafts.at(index).teachPointReferPos);
-    settings.setValue("CutinSpeed", crafts.at(index).cutinSpeed);
-    settings.setValue("MovingSpeed", crafts.at(index).moveSpeed);
-    settings.setValue("RotationSpeed", crafts.at(index).rotateSpeed);
-    settings.setValue("ContactForce", crafts.at(index).contactForce);
-    settings.setValue("SettingForce", crafts.at(index).settingForce);
-    settings.setValue("TransitionTime", crafts.at(index).transitionTime);
-    settings.setValue("TransitionRadius", crafts.at(index).transitionRadius);
-    settings.setValue("DiscRadius", crafts.at(index).discRadius);
-    settings.setValue("DiscThickness", crafts.at(index).discThickness);
-    settings.setValue("GrindAngle", crafts.at(index).grindAngle);
-    settings.setValue("OffsetCount", crafts.at(index).offsetCount);
-    settings.setValue("AddOffsetCount", crafts.at(index).addOffsetCount);
-    settings.setValue("RaiseCount", crafts.at(index).raiseCount);
-    settings.setValue("FloatCount", crafts.at(index).floatCount);
-    settings.setValue("IsMirror", crafts.at(index).isMirror);
-    // 记录工艺参数数量
-    settings.setArrayIndex(crafts.size() - 1);
-    settings.endArray();
+    if (!crafts.Save(index)) {
+        QMessageBox::critical(NULL, "提示", "工艺参数保存失败");
+    }
 }
 
 void MainWindow::ReadCurrPara() {
     // 读取当前工艺参数
-    ui->cmbPolishMode->setCurrentIndex(crafts.at(currCraftIdx).mode);
-    ui->cmbPolishWay->setCurrentIndex(crafts.at(currCraftIdx).way);
+    ui->cmbPolishMode->setCurrentIndex(crafts.At(currCraftIdx).mode);
+    ui->cmbPolishWay->setCurrentIndex(crafts.At(currCraftIdx).way);
     ui->leTeachPos->setText(
-        QString::number(crafts.at(currCraftIdx).teachPointReferPos));
+        QString::number(crafts.At(currCraftIdx).teachPointReferPos));
     ui->leCutinSpeed->setText(
-        QString::number(crafts.at(currCraftIdx).cutinSpeed));
+        QString::number(crafts.At(currCraftIdx).cutinSpeed));
     ui->leMoveSpeed->setText(
-        QString::number(crafts.at(currCraftIdx).moveSpeed));
+        QString::number(crafts.At(currCraftIdx).moveSpeed));
     ui->leRotateSpeed->setText(
-        QString::number(crafts.at(currCraftIdx).rotateSpeed));
+        QString::number(crafts.At(currCraftIdx).rotateSpeed));
     ui->leContactForce->setText(
-        QString::number(crafts.at(currCraftIdx).contactForce));
+        QString::number(crafts.At(currCraftIdx).contactForce));
     ui->leSettingForce->setText(
-        QString::number(crafts.at(currCraftIdx).settingForce));
+        QString::number(crafts.At(currCraftIdx).settingForce));
     ui->leTransitionTime->setText(
-        QString::number(crafts.at(currCraftIdx).transitionTime));
+        QString::number(crafts.At(currCraftIdx).transitionTime));
     ui->leTransitionRadius->setText(
-        QString::number(crafts.at(currCraftIdx).transitionRadius));
+        QString::number(crafts.At(currCraftIdx).transitionRadius));
     ui->leDiscRadius->setText(
-        QString::number(crafts.at(currCraftIdx).discRadius));
+        QString::number(crafts.At(currCraftIdx).discRadius));
     ui->leDiscThickness->setText(
-        QString::number(crafts.at(currCraftIdx).discThickness));
+        QString::number(crafts.At(currCraftIdx).discThickness));
     ui->leGrindAngle->setText(
-        QString::number(crafts.at(currCraftIdx).grindAngle));
+        QString::number(crafts.At(currCraftIdx).grindAngle));
     ui->leOffsetCount->setText(
-        QString::number(crafts.at(currCraftIdx).offsetCount));
+        QString::number(crafts.At(currCraftIdx).offsetCount));
     ui->leAddOffsetCount->setText(
-        QString::number(crafts.at(currCraftIdx).addOffsetCount));
+        QString::number(crafts.At(currCraftIdx).addOffsetCount));
     ui->leRaiseCount->setText(
-        QString::number(crafts.at(currCraftIdx).raiseCount));
+        QString::number(crafts.At(currCraftIdx).raiseCount));
     ui->leFloatCount->setText(
-        QString::number(crafts.at(currCraftIdx).floatCount));
+        QString::number(crafts.At(currCraftIdx).floatCount));
+    ui->leOverlapRatio->setText(
+        QString::number(crafts.At(currCraftIdx).overlapRatio));
     ui->chkMirror->setCheckState(
-        crafts.at(currCraftIdx).isMirror ? Qt::Checked : Qt::Unchecked);
+        crafts.At(currCraftIdx).isMirror ? Qt::Checked : Qt::Unchecked);
 
-    robot.teachPos = crafts.at(currCraftIdx).teachPointReferPos;
-    robot.discThickness = crafts.at(currCraftIdx).discThickness;
+    robot->teachPos = crafts.At(currCraftIdx).teachPointReferPos;
+    robot->discThickness = crafts.At(currCraftIdx).discThickness;
 }
 
 void MainWindow::DelCurrPara() {
     // 删除当前工艺参数
-    crafts.remove(currCraftIdx);
-    QString fileName = QCoreApplication::applicationDirPath();
-    fileName += "/config.ini";
-    QSettings settings(fileName, QSettings::IniFormat);
-    settings.beginWriteArray("CraftParameter");
-    settings.clear();
-    settings.endArray();
-    int size = crafts.size();
-    for (int i = 0; i < size; ++i) {
-        SavePara(i);
+    if (!crafts.Remove(currCraftIdx)) {
+        QMessageBox::critical(NULL, "提示", "工艺参数删除失败");
     }
 }
 
@@ -195,6 +155,10 @@ void MainWindow::InitButtons() {
     SetBackgroundColor(ui->btnClear, greyColor);
     SetBackgroundColor(ui->btnClearMid, greyColor);
     SetBackgroundColor(ui->btnDelLastMid, greyColor);
+    SetBackgroundColor(ui->btnRecordPath, greyColor);
+    SetBackgroundColor(ui->btnReference, greyColor);
+    SetBackgroundColor(ui->btnRegister, greyColor);
+    SetBackgroundColor(ui->btnProbe, greyColor);
     SetBackgroundColor(ui->btnSafe, greyColor);
     SetBackgroundColor(ui->btnBegin, greyColor);
     SetBackgroundColor(ui->btnEnd, greyColor);
@@ -243,6 +207,14 @@ void MainWindow::EnableButtons() {
     SetBackgroundColor(ui->btnClearMid, defaultColor);
     ui->btnDelLastMid->setEnabled(true);
     SetBackgroundColor(ui->btnDelLastMid, defaultColor);
+    ui->btnRecordPath->setEnabled(true);
+    SetBackgroundColor(ui->btnRecordPath, defaultColor);
+    ui->btnReference->setEnabled(true);
+    SetBackgroundColor(ui->btnReference, defaultColor);
+    ui->btnRegister->setEnabled(true);
+    SetBackgroundColor(ui->btnRegister, defaultColor);
+    ui->btnProbe->setEnabled(true);
+    SetBackgroundColor(ui->btnProbe, defaultColor);
     ui->btnSafe->setEnabled(true);
     SetBackgroundColor(ui->btnSafe, defaultColor);
     ui->btnBegin->setEnabled(true);
@@ -291,6 +263,8 @@ void MainWindow::SetValidator() {
     ui->leAddOffsetCount->setValidator(new QIntValidator(ui->leAddOffsetCount));
     ui->leRaiseCount->setValidator(new QIntValidator(ui->leRaiseCount));
     ui->leFloatCount->setValidator(new QIntValidator(ui->leFloatCount));
+    ui->leOverlapRatio->setValidator(
+        new QIntValidator(0, 90, ui->leOverlapRatio));
 }
 
 void MainWindow::SetPolishWay(const PolishWay &way) {
@@ -372,10 +346,48 @@ void MainWindow::SetPolishWay(const PolishWay &way) {
         ui->btnBeginOffset->setVisible(false);
         ui->btnEndOffset->setVisible(false);
         break;
+    case PolishWay::SplineWay:
+        ui->leOffsetCount->setEnabled(false);
+        ui->lblBackground->setPixmap(QPixmap(":/pic/line.png"));
+        ui->btnAux->setVisible(false);
+        ui->btnMid->move(550, 310);
+        ui->btnMid->setVisible(true);
+        ui->btnBeginOffset->setVisible(false);
+        ui->btnEndOffset->setVisible(false);
+        break;
+    case PolishWay::CloudWay:
+    case PolishWay::MeshWay:
+        ui->leOffsetCount->setEnabled(false);
+        ui->lblBackground->setPixmap(QPixmap(":/pic/region_arc.png"));
+        ui->btnAux->setVisible(false);
+        ui->btnMid->setVisible(false);
+        ui->btnBeginOffset->setVisible(true);
+        ui->btnEndOffset->setVisible(true);
+        break;
+    case PolishWay::SphereWay:
+        ui->leOffsetCount->setEnabled(false);
+        ui->lblBackground->setPixmap(QPixmap(":/pic/arc.png"));
+        ui->btnAux->setVisible(false);
+        ui->btnMid->move(550, 110);
+        ui->btnMid->setVisible(true);
+        ui->btnBeginOffset->setVisible(false);
+        ui->btnEndOffset->setVisible(false);
+        break;
     default:
         break;
     }
 
+    switch (way) {
+    case PolishWay::SphereWay:
+    case PolishWay::CloudWay:
+    case PolishWay::MeshWay:
+        ui->leOverlapRatio->setEnabled(true);
+        break;
+    default:
+        ui->leOverlapRatio->setEnabled(false);
+        break;
+    }
+
     switch (way) {
     case PolishWay::RegionArcWay1:
     case PolishWay::RegionArcWay2:
@@ -416,7 +428,7 @@ void MainWindow::SetPolishWay(const PolishWay &way) {
     case PolishWay::CylinderWay_Horizontal_Concave:
     case PolishWay::CylinderWay_Vertical_Concave:
         ui->chkMirror->setVisible(true);
-        if (crafts.at(currCraftIdx).isMirror) {
+        if (crafts.At(currCraftIdx).isMirror) {
             ui->btnBegin->move(930, 210);
             ui->btnEnd->move(150, 210);
             ui->btnBeginOffset->move(930, 360);
@@ -449,7 +461,7 @@ void MainWindow::ConnectRobot() {
     ui->btnRobotConnect->setText("连接中");
     // 连接机器人
     std::thread t([this] {
-        if (robot.RobotConnect(ui->leRobotIP->text())) {
+        if (robot->RobotConnect(ui->leRobotIP->text())) {
             EnableButtons();
             SetBackgroundColor(ui->btnRobotConnect, greenColor);
             ui->btnRobotConnect->setText("已连接");
@@ -468,7 +480,7 @@ void MainWindow::ConnectAGP() {
     ui->btnAGPConnect->setText("连接中");
     // 连接AGP
     std::thread t([this] {
-        if (robot.AGPConnect(ui->leAGPIP->text())) {
+        if (robot->AGPConnect(ui->leAGPIP->text())) {
             SetBackgroundColor(ui->btnAGPConnect, greenColor);
             ui->btnAGPConnect->setText("已连接");
         } else {
@@ -480,6 +492,44 @@ void MainWindow::ConnectAGP() {
     t.detach();
 }
 
+void MainWindow::UpdatePointButtons(const QStringList &points) {
+    // 按已记录点位刷新首页按钮状态
+    SetBackgroundColor(ui->btnSafe, defaultColor);
+    SetBackgroundColor(ui->btnBegin, defaultColor);
+    SetBackgroundColor(ui->btnEnd, defaultColor);
+    SetBackgroundColor(ui->btnAux, defaultColor);
+    SetBackgroundColor(ui->btnBeginOffset, defaultColor);
+    SetBackgroundColor(ui->btnEndOffset, defaultColor);
+    SetBackgroundColor(ui->btnMid, defaultColor);
+    SetBackgroundColor(ui->btnReference, defaultColor);
+    int midCount = 0;
+    int referenceCount = 0;
+    for (const QString &strPoint : points) {
+        if (strPoint.startsWith("安全点")) {
+            SetBackgroundColor(ui->btnSafe, greenColor);
+        } else if (strPoint.startsWith("起始点")) {
+            SetBackgroundColor(ui->btnBegin, greenColor);
+        } else if (strPoint.startsWith("结束点")) {
+            SetBackgroundColor(ui->btnEnd, greenColor);
+        } else if (strPoint.startsWith("辅助点")) {
+            SetBackgroundColor(ui->btnAux, greenColor);
+        } else if (strPoint.startsWith("起始偏移点")) {
+            SetBackgroundColor(ui->btnBeginOffset, greenColor);
+        } else if (strPoint.startsWith("结束偏移点")) {
+            SetBackgroundColor(ui->btnEndOffset, greenColor);
+        } else if (strPoint.startsWith("中间点")) {
+            SetBackgroundColor(ui->btnMid, greenColor);
+            ++midCount;
+        } else if (strPoint.startsWith("基准点")) {
+            SetBackgroundColor(ui->btnReference, greenColor);
+            ++referenceCount;
+        }
+        AddHistoryPoint(strPoint);
+    }
+    ui->btnMid->setText("中间点" + QString::number(midCount));
+    ui->btnReference->setText("基准点" + QString::number(referenceCount));
+}
+
 void MainWindow::AddHistoryPoint(const QString &strPoint) {
     if (!strPoint.contains("：")) {
         return;
@@ -501,7 +551,7 @@ void MainWindow::AddHistoryPoint(const QString &strPoint) {
 }
 
 void MainWindow::on_btnDrag_clicked() {
-    if (robot.RobotTeach(crafts.at(currCraftIdx).teachPointReferPos)) {
+    if (robot->RobotTeach(crafts.At(currCraftIdx).teachPointReferPos)) {
         SetBackgroundColor(ui->btnDrag, greenColor);
     } else {
         SetBackgroundColor(ui->btnDrag, defaultColor);
@@ -510,7 +560,7 @@ void MainWindow::on_btnDrag_clicked() {
 
 void MainWindow::on_btnSafe_clicked() {
     QString strPoint = "";
-    if (robot.GetSafePoint(strPoint)) {
+    if (robot->GetSafePoint(strPoint)) {
         AddHistoryPoint(strPoint);
         SetBackgroundColor(ui->btnSafe, greenColor);
     } else {
@@ -536,7 +586,7 @@ void MainWindow::on_btnNext_clicked() {
 
 void MainWindow::on_btnBegin_clicked() {
     QString strPoint = "";
-    if (robot.GetBeginPoint(strPoint)) {
+    if (robot->GetBeginPoint(strPoint)) {
         AddHistoryPoint(strPoint);
         SetBackgroundColor(ui->btnBegin, greenColor);
     } else {
@@ -546,7 +596,7 @@ void MainWindow::on_btnBegin_clicked() {
 
 void MainWindow::on_btnEnd_clicked() {
     QString strPoint = "";
-    if (robot.GetEndPoint(strPoint)) {
+    if (robot->GetEndPoint(strPoint)) {
         AddHistoryPoint(strPoint);
         SetBackgroundColor(ui->btnEnd, greenColor);
     } else {
@@ -555,7 +605,9 @@ void MainWindow::on_btnEnd_clicked() {
 }
 
 void MainWindow::on_btnTryRun_clicked() {
-    if (!robot.CheckAllPoints(crafts.at(currCraftIdx).way)) {
+    QString tip;
+    if (!robot->CheckAllPoints(crafts.At(currCraftIdx).way, tip)) {
+        QMessageBox::critical(NULL, "提示", tip);
         return;
     }
     ui->btnRun->setEnabled(false);
@@ -563,14 +615,14 @@ void MainWindow::on_btnTryRun_clicked() {
     ui->btnMoveToPoint->setEnabled(false);
     SetBackgroundColor(ui->btnTryRun, greenColor);
     ui->btnTryRun->setText("试运行中");
-    if (robot.CloseFreeDriver()) {
+    if (robot->CloseFreeDriver()) {
         // QThread::msleep(1000);
         SetBackgroundColor(ui->btnDrag, defaultColor);
     }
-    // robot.Run(crafts.at(currCraftIdx), false);
+    // robot->Run(crafts.At(currCraftIdx), false);
     // AGP停止
     std::thread t([this] {
-        robot.Run(crafts.at(currCraftIdx), false);
+        robot->Run(crafts.At(currCraftIdx), false);
         ui->btnRun->setEnabled(true);
         ui->btnTryRun->setEnabled(true);
         ui->btnMoveToPoint->setEnabled(true);
@@ -581,7 +633,9 @@ void MainWindow::on_btnTryRun_clicked() {
 }
 
 void MainWindow::on_btnRun_clicked() {
-    if (!robot.CheckAllPoints(crafts.at(currCraftIdx).way)) {
+    QString tip;
+    if (!robot->CheckAllPoints(crafts.At(currCraftIdx).way, tip)) {
+        QMessageBox::critical(NULL, "提示", tip);
         return;
     }
     ui->btnRun->setEnabled(false);
@@ -589,15 +643,15 @@ void MainWindow::on_btnRun_clicked() {
     ui->btnMoveToPoint->setEnabled(false);
     SetBackgroundColor(ui->btnRun, greenColor);
     ui->btnRun->setText("运行中");
-    if (robot.CloseFreeDriver()) {
+    if (robot->CloseFreeDriver()) {
         // QThread::msleep(1000);
         SetBackgroundColor(ui->btnDrag, defaultColor);
     }
-    // robot.Run(crafts.at(currCraftIdx), true);
+    // robot->Run(crafts.At(currCraftIdx), true);
     // AGP停止
     std::thread t([this] {
-        robot.Run(crafts.at(currCraftIdx), true);
-        robot.AGPStop();
+        robot->Run(crafts.At(currCraftIdx), true);
+        robot->AGPStop();
         ui->btnRun->setEnabled(true);
         ui->btnTryRun->setEnabled(true);
         ui->btnMoveToPoint->setEnabled(true);
@@ -628,7 +682,10 @@ void MainWindow::on_btnSaveCurrPara_clicked() {
 }
 
 void MainWindow::on_cmbCraftID_currentIndexChanged(int index) {
-    currCraftIdx = index;
+    if (index < 0) {
+        return;
+    }
+    currCraftIdx = ui->cmbCraftID->itemData(index).toInt();
     ReadCurrPara();
 }
 
@@ -645,7 +702,7 @@ void MainWindow::on_leCutinSpeed_editingFinished() {
             NULL, "提示",
             QString("切入速度范围：%1~%2").arg(v.bottom()).arg(v.top()));
         ui->leCutinSpeed->setText(
-            QString::number(crafts.at(currCraftIdx).cutinSpeed));
+            QString::number(crafts.At(currCraftIdx).cutinSpeed));
     } else {
         crafts[currCraftIdx].cutinSpeed = ui->leCutinSpeed->text().toInt();
     }
@@ -660,7 +717,7 @@ void MainWindow::on_leMoveSpeed_editingFinished() {
             NULL, "提示",
             QString("行进速度范围：%1~%2").arg(v.bottom()).arg(v.top()));
         ui->leMoveSpeed->setText(
-            QString::number(crafts.at(currCraftIdx).moveSpeed));
+            QString::number(crafts.At(currCraftIdx).moveSpeed));
     } else {
         crafts[currCraftIdx].moveSpeed = ui->leMoveSpeed->text().toInt();
     }
@@ -689,33 +746,36 @@ void MainWindow::on_cmbPolishWay_currentIndexChanged(int index) {
 
 void MainWindow::on_leTeachPos_editingFinished() {
     crafts[currCraftIdx].teachPointReferPos = ui->leTeachPos->text().toInt();
-    robot.teachPos = ui->leTeachPos->text().toInt();
+    robot->teachPos = ui->leTeachPos->text().toInt();
 }
 
 void MainWindow::on_btnAddNewPara_clicked() {
-    crafts.append(crafts.at(currCraftIdx));
-    int size = crafts.size();
-    crafts[size - 1].craftID = "";
-    SavePara(size - 1);
-    ui->cmbCraftID->addItem("");
-    ui->cmbCraftID->setCurrentIndex(size - 1);
+    Craft craft = crafts.At(currCraftIdx);
+    craft.craftID = "";
+    int index = crafts.Append(craft);
+    if (index < 0) {
+        QMessageBox::critical(NULL, "提示", "工艺参数保存失败");
+        return;
+    }
+    ui->cmbCraftID->addItem("", index);
+    ui->cmbCraftID->setCurrentIndex(ui->cmbCraftID->count() - 1);
     ui->cmbCraftID->setFocus();
 }
 
 void MainWindow::on_btnDelCurrPara_clicked() {
-    if (crafts.size() <= 1) {
+    if (crafts.Size() <= 1) {
         QMessageBox::critical(NULL, "提示", "至少保留一份工艺");
         return;
     }
     DelCurrPara();
-    ui->cmbCraftID->removeItem(currCraftIdx);
+    ui->cmbCraftID->removeItem(ui->cmbCraftID->currentIndex());
 }
 
 void MainWindow::on_btnStop_clicked() {
     ui->btnStop->setEnabled(false);
     SetBackgroundColor(ui->btnStop, greenColor);
     std::thread t([this] {
-        if (robot.Stop()) {
+        if (robot->Stop()) {
             SetBackgroundColor(ui->btnDrag, defaultColor);
         }
         QThread::msleep(200);
@@ -727,7 +787,7 @@ void MainWindow::on_btnStop_clicked() {
 
 void MainWindow::on_btnAux_clicked() {
     QString strPoint = "";
-    if (robot.GetAuxPoint(strPoint)) {
+    if (robot->GetAuxPoint(strPoint)) {
         AddHistoryPoint(strPoint);
         SetBackgroundColor(ui->btnAux, greenColor);
     } else {
@@ -737,7 +797,7 @@ void MainWindow::on_btnAux_clicked() {
 
 void MainWindow::on_btnMid_clicked() {
     QString strPoint = "";
-    int size = robot.GetMidPoint(midPressDuration.elapsed(), strPoint);
+    int size = robot->GetMidPoint(midPressDuration.elapsed(), strPoint);
     if (!strPoint.isEmpty()) {
         AddHistoryPoint(strPoint);
     }
@@ -760,7 +820,7 @@ void MainWindow::on_leOffsetCount_editingFinished() {
 
 void MainWindow::on_btnBeginOffset_clicked() {
     QString strPoint = "";
-    if (robot.GetBeginOffsetPoint(strPoint)) {
+    if (robot->GetBeginOffsetPoint(strPoint)) {
         AddHistoryPoint(strPoint);
         SetBackgroundColor(ui->btnBeginOffset, greenColor);
     } else {
@@ -770,7 +830,7 @@ void MainWindow::on_btnBeginOffset_clicked() {
 
 void MainWindow::on_btnEndOffset_clicked() {
     QString strPoint = "";
-    if (robot.GetEndOffsetPoint(strPoint)) {
+    if (robot->GetEndOffsetPoint(strPoint)) {
         AddHistoryPoint(strPoint);
         SetBackgroundColor(ui->btnEndOffset, greenColor);
     } else {
@@ -779,7 +839,7 @@ void MainWindow::on_btnEndOffset_clicked() {
 }
 
 void MainWindow::on_btnClear_clicked() {
-    if (robot.ClearPoints()) {
+    if (robot->ClearPoints()) {
         SetBackgroundColor(ui->btnSafe, defaultColor);
         SetBackgroundColor(ui->btnBegin, defaultColor);
         SetBackgroundColor(ui->btnEnd, defaultColor);
@@ -788,11 +848,15 @@ void MainWindow::on_btnClear_clicked() {
         SetBackgroundColor(ui->btnEndOffset, defaultColor);
         SetBackgroundColor(ui->btnMid, defaultColor);
         ui->btnMid->setText("中间点" + QString::number(0));
+        SetBackgroundColor(ui->btnReference, defaultColor);
+        ui->btnReference->setText("基准点" + QString::number(0));
+        SetBackgroundColor(ui->btnRegister, defaultColor);
+        ui->btnRegister->setText("配准");
     }
 }
 
 void MainWindow::on_btnOpenWeb_clicked() {
-    robot.OpenWeb(ui->leRobotIP->text());
+    robot->OpenWeb(ui->leRobotIP->text());
 }
 
 void MainWindow::on_leAddOffsetCount_editingFinished() {
@@ -802,20 +866,126 @@ void MainWindow::on_leAddOffsetCount_editingFinished() {
 void MainWindow::on_btnMid_pressed() { midPressDuration.start(); }
 
 void MainWindow::on_btnClearMid_clicked() {
-    if (robot.ClearMidPoints()) {
+    if (robot->ClearMidPoints()) {
         SetBackgroundColor(ui->btnMid, defaultColor);
         ui->btnMid->setText("中间点0");
     }
 }
 
 void MainWindow::on_btnDelLastMid_clicked() {
-    int size = robot.DelLastMidPoint();
+    int size = robot->DelLastMidPoint();
     if (size == 0) {
         SetBackgroundColor(ui->btnMid, defaultColor);
     }
     ui->btnMid->setText("中间点" + QString::number(size));
 }
 
+void MainWindow::on_btnRecordPath_clicked() {
+    if (!robot->IsTeachRecording()) {
+        // 自由拖拽时连续录制，结束后转换为点位
+        if (!robot->StartTeachRecord()) {
+            QMessageBox::critical(NULL, "提示", "请先启用自由拖拽");
+            return;
+        }
+        SetBackgroundColor(ui->btnRecordPath, greenColor);
+        ui->btnRecordPath->setText("结束录制");
+        return;
+    }
+    QString tip;
+    bool isConverted = robot->StopTeachRecord(tip);
+    SetBackgroundColor(ui->btnRecordPath, defaultColor);
+    ui->btnRecordPath->setText("录制轨迹");
+    if (!isConverted) {
+        QMessageBox::critical(NULL, "提示", tip);
+        return;
+    }
+    UpdatePointButtons(robot->GetRecordedPoints());
+    QMessageBox::information(NULL, "提示", tip);
+}
+
+void MainWindow::on_btnReference_clicked() {
+    QString strPoint = "";
+    int count = robot->AddReferencePoint(strPoint);
+    if (count < 0) {
+        QMessageBox::critical(NULL, "提示", "读取点位失败");
+        return;
+    }
+    AddHistoryPoint(strPoint);
+    SetBackgroundColor(ui->btnReference, greenColor);
+    ui->btnReference->setText("基准点" + QString::number(count));
+}
+
+void MainWindow::on_btnRegister_clicked() {
+    // 重新装夹后按记录顺序逐个测量基准点，全部测完后自动配准
+    int total = robot->ReferenceCount();
+    if (total < 3) {
+        QMessageBox::critical(NULL, "提示", "请先记录至少3个基准点");
+        return;
+    }
+    QString strPoint = "";
+    int count = robot->AddTouchPoint(strPoint);
+    if (count < 0) {
+        QMessageBox::critical(NULL, "提示", "读取点位失败");
+        return;
+    }
+    if (count < total) {
+        SetBackgroundColor(ui->btnRegister, greenColor);
+        ui->btnRegister->setText(QString("配准%1/%2").arg(count).arg(total));
+        return;
+    }
+    QString tip;
+    bool isRegistered = robot->RegisterProgram(tip);
+    SetBackgroundColor(ui->btnRegister, defaultColor);
+    ui->btnRegister->setText("配准");
+    if (!isRegistered) {
+        QMessageBox::critical(NULL, "提示", tip);
+        return;
+    }
+    UpdatePointButtons(robot->GetRecordedPoints());
+    QMessageBox::information(NULL, "提示", tip);
+}
+
+void MainWindow::on_btnProbe_clicked() {
+    // 打磨头自动触碰探测全部基准点后配准，代替逐个手动测量
+    if (robot->ReferenceCount() < 3) {
+        QMessageBox::critical(NULL, "提示", "请先记录至少3个基准点");
+        return;
+    }
+    ui->btnRun->setEnabled(false);
+    ui->btnTryRun->setEnabled(false);
+    ui->btnMoveToPoint->setEnabled(false);
+    ui->btnProbe->setEnabled(false);
+    SetBackgroundColor(ui->btnProbe, greenColor);
+    ui->btnProbe->setText("探测中");
+    if (robot->CloseFreeDriver()) {
+        SetBackgroundColor(ui->btnDrag, defaultColor);
+    }
+    std::thread t([this] {
+        QString tip;
+        bool isRegistered =
+            robot->ProbeReferencePoints(tip) && robot->RegisterProgram(tip);
+        // 提示框和点位按钮在界面线程中更新
+        QMetaObject::invokeMethod(
+            this,
+            [this, isRegistered, tip] {
+                ui->btnRun->setEnabled(true);
+                ui->btnTryRun->setEnabled(true);
+                ui->btnMoveToPoint->setEnabled(true);
+                ui->btnProbe->setEnabled(true);
+                SetBackgroundColor(ui->btnProbe, defaultColor);
+                ui->btnProbe->setText("探测配准");
+                if (!isRegistered) {
+                    QMessageBox::critical(NULL, "提示", tip);
+                    return;
+                }
+                UpdatePointButtons(robot->GetRecordedPoints());
+                QMessageBox::information(NULL, "提示", tip);
+            },
+            Qt::QueuedConnection);
+    });
+    t.detach();
+}
+
 void MainWindow::on_btnMoveToPoint_clicked() {
     QString strPoint = ui->leHistoryPoint->text();
     if (strPoint.contains("：")) {
@@ -826,11 +996,11 @@ void MainWindow::on_btnMoveToPoint_clicked() {
         ui->btnMoveToPoint->setEnabled(false);
         SetBackgroundColor(ui->btnMoveToPoint, greenColor);
         ui->btnMoveToPoint->setText("移动中");
-        if (robot.CloseFreeDriver()) {
+        if (robot->CloseFreeDriver()) {
             SetBackgroundColor(ui->btnDrag, defaultColor);
         }
         std::thread t([this, strValues] {
-            robot.MoveToPoint(strValues);
+            robot->MoveToPoint(strValues);
             ui->btnRun->setEnabled(true);
             ui->btnTryRun->setEnabled(true);
             ui->btnMoveToPoint->setEnabled(true);
@@ -853,7 +1023,7 @@ void MainWindow::on_btnStop2_clicked() {
     ui->btnStop2->setEnabled(false);
     SetBackgroundColor(ui->btnStop2, greenColor);
     std::thread t([this] {
-        if (robot.Stop()) {
+        if (robot->Stop()) {
             SetBackgroundColor(ui->btnDrag, defaultColor);
         }
         QThread::msleep(200);
@@ -870,10 +1040,140 @@ void MainWindow::on_btnCoverPoint_clicked() {
     if (strPoint.isEmpty()) {
         return;
     }
-    robot.CoverPoint(strPoint);
+    robot->CoverPoint(strPoint);
     AddHistoryPoint(strPoint);
 }
 
+void MainWindow::on_btnSaveProgram_clicked() {
+    QString fileName = QFileDialog::getSaveFileName(
+        this, "保存程序", QCoreApplication::applicationDirPath(),
+        "程序文件 (*.ini)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    if (robot->SaveProgram(fileName, crafts.At(currCraftIdx))) {
+        QMessageBox::information(NULL, "提示", "程序已保存");
+    } else {
+        QMessageBox::critical(NULL, "提示", "程序保存失败");
+    }
+}
+
+void MainWindow::on_btnLoadProgram_clicked() {
+    QString fileName = QFileDialog::getOpenFileName(
+        this, "加载程序", QCoreApplication::applicationDirPath(),
+        "程序文件 (*.ini)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    Craft craft;
+    if (!robot->LoadProgram(fileName, craft)) {
+        QMessageBox::critical(NULL, "提示", "程序文件读取失败");
+        return;
+    }
+    // 选中同名工艺，没有则新增
+    int index = ui->cmbCraftID->findText(craft.craftID);
+    if (index < 0) {
+        int craftIdx = crafts.Append(craft);
+        if (craftIdx < 0) {
+            QMessageBox::critical(NULL, "提示", "工艺参数保存失败");
+            return;
+        }
+        ui->cmbCraftID->addItem(craft.craftID, craftIdx);
+        index = ui->cmbCraftID->count() - 1;
+    }
+    ui->cmbCraftID->setCurrentIndex(index);
+    UpdatePointButtons(robot->GetRecordedPoints());
+}
+
+void MainWindow::on_btnLoadCloud_clicked() {
+    QString fileName = QFileDialog::getOpenFileName(
+        this, "导入点云", QCoreApplication::applicationDirPath(),
+        "点云文件 (*.ply *.xyz *.txt)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool ok = robot->LoadCloud(fileName);
+    QApplication::restoreOverrideCursor();
+    if (ok) {
+        QMessageBox::information(
+            NULL, "提示", QString("已导入 %1 个点").arg(robot->CloudSize()));
+    } else {
+        QMessageBox::critical(NULL, "提示", "点云文件读取失败");
+    }
+}
+
+void MainWindow::on_btnLoadMesh_clicked() {
+    QString fileName = QFileDialog::getOpenFileName(
+        this, "导入模型", QCoreApplication::applicationDirPath(),
+        "模型文件 (*.stl)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool ok = robot->LoadMesh(fileName);
+    QApplication::restoreOverrideCursor();
+    if (ok) {
+        QMessageBox::information(
+            NULL, "提示", QString("已导入 %1 个面").arg(robot->MeshSize()));
+    } else {
+        QMessageBox::critical(NULL, "提示", "模型文件读取失败");
+    }
+}
+
+void MainWindow::UpdateCallStats() {
+    ui->btnStatsEnable->setText(CallStats::IsEnabled() ? "停止统计"
+                                                       : "开始统计");
+    QVector<CallSummary> summaries = CallStats::Summaries();
+    QTableWidget *table = ui->tblCallStats;
+    table->setColumnCount(8);
+    table->setHorizontalHeaderLabels({"调用", "次数", "错误", "平均/μs",
+                                      "P50/μs", "P99/μs", "最大/μs",
+                                      "总计/ms"});
+    table->setRowCount(summaries.size());
+    for (int i = 0; i < summaries.size(); ++i) {
+        const CallSummary &summary = summaries.at(i);
+        QStringList cells{summary.name,
+                          QString::number(summary.count),
+                          QString::number(summary.errors),
+                          QString::number(summary.mean, 'f', 1),
+                          QString::number(summary.p50, 'f', 1),
+                          QString::number(summary.p99, 'f', 1),
+                          QString::number(summary.max, 'f', 1),
+                          QString::number(summary.total, 'f', 1)};
+        for (int j = 0; j < cells.size(); ++j) {
+            table->setItem(i, j, new QTableWidgetItem(cells.at(j)));
+        }
+    }
+    table->resizeColumnsToContents();
+}
+
+void MainWindow::on_btnStatsEnable_clicked() {
+    CallStats::SetEnabled(!CallStats::IsEnabled());
+    UpdateCallStats();
+}
+
+void MainWindow::on_btnStatsRefresh_clicked() { UpdateCallStats(); }
+
+void MainWindow::on_btnStatsReset_clicked() {
+    CallStats::Reset();
+    UpdateCallStats();
+}
+
+void MainWindow::on_btnStatsExport_clicked() {
+    QString fileName = QFileDialog::getSaveFileName(
+        this, "导出调用统计", QCoreApplication::applicationDirPath(),
+        "JSON 文件 (*.json)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    if (CallStats::SaveJson(fileName)) {
+        QMessageBox::information(NULL, "提示", "调用统计已导出");
+    } else {
+        QMessageBox::critical(NULL, "提示", "调用统计导出失败");
+    }
+}
+
 void MainWindow::on_leRaiseCount_editingFinished() {
     crafts[currCraftIdx].raiseCount = ui->leRaiseCount->text().toInt();
 }
@@ -882,9 +1182,13 @@ void MainWindow::on_leFloatCount_editingFinished() {
     crafts[currCraftIdx].floatCount = ui->leFloatCount->text().toInt();
 }
 
+void MainWindow::on_leOverlapRatio_editingFinished() {
+    crafts[currCraftIdx].overlapRatio = ui->leOverlapRatio->text().toInt();
+}
+
 void MainWindow::on_leDiscThickness_editingFinished() {
     crafts[currCraftIdx].discThickness = ui->leDiscThickness->text().toInt();
-    robot.discThickness = ui->leDiscThickness->text().toInt();
+    robot->discThickness = ui->leDiscThickness->text().toInt();
 }
 
 void MainWindow::on_leTransitionRadius_editingFinished() {
@@ -903,5 +1207,5 @@ void MainWindow::on_chkMirror_stateChanged(int arg1) {
     default:
         break;
     }
-    SetPolishWay(crafts.at(currCraftIdx).way);
+    SetPolishWay(crafts.At(currCraftIdx).way);
 }
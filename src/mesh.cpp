@@ -0,0 +1,418 @@
+﻿#include <QFile>
+#include <QtEndian>
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "mesh.h"
+#include "textparse.h"
+
+// BVH 叶节点面数
+constexpr int bvhLeafSize = 4;
+// 顶点焊接容差，mm
+constexpr double weldTolerance = 1e-3;
+
+// 半边 h 在同一面内的下一条半边
+static inline int NextHalfEdge(int h) { return h - h % 3 + (h + 1) % 3; }
+
+Mesh::Mesh() {}
+
+bool Mesh::Load(const QString &fileName) {
+    Clear();
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray data = file.readAll();
+    file.close();
+    // 文件长度与面数吻合即为二进制（二进制文件头也可能以 solid 开头）
+    bool isBinary = false;
+    if (data.size() >= 84) {
+        quint32 count = qFromLittleEndian<quint32>(data.constData() + 80);
+        isBinary = 84 + (qint64)count * 50 == data.size();
+    }
+    bool ok = isBinary ? LoadBinary(data)
+                       : data.left(256).trimmed().startsWith("solid") &&
+                             LoadAscii(data);
+    if (!ok || indices.isEmpty()) {
+        Clear();
+        return false;
+    }
+    this->fileName = fileName;
+    return true;
+}
+
+void Mesh::Clear() {
+    fileName.clear();
+    vertices.clear();
+    indices.clear();
+    twins.clear();
+    faceNormals.clear();
+    nodes.clear();
+    faceOrder.clear();
+}
+
+bool Mesh::IsEmpty() const { return indices.isEmpty(); }
+
+int Mesh::FaceCount() const { return indices.size() / 3; }
+
+int Mesh::VertexCount() const { return vertices.size(); }
+
+QString Mesh::FileName() const { return fileName; }
+
+const QVector3D &Mesh::Vertex(int index) const { return vertices.at(index); }
+
+const QVector3D &Mesh::FaceNormal(int face) const {
+    return faceNormals.at(face);
+}
+
+bool Mesh::LoadBinary(const QByteArray &data) {
+    // 80字节文件头 + 面数 + 每面50字节（法向、三个顶点、属性）
+    quint32 count = qFromLittleEndian<quint32>(data.constData() + 80);
+    QVector<QVector3D> corners;
+    corners.reserve(count * 3);
+    const char *p = data.constData() + 84;
+    for (quint32 i = 0; i < count; ++i, p += 50) {
+        for (int k = 0; k < 3; ++k) {
+            float xyz[3];
+            for (int j = 0; j < 3; ++j) {
+                quint32 bits =
+                    qFromLittleEndian<quint32>(p + 12 + k * 12 + j * 4);
+                std::memcpy(&xyz[j], &bits, sizeof(float));
+            }
+            corners.append(QVector3D(xyz[0], xyz[1], xyz[2]));
+        }
+    }
+    Build(corners);
+    return true;
+}
+
+bool Mesh::LoadAscii(const QByteArray &data) {
+    // 只取 vertex 行，每三个顶点一个面；文件中的法向不可靠，按顶点重新计算
+    QVector<QVector3D> corners;
+    const char *p = data.constData();
+    const char *end = p + data.size();
+    while (p < end) {
+        const char *lineEnd = (const char *)std::memchr(p, '\n', end - p);
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+        while (p < lineEnd && (*p == ' ' || *p == '\t')) {
+            ++p;
+        }
+        if (lineEnd - p > 6 && std::memcmp(p, "vertex", 6) == 0) {
+            double values[3];
+            if (ParseNumbers(p + 6, lineEnd, values, 3) != 3) {
+                return false;
+            }
+            corners.append(QVector3D(values[0], values[1], values[2]));
+        }
+        p = lineEnd + 1;
+    }
+    if (corners.size() % 3 != 0) {
+        return false;
+    }
+    Build(corners);
+    return true;
+}
+
+void Mesh::Build(const QVector<QVector3D> &corners) {
+    // 顶点焊接：按量化坐标排序，相同坐标合并
+    int cornerCount = corners.size();
+    struct WeldKey {
+        qint64 x, y, z;
+        int corner;
+    };
+    std::vector<WeldKey> keys(cornerCount);
+    for (int i = 0; i < cornerCount; ++i) {
+        const QVector3D &p = corners.at(i);
+        keys[i] = {qRound64(p.x() / weldTolerance),
+                   qRound64(p.y() / weldTolerance),
+                   qRound64(p.z() / weldTolerance), i};
+    }
+    std::sort(keys.begin(), keys.end(),
+              [](const WeldKey &a, const WeldKey &b) {
+                  if (a.x != b.x) {
+                      return a.x < b.x;
+                  }
+                  if (a.y != b.y) {
+                      return a.y < b.y;
+                  }
+                  return a.z < b.z;
+              });
+    QVector<int> cornerVertex(cornerCount);
+    for (int i = 0; i < cornerCount; ++i) {
+        if (i == 0 || keys[i].x != keys[i - 1].x ||
+            keys[i].y != keys[i - 1].y || keys[i].z != keys[i - 1].z) {
+            vertices.append(corners.at(keys[i].corner));
+        }
+        cornerVertex[keys[i].corner] = vertices.size() - 1;
+    }
+    // 去掉退化面（焊接后有重合顶点或面积为0）
+    for (int f = 0; f < cornerCount / 3; ++f) {
+        int a = cornerVertex.at(3 * f);
+        int b = cornerVertex.at(3 * f + 1);
+        int c = cornerVertex.at(3 * f + 2);
+        QVector3D normal = QVector3D::crossProduct(
+            vertices.at(b) - vertices.at(a), vertices.at(c) - vertices.at(a));
+        if (a == b || b == c || c == a || normal.lengthSquared() < 1e-12f) {
+            continue;
+        }
+        indices.append(a);
+        indices.append(b);
+        indices.append(c);
+        faceNormals.append(normal.normalized());
+    }
+    // 对边：同一条无向边上方向相反的两条半边配对
+    int halfEdgeCount = indices.size();
+    qint64 vertexCount = vertices.size();
+    std::vector<std::pair<qint64, int>> edges(halfEdgeCount);
+    for (int h = 0; h < halfEdgeCount; ++h) {
+        qint64 a = indices.at(h);
+        qint64 b = indices.at(NextHalfEdge(h));
+        edges[h] = {qMin(a, b) * vertexCount + qMax(a, b), h};
+    }
+    std::sort(edges.begin(), edges.end());
+    twins.fill(-1, halfEdgeCount);
+    for (int i = 0; i + 1 < halfEdgeCount; ++i) {
+        if (edges[i].first != edges[i + 1].first) {
+            continue;
+        }
+        // 恰好两条且方向相反才配对，非流形边保持边界
+        bool isManifold =
+            (i == 0 || edges[i - 1].first != edges[i].first) &&
+            (i + 2 >= halfEdgeCount || edges[i + 2].first != edges[i].first);
+        int h0 = edges[i].second;
+        int h1 = edges[i + 1].second;
+        if (isManifold && indices.at(h0) == indices.at(NextHalfEdge(h1))) {
+            twins[h0] = h1;
+            twins[h1] = h0;
+        }
+    }
+    // BVH
+    faceOrder.resize(FaceCount());
+    for (int f = 0; f < faceOrder.size(); ++f) {
+        faceOrder[f] = f;
+    }
+    if (!faceOrder.isEmpty()) {
+        nodes.reserve(2 * FaceCount() / bvhLeafSize + 1);
+        BuildBvh(0, faceOrder.size());
+    }
+}
+
+void Mesh::BuildBvh(int first, int count) {
+    int index = nodes.size();
+    BvhNode node;
+    node.minPos = vertices.at(indices.at(3 * faceOrder.at(first)));
+    node.maxPos = node.minPos;
+    QVector3D minCenter(FLT_MAX, FLT_MAX, FLT_MAX);
+    QVector3D maxCenter(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (int i = first; i < first + count; ++i) {
+        int f = faceOrder.at(i);
+        QVector3D center;
+        for (int k = 0; k < 3; ++k) {
+            const QVector3D &p = vertices.at(indices.at(3 * f + k));
+            center += p;
+            for (int j = 0; j < 3; ++j) {
+                node.minPos[j] = qMin(node.minPos[j], p[j]);
+                node.maxPos[j] = qMax(node.maxPos[j], p[j]);
+            }
+        }
+        for (int j = 0; j < 3; ++j) {
+            minCenter[j] = qMin(minCenter[j], center[j]);
+            maxCenter[j] = qMax(maxCenter[j], center[j]);
+        }
+    }
+    node.first = first;
+    node.count = count;
+    nodes.append(node);
+    if (count <= bvhLeafSize) {
+        return;
+    }
+    // 按面重心包围盒最长边取中位数分割
+    QVector3D extent = maxCenter - minCenter;
+    int axis = 0;
+    if (extent.y() > extent[axis]) {
+        axis = 1;
+    }
+    if (extent.z() > extent[axis]) {
+        axis = 2;
+    }
+    int half = count / 2;
+    int *order = faceOrder.data();
+    std::nth_element(order + first, order + first + half, order + first + count,
+                     [this, axis](int a, int b) {
+                         float ca = 0;
+                         float cb = 0;
+                         for (int k = 0; k < 3; ++k) {
+                             ca += vertices.at(indices.at(3 * a + k))[axis];
+                             cb += vertices.at(indices.at(3 * b + k))[axis];
+                         }
+                         return ca < cb;
+                     });
+    BuildBvh(first, half);
+    int right = nodes.size();
+    BuildBvh(first + half, count - half);
+    nodes[index].first = right;
+    nodes[index].count = 0;
+}
+
+void Mesh::QueryPlane(const QVector3D &normal, double offset,
+                      QVector<int> &faces) const {
+    faces.clear();
+    if (nodes.isEmpty()) {
+        return;
+    }
+    QVector<int> stack{0};
+    while (!stack.isEmpty()) {
+        int index = stack.takeLast();
+        const BvhNode &node = nodes.at(index);
+        // 包围盒在法向上的投影半径与中心到平面的距离比较
+        QVector3D center = (node.minPos + node.maxPos) / 2;
+        QVector3D extent = (node.maxPos - node.minPos) / 2;
+        double radius = qAbs(normal.x()) * extent.x() +
+                        qAbs(normal.y()) * extent.y() +
+                        qAbs(normal.z()) * extent.z();
+        double distance = QVector3D::dotProduct(normal, center) - offset;
+        if (qAbs(distance) > radius) {
+            continue;
+        }
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                faces.append(faceOrder.at(i));
+            }
+        } else {
+            stack.append(index + 1);
+            stack.append(node.first);
+        }
+    }
+}
+
+QVector<MeshPolyline> Mesh::Slice(const QVector3D &normal,
+                                  double offset) const {
+    QVector<MeshPolyline> lines;
+    QVector<int> faces;
+    QueryPlane(normal, offset, faces);
+    std::sort(faces.begin(), faces.end());
+    // 顶点在平面正侧（含平面上）或负侧，半边从正到负为出边，从负到正为入边
+    auto distance = [this, &normal, offset](int h) {
+        return QVector3D::dotProduct(normal, vertices.at(indices.at(h))) -
+               offset;
+    };
+    auto findEdge = [&distance](int f, bool isExit) {
+        for (int h = 3 * f; h < 3 * f + 3; ++h) {
+            bool isBegin = distance(h) >= 0;
+            bool isEnd = distance(NextHalfEdge(h)) >= 0;
+            if (isBegin != isEnd && isBegin == isExit) {
+                return h;
+            }
+        }
+        return -1;
+    };
+    auto crossing = [this, &distance](int h) {
+        double d0 = distance(h);
+        double d1 = distance(NextHalfEdge(h));
+        const QVector3D &p = vertices.at(indices.at(h));
+        const QVector3D &q = vertices.at(indices.at(NextHalfEdge(h)));
+        return p + (q - p) * (d0 / (d0 - d1));
+    };
+    auto edgeNormal = [this](int h) {
+        QVector3D n = faceNormals.at(h / 3);
+        if (twins.at(h) >= 0) {
+            n += faceNormals.at(twins.at(h) / 3);
+        }
+        return n.normalized();
+    };
+    auto slot = [&faces](int f) {
+        auto it = std::lower_bound(faces.cbegin(), faces.cend(), f);
+        return it != faces.cend() && *it == f ? int(it - faces.cbegin()) : -1;
+    };
+    std::vector<char> visited(faces.size(), 0);
+    for (int i = 0; i < faces.size(); ++i) {
+        int f = faces.at(i);
+        if (visited[i]) {
+            continue;
+        }
+        visited[i] = 1;
+        int in = findEdge(f, false);
+        if (in < 0) {
+            continue; // 包围盒相交但面未穿过平面
+        }
+        MeshPolyline line;
+        line.isClosed = false;
+        line.points.append(crossing(in));
+        line.normals.append(edgeNormal(in));
+        // 沿出边经对边向前追踪，回到起始面即闭合
+        int g = f;
+        while (true) {
+            int out = findEdge(g, true);
+            int twin = twins.at(out);
+            if (twin >= 0 && twin / 3 == f) {
+                line.isClosed = true;
+                break;
+            }
+            line.points.append(crossing(out));
+            line.normals.append(edgeNormal(out));
+            if (twin < 0) {
+                break;
+            }
+            g = twin / 3;
+            int gi = slot(g);
+            if (gi < 0 || visited[gi]) {
+                break;
+            }
+            visited[gi] = 1;
+        }
+        // 未闭合时从起始面入边向后追踪
+        if (!line.isClosed) {
+            QVector<QVector3D> points;
+            QVector<QVector3D> normals;
+            int h = in;
+            while (twins.at(h) >= 0) {
+                g = twins.at(h) / 3;
+                int gi = slot(g);
+                if (gi < 0 || visited[gi]) {
+                    break;
+                }
+                visited[gi] = 1;
+                h = findEdge(g, false);
+                points.prepend(crossing(h));
+                normals.prepend(edgeNormal(h));
+            }
+            line.points = points + line.points;
+            line.normals = normals + line.normals;
+        }
+        if (line.points.size() >= 2) {
+            lines.append(line);
+        }
+    }
+    return lines;
+}
+
+QVector<QVector<MeshPolyline>>
+Mesh::Slice(const QVector3D &normal, const QVector<double> &offsets) const {
+    // 各线程按平面领取任务，结果写入对应位置
+    QVector<QVector<MeshPolyline>> slices(offsets.size());
+    QVector<MeshPolyline> *output = slices.data();
+    std::atomic<int> next(0);
+    auto worker = [this, &normal, &offsets, output, &next]() {
+        int i;
+        while ((i = next.fetch_add(1)) < offsets.size()) {
+            output[i] = Slice(normal, offsets.at(i));
+        }
+    };
+    int count = qBound(1, (int)std::thread::hardware_concurrency(),
+                       qMax(1, offsets.size()));
+    std::vector<std::thread> threads;
+    for (int i = 1; i < count; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    return slices;
+}
@@ -0,0 +1,279 @@
+﻿#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <mutex>
+
+#include "callstats.h"
+#include "metrics.h"
+
+// 按工艺名统计的最大工艺数，超出后计入最后一项
+constexpr int maxJobs = 64;
+// 单个请求头的长度上限
+constexpr int maxRequestSize = 8192;
+
+struct JobEntry {
+    std::atomic<quint64> cycles;      // 完成件数
+    std::atomic<double> lastSeconds;  // 最近一次节拍，s
+    std::atomic<double> totalSeconds; // 累计节拍，s
+};
+
+static std::atomic<bool> isMetricsEnabled(false);
+static JobEntry jobs[maxJobs];
+static QByteArray jobNames[maxJobs];
+static std::atomic<int> jobCount(0);
+static std::mutex jobMutex;
+static std::atomic<int> currentJob(-1);
+static std::atomic<quint64> cyclesStarted(0);
+static std::atomic<quint64> stopEvents(0);
+static std::atomic<quint64> stopsAtBegin(0);
+static std::atomic<bool> isCycleRunning(false);
+static std::atomic<int> pendingSegments(0);
+static std::atomic<int> queueDepth(-1);
+static std::atomic<double> agpForce(0);
+static std::atomic<double> agpTemperature(0);
+static std::atomic<double> agpSpeed(0);
+
+void RunMetrics::SetEnabled(bool isEnabled) {
+    isMetricsEnabled.store(isEnabled);
+}
+
+bool RunMetrics::IsEnabled() {
+    return isMetricsEnabled.load(std::memory_order_relaxed);
+}
+
+void RunMetrics::BeginCycle(const QString &craftID) {
+    QByteArray name = craftID.toUtf8();
+    int index = -1;
+    {
+        // 只有运行线程登记工艺名，抓取线程按 jobCount 读取已发布的名称
+        std::lock_guard<std::mutex> lock(jobMutex);
+        int count = jobCount.load();
+        for (int i = 0; i < count && index < 0; ++i) {
+            if (jobNames[i] == name) {
+                index = i;
+            }
+        }
+        if (index < 0 && count < maxJobs) {
+            jobNames[count] = name;
+            jobCount.store(count + 1);
+            index = count;
+        }
+        if (index < 0) {
+            index = maxJobs - 1;
+        }
+    }
+    currentJob.store(index);
+    stopsAtBegin.store(stopEvents.load());
+    cyclesStarted.fetch_add(1);
+    isCycleRunning.store(true);
+}
+
+// std::atomic<double> 没有 fetch_add
+static void AtomicAdd(std::atomic<double> &value, double delta) {
+    double current = value.load(std::memory_order_relaxed);
+    while (!value.compare_exchange_weak(current, current + delta,
+                                        std::memory_order_relaxed)) {
+    }
+}
+
+void RunMetrics::EndCycle(double seconds) {
+    isCycleRunning.store(false);
+    pendingSegments.store(0);
+    queueDepth.store(-1);
+    int index = currentJob.load();
+    if (index < 0 || stopEvents.load() != stopsAtBegin.load()) {
+        return;
+    }
+    JobEntry &job = jobs[index];
+    job.lastSeconds.store(seconds, std::memory_order_relaxed);
+    AtomicAdd(job.totalSeconds, seconds);
+    job.cycles.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RunMetrics::AddStop() { stopEvents.fetch_add(1); }
+
+void RunMetrics::SetPendingSegments(int count) {
+    pendingSegments.store(count, std::memory_order_relaxed);
+}
+
+void RunMetrics::SetQueueDepth(int depth) {
+    queueDepth.store(depth, std::memory_order_relaxed);
+}
+
+void RunMetrics::SetAGP(double force, double temperature, double speed) {
+    agpForce.store(force, std::memory_order_relaxed);
+    agpTemperature.store(temperature, std::memory_order_relaxed);
+    agpSpeed.store(speed, std::memory_order_relaxed);
+}
+
+// 标签值转义：反斜杠、双引号、换行
+static QByteArray Label(const QByteArray &value) {
+    QByteArray escaped = value;
+    escaped.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+    return escaped;
+}
+
+static void Header(QByteArray &text, const char *name, const char *type,
+                   const char *help) {
+    text += QByteArray("# HELP ") + name + " " + help + "\n";
+    text += QByteArray("# TYPE ") + name + " " + type + "\n";
+}
+
+static void Sample(QByteArray &text, const char *name, double value,
+                   const QByteArray &labels = QByteArray()) {
+    text += name;
+    if (!labels.isEmpty()) {
+        text += "{" + labels + "}";
+    }
+    text += " " + QByteArray::number(value, 'g', 12) + "\n";
+}
+
+QByteArray RunMetrics::Prometheus() {
+    QByteArray text;
+    Header(text, "swr_cycles_started_total", "counter", "Runs started.");
+    Sample(text, "swr_cycles_started_total", cyclesStarted.load());
+    Header(text, "swr_cycle_running", "gauge",
+           "Whether a run is in progress.");
+    Sample(text, "swr_cycle_running", isCycleRunning.load() ? 1 : 0);
+    Header(text, "swr_stop_events_total", "counter", "Stop requests.");
+    Sample(text, "swr_stop_events_total", stopEvents.load());
+
+    int count = jobCount.load();
+    Header(text, "swr_parts_completed_total", "counter",
+           "Runs completed without a stop, per craft.");
+    for (int i = 0; i < count; ++i) {
+        Sample(text, "swr_parts_completed_total",
+               jobs[i].cycles.load(std::memory_order_relaxed),
+               "craft=\"" + Label(jobNames[i]) + "\"");
+    }
+    Header(text, "swr_cycle_seconds", "gauge",
+           "Cycle time of the last completed run, per craft.");
+    for (int i = 0; i < count; ++i) {
+        if (jobs[i].cycles.load(std::memory_order_relaxed) > 0) {
+            Sample(text, "swr_cycle_seconds",
+                   jobs[i].lastSeconds.load(std::memory_order_relaxed),
+                   "craft=\"" + Label(jobNames[i]) + "\"");
+        }
+    }
+    Header(text, "swr_cycle_seconds_total", "counter",
+           "Total cycle time of completed runs, per craft.");
+    for (int i = 0; i < count; ++i) {
+        Sample(text, "swr_cycle_seconds_total",
+               jobs[i].totalSeconds.load(std::memory_order_relaxed),
+               "craft=\"" + Label(jobNames[i]) + "\"");
+    }
+
+    Header(text, "swr_path_segments_pending", "gauge",
+           "Planned path segments not yet sent to the controller.");
+    Sample(text, "swr_path_segments_pending", pendingSegments.load());
+    int depth = queueDepth.load();
+    if (depth >= 0) {
+        Header(text, "swr_motion_queue_depth", "gauge",
+               "Segments sent to the controller and not yet finished.");
+        Sample(text, "swr_motion_queue_depth", depth);
+    }
+    Header(text, "swr_agp_force_newtons", "gauge", "Measured AGP force.");
+    Sample(text, "swr_agp_force_newtons", agpForce.load());
+    Header(text, "swr_agp_temperature_celsius", "gauge",
+           "Measured AGP temperature.");
+    Sample(text, "swr_agp_temperature_celsius", agpTemperature.load());
+    Header(text, "swr_agp_speed_rpm", "gauge", "Measured AGP speed.");
+    Sample(text, "swr_agp_speed_rpm", agpSpeed.load());
+
+    QVector<CallSummary> summaries = CallStats::Summaries();
+    Header(text, "swr_call_latency_seconds", "summary",
+           "SDK and AGP Modbus call latency.");
+    for (const CallSummary &summary : summaries) {
+        QByteArray call = "call=\"" + Label(summary.name.toUtf8()) + "\"";
+        const char *quantiles[] = {"0.5", "0.9", "0.99", "0.999"};
+        double values[] = {summary.p50, summary.p90, summary.p99,
+                           summary.p999};
+        for (int q = 0; q < 4; ++q) {
+            Sample(text, "swr_call_latency_seconds", values[q] / 1e6,
+                   call + ",quantile=\"" + quantiles[q] + "\"");
+        }
+        Sample(text, "swr_call_latency_seconds_sum", summary.total / 1e3,
+               call);
+        Sample(text, "swr_call_latency_seconds_count", summary.count, call);
+    }
+    Header(text, "swr_call_errors_total", "counter",
+           "SDK and AGP Modbus calls that returned an error.");
+    for (const CallSummary &summary : summaries) {
+        Sample(text, "swr_call_errors_total", summary.errors,
+               "call=\"" + Label(summary.name.toUtf8()) + "\"");
+    }
+    return text;
+}
+
+MetricsServer::MetricsServer() : isRunning(false) {}
+
+MetricsServer::~MetricsServer() { Stop(); }
+
+bool MetricsServer::Start(quint16 port) {
+    Stop();
+    // 等待服务线程报告监听结果：0 等待中，1 成功，-1 失败
+    std::atomic<int> state(0);
+    isRunning.store(true);
+    server = std::thread(&MetricsServer::Serve, this, port, &state);
+    while (state.load() == 0) {
+        std::this_thread::yield();
+    }
+    if (state.load() < 0) {
+        Stop();
+        return false;
+    }
+    return true;
+}
+
+void MetricsServer::Stop() {
+    isRunning.store(false);
+    if (server.joinable()) {
+        server.join();
+    }
+}
+
+bool MetricsServer::IsRunning() const { return isRunning.load(); }
+
+void MetricsServer::Serve(quint16 port, std::atomic<int> *state) {
+    // Qt 网络对象属于本线程，以阻塞方式使用，无需事件循环
+    QTcpServer listener;
+    if (!listener.listen(QHostAddress::LocalHost, port)) {
+        state->store(-1);
+        return;
+    }
+    state->store(1);
+    while (isRunning.load()) {
+        if (!listener.waitForNewConnection(200)) {
+            continue;
+        }
+        QTcpSocket *socket = listener.nextPendingConnection();
+        QByteArray request;
+        while (!request.contains("\r\n\r\n") &&
+               request.size() < maxRequestSize &&
+               socket->waitForReadyRead(1000)) {
+            request += socket->readAll();
+        }
+        QList<QByteArray> fields =
+            request.left(request.indexOf('\n')).split(' ');
+        QByteArray status = "200 OK";
+        QByteArray body;
+        if (fields.size() < 2 || fields.at(0) != "GET") {
+            status = "405 Method Not Allowed";
+        } else if (fields.at(1) == "/metrics") {
+            body = RunMetrics::Prometheus();
+        } else {
+            status = "404 Not Found";
+        }
+        socket->write("HTTP/1.1 " + status +
+                      "\r\nContent-Type: text/plain; version=0.0.4; "
+                      "charset=utf-8\r\nContent-Length: " +
+                      QByteArray::number(body.size()) +
+                      "\r\nConnection: close\r\n\r\n" + body);
+        socket->waitForBytesWritten(1000);
+        socket->disconnectFromHost();
+        if (socket->state() != QAbstractSocket::UnconnectedState) {
+            socket->waitForDisconnected(1000);
+        }
+        delete socket;
+    }
+}
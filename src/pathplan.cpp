@@ -0,0 +1,491 @@
+﻿#include <QPair>
+#include <cmath>
+
+#include "pathplan.h"
+
+FeedPlanParams::FeedPlanParams()
+    : isEnabled(false), contactSpeed(0), maxSpeed(500), minSpeed(5),
+      maxAngularSpeed(60) {}
+
+BlendPlanParams::BlendPlanParams()
+    : isEnabled(false), maxRadius(5), tolerance(0.5) {}
+
+CompressParams::CompressParams()
+    : isEnabled(false), tolerance(0.1), rotTolerance(0.5), maxArcAngle(180) {}
+
+// 三点圆弧长度，三点共线时按折线计算
+static double ArcLength(const QVector3D &A, const QVector3D &B,
+                        const QVector3D &C, double *radius) {
+    double length = A.distanceToPoint(B) + B.distanceToPoint(C);
+    if (radius != nullptr) {
+        *radius = 0;
+    }
+    QVector3D N = QVector3D::crossProduct(B - A, C - A);
+    if (N.lengthSquared() < 1e-6) {
+        return length;
+    }
+    QVector3D O = Point::calculateCircumcenter(A, B, C);
+    QVector3D OA = A - O;
+    QVector3D OB = B - O;
+    QVector3D OC = C - O;
+    double r = OA.length();
+    double angleAB = qAcos(
+        qBound(-1.0, (double)QVector3D::dotProduct(OA, OB) / (r * r), 1.0));
+    double angleBC = qAcos(
+        qBound(-1.0, (double)QVector3D::dotProduct(OB, OC) / (r * r), 1.0));
+    if (radius != nullptr) {
+        *radius = r;
+    }
+    return r * (angleAB + angleBC);
+}
+
+double PathPlanner::SegmentLength(const Point &start,
+                                  const PathSegment &segment,
+                                  double *radius) {
+    if (segment.isArc) {
+        return ArcLength(start.pos, segment.auxPoint.pos, segment.endPoint.pos,
+                         radius);
+    }
+    if (radius != nullptr) {
+        *radius = 0;
+    }
+    return start.pos.distanceToPoint(segment.endPoint.pos);
+}
+
+// 圆弧上某点的切线方向，三点共线时返回零向量
+static QVector3D ArcTangent(const QVector3D &A, const QVector3D &B,
+                            const QVector3D &C, const QVector3D &X) {
+    QVector3D N = QVector3D::crossProduct(B - A, C - B);
+    if (N.lengthSquared() < 1e-6) {
+        return QVector3D();
+    }
+    QVector3D O = Point::calculateCircumcenter(A, B, C);
+    return QVector3D::crossProduct(N, X - O).normalized();
+}
+
+QVector3D PathPlanner::StartTangent(const Point &start,
+                                    const PathSegment &segment) {
+    if (segment.isArc) {
+        QVector3D tangent = ArcTangent(start.pos, segment.auxPoint.pos,
+                                       segment.endPoint.pos, start.pos);
+        if (!tangent.isNull()) {
+            return tangent;
+        }
+    }
+    return (segment.endPoint.pos - start.pos).normalized();
+}
+
+QVector3D PathPlanner::EndTangent(const Point &start,
+                                  const PathSegment &segment) {
+    if (segment.isArc) {
+        QVector3D tangent =
+            ArcTangent(start.pos, segment.auxPoint.pos, segment.endPoint.pos,
+                       segment.endPoint.pos);
+        if (!tangent.isNull()) {
+            return tangent;
+        }
+    }
+    return (segment.endPoint.pos - start.pos).normalized();
+}
+
+double PathPlanner::RotationAngle(const QVector3D &rot1,
+                                  const QVector3D &rot2) {
+    // R = R1^T * R2 的转角
+    QMatrix3x3 R1 = Point::toRotationMatrix(rot1);
+    QMatrix3x3 R2 = Point::toRotationMatrix(rot2);
+    double trace = 0;
+    for (int i = 0; i < 3; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            trace += R1(k, i) * R2(k, i);
+        }
+    }
+    return qRadiansToDegrees(qAcos(qBound(-1.0, (trace - 1) / 2, 1.0)));
+}
+
+Point PathPlanner::ToTcp(const Point &point, double toolOffset) {
+    return point.PosRelByTool(OffsetDirection::OffsetZ, -toolOffset);
+}
+
+void PathPlanner::PlanFeed(QVector<PathSegment> &path, double toolOffset,
+                           double contactSpeed, const FeedPlanParams &params) {
+    if (contactSpeed <= 0) {
+        return;
+    }
+    for (int i = 1; i < path.size(); ++i) {
+        PathSegment &segment = path[i];
+        // 空移、切入、抬起保持生成时的速度
+        if (!segment.isContact) {
+            continue;
+        }
+        const Point &start = path.at(i - 1).endPoint;
+        // 接触侧与TCP侧轨迹长度（圆弧即半径之比），TCP在凸面外侧走得更长
+        double contactLength = SegmentLength(start, segment);
+        PathSegment tcpSegment = segment;
+        tcpSegment.auxPoint = ToTcp(segment.auxPoint, toolOffset);
+        tcpSegment.endPoint = ToTcp(segment.endPoint, toolOffset);
+        double tcpLength =
+            SegmentLength(ToTcp(start, toolOffset), tcpSegment);
+        double velocity = contactSpeed;
+        if (contactLength > 1e-3) {
+            velocity = contactSpeed * tcpLength / contactLength;
+        }
+        // 姿态变化快的段按角速度上限降速（近似关节速度限制）
+        double angle = RotationAngle(start.rot, segment.endPoint.rot);
+        if (segment.isArc) {
+            angle = RotationAngle(start.rot, segment.auxPoint.rot) +
+                    RotationAngle(segment.auxPoint.rot, segment.endPoint.rot);
+        }
+        if (angle > 1e-3 && params.maxAngularSpeed > 0 && tcpLength > 1e-3) {
+            velocity =
+                qMin(velocity, params.maxAngularSpeed * tcpLength / angle);
+        }
+        segment.velocity = qBound(params.minSpeed, velocity, params.maxSpeed);
+    }
+}
+
+double PathPlanner::EstimateDuration(const QVector<PathSegment> &path,
+                                     double toolOffset) {
+    double duration = 0;
+    for (int i = 1; i < path.size(); ++i) {
+        const PathSegment &segment = path.at(i);
+        PathSegment tcpSegment = segment;
+        tcpSegment.auxPoint = ToTcp(segment.auxPoint, toolOffset);
+        tcpSegment.endPoint = ToTcp(segment.endPoint, toolOffset);
+        double length =
+            SegmentLength(ToTcp(path.at(i - 1).endPoint, toolOffset),
+                          tcpSegment);
+        double velocity = segment.velocity;
+        double acc = segment.acc;
+        if (length <= 0 || velocity <= 0) {
+            continue;
+        }
+        if (acc <= 0) {
+            duration += length / velocity;
+            continue;
+        }
+        // 起点、终点是否停顿，每个停顿端加减速多用 v/(2a)
+        bool isStartStop = path.at(i - 1).radius <= 0 &&
+                           !(segment.isStreamed && path.at(i - 1).isStreamed);
+        bool isEndStop = segment.radius <= 0 &&
+                         !(i + 1 < path.size() && segment.isStreamed &&
+                           path.at(i + 1).isStreamed);
+        int stops = (isStartStop ? 1 : 0) + (isEndStop ? 1 : 0);
+        double rampLength = stops * velocity * velocity / (2 * acc);
+        if (length >= rampLength) {
+            duration += length / velocity + stops * velocity / (2 * acc);
+        } else {
+            // 达不到设定速度：两端停顿为三角形速度曲线，单端停顿为匀加速
+            duration += stops == 2 ? 2 * qSqrt(length / acc)
+                                   : qSqrt(2 * length / acc);
+        }
+    }
+    return duration;
+}
+
+// 角度差换算到 (-180, 180]
+static double AngleDelta(double from, double to) {
+    double delta = std::fmod(to - from, 360.0);
+    if (delta > 180) {
+        delta -= 360;
+    } else if (delta <= -180) {
+        delta += 360;
+    }
+    return delta;
+}
+
+// 姿态插值：from 到 to 的比例 f，各角按最近的角度差
+static QVector3D LerpRotation(const QVector3D &from, const QVector3D &to,
+                              double f) {
+    return QVector3D(
+        AngleDelta(0, from.x() + AngleDelta(from.x(), to.x()) * f),
+        AngleDelta(0, from.y() + AngleDelta(from.y(), to.y()) * f),
+        AngleDelta(0, from.z() + AngleDelta(from.z(), to.z()) * f));
+}
+
+QVector<Point> PathPlanner::SampleServo(const QVector<Point> &points,
+                                        double velocity, double acc,
+                                        double period) {
+    QVector<Point> samples;
+    if (points.size() < 2 || velocity <= 0 || period <= 0) {
+        return samples;
+    }
+    QVector<double> lengths(points.size(), 0);
+    for (int i = 1; i < points.size(); ++i) {
+        lengths[i] = lengths.at(i - 1) +
+                     points.at(i - 1).pos.distanceToPoint(points.at(i).pos);
+    }
+    double total = lengths.last();
+    // 梯形速度曲线：加速段时长 rampTime，匀速段时长 cruiseTime
+    double peak = velocity;
+    if (acc > 0 && peak * peak / acc > total) {
+        peak = qSqrt(acc * total);
+    }
+    double rampTime = acc > 0 ? peak / acc : 0;
+    double rampLength = peak * rampTime / 2;
+    double cruiseTime = peak > 0 ? (total - 2 * rampLength) / peak : 0;
+    double duration = 2 * rampTime + cruiseTime;
+    int count = qMax(1, qCeil(duration / period));
+    samples.reserve(count);
+    int index = 1;
+    for (int k = 1; k <= count; ++k) {
+        double t = qMin(k * period, duration);
+        double s;
+        if (t < rampTime) {
+            s = acc * t * t / 2;
+        } else if (t < rampTime + cruiseTime) {
+            s = rampLength + peak * (t - rampTime);
+        } else {
+            double rest = duration - t;
+            s = total - acc * rest * rest / 2;
+        }
+        if (k == count) {
+            samples.append(points.last());
+            break;
+        }
+        s = qBound(0.0, s, total);
+        while (index + 1 < points.size() && lengths.at(index) < s) {
+            ++index;
+        }
+        const Point &from = points.at(index - 1);
+        const Point &to = points.at(index);
+        double span = lengths.at(index) - lengths.at(index - 1);
+        float f = span > 0 ? (s - lengths.at(index - 1)) / span : 1;
+        Point point = to;
+        point.pos = from.pos + (to.pos - from.pos) * f;
+        point.rot = LerpRotation(from.rot, to.rot, f);
+        samples.append(point);
+    }
+    return samples;
+}
+
+void PathPlanner::PlanBlend(QVector<PathSegment> &path, double toolOffset,
+                            const BlendPlanParams &params) {
+    if (path.isEmpty()) {
+        return;
+    }
+    // 过渡半径是TCP到路点的距离，按TCP侧路径计算
+    QVector<PathSegment> tcpPath = path;
+    for (PathSegment &segment : tcpPath) {
+        segment.auxPoint = ToTcp(segment.auxPoint, toolOffset);
+        segment.endPoint = ToTcp(segment.endPoint, toolOffset);
+    }
+    QVector<double> lengths(path.size(), 0);
+    for (int i = 1; i < path.size(); ++i) {
+        lengths[i] = SegmentLength(tcpPath.at(i - 1).endPoint, tcpPath.at(i));
+    }
+    // 首段起点未知（当前位置），末段需要停稳
+    path.first().radius = 0;
+    path.last().radius = 0;
+    for (int i = 1; i + 1 < path.size(); ++i) {
+        double radius =
+            qMin(params.maxRadius, qMin(lengths[i], lengths[i + 1]) / 2);
+        QVector3D tangentIn =
+            EndTangent(tcpPath.at(i - 1).endPoint, tcpPath.at(i));
+        QVector3D tangentOut =
+            StartTangent(tcpPath.at(i).endPoint, tcpPath.at(i + 1));
+        double phi = qAcos(qBound(
+            -1.0, (double)QVector3D::dotProduct(tangentIn, tangentOut), 1.0));
+        if (phi > qDegreesToRadians(175.0)) {
+            radius = 0; // 原路折返不过渡
+        } else if (phi > 1e-6) {
+            // 拐角到过渡圆弧的最大偏差为 r·tan(φ/4)
+            radius = qMin(radius, params.tolerance / qTan(phi / 4));
+        }
+        path[i].radius = qMax(0.0, radius);
+    }
+}
+
+// 点位 first..last 用直线 first->last 表示时偏差最大的点位（位置、姿态偏差
+// 按各自允许值归一化），全部在允许范围内时返回 -1
+static int LineOutlier(const QVector<QVector3D> &positions,
+                       const QVector<QVector3D> &rotations,
+                       const QVector<double> &lengths, int first, int last,
+                       const CompressParams &params) {
+    const QVector3D &A = positions.at(first);
+    QVector3D AB = positions.at(last) - A;
+    double lengthSquared = AB.lengthSquared();
+    double span = lengths.at(last) - lengths.at(first);
+    double maxError = 1;
+    int outlier = -1;
+    for (int k = first + 1; k < last; ++k) {
+        const QVector3D &X = positions.at(k);
+        // 到线段（而非直线）的距离，原路折返的点位不会被漏掉
+        double along = QVector3D::dotProduct(X - A, AB);
+        double t = lengthSquared > 0 ? qBound(0.0, along / lengthSquared, 1.0)
+                                     : 0;
+        double error = X.distanceToPoint(A + AB * t) / params.tolerance;
+        if (params.rotTolerance > 0) {
+            double f =
+                span > 0 ? (lengths.at(k) - lengths.at(first)) / span : 0;
+            QVector3D rot =
+                LerpRotation(rotations.at(first), rotations.at(last), f);
+            error = qMax(error,
+                         PathPlanner::RotationAngle(rot, rotations.at(k)) /
+                             params.rotTolerance);
+        }
+        if (error > maxError) {
+            maxError = error;
+            outlier = k;
+        }
+    }
+    return outlier;
+}
+
+// 点位 first..last 能否用经过 first、mid、last 的圆弧表示：偏差在允许范围内，
+// 点位沿圆弧单调前进，圆心角不超过上限。mid 取弧长居中的点位
+static bool FitArc(const QVector<QVector3D> &positions,
+                   const QVector<QVector3D> &rotations,
+                   const QVector<double> &lengths, int first, int last,
+                   const CompressParams &params, int &mid) {
+    double half = (lengths.at(first) + lengths.at(last)) / 2;
+    mid = first + 1;
+    while (mid + 1 < last && lengths.at(mid) < half) {
+        ++mid;
+    }
+    const QVector3D &A = positions.at(first);
+    const QVector3D &B = positions.at(mid);
+    const QVector3D &C = positions.at(last);
+    // 三点接近共线时圆心不稳定，交给直线段
+    QVector3D N = QVector3D::crossProduct(B - A, C - A);
+    double sine = N.length() / (A.distanceToPoint(B) * A.distanceToPoint(C));
+    if (!(sine > 1e-3)) {
+        return false;
+    }
+    N.normalize();
+    QVector3D O = Point::calculateCircumcenter(A, B, C);
+    QVector3D OA = A - O;
+    double r = OA.length();
+    // 点位相对起点绕法向转过的角度，rad，起点附近的微小回退记为负值
+    double slack = params.tolerance / r;
+    auto angleOf = [&](const QVector3D &X) {
+        QVector3D OX = X - O;
+        double angle = std::atan2(
+            QVector3D::dotProduct(N, QVector3D::crossProduct(OA, OX)),
+            QVector3D::dotProduct(OA, OX));
+        return angle < -slack ? angle + 2 * M_PI : angle;
+    };
+    double total = angleOf(C);
+    if (total > qDegreesToRadians(params.maxArcAngle)) {
+        return false;
+    }
+    double progress = 0;
+    for (int k = first + 1; k < last; ++k) {
+        QVector3D OX = positions.at(k) - O;
+        double height = QVector3D::dotProduct(OX, N);
+        double radial = (OX - N * height).length() - r;
+        if (qSqrt(height * height + radial * radial) > params.tolerance) {
+            return false;
+        }
+        double angle = angleOf(positions.at(k));
+        if (angle < progress - slack || angle > total + slack) {
+            return false;
+        }
+        progress = qMax(progress, angle);
+        if (params.rotTolerance > 0) {
+            QVector3D rot = LerpRotation(rotations.at(first),
+                                         rotations.at(last), angle / total);
+            if (PathPlanner::RotationAngle(rot, rotations.at(k)) >
+                params.rotTolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 能否与 head 开始的直线段一起压缩
+static bool IsMergeable(const PathSegment &head, const PathSegment &segment,
+                        bool isStreamKept) {
+    return !segment.isArc && segment.phase == head.phase &&
+           segment.isContact == head.isContact &&
+           segment.velocity == head.velocity && segment.acc == head.acc &&
+           segment.isStreamed == head.isStreamed &&
+           !(segment.isStreamed && isStreamKept);
+}
+
+int PathPlanner::Compress(QVector<PathSegment> &path,
+                          const CompressParams &params, bool isStreamKept) {
+    if (params.tolerance <= 0) {
+        return 0;
+    }
+    QVector<PathSegment> result;
+    result.reserve(path.size());
+    int i = 0;
+    while (i < path.size()) {
+        // 可压缩的连续直线段 [i, end)，首段起点未知，不参与压缩
+        int end = i;
+        while (i > 0 && end < path.size() &&
+               IsMergeable(path.at(i), path.at(end), isStreamKept)) {
+            ++end;
+        }
+        if (end - i < 2) {
+            result.append(path.at(i));
+            ++i;
+            continue;
+        }
+        // 点位 k 为第 i + k - 1 段的终点，点位 0 为前一段终点
+        int count = end - i + 1;
+        QVector<QVector3D> positions(count);
+        QVector<QVector3D> rotations(count);
+        QVector<double> lengths(count, 0);
+        for (int k = 0; k < count; ++k) {
+            const Point &point = path.at(i + k - 1).endPoint;
+            positions[k] = point.pos;
+            rotations[k] = point.rot;
+            if (k > 0) {
+                lengths[k] = lengths.at(k - 1) +
+                             positions.at(k - 1).distanceToPoint(point.pos);
+            }
+        }
+        // Douglas–Peucker，用栈代替递归，长路径不会栈溢出
+        QVector<bool> isKept(count, false);
+        isKept[0] = true;
+        isKept[count - 1] = true;
+        QVector<QPair<int, int>> ranges{qMakePair(0, count - 1)};
+        while (!ranges.isEmpty()) {
+            QPair<int, int> range = ranges.takeLast();
+            int k = LineOutlier(positions, rotations, lengths, range.first,
+                                range.second, params);
+            if (k >= 0) {
+                isKept[k] = true;
+                ranges.append(qMakePair(range.first, k));
+                ranges.append(qMakePair(k, range.second));
+            }
+        }
+        QVector<int> breaks;
+        for (int k = 0; k < count; ++k) {
+            if (isKept.at(k)) {
+                breaks.append(k);
+            }
+        }
+        // 从每个分段点起尽量向后合并为一段圆弧，不能合并时保留直线段
+        int b = 0;
+        while (b + 1 < breaks.size()) {
+            int arcEnd = -1;
+            int arcMid = -1;
+            for (int m = b + 2; m < breaks.size(); ++m) {
+                int mid;
+                if (!FitArc(positions, rotations, lengths, breaks.at(b),
+                            breaks.at(m), params, mid)) {
+                    break;
+                }
+                arcEnd = m;
+                arcMid = mid;
+            }
+            int next = arcEnd >= 0 ? arcEnd : b + 1;
+            // 终点、过渡半径等沿用原来在该点结束的路径段
+            PathSegment segment = path.at(i + breaks.at(next) - 1);
+            if (arcEnd >= 0) {
+                segment.isArc = true;
+                segment.auxPoint = path.at(i + arcMid - 1).endPoint;
+                segment.isStreamed = false;
+            }
+            result.append(segment);
+            b = next;
+        }
+        i = end;
+    }
+    int removed = path.size() - result.size();
+    path = result;
+    return removed;
+}
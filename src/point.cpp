@@ -1,5 +1,6 @@
 ﻿#include <QMatrix4x4>
 #include <QQuaternion>
+#include <QStringList>
 
 #include "point.h"
 
@@ -96,16 +97,35 @@ Point Point::PosRelByTool(const OffsetDirection &direction,
 }
 
 QString Point::toString() const {
+    // 固定三位小数（0.001mm、0.001°），默认的6位有效数字保存后会丢精度
     QString str = QString("%1、%2、%3、%4、%5、%6")
-                      .arg(pos.x())
-                      .arg(pos.y())
-                      .arg(pos.z())
-                      .arg(rot.x())
-                      .arg(rot.y())
-                      .arg(rot.z());
+                      .arg(pos.x(), 0, 'f', 3)
+                      .arg(pos.y(), 0, 'f', 3)
+                      .arg(pos.z(), 0, 'f', 3)
+                      .arg(rot.x(), 0, 'f', 3)
+                      .arg(rot.y(), 0, 'f', 3)
+                      .arg(rot.z(), 0, 'f', 3);
     return str;
 }
 
+bool Point::fromString(const QString &str, Point &point) {
+    QStringList values = str.split("、");
+    if (values.size() != 6) {
+        return false;
+    }
+    float v[6];
+    for (int i = 0; i < 6; ++i) {
+        bool ok = false;
+        v[i] = values.at(i).trimmed().toFloat(&ok);
+        if (!ok) {
+            return false;
+        }
+    }
+    point.pos = QVector3D(v[0], v[1], v[2]);
+    point.rot = QVector3D(v[3], v[4], v[5]);
+    return true;
+}
+
 void Point::operator+=(const Point &point) {
     pos += point.pos;
     // rot += point.rot;
@@ -139,14 +159,98 @@ QVector3D Point::calculateCircumcenter(const QVector3D &A, const QVector3D &B,
     return circumcenter;
 }
 
-static QVector3D calculateSpherecenter(const QVector3D &A, const QVector3D &B,
+QVector3D Point::calculateSpherecenter(const QVector3D &A, const QVector3D &B,
                                        const QVector3D &C, const QVector3D &D) {
-    // TODO
-    QVector3D spherecenter;
+    // 以A为原点，球心X满足 2(B-A)·X = |B-A|²，C、D同理，克拉默法则求解
+    QVector3D AB = B - A;
+    QVector3D AC = C - A;
+    QVector3D AD = D - A;
+    float det = 2.f * QVector3D::dotProduct(AB, QVector3D::crossProduct(AC, AD));
+    // det 随边长三次方变化，按三边长之积取相对阈值判断四点近似共面
+    double scale = double(AB.length()) * AC.length() * AD.length();
+    if (scale <= 0 || qAbs(det) < 2 * 1e-3 * scale) {
+        return A;
+    }
+
+    QVector3D toSpherecenter =
+        (QVector3D::crossProduct(AC, AD) * AB.lengthSquared() +
+         QVector3D::crossProduct(AD, AB) * AC.lengthSquared() +
+         QVector3D::crossProduct(AB, AC) * AD.lengthSquared()) /
+        det;
+
+    QVector3D spherecenter = A + toSpherecenter;
 
     return spherecenter;
 }
 
+bool Point::fitSphere(const QVector<QVector3D> &points, QVector3D &center,
+                      float &radius) {
+    int size = points.size();
+    if (size < 4) {
+        return false;
+    }
+    if (size == 4) {
+        center = calculateSpherecenter(points.at(0), points.at(1),
+                                       points.at(2), points.at(3));
+        radius = center.distanceToPoint(points.at(0));
+        return radius > 1e-3f;
+    }
+    // 以重心为原点提高精度，代数拟合 |q|² + D·q + G = 0
+    QVector3D mean;
+    for (const QVector3D &point : points) {
+        mean += point;
+    }
+    mean /= size;
+    double A[4][5] = {};
+    for (const QVector3D &point : points) {
+        QVector3D q = point - mean;
+        double row[4] = {q.x(), q.y(), q.z(), 1};
+        double rhs = -q.lengthSquared();
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                A[i][j] += row[i] * row[j];
+            }
+            A[i][4] += row[i] * rhs;
+        }
+    }
+    // 正规方程，列主元高斯消元
+    for (int k = 0; k < 4; ++k) {
+        int pivot = k;
+        for (int i = k + 1; i < 4; ++i) {
+            if (qAbs(A[i][k]) > qAbs(A[pivot][k])) {
+                pivot = i;
+            }
+        }
+        if (qAbs(A[pivot][k]) < 1e-9) {
+            return false; // 点共面或重合
+        }
+        for (int j = 0; j < 5; ++j) {
+            qSwap(A[k][j], A[pivot][j]);
+        }
+        for (int i = k + 1; i < 4; ++i) {
+            double factor = A[i][k] / A[k][k];
+            for (int j = k; j < 5; ++j) {
+                A[i][j] -= factor * A[k][j];
+            }
+        }
+    }
+    double x[4];
+    for (int i = 3; i >= 0; --i) {
+        x[i] = A[i][4];
+        for (int j = i + 1; j < 4; ++j) {
+            x[i] -= A[i][j] * x[j];
+        }
+        x[i] /= A[i][i];
+    }
+    double r2 = (x[0] * x[0] + x[1] * x[1] + x[2] * x[2]) / 4 - x[3];
+    if (r2 <= 1e-6) {
+        return false;
+    }
+    center = mean - QVector3D(x[0], x[1], x[2]) / 2;
+    radius = qSqrt(r2);
+    return true;
+}
+
 QMatrix3x3 Point::toRotationMatrix(const QVector3D &rotation) {
     // 转换角度为弧度
     QVector3D rot_rad{qDegreesToRadians(rotation.x()),
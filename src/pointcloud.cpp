@@ -0,0 +1,496 @@
+﻿#include <QFile>
+#include <QtEndian>
+#include <QtMath>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "pointcloud.h"
+#include "textparse.h"
+
+// KD树叶节点点数
+constexpr int leafSize = 8;
+// 法向估计每次领取的点数
+constexpr int normalChunk = 4096;
+
+// 建树时并行的层数，使子树数不少于线程数
+static int ParallelDepth() {
+    int threads = qMax(1u, std::thread::hardware_concurrency());
+    int depth = 0;
+    while ((1 << depth) < threads) {
+        ++depth;
+    }
+    return depth;
+}
+
+// 对称3x3矩阵最小特征值对应的特征向量（Jacobi迭代）
+static QVector3D SmallestEigenvector(double a[3][3]) {
+    double v[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    const int pairs[3][2] = {{0, 1}, {0, 2}, {1, 2}};
+    for (int sweep = 0; sweep < 16; ++sweep) {
+        double off = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+        if (off < 1e-18) {
+            break;
+        }
+        for (const auto &pair : pairs) {
+            int p = pair[0];
+            int q = pair[1];
+            if (qAbs(a[p][q]) < 1e-30) {
+                continue;
+            }
+            double theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+            double t = (theta >= 0 ? 1 : -1) /
+                       (qAbs(theta) + qSqrt(theta * theta + 1));
+            double c = 1 / qSqrt(t * t + 1);
+            double s = t * c;
+            for (int k = 0; k < 3; ++k) {
+                double akp = a[k][p];
+                double akq = a[k][q];
+                a[k][p] = c * akp - s * akq;
+                a[k][q] = s * akp + c * akq;
+            }
+            for (int k = 0; k < 3; ++k) {
+                double apk = a[p][k];
+                double aqk = a[q][k];
+                a[p][k] = c * apk - s * aqk;
+                a[q][k] = s * apk + c * aqk;
+            }
+            for (int k = 0; k < 3; ++k) {
+                double vkp = v[k][p];
+                double vkq = v[k][q];
+                v[k][p] = c * vkp - s * vkq;
+                v[k][q] = s * vkp + c * vkq;
+            }
+        }
+    }
+    int index = 0;
+    for (int i = 1; i < 3; ++i) {
+        if (a[i][i] < a[index][index]) {
+            index = i;
+        }
+    }
+    return QVector3D(v[0][index], v[1][index], v[2][index]).normalized();
+}
+
+PointCloud::PointCloud() : hasNormals(false) {}
+
+bool PointCloud::Load(const QString &fileName, int k) {
+    Clear();
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray data = file.readAll();
+    file.close();
+    bool ok = data.startsWith("ply") ? LoadPly(data) : LoadXyz(data);
+    if (!ok || positions.size() < 3) {
+        Clear();
+        return false;
+    }
+    // 按下标排序建树，最后统一重排点和法向
+    std::vector<int> order(positions.size());
+    for (int i = 0; i < positions.size(); ++i) {
+        order[i] = i;
+    }
+    axes.fill(0, positions.size());
+    BuildIndex(order.data(), axes.data(), 0, positions.size(), 0);
+    QVector<QVector3D> sorted(positions.size());
+    for (int i = 0; i < positions.size(); ++i) {
+        sorted[i] = positions.at(order[i]);
+    }
+    positions.swap(sorted);
+    if (hasNormals) {
+        for (int i = 0; i < normals.size(); ++i) {
+            sorted[i] = normals.at(order[i]).normalized();
+        }
+        normals.swap(sorted);
+    } else {
+        EstimateNormals(qMax(3, k));
+    }
+    this->fileName = fileName;
+    return true;
+}
+
+void PointCloud::Clear() {
+    fileName.clear();
+    positions.clear();
+    normals.clear();
+    axes.clear();
+    hasNormals = false;
+}
+
+bool PointCloud::IsEmpty() const { return positions.isEmpty(); }
+
+int PointCloud::Count() const { return positions.size(); }
+
+QString PointCloud::FileName() const { return fileName; }
+
+const QVector3D &PointCloud::Position(int index) const {
+    return positions.at(index);
+}
+
+const QVector3D &PointCloud::Normal(int index) const {
+    return normals.at(index);
+}
+
+bool PointCloud::LoadXyz(const QByteArray &data) {
+    // 每行 x y z [nx ny nz]，无法解析的行（注释、表头）跳过。
+    // 后三列须都是单位向量才当作法向，否则视为颜色（XYZRGB）另行估计
+    const char *p = data.constData();
+    const char *end = p + data.size();
+    hasNormals = true;
+    while (p < end) {
+        const char *lineEnd = (const char *)std::memchr(p, '\n', end - p);
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+        double values[6];
+        int count = ParseNumbers(p, lineEnd, values, 6);
+        if (count >= 3) {
+            positions.append(QVector3D(values[0], values[1], values[2]));
+            if (count == 6) {
+                normals.append(QVector3D(values[3], values[4], values[5]));
+            } else {
+                hasNormals = false;
+            }
+        }
+        p = lineEnd + 1;
+    }
+    for (int i = 0; hasNormals && i < normals.size(); ++i) {
+        if (qAbs(normals[i].length() - 1.0f) > 0.05f) {
+            hasNormals = false;
+        }
+    }
+    if (!hasNormals) {
+        normals.clear();
+    }
+    return true;
+}
+
+bool PointCloud::LoadPly(const QByteArray &data) {
+    // 文件头：只支持 vertex 为第一个元素，其他元素（面片等）忽略
+    int headerEnd = data.indexOf("end_header");
+    if (headerEnd < 0) {
+        return false;
+    }
+    int bodyBegin = data.indexOf('\n', headerEnd);
+    if (bodyBegin < 0) {
+        return false;
+    }
+    ++bodyBegin;
+    QList<QByteArray> lines = data.left(headerEnd).split('\n');
+    bool isBinary = false;
+    int vertexCount = -1;
+    bool isVertexElement = false;
+    QVector<QByteArray> types;
+    QVector<QByteArray> names;
+    for (const QByteArray &line : lines) {
+        QList<QByteArray> words = line.simplified().split(' ');
+        if (words.first() == "format" && words.size() >= 2) {
+            if (words.at(1) == "binary_little_endian") {
+                isBinary = true;
+            } else if (words.at(1) != "ascii") {
+                return false;
+            }
+        } else if (words.first() == "element" && words.size() >= 3) {
+            if (words.at(1) == "vertex") {
+                if (vertexCount >= 0 || !types.isEmpty()) {
+                    return false;
+                }
+                vertexCount = words.at(2).toInt();
+                isVertexElement = true;
+            } else {
+                if (vertexCount < 0) {
+                    return false; // vertex 之前有其他元素
+                }
+                isVertexElement = false;
+            }
+        } else if (words.first() == "property" && isVertexElement) {
+            if (words.size() < 3 || words.at(1) == "list") {
+                return false;
+            }
+            types.append(words.at(1));
+            names.append(words.at(2));
+        }
+    }
+    int ix = names.indexOf("x");
+    int iy = names.indexOf("y");
+    int iz = names.indexOf("z");
+    int inx = names.indexOf("nx");
+    int iny = names.indexOf("ny");
+    int inz = names.indexOf("nz");
+    if (vertexCount <= 0 || ix < 0 || iy < 0 || iz < 0) {
+        return false;
+    }
+    hasNormals = inx >= 0 && iny >= 0 && inz >= 0;
+    positions.reserve(vertexCount);
+    if (hasNormals) {
+        normals.reserve(vertexCount);
+    }
+    int propertyCount = names.size();
+    QVector<double> values(propertyCount);
+    const char *p = data.constData() + bodyBegin;
+    const char *end = data.constData() + data.size();
+    if (!isBinary) {
+        for (int i = 0; i < vertexCount && p < end; ++i) {
+            const char *lineEnd = (const char *)std::memchr(p, '\n', end - p);
+            if (lineEnd == nullptr) {
+                lineEnd = end;
+            }
+            if (ParseNumbers(p, lineEnd, values.data(), propertyCount) ==
+                propertyCount) {
+                positions.append(QVector3D(values[ix], values[iy], values[iz]));
+                if (hasNormals) {
+                    normals.append(
+                        QVector3D(values[inx], values[iny], values[inz]));
+                }
+            }
+            p = lineEnd + 1;
+        }
+        return true;
+    }
+    // 二进制：按属性类型计算偏移
+    QVector<int> offsets(propertyCount);
+    QVector<int> sizes(propertyCount);
+    int stride = 0;
+    for (int i = 0; i < propertyCount; ++i) {
+        const QByteArray &type = types.at(i);
+        if (type == "char" || type == "uchar" || type == "int8" ||
+            type == "uint8") {
+            sizes[i] = 1;
+        } else if (type == "short" || type == "ushort" || type == "int16" ||
+                   type == "uint16") {
+            sizes[i] = 2;
+        } else if (type == "int" || type == "uint" || type == "int32" ||
+                   type == "uint32" || type == "float" || type == "float32") {
+            sizes[i] = 4;
+        } else if (type == "double" || type == "float64") {
+            sizes[i] = 8;
+        } else {
+            return false;
+        }
+        offsets[i] = stride;
+        stride += sizes[i];
+    }
+    if ((qint64)stride * vertexCount > end - p) {
+        return false;
+    }
+    auto readValue = [&types, &sizes, &offsets](const char *record, int i) {
+        const char *q = record + offsets.at(i);
+        const QByteArray &type = types.at(i);
+        switch (sizes.at(i)) {
+        case 1:
+            return type.startsWith('u') ? (double)(quint8)q[0]
+                                        : (double)(qint8)q[0];
+        case 2:
+            return type.startsWith('u') ? (double)qFromLittleEndian<quint16>(q)
+                                        : (double)qFromLittleEndian<qint16>(q);
+        case 4:
+            if (type.startsWith('f')) {
+                quint32 bits = qFromLittleEndian<quint32>(q);
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return (double)value;
+            }
+            return type.startsWith('u') ? (double)qFromLittleEndian<quint32>(q)
+                                        : (double)qFromLittleEndian<qint32>(q);
+        default: {
+            quint64 bits = qFromLittleEndian<quint64>(q);
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        }
+    };
+    for (int i = 0; i < vertexCount; ++i) {
+        const char *record = p + (qint64)stride * i;
+        positions.append(QVector3D(readValue(record, ix), readValue(record, iy),
+                                   readValue(record, iz)));
+        if (hasNormals) {
+            normals.append(QVector3D(readValue(record, inx),
+                                     readValue(record, iny),
+                                     readValue(record, inz)));
+        }
+    }
+    return true;
+}
+
+void PointCloud::BuildIndex(int *order, quint8 *axisData, int lo, int hi,
+                            int depth) {
+    if (hi - lo <= leafSize) {
+        return;
+    }
+    // 按包围盒最长边分割，区间中点为节点
+    QVector3D minPos = positions.at(order[lo]);
+    QVector3D maxPos = minPos;
+    for (int i = lo + 1; i < hi; ++i) {
+        const QVector3D &pos = positions.at(order[i]);
+        for (int j = 0; j < 3; ++j) {
+            minPos[j] = qMin(minPos[j], pos[j]);
+            maxPos[j] = qMax(maxPos[j], pos[j]);
+        }
+    }
+    QVector3D extent = maxPos - minPos;
+    int axis = 0;
+    if (extent.y() > extent[axis]) {
+        axis = 1;
+    }
+    if (extent.z() > extent[axis]) {
+        axis = 2;
+    }
+    int mid = (lo + hi) / 2;
+    std::nth_element(order + lo, order + mid, order + hi,
+                     [this, axis](int a, int b) {
+                         return positions.at(a)[axis] < positions.at(b)[axis];
+                     });
+    axisData[mid] = axis;
+    // 上层子树交给线程并行构建
+    static const int parallelDepth = ParallelDepth();
+    if (depth < parallelDepth && hi - lo > 65536) {
+        std::thread left(&PointCloud::BuildIndex, this, order, axisData, lo,
+                         mid, depth + 1);
+        BuildIndex(order, axisData, mid + 1, hi, depth + 1);
+        left.join();
+    } else {
+        BuildIndex(order, axisData, lo, mid, depth + 1);
+        BuildIndex(order, axisData, mid + 1, hi, depth + 1);
+    }
+}
+
+int PointCloud::KNearest(const QVector3D &point, int k, int *indices,
+                         float *distances) const {
+    int found = 0;
+    if (k > 0 && !positions.isEmpty()) {
+        SearchIndex(0, positions.size(), point, k, indices, distances, found);
+    }
+    return found;
+}
+
+void PointCloud::SearchIndex(int lo, int hi, const QVector3D &point, int k,
+                             int *indices, float *distances,
+                             int &found) const {
+    // 有序插入，保留最近的k个
+    auto insert = [&](int index) {
+        float distance = (positions.at(index) - point).lengthSquared();
+        if (found == k && distance >= distances[k - 1]) {
+            return;
+        }
+        int i = found < k ? found++ : k - 1;
+        while (i > 0 && distances[i - 1] > distance) {
+            distances[i] = distances[i - 1];
+            indices[i] = indices[i - 1];
+            --i;
+        }
+        distances[i] = distance;
+        indices[i] = index;
+    };
+    if (hi - lo <= leafSize) {
+        for (int i = lo; i < hi; ++i) {
+            insert(i);
+        }
+        return;
+    }
+    int mid = (lo + hi) / 2;
+    int axis = axes.at(mid);
+    insert(mid);
+    float diff = point[axis] - positions.at(mid)[axis];
+    if (diff < 0) {
+        SearchIndex(lo, mid, point, k, indices, distances, found);
+        if (found < k || diff * diff < distances[found - 1]) {
+            SearchIndex(mid + 1, hi, point, k, indices, distances, found);
+        }
+    } else {
+        SearchIndex(mid + 1, hi, point, k, indices, distances, found);
+        if (found < k || diff * diff < distances[found - 1]) {
+            SearchIndex(lo, mid, point, k, indices, distances, found);
+        }
+    }
+}
+
+void PointCloud::EstimateNormals(int k) {
+    // 各线程按块领取点，k近邻协方差最小特征向量即法向
+    int size = positions.size();
+    normals.fill(QVector3D(), size);
+    QVector3D *output = normals.data();
+    std::atomic<int> next(0);
+    auto worker = [this, k, size, output, &next]() {
+        std::vector<int> indices(k);
+        std::vector<float> distances(k);
+        while (true) {
+            int begin = next.fetch_add(normalChunk);
+            if (begin >= size) {
+                break;
+            }
+            int end = qMin(size, begin + normalChunk);
+            for (int i = begin; i < end; ++i) {
+                int found = KNearest(positions.at(i), k, indices.data(),
+                                     distances.data());
+                QVector3D mean;
+                for (int j = 0; j < found; ++j) {
+                    mean += positions.at(indices[j]);
+                }
+                mean /= found;
+                double cov[3][3] = {};
+                for (int j = 0; j < found; ++j) {
+                    QVector3D d = positions.at(indices[j]) - mean;
+                    for (int r = 0; r < 3; ++r) {
+                        for (int c = 0; c < 3; ++c) {
+                            cov[r][c] += d[r] * d[c];
+                        }
+                    }
+                }
+                output[i] = SmallestEigenvector(cov);
+            }
+        }
+    };
+    int count = qMax(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (int i = 1; i < count; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+bool PointCloud::Project(const QVector3D &origin, const QVector3D &direction,
+                         int k, double maxGap, QVector3D &point,
+                         QVector3D &normal) const {
+    if (positions.isEmpty()) {
+        return false;
+    }
+    k = qBound(1, k, 64);
+    int indices[64];
+    float distances[64];
+    QVector3D dir = direction.normalized();
+    point = origin;
+    // 最近邻平面与投影线求交，迭代收敛到曲面上
+    for (int iteration = 0; iteration < 4; ++iteration) {
+        int found = KNearest(point, k, indices, distances);
+        QVector3D mean;
+        QVector3D sum;
+        for (int j = 0; j < found; ++j) {
+            mean += positions.at(indices[j]);
+            const QVector3D &n = normals.at(indices[j]);
+            sum += QVector3D::dotProduct(n, dir) < 0 ? -n : n;
+        }
+        mean /= found;
+        normal = sum.normalized();
+        double cosine = QVector3D::dotProduct(normal, dir);
+        if (normal.isNull() || cosine < 0.1) {
+            return false; // 投影方向与曲面近似平行
+        }
+        double step = QVector3D::dotProduct(mean - point, normal) / cosine;
+        point += dir * step;
+        if (qAbs(step) < 1e-3) {
+            break;
+        }
+    }
+    int nearest;
+    float distance;
+    KNearest(point, 1, &nearest, &distance);
+    return qSqrt(distance) <= maxGap;
+}
@@ -0,0 +1,37 @@
+﻿#include "probe.h"
+
+// 建立基线的采样数
+static constexpr int baselineSamples = 10;
+// 判定接触需连续满足阈值的采样数
+static constexpr int contactSamples = 2;
+
+ProbeParams::ProbeParams()
+    : speed(5), approach(20), overtravel(10), interval(2), force(10),
+      posDrop(0.5), forceRise(5) {}
+
+ContactDetector::ContactDetector()
+    : posDrop(0), forceRise(0), baseCount(0), basePos(0), baseForce(0),
+      hits(0) {}
+
+void ContactDetector::Reset(const ProbeParams &params) {
+    posDrop = params.posDrop;
+    forceRise = params.forceRise;
+    baseCount = 0;
+    basePos = 0;
+    baseForce = 0;
+    hits = 0;
+}
+
+bool ContactDetector::Update(double agpPos, double force) {
+    if (baseCount < baselineSamples) {
+        basePos += agpPos / baselineSamples;
+        baseForce += force / baselineSamples;
+        ++baseCount;
+        return false;
+    }
+    // 打磨头被工件推回时位置减小，压力增大
+    bool isTouched =
+        basePos - agpPos >= posDrop || force - baseForce >= forceRise;
+    hits = isTouched ? hits + 1 : 0;
+    return hits >= contactSamples;
+}
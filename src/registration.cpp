@@ -0,0 +1,162 @@
+﻿#include <QQuaternion>
+#include <QtMath>
+#include <algorithm>
+
+#include "registration.h"
+
+RegistrationParams::RegistrationParams() : maxResidual(1), minSpread(10) {}
+
+RigidTransform::RigidTransform() : rms(0), maxError(0) {}
+
+// 对称矩阵特征分解（Jacobi迭代），a 对角线为特征值，v 的列为特征向量
+template <int N> static void JacobiEigen(double a[N][N], double v[N][N]) {
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            v[i][j] = i == j ? 1 : 0;
+        }
+    }
+    for (int sweep = 0; sweep < 32; ++sweep) {
+        double off = 0;
+        for (int p = 0; p < N; ++p) {
+            for (int q = p + 1; q < N; ++q) {
+                off += a[p][q] * a[p][q];
+            }
+        }
+        if (off < 1e-24) {
+            break;
+        }
+        for (int p = 0; p < N; ++p) {
+            for (int q = p + 1; q < N; ++q) {
+                if (qAbs(a[p][q]) < 1e-30) {
+                    continue;
+                }
+                double theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+                double t = (theta >= 0 ? 1 : -1) /
+                           (qAbs(theta) + qSqrt(theta * theta + 1));
+                double c = 1 / qSqrt(t * t + 1);
+                double s = t * c;
+                for (int k = 0; k < N; ++k) {
+                    double akp = a[k][p];
+                    double akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < N; ++k) {
+                    double apk = a[p][k];
+                    double aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < N; ++k) {
+                    double vkp = v[k][p];
+                    double vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+}
+
+bool FrameRegistration::Solve(const QVector<QVector3D> &from,
+                              const QVector<QVector3D> &to,
+                              const RegistrationParams &params,
+                              RigidTransform &transform) {
+    transform = RigidTransform();
+    int n = from.size();
+    if (n < 3 || to.size() != n) {
+        return false;
+    }
+    // 去质心后的点，double 累加避免大坐标下的精度损失
+    double fromCenter[3] = {0, 0, 0};
+    double toCenter[3] = {0, 0, 0};
+    for (int i = 0; i < n; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            fromCenter[k] += from.at(i)[k] / n;
+            toCenter[k] += to.at(i)[k] / n;
+        }
+    }
+    double cov[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+    double s[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+    for (int i = 0; i < n; ++i) {
+        double p[3], q[3];
+        for (int k = 0; k < 3; ++k) {
+            p[k] = from.at(i)[k] - fromCenter[k];
+            q[k] = to.at(i)[k] - toCenter[k];
+        }
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                cov[r][c] += p[r] * p[c] / n;
+                s[r][c] += p[r] * q[c];
+            }
+        }
+    }
+    // 基准点近似共线时绕该直线的转角不确定：第二大特征值即偏离主方向的方差
+    double axes[3][3];
+    JacobiEigen<3>(cov, axes);
+    double eigen[3] = {cov[0][0], cov[1][1], cov[2][2]};
+    std::sort(eigen, eigen + 3);
+    if (eigen[1] < params.minSpread * params.minSpread) {
+        return false;
+    }
+    // Horn：最优旋转的单位四元数为 4x4 对称矩阵最大特征值的特征向量，
+    // 结果恒为右手旋转，不会出现 SVD 解的反射
+    double m[4][4] = {
+        {s[0][0] + s[1][1] + s[2][2], s[1][2] - s[2][1], s[2][0] - s[0][2],
+         s[0][1] - s[1][0]},
+        {s[1][2] - s[2][1], s[0][0] - s[1][1] - s[2][2], s[0][1] + s[1][0],
+         s[2][0] + s[0][2]},
+        {s[2][0] - s[0][2], s[0][1] + s[1][0], -s[0][0] + s[1][1] - s[2][2],
+         s[1][2] + s[2][1]},
+        {s[0][1] - s[1][0], s[2][0] + s[0][2], s[1][2] + s[2][1],
+         -s[0][0] - s[1][1] + s[2][2]}};
+    double v[4][4];
+    JacobiEigen<4>(m, v);
+    int index = 0;
+    for (int i = 1; i < 4; ++i) {
+        if (m[i][i] > m[index][index]) {
+            index = i;
+        }
+    }
+    QQuaternion quaternion(v[0][index], v[1][index], v[2][index],
+                           v[3][index]);
+    transform.rotation = quaternion.normalized().toRotationMatrix();
+    QVector3D center(fromCenter[0], fromCenter[1], fromCenter[2]);
+    QVector3D rotated;
+    for (int r = 0; r < 3; ++r) {
+        rotated[r] = transform.rotation(r, 0) * center.x() +
+                     transform.rotation(r, 1) * center.y() +
+                     transform.rotation(r, 2) * center.z();
+    }
+    transform.translation =
+        QVector3D(toCenter[0], toCenter[1], toCenter[2]) - rotated;
+
+    // 残差
+    QVector<Point> points(n);
+    for (int i = 0; i < n; ++i) {
+        points[i].pos = from.at(i);
+    }
+    Apply(transform, points);
+    double sum = 0;
+    for (int i = 0; i < n; ++i) {
+        double error = points.at(i).pos.distanceToPoint(to.at(i));
+        sum += error * error;
+        transform.maxError = qMax(transform.maxError, error);
+    }
+    transform.rms = qSqrt(sum / n);
+    return transform.maxError <= params.maxResidual;
+}
+
+void FrameRegistration::Apply(const RigidTransform &transform,
+                              QVector<Point> &points) {
+    const QMatrix3x3 &R = transform.rotation;
+    for (Point &point : points) {
+        QVector3D pos = point.pos;
+        for (int r = 0; r < 3; ++r) {
+            point.pos[r] = R(r, 0) * pos.x() + R(r, 1) * pos.y() +
+                           R(r, 2) * pos.z() + transform.translation[r];
+        }
+        point.rot =
+            Point::toEulerAngles(R * Point::toRotationMatrix(point.rot));
+    }
+}
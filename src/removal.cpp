@@ -0,0 +1,142 @@
+﻿#include <QImage>
+#include <QtMath>
+#include <cfloat>
+#include <cmath>
+
+#include "removal.h"
+
+RemovalParams::RemovalParams() : coefficient(1e-6), target(1) {}
+
+RemovalMap::RemovalMap()
+    : minDepth(0), meanDepth(0), maxDepth(0), shortCells(0), speedScale(0) {}
+
+// 打磨片平面内弓高为 sagitta 的弓形面积，mm²
+static double SegmentArea(double radius, double sagitta) {
+    double h = qBound(0.0, sagitta, 2 * radius);
+    double d = radius - h;
+    return radius * radius * qAcos(d / radius) -
+           d * qSqrt(qMax(0.0, 2 * radius * h - h * h));
+}
+
+bool RemovalSimulator::Simulate(const QVector<PathSegment> &path,
+                                const QVector<QVector3D> &corners,
+                                double discRadius, double force,
+                                double rotateSpeed,
+                                const CoverageParams &gridParams,
+                                const RemovalParams &params,
+                                RemovalMap &map) {
+    map = RemovalMap();
+    if (path.size() < 2 ||
+        !CoverageAnalyzer::InitMap(corners, discRadius, gridParams.cellSize,
+                                   map.grid)) {
+        return false;
+    }
+    const CoverageMap &grid = map.grid;
+    QVector<ContactPatch> patches = CoverageAnalyzer::SamplePath(
+        path, grid, discRadius, gridParams.depth);
+    map.depths.fill(0, grid.width * grid.height);
+    // 每个采样去除深度 = 增益 × 到打磨片中心的距离，增益 = k·p·ω·t，换算为 μm
+    double omega = rotateSpeed * 2 * M_PI / 60;
+    QVector<float> gains(patches.size(), 0);
+    for (int p = 0; p < patches.size(); ++p) {
+        const ContactPatch &patch = patches.at(p);
+        double area = SegmentArea(discRadius, patch.length / patch.cosTilt);
+        if (area > 1e-6) {
+            gains[p] = params.coefficient * force / area * omega *
+                       patch.dwell * 1000;
+        }
+    }
+    int width = grid.width;
+    float *output = map.depths.data();
+    float radius = discRadius;
+    CoverageAnalyzer::ForEachTile(
+        grid, patches,
+        [&](int left, int bottom, int right, int top,
+            const std::vector<int> &indices) {
+            for (int p : indices) {
+                const ContactPatch &patch = patches.at(p);
+                float gain = gains.at(p);
+                float length = patch.length;
+                float invCos = 1 / patch.cosTilt;
+                int first = qMax(left, patch.minX);
+                int count = qMin(right, patch.maxX) - first + 1;
+                for (int j = qMax(bottom, patch.minY);
+                     j <= qMin(top, patch.maxY); ++j) {
+                    float along0 = patch.along0 + patch.alongX * first +
+                                   patch.alongY * j;
+                    float across0 = patch.across0 + patch.acrossX * first +
+                                    patch.acrossY * j;
+                    float *cells = output + j * width + first;
+                    // 打磨片核：内层循环无分支、连续访存，由编译器向量化
+                    for (int k = 0; k < count; ++k) {
+                        float along = along0 + patch.alongX * k;
+                        float across = across0 + patch.acrossX * k;
+                        float rim = along * invCos;
+                        float radial = radius - rim;
+                        float chord = rim * (2 * radius - rim) - across * across;
+                        float r = std::sqrt(radial * radial + across * across);
+                        cells[k] += (along >= 0 && along <= length && chord >= 0)
+                                        ? gain * r
+                                        : 0.0f;
+                    }
+                }
+            }
+        });
+
+    // 统计区域内去除深度
+    double sum = 0;
+    int regionCells = 0;
+    map.minDepth = DBL_MAX;
+    for (int c = 0; c < map.depths.size(); ++c) {
+        if (!grid.mask.at(c)) {
+            continue;
+        }
+        double depth = map.depths.at(c);
+        map.minDepth = qMin(map.minDepth, depth);
+        map.maxDepth = qMax(map.maxDepth, depth);
+        sum += depth;
+        ++regionCells;
+        if (depth < params.target) {
+            ++map.shortCells;
+        }
+    }
+    if (regionCells == 0) {
+        map.minDepth = 0;
+        return false;
+    }
+    map.meanDepth = sum / regionCells;
+    // 去除深度与停留时间成正比，即与进给速度成反比
+    map.speedScale = params.target > 0 ? map.minDepth / params.target : 0;
+    return true;
+}
+
+bool RemovalSimulator::SaveHeatmap(const RemovalMap &map, double target,
+                                   const QString &fileName) {
+    const CoverageMap &grid = map.grid;
+    if (grid.width <= 0 || grid.height <= 0) {
+        return false;
+    }
+    QImage image(grid.width, grid.height, QImage::Format_RGB32);
+    for (int j = 0; j < grid.height; ++j) {
+        // 图像 y 向下，网格 y 向上
+        QRgb *line =
+            reinterpret_cast<QRgb *>(image.scanLine(grid.height - 1 - j));
+        for (int i = 0; i < grid.width; ++i) {
+            int index = j * grid.width + i;
+            double depth = map.depths.at(index);
+            if (!grid.mask.at(index)) {
+                line[i] = depth > 0 ? qRgb(150, 150, 150) : qRgb(90, 90, 90);
+            } else if (depth < target) {
+                double t = target > 0 ? depth / target : 0;
+                line[i] = qRgb(220, qRound(40 + 140 * t), 40);
+            } else {
+                double t = map.maxDepth > target
+                               ? (depth - target) / (map.maxDepth - target)
+                               : 0;
+                line[i] = qRgb(qRound(200 - 180 * t), qRound(235 - 155 * t),
+                               qRound(200 - 40 * t));
+            }
+        }
+    }
+    return image.save(fileName, "PNG");
+}
@@ -1,26 +1,47 @@
-﻿#include <QDebug>
+﻿#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
 #include <QDesktopServices>
-#include <QMessageBox>
+#include <QDir>
+#include <QSettings>
 #include <QThread>
 #include <QUrl>
+#include <chrono>
+#include <algorithm>
+#include <climits>
+#include <cstring>
 
+#include "callstats.h"
+#include "craftstore.h"
 #include "robot.h"
-
-#include "HR_Pro.h"
+#include "trace.h"
 
 constexpr int defaultOffset = -30;
 constexpr OffsetDirection defaultDirection = OffsetDirection::OffsetZ;
 constexpr double defaultVelocity = 200;
 constexpr double precision = 1e-4;
 
-int status = -1;
-std::string robotIPAddr;
-
 Robot::Robot()
-    : agp(nullptr), isTeach(false), isStop(true), discThickness(0),
-      teachPos(0) {}
+    : agp(nullptr), isTeach(false), isStop(true), segmentIndex(0),
+      isSegmentTracked(false), isRunLogEnabled(true), runLogDir("logs"),
+      runLogInterval(10), isRecording(false), isForceFeedOn(false),
+      feedScale(1),
+      forceFeedTarget(0), forceFeedContact(0), isForceFeedControlling(false),
+      lastOverride(1), capturePath(nullptr),
+      capturePhase(PathPhase::ApproachPhase), isCaptureContact(false),
+      isCaptureStreamed(false),
+      splineStep(2), isSphereSpiral(false), sphereStep(2),
+      isCloudRaster(false), cloudStep(2), cloudNeighbors(16), cloudGap(5),
+      isMeshRaster(false), meshStep(1),
+      executionMode(ExecutionMode::AutoMode), servoPeriod(0.008),
+      isTeachRecording(false), discThickness(0), teachPos(0) {}
 
 Robot::~Robot() {
+    StopRecorder();
+    isTeachRecording.store(false);
+    if (teachRecorder.joinable()) {
+        teachRecorder.join();
+    }
     if (agp != nullptr) {
         delete agp;
         agp = nullptr;
@@ -28,52 +49,58 @@ Robot::~Robot() {
 }
 
 bool Robot::AGPConnect(QString agpIP) {
+    std::lock_guard<std::recursive_mutex> lock(agpMutex);
     if (agp != nullptr) {
         delete agp;
     }
     agp = new AGP(agpIP.toStdString());
-    if (agp != nullptr && agp->AGP_connect()) {
-        agp->Control(FUNC::RESET);
-        agp->Control(FUNC::ENABLE);
-        agp->SetMode(MODE::ForceMode);
-        agp->SetLoadWeight(22);
-        agp->SetForce(20);
-        agp->SetSpeed(0);
+    if (agp != nullptr && AGP_CALL(AGP_connect)) {
+        AGP_CALL(Control, FUNC::RESET);
+        AGP_CALL(Control, FUNC::ENABLE);
+        AGP_CALL(SetMode, MODE::ForceMode);
+        AGP_CALL(SetLoadWeight, 22);
+        AGP_CALL(SetForce, 20);
+        AGP_CALL(SetSpeed, 0);
         return true;
     }
     return false;
 }
 
 void Robot::AGPRun(const Craft &craft, bool isRotated) {
+    if (agp == nullptr) {
+        return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(agpMutex);
     // 设置AGP参数
-    agp->Control(FUNC::RESET);
-    agp->Control(FUNC::ENABLE);
+    AGP_CALL(Control, FUNC::RESET);
+    AGP_CALL(Control, FUNC::ENABLE);
     switch (craft.mode) {
     case PolishMode::MomentMode:
-        agp->SetMode(MODE::ForceMode);
+        AGP_CALL(SetMode, MODE::ForceMode);
         break;
     case PolishMode::PositionMode:
-        agp->SetMode(MODE::PosMode);
+        AGP_CALL(SetMode, MODE::PosMode);
         break;
     default:
         break;
     }
     if (isRotated) {
-        agp->SetSpeed(craft.rotateSpeed);
+        AGP_CALL(SetSpeed, craft.rotateSpeed);
     } else {
-        agp->SetSpeed(0);
+        AGP_CALL(SetSpeed, 0);
     }
-    agp->SetTouchForce(craft.contactForce);
-    agp->SetRampTime(craft.transitionTime);
-    agp->SetForce(craft.settingForce);
-    agp->SetPos(craft.teachPointReferPos * 100);
+    AGP_CALL(SetTouchForce, craft.contactForce);
+    AGP_CALL(SetRampTime, craft.transitionTime);
+    AGP_CALL(SetForce, craft.settingForce);
+    AGP_CALL(SetPos, craft.teachPointReferPos * 100);
 }
 
 void Robot::AGPStop() {
     if (agp != nullptr) {
         while (true) {
             if (!IsRobotMoved()) {
-                agp->SetSpeed(0);
+                std::lock_guard<std::recursive_mutex> lock(agpMutex);
+                AGP_CALL(SetSpeed, 0);
                 break;
             }
         }
@@ -81,8 +108,9 @@ void Robot::AGPStop() {
 }
 
 bool Robot::IsAGPEnabled() {
+    std::lock_guard<std::recursive_mutex> lock(agpMutex);
     if (agp != nullptr) {
-        int16_t state = agp->ReadStatus();
+        int16_t state = AGP_CALL(ReadStatus);
         if ((state & 0x01) == 1) {
             return true;
         }
@@ -90,13 +118,520 @@ bool Robot::IsAGPEnabled() {
     return false;
 }
 
+void Robot::LoadSettings(const QString &fileName) {
+    QSettings settings(fileName, QSettings::IniFormat);
+    settings.setIniCodec("UTF-8");
+    // 运行记录
+    settings.beginGroup("RunLog");
+    isRunLogEnabled = settings.value("Enabled", true).toBool();
+    runLogDir = settings.value("Directory", "logs").toString();
+    runLogInterval = qMax(1, settings.value("Interval", 10).toInt());
+    settings.endGroup();
+    // 调用耗时统计、运行时间线
+    settings.beginGroup("Diagnostics");
+    CallStats::SetEnabled(settings.value("CallStats", false).toBool());
+    traceDir = settings.value("TraceDir").toString();
+    settings.endGroup();
+    // 本机指标服务（Prometheus），同时开启调用耗时统计
+    settings.beginGroup("Metrics");
+    bool isMetricsEnabled = settings.value("Enabled", false).toBool();
+    quint16 metricsPort = settings.value("Port", 9105).toUInt();
+    settings.endGroup();
+    RunMetrics::SetEnabled(isMetricsEnabled);
+    if (isMetricsEnabled) {
+        CallStats::SetEnabled(true);
+        if (!metricsServer.IsRunning() && !metricsServer.Start(metricsPort)) {
+            qWarning("metrics: cannot listen on port %d", metricsPort);
+        }
+    } else {
+        metricsServer.Stop();
+    }
+    // 力自适应进给
+    ForceFeedParams params;
+    settings.beginGroup("ForceFeed");
+    params.isEnabled = settings.value("Enabled", params.isEnabled).toBool();
+    params.targetForce =
+        settings.value("TargetForce", params.targetForce).toDouble();
+    params.band = settings.value("Band", params.band).toDouble();
+    params.kp = settings.value("Kp", params.kp).toDouble();
+    params.ki = settings.value("Ki", params.ki).toDouble();
+    params.maxRate = settings.value("MaxRate", params.maxRate).toDouble();
+    params.floor = settings.value("Floor", params.floor).toDouble();
+    params.ceiling = settings.value("Ceiling", params.ceiling).toDouble();
+    params.filterTime =
+        settings.value("FilterTime", params.filterTime * 1000).toDouble() /
+        1000;
+    settings.endGroup();
+    forceFeed.SetParams(params);
+    // 连续轨迹执行方式
+    settings.beginGroup("Motion");
+    QString mode = settings.value("Mode", "auto").toString().toLower();
+    if (mode == "waypoint") {
+        executionMode = ExecutionMode::WaypointMode;
+    } else if (mode == "path") {
+        executionMode = ExecutionMode::PathUploadMode;
+    } else if (mode == "servo") {
+        executionMode = ExecutionMode::ServoMode;
+    } else {
+        executionMode = ExecutionMode::AutoMode;
+    }
+    servoPeriod = settings.value("ServoPeriod", servoPeriod * 1000).toDouble() /
+                  1000;
+    settings.endGroup();
+    // 曲率进给规划
+    settings.beginGroup("FeedPlan");
+    feedPlanParams.isEnabled =
+        settings.value("Enabled", feedPlanParams.isEnabled).toBool();
+    feedPlanParams.contactSpeed =
+        settings.value("ContactSpeed", feedPlanParams.contactSpeed).toDouble();
+    feedPlanParams.maxSpeed =
+        settings.value("MaxSpeed", feedPlanParams.maxSpeed).toDouble();
+    feedPlanParams.minSpeed =
+        settings.value("MinSpeed", feedPlanParams.minSpeed).toDouble();
+    feedPlanParams.maxAngularSpeed =
+        settings.value("MaxAngularSpeed", feedPlanParams.maxAngularSpeed)
+            .toDouble();
+    settings.endGroup();
+    // 路径压缩
+    settings.beginGroup("Compress");
+    compressParams.isEnabled =
+        settings.value("Enabled", compressParams.isEnabled).toBool();
+    compressParams.tolerance =
+        settings.value("Tolerance", compressParams.tolerance).toDouble();
+    compressParams.rotTolerance =
+        settings.value("RotTolerance", compressParams.rotTolerance).toDouble();
+    compressParams.maxArcAngle =
+        settings.value("MaxArcAngle", compressParams.maxArcAngle).toDouble();
+    settings.endGroup();
+    // 过渡半径规划
+    settings.beginGroup("BlendPlan");
+    blendPlanParams.isEnabled =
+        settings.value("Enabled", blendPlanParams.isEnabled).toBool();
+    blendPlanParams.maxRadius =
+        settings.value("MaxRadius", blendPlanParams.maxRadius).toDouble();
+    blendPlanParams.tolerance =
+        settings.value("Tolerance", blendPlanParams.tolerance).toDouble();
+    settings.endGroup();
+    // 覆盖分析
+    settings.beginGroup("Coverage");
+    coverageParams.cellSize =
+        settings.value("CellSize", coverageParams.cellSize).toDouble();
+    coverageParams.depth =
+        settings.value("Depth", coverageParams.depth).toDouble();
+    coverageParams.target =
+        settings.value("Target", coverageParams.target).toDouble();
+    coverageParams.maxOffsetCount =
+        settings.value("MaxOffsetCount", coverageParams.maxOffsetCount)
+            .toInt();
+    settings.endGroup();
+    // 材料去除仿真
+    settings.beginGroup("Removal");
+    removalParams.coefficient =
+        settings.value("Coefficient", removalParams.coefficient).toDouble();
+    removalParams.target =
+        settings.value("Target", removalParams.target).toDouble();
+    settings.endGroup();
+    // 参数扫描，范围写作 "min,max,step"（QSettings 按逗号拆成列表）
+    settings.beginGroup("Sweep");
+    sweepParams.moveSpeed.Parse(
+        settings.value("MoveSpeed").toStringList().join(','));
+    sweepParams.offsetCount.Parse(
+        settings.value("OffsetCount").toStringList().join(','));
+    sweepParams.grindAngle.Parse(
+        settings.value("GrindAngle").toStringList().join(','));
+    sweepParams.transitionRadius.Parse(
+        settings.value("TransitionRadius").toStringList().join(','));
+    sweepParams.isRemovalMetric =
+        settings.value("Metric", "Coverage").toString().compare(
+            "Removal", Qt::CaseInsensitive) == 0;
+    sweepParams.minQuality =
+        settings.value("MinQuality", sweepParams.minQuality).toDouble();
+    sweepParams.maxVariants =
+        settings.value("MaxVariants", sweepParams.maxVariants).toInt();
+    settings.endGroup();
+    // 样条路径
+    settings.beginGroup("Spline");
+    splineStep = qMax(0.1, settings.value("Step", 2).toDouble());
+    settings.endGroup();
+    // 球面路径
+    settings.beginGroup("Sphere");
+    isSphereSpiral =
+        settings.value("Pattern", "Latitude").toString().compare(
+            "Spiral", Qt::CaseInsensitive) == 0;
+    sphereStep = qMax(0.1, settings.value("Step", 2).toDouble());
+    settings.endGroup();
+    // 点云路径
+    settings.beginGroup("Cloud");
+    isCloudRaster =
+        settings.value("Pattern", "Boustrophedon").toString().compare(
+            "Raster", Qt::CaseInsensitive) == 0;
+    cloudStep = qMax(0.1, settings.value("Step", 2).toDouble());
+    cloudNeighbors = qBound(3, settings.value("Neighbors", 16).toInt(), 64);
+    cloudGap = qMax(0.1, settings.value("MaxGap", 5).toDouble());
+    settings.endGroup();
+    // 模型切片路径
+    settings.beginGroup("Mesh");
+    isMeshRaster =
+        settings.value("Pattern", "Boustrophedon").toString().compare(
+            "Raster", Qt::CaseInsensitive) == 0;
+    meshStep = qMax(0.1, settings.value("Step", 1).toDouble());
+    settings.endGroup();
+    // 拖拽示教录制
+    settings.beginGroup("Teach");
+    teachParams.interval =
+        qMax(1, settings.value("Interval", teachParams.interval).toInt());
+    teachParams.duration =
+        qMax(1.0, settings.value("Duration", teachParams.duration).toDouble());
+    teachParams.step =
+        qMax(0.1, settings.value("Step", teachParams.step).toDouble());
+    settings.endGroup();
+    // 工件坐标系配准
+    settings.beginGroup("Registration");
+    registerParams.maxResidual =
+        settings.value("MaxResidual", registerParams.maxResidual).toDouble();
+    registerParams.minSpread =
+        settings.value("MinSpread", registerParams.minSpread).toDouble();
+    settings.endGroup();
+    // 触碰探测
+    settings.beginGroup("Probe");
+    probeParams.speed =
+        qMax(0.1, settings.value("Speed", probeParams.speed).toDouble());
+    probeParams.approach =
+        settings.value("Approach", probeParams.approach).toDouble();
+    probeParams.overtravel =
+        settings.value("Overtravel", probeParams.overtravel).toDouble();
+    probeParams.interval =
+        qMax(1, settings.value("Interval", probeParams.interval).toInt());
+    probeParams.force = settings.value("Force", probeParams.force).toInt();
+    probeParams.posDrop =
+        settings.value("PosDrop", probeParams.posDrop).toDouble();
+    probeParams.forceRise =
+        settings.value("ForceRise", probeParams.forceRise).toDouble();
+    settings.endGroup();
+}
+
+bool Robot::GetJointPos(double *joints) {
+    Q_UNUSED(joints);
+    return false;
+}
+
+int Robot::GetCurrentSegment() { return segmentIndex.load(); }
+
+bool Robot::SetSpeedOverride(double ratio) {
+    Q_UNUSED(ratio);
+    return false;
+}
+
+bool Robot::MoveTcpPath(const QVector<Point> &points, double dVelocity,
+                        double dAcc) {
+    Q_UNUSED(points);
+    Q_UNUSED(dVelocity);
+    Q_UNUSED(dAcc);
+    return false;
+}
+
+int Robot::Capabilities() const { return 0; }
+
+bool Robot::ServoTcpPath(const QVector<Point> &points, double period) {
+    Q_UNUSED(points);
+    Q_UNUSED(period);
+    return false;
+}
+
+bool Robot::AbortMotion() { return false; }
+
+void Robot::StartRecorder(const Craft &craft) {
+    StopRecorder();
+    // 力自适应进给、运行指标同样由采样线程驱动，不记录时也要启动
+    if (!isRunLogEnabled && !isForceFeedOn.load() &&
+        !RunMetrics::IsEnabled()) {
+        return;
+    }
+    QString fileName;
+    QDir dir(QCoreApplication::applicationDirPath());
+    if (isRunLogEnabled && dir.mkpath(runLogDir) && dir.cd(runLogDir)) {
+        QString name = craft.craftID;
+        name.replace(QRegExp("[\\\\/:*?\"<>|]"), "_");
+        fileName = dir.filePath(
+            QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss_") + name +
+            ".swrlog");
+    }
+    QString craftID = craft.craftID;
+    float referencePos = craft.teachPointReferPos;
+    isRecording.store(true);
+    recorder = std::thread([this, fileName, craftID, referencePos] {
+        RunLogWriter writer;
+        if (!fileName.isEmpty() &&
+            writer.Open(fileName, craftID, referencePos)) {
+            RecordLoop(&writer);
+            writer.Close();
+        } else {
+            RecordLoop(nullptr);
+        }
+    });
+}
+
+void Robot::StopRecorder() {
+    isRecording.store(false);
+    if (recorder.joinable()) {
+        recorder.join();
+    }
+}
+
+void Robot::RecordLoop(RunLogWriter *writer) {
+    // 采样在独立线程完成，运行线程只更新路径段编号
+    using namespace std::chrono;
+    const steady_clock::time_point begin = steady_clock::now();
+    const milliseconds period(runLogInterval);
+    steady_clock::time_point next = begin;
+    qint64 lastTimestamp = 0;
+    Trace::SetThreadName("record");
+    while (isRecording.load()) {
+        TraceScope trace("Sample", "record");
+        RunLogRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.timestamp =
+            duration_cast<microseconds>(steady_clock::now() - begin).count();
+        record.flags = RunLogFlag::RecordValid;
+        Point point;
+        if (GetTcpPoint(point)) {
+            record.tcp[0] = point.pos.x();
+            record.tcp[1] = point.pos.y();
+            record.tcp[2] = point.pos.z();
+            record.tcp[3] = point.rot.x();
+            record.tcp[4] = point.rot.y();
+            record.tcp[5] = point.rot.z();
+            record.flags |= RunLogFlag::TcpValid;
+        }
+        double joints[6];
+        if (GetJointPos(joints)) {
+            for (int i = 0; i < 6; ++i) {
+                record.joint[i] = joints[i];
+            }
+            record.flags |= RunLogFlag::JointValid;
+        }
+        {
+            std::lock_guard<std::recursive_mutex> lock(agpMutex);
+            int16_t values[7];
+            if (agp != nullptr && AGP_CALL(ReadInputs, values)) {
+                record.speed = values[1];
+                record.force = values[2];
+                record.agpPos = values[3] / 100.0;
+                record.temperature = values[6];
+                record.flags |= RunLogFlag::AGPValid;
+            }
+        }
+        record.segment = GetCurrentSegment();
+        if (RunMetrics::IsEnabled()) {
+            if (record.flags & RunLogFlag::AGPValid) {
+                RunMetrics::SetAGP(record.force, record.temperature,
+                                   record.speed);
+            }
+            if (isSegmentTracked) {
+                RunMetrics::SetQueueDepth(
+                    qMax(0, segmentIndex.load() - record.segment));
+            }
+        }
+        if (writer != nullptr) {
+            writer->Append(record);
+        }
+        if (isForceFeedOn.load()) {
+            UpdateForceFeed(record, (record.timestamp - lastTimestamp) / 1e6);
+        }
+        lastTimestamp = record.timestamp;
+        // 采样落后时不追赶，直接从当前时刻重新计时
+        next += period;
+        steady_clock::time_point now = steady_clock::now();
+        if (next < now) {
+            next = now;
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void Robot::UpdateForceFeed(const RunLogRecord &record, double dt) {
+    bool isInContact = (record.flags & RunLogFlag::AGPValid) &&
+                       record.force >= forceFeedContact;
+    // 只有接触段按 feedScale 放大下发，也只在接触段执行时调低速度比；
+    // 进刀、切入、空移、抬起、退刀和急停后速度比均为1
+    bool isContactSegment = false;
+    if (!isStop.load()) {
+        if (isSegmentTracked) {
+            std::lock_guard<std::mutex> lock(contactMutex);
+            isContactSegment = record.segment >= 0 &&
+                               record.segment < contactSegments.size() &&
+                               contactSegments.at(record.segment);
+        } else {
+            // 无执行位置反馈时接触段不放大下发，只在压力达到接触力时调节
+            isContactSegment = isInContact;
+        }
+    }
+    double speedRatio = 1;
+    if (isContactSegment) {
+        if (isInContact) {
+            if (!isForceFeedControlling) {
+                forceFeed.Start(forceFeedTarget);
+                isForceFeedControlling = true;
+            }
+            forceFeed.Update(record.force, dt);
+        }
+        // 未接触时保持当前倍率，尚未开始调节时倍率为1（即工艺移动速度）
+        double ratio = isForceFeedControlling ? forceFeed.Ratio() : 1;
+        speedRatio = qMin(1.0, ratio / feedScale);
+    }
+    // 变化很小时不下发，减少控制器通信；恢复为1时总是下发
+    bool isChanged = speedRatio == 1
+                         ? lastOverride != 1
+                         : qAbs(speedRatio - lastOverride) >= 0.005;
+    if (isChanged && SetSpeedOverride(speedRatio)) {
+        lastOverride = speedRatio;
+    }
+}
+
+void Robot::MarkContactSegment(int segment, bool isContact) {
+    std::lock_guard<std::mutex> lock(contactMutex);
+    if (segment >= contactSegments.size()) {
+        contactSegments.resize(segment + 1);
+    }
+    contactSegments[segment] = isContact;
+}
+
+void Robot::TeachLoop() {
+    using namespace std::chrono;
+    const steady_clock::time_point begin = steady_clock::now();
+    const milliseconds period(teachParams.interval);
+    steady_clock::time_point next = begin;
+    Trace::SetThreadName("teach");
+    while (isTeachRecording.load()) {
+        TeachSample sample;
+        if (GetTcpPoint(sample.tcp)) {
+            sample.timestamp =
+                duration_cast<microseconds>(steady_clock::now() - begin)
+                    .count();
+            sample.agpPos = teachPos;
+            {
+                std::lock_guard<std::recursive_mutex> lock(agpMutex);
+                if (agp != nullptr) {
+                    sample.agpPos = AGP_CALL(ReadPos) / 100.0;
+                }
+            }
+            teachBuffer.Push(sample);
+        }
+        // 采样落后时不追赶，直接从当前时刻重新计时
+        next += period;
+        steady_clock::time_point now = steady_clock::now();
+        if (next < now) {
+            next = now;
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
+
+bool Robot::ProbePoint(const Point &nominal, QVector3D &measured) {
+    using namespace std::chrono;
+    auto waitMotion = [this] {
+        do {
+            QThread::msleep(100);
+        } while (!isStop.load() && IsRobotMoved());
+    };
+    // 探测前已有急停时中断，不能清除操作员的停止请求
+    if (isStop.load()) {
+        return false;
+    }
+    {
+        // 打磨头不旋转，以较小的设定力伸出，触碰工件时缩回
+        std::lock_guard<std::recursive_mutex> lock(agpMutex);
+        AGP_CALL(Control, FUNC::RESET);
+        AGP_CALL(Control, FUNC::ENABLE);
+        AGP_CALL(SetMode, MODE::ForceMode);
+        AGP_CALL(SetSpeed, 0);
+        AGP_CALL(SetTouchForce, probeParams.force);
+        AGP_CALL(SetForce, probeParams.force);
+    }
+    // 沿名义点的工具Z轴，从起点低速移向越过名义点的终点
+    Point begin = nominal.PosRelByTool(defaultDirection, -probeParams.approach);
+    Point end = nominal.PosRelByTool(defaultDirection, probeParams.overtravel);
+    MoveL(begin, defaultVelocity, 2000, 0);
+    waitMotion();
+    if (isStop.load()) {
+        return false;
+    }
+    TraceScope trace("Probe", "motion");
+    ContactDetector detector;
+    detector.Reset(probeParams);
+    MoveL(end, probeParams.speed, 100, 0);
+    const milliseconds period(probeParams.interval);
+    const milliseconds checkPeriod(100);
+    // 超时按行程时间留出余量，防止控制器未报告运动结束时一直等待
+    double travel = probeParams.approach + probeParams.overtravel;
+    const steady_clock::time_point deadline =
+        steady_clock::now() +
+        milliseconds(qRound(travel / probeParams.speed * 1000) + 2000);
+    steady_clock::time_point next = steady_clock::now();
+    steady_clock::time_point checked = next;
+    bool isTouched = false;
+    bool isTimeout = false;
+    while (!isStop.load()) {
+        // TCP 前后各读一次打磨头取平均，减小两者读取时刻不同带来的误差
+        int16_t before[7];
+        int16_t after[7];
+        Point tcp;
+        bool isRead = false;
+        {
+            std::lock_guard<std::recursive_mutex> lock(agpMutex);
+            isRead = AGP_CALL(ReadInputs, before) && GetTcpPoint(tcp) &&
+                     AGP_CALL(ReadInputs, after);
+        }
+        if (isRead && detector.Update(after[3] / 100.0, after[2])) {
+            double agpPos = (before[3] + after[3]) / 200.0;
+            measured =
+                tcp.PosRelByTool(defaultDirection, agpPos + discThickness)
+                    .pos;
+            isTouched = true;
+            break;
+        }
+        steady_clock::time_point now = steady_clock::now();
+        if (now - checked >= checkPeriod) {
+            checked = now;
+            isTimeout = now > deadline;
+            if (isTimeout || !IsRobotMoved()) {
+                break;
+            }
+        }
+        next += period;
+        if (next < now) {
+            next = now;
+        }
+        std::this_thread::sleep_until(next);
+    }
+    if (isTouched || isTimeout) {
+        // 中止探测运动后退回起点；接触点已由打磨头位置补偿，与停止距离无关。
+        // 只中止运动，期间操作员的急停仍保留在 isStop 中
+        if (!AbortMotion()) {
+            // 后端不能单独中止运动时只能急停，探测随之中断
+            Stop();
+        }
+        do {
+            QThread::msleep(100);
+        } while (IsRobotMoved());
+    }
+    if (!isStop.load()) {
+        MoveL(begin, defaultVelocity, 2000, 0);
+        waitMotion();
+    }
+    return isTouched && !isStop.load();
+}
+
 bool Robot::GetPoint(Point &point) {
     if (!GetTcpPoint(point)) {
         return false;
     }
     double pos = teachPos;
-    if (agp != nullptr) {
-        pos = agp->ReadPos() / 100.0;
+    {
+        std::lock_guard<std::recursive_mutex> lock(agpMutex);
+        if (agp != nullptr) {
+            pos = AGP_CALL(ReadPos) / 100.0;
+        }
     }
     point = point.PosRelByTool(defaultDirection, pos + discThickness);
     return true;
@@ -194,6 +729,205 @@ int Robot::GetMidPoint(qint64 pressDuration, QString &strPoint) {
     return pointSet.midPoints.size();
 }
 
+bool Robot::StartTeachRecord() {
+    if (!isTeach || isTeachRecording.load()) {
+        return false;
+    }
+    if (teachRecorder.joinable()) {
+        teachRecorder.join();
+    }
+    // 缓冲区按录制时长一次分配，超出后覆盖最早的采样
+    int capacity = qCeil(teachParams.duration * 1000 / teachParams.interval);
+    teachBuffer.Reset(capacity);
+    isTeachRecording.store(true);
+    teachRecorder = std::thread([this] { TeachLoop(); });
+    return true;
+}
+
+bool Robot::StopTeachRecord(QString &tip) {
+    if (!isTeachRecording.exchange(false)) {
+        tip = "未在录制轨迹";
+        return false;
+    }
+    teachRecorder.join();
+    QVector<TeachSample> samples = teachBuffer.Samples();
+    // 采样换算为打磨片接触点（与 GetPoint 相同），按最小点距抽稀，
+    // 结束点始终取最后一个采样
+    QVector<Point> points;
+    for (int i = 0; i < samples.size(); ++i) {
+        const TeachSample &sample = samples.at(i);
+        Point point = sample.tcp.PosRelByTool(
+            defaultDirection, sample.agpPos + discThickness);
+        if (points.isEmpty()) {
+            points.append(point);
+            continue;
+        }
+        bool isFar =
+            points.last().pos.distanceToPoint(point.pos) >= teachParams.step;
+        if (isFar) {
+            points.append(point);
+        } else if (i == samples.size() - 1 && points.size() > 1) {
+            points.last() = point;
+        }
+    }
+    if (points.size() < 2) {
+        tip = "录制的轨迹过短";
+        return false;
+    }
+    pointSet.beginPoint = points.first();
+    pointSet.auxBeginPoint =
+        pointSet.beginPoint.PosRelByTool(defaultDirection, defaultOffset);
+    pointSet.isBeginPointRecorded = true;
+    pointSet.endPoint = points.last();
+    pointSet.auxEndPoint =
+        pointSet.endPoint.PosRelByTool(defaultDirection, defaultOffset);
+    pointSet.isEndPointRecorded = true;
+    pointSet.midPoints = points.mid(1, points.size() - 2);
+    double duration =
+        (samples.last().timestamp - samples.first().timestamp) / 1e6;
+    tip = QString("录制%1个采样（%2秒），生成%3个中间点")
+              .arg(samples.size())
+              .arg(duration, 0, 'f', 1)
+              .arg(pointSet.midPoints.size());
+    if (teachBuffer.Dropped() > 0) {
+        tip += QString("，最早的%1个采样超出录制时长已丢弃")
+                   .arg(teachBuffer.Dropped());
+    }
+    return true;
+}
+
+bool Robot::IsTeachRecording() const { return isTeachRecording.load(); }
+
+int Robot::AddReferencePoint(QString &strPoint) {
+    Point point;
+    if (!GetPoint(point)) {
+        return -1;
+    }
+    pointSet.referencePoints.append(point);
+    strPoint = QString("基准点%1：").arg(pointSet.referencePoints.size()) +
+               point.toString();
+    return pointSet.referencePoints.size();
+}
+
+int Robot::AddTouchPoint(QString &strPoint) {
+    Point point;
+    if (!GetPoint(point)) {
+        return -1;
+    }
+    touchPoints.append(point.pos);
+    strPoint = QString("测量点%1：").arg(touchPoints.size()) + point.toString();
+    return touchPoints.size();
+}
+
+int Robot::ReferenceCount() const { return pointSet.referencePoints.size(); }
+
+int Robot::TouchCount() const { return touchPoints.size(); }
+
+void Robot::ClearTouchPoints() { touchPoints.clear(); }
+
+bool Robot::ProbeReferencePoints(QString &tip) {
+    int count = pointSet.referencePoints.size();
+    if (count < 3) {
+        tip = "至少需要3个基准点";
+        return false;
+    }
+    if (agp == nullptr) {
+        tip = "打磨头未连接";
+        return false;
+    }
+    QVector<QVector3D> measured;
+    // 与 Run 相同，开始时清除空闲状态的停止标志；之后的急停不再清除，
+    // 每个基准点探测前检查，一旦急停即中断整个探测
+    isStop.store(false);
+    for (int i = 0; i < count; ++i) {
+        QVector3D point;
+        if (!ProbePoint(pointSet.referencePoints.at(i), point)) {
+            if (isStop.load()) {
+                tip = "探测被中断";
+            } else {
+                tip = QString("基准点%1越过名义位置%2mm仍未探测到接触")
+                          .arg(i + 1)
+                          .arg(probeParams.overtravel);
+            }
+            isStop.store(true);
+            return false;
+        }
+        measured.append(point);
+    }
+    isStop.store(true);
+    touchPoints = measured;
+    tip = QString("已探测%1个基准点").arg(count);
+    return true;
+}
+
+bool Robot::RegisterProgram(QString &tip) {
+    int count = pointSet.referencePoints.size();
+    if (count < 3) {
+        tip = "至少需要3个基准点";
+        return false;
+    }
+    if (touchPoints.size() != count) {
+        tip = QString("已测量%1个基准点，共%2个")
+                  .arg(touchPoints.size())
+                  .arg(count);
+        return false;
+    }
+    QVector<QVector3D> taught;
+    for (const Point &point : pointSet.referencePoints) {
+        taught.append(point.pos);
+    }
+    RigidTransform transform;
+    if (!FrameRegistration::Solve(taught, touchPoints, registerParams,
+                                  transform)) {
+        if (transform.maxError > 0) {
+            tip = QString("配准残差%1mm超过%2mm，请检查基准点顺序后重新测量")
+                      .arg(transform.maxError, 0, 'f', 2)
+                      .arg(registerParams.maxResidual);
+        } else {
+            tip = "基准点共线或过于集中，无法确定工件姿态";
+        }
+        touchPoints.clear();
+        return false;
+    }
+    // 程序中的全部位姿（含基准点，便于再次配准）收集后一次变换，再按原顺序写回
+    Point *const poses[] = {
+        &pointSet.safePoint,        &pointSet.beginPoint,
+        &pointSet.auxBeginPoint,    &pointSet.endPoint,
+        &pointSet.auxEndPoint,      &pointSet.auxPoint,
+        &pointSet.beginOffsetPoint, &pointSet.endOffsetPoint};
+    QVector<Point> points;
+    points.reserve(8 + pointSet.midPoints.size() + count);
+    for (Point *pose : poses) {
+        points.append(*pose);
+    }
+    points += pointSet.midPoints;
+    points += pointSet.referencePoints;
+    FrameRegistration::Apply(transform, points);
+    int index = 0;
+    for (Point *pose : poses) {
+        *pose = points.at(index++);
+    }
+    for (Point &point : pointSet.midPoints) {
+        point = points.at(index++);
+    }
+    for (Point &point : pointSet.referencePoints) {
+        point = points.at(index++);
+    }
+    touchPoints.clear();
+    const QMatrix3x3 &R = transform.rotation;
+    double trace = R(0, 0) + R(1, 1) + R(2, 2);
+    double angle = qRadiansToDegrees(qAcos(qBound(-1.0, (trace - 1) / 2, 1.0)));
+    tip = QString("配准完成：平移%1mm，转角%2°，残差均方根%3mm、最大%4mm")
+              .arg(transform.translation.length(), 0, 'f', 2)
+              .arg(angle, 0, 'f', 2)
+              .arg(transform.rms, 0, 'f', 3)
+              .arg(transform.maxError, 0, 'f', 3);
+    if (!cloud.IsEmpty() || !mesh.IsEmpty()) {
+        tip += "；点云、模型未变换，请导入重新装夹后的扫描数据";
+    }
+    return true;
+}
+
 bool Robot::ClearPoints() {
     if (pointSet.isSafePointRecorded) {
         pointSet.isSafePointRecorded = false;
@@ -214,6 +948,8 @@ bool Robot::ClearPoints() {
         pointSet.isEndOffsetPointRecorded = false;
     }
     pointSet.midPoints.clear();
+    pointSet.referencePoints.clear();
+    touchPoints.clear();
     return true;
 }
 
@@ -229,7 +965,7 @@ int Robot::DelLastMidPoint() {
     return pointSet.midPoints.size();
 }
 
-bool Robot::CheckAllPoints(const PolishWay &way) {
+bool Robot::CheckAllPoints(const PolishWay &way, QString &tip) {
     // 检查路径所需点位是否采集
     QVector<QString> check;
     if (!pointSet.isSafePointRecorded) {
@@ -262,6 +998,21 @@ bool Robot::CheckAllPoints(const PolishWay &way) {
             check.append("中间点");
         }
         break;
+    case PolishWay::SplineWay:
+    case PolishWay::SphereWay:
+        if (pointSet.midPoints.isEmpty()) {
+            check.append("中间点");
+        }
+        break;
+    case PolishWay::CloudWay:
+    case PolishWay::MeshWay:
+        if (!pointSet.isBeginOffsetPointRecorded) {
+            check.append("起始偏移点");
+        }
+        if (!pointSet.isEndOffsetPointRecorded) {
+            check.append("结束偏移点");
+        }
+        break;
     case PolishWay::ZLineWay:
     case PolishWay::SpiralLineWay:
         if (!pointSet.isAuxPointRecorded) {
@@ -274,7 +1025,7 @@ bool Robot::CheckAllPoints(const PolishWay &way) {
     }
     int size = check.size();
     if (size != 0) {
-        QString tip = "";
+        tip = "";
         for (int i = 0; i < size; ++i) {
             if (i != 0) {
                 tip += "、";
@@ -282,7 +1033,6 @@ bool Robot::CheckAllPoints(const PolishWay &way) {
             tip += check.at(i);
         }
         tip += "未记录";
-        QMessageBox::critical(NULL, "提示", tip);
         return false;
     }
     switch (way) {
@@ -297,7 +1047,38 @@ bool Robot::CheckAllPoints(const PolishWay &way) {
     case PolishWay::CylinderWay_Horizontal_Concave:
     case PolishWay::CylinderWay_Vertical_Concave:
         if (pointSet.midPoints.size() % 2 == 0) {
-            QMessageBox::critical(NULL, "提示", "圆弧中间点数量不能为偶数个！");
+            tip = "圆弧中间点数量不能为偶数个！";
+            return false;
+        }
+        break;
+    case PolishWay::SphereWay: {
+        if (pointSet.midPoints.size() < 2) {
+            tip = "球面中间点数量不能少于两个！";
+            return false;
+        }
+        QVector<QVector3D> points;
+        points.append(pointSet.beginPoint.pos);
+        for (const Point &point : pointSet.midPoints) {
+            points.append(point.pos);
+        }
+        points.append(pointSet.endPoint.pos);
+        QVector3D center;
+        float radius = 0;
+        if (!Point::fitSphere(points, center, radius)) {
+            tip = "示教点无法拟合球面，请检查点位！";
+            return false;
+        }
+        break;
+    }
+    case PolishWay::CloudWay:
+        if (cloud.IsEmpty()) {
+            tip = "未导入点云！";
+            return false;
+        }
+        break;
+    case PolishWay::MeshWay:
+        if (mesh.IsEmpty()) {
+            tip = "未导入模型！";
             return false;
         }
         break;
@@ -346,18 +1127,240 @@ void Robot::CoverPoint(QString &strPoint) {
     }
 }
 
+QStringList Robot::GetRecordedPoints() const {
+    QStringList points;
+    if (pointSet.isSafePointRecorded) {
+        points.append(QString("安全点：") + pointSet.safePoint.toString());
+    }
+    if (pointSet.isBeginPointRecorded) {
+        points.append(QString("起始点：") + pointSet.beginPoint.toString());
+    }
+    if (pointSet.isEndPointRecorded) {
+        points.append(QString("结束点：") + pointSet.endPoint.toString());
+    }
+    if (pointSet.isAuxPointRecorded) {
+        points.append(QString("辅助点：") + pointSet.auxPoint.toString());
+    }
+    if (pointSet.isBeginOffsetPointRecorded) {
+        points.append(QString("起始偏移点：") +
+                      pointSet.beginOffsetPoint.toString());
+    }
+    if (pointSet.isEndOffsetPointRecorded) {
+        points.append(QString("结束偏移点：") +
+                      pointSet.endOffsetPoint.toString());
+    }
+    for (int i = 0; i < pointSet.midPoints.size(); ++i) {
+        points.append(QString("中间点%1：").arg(i + 1) +
+                      pointSet.midPoints.at(i).toString());
+    }
+    for (int i = 0; i < pointSet.referencePoints.size(); ++i) {
+        points.append(QString("基准点%1：").arg(i + 1) +
+                      pointSet.referencePoints.at(i).toString());
+    }
+    return points;
+}
+
+bool Robot::SaveProgram(const QString &fileName, const Craft &craft) const {
+    // 程序文件：工艺参数 + 点位
+    QSettings settings(fileName, QSettings::IniFormat);
+    settings.setIniCodec("UTF-8");
+    settings.clear();
+    settings.beginGroup("Craft");
+    const QMap<QString, QString> map = CraftStore::ToMap(craft);
+    for (auto it = map.cbegin(); it != map.cend(); ++it) {
+        settings.setValue(it.key(), it.value());
+    }
+    settings.endGroup();
+    settings.beginGroup("Points");
+    if (pointSet.isSafePointRecorded) {
+        settings.setValue("SafePoint", pointSet.safePoint.toString());
+    }
+    if (pointSet.isBeginPointRecorded) {
+        settings.setValue("BeginPoint", pointSet.beginPoint.toString());
+    }
+    if (pointSet.isEndPointRecorded) {
+        settings.setValue("EndPoint", pointSet.endPoint.toString());
+    }
+    if (pointSet.isAuxPointRecorded) {
+        settings.setValue("AuxPoint", pointSet.auxPoint.toString());
+    }
+    if (pointSet.isBeginOffsetPointRecorded) {
+        settings.setValue("BeginOffsetPoint",
+                          pointSet.beginOffsetPoint.toString());
+    }
+    if (pointSet.isEndOffsetPointRecorded) {
+        settings.setValue("EndOffsetPoint", pointSet.endOffsetPoint.toString());
+    }
+    if (!cloud.IsEmpty()) {
+        settings.setValue("CloudFile", cloud.FileName());
+    }
+    if (!mesh.IsEmpty()) {
+        settings.setValue("MeshFile", mesh.FileName());
+    }
+    settings.endGroup();
+    settings.beginWriteArray("MidPoints", pointSet.midPoints.size());
+    for (int i = 0; i < pointSet.midPoints.size(); ++i) {
+        settings.setArrayIndex(i);
+        settings.setValue("Point", pointSet.midPoints.at(i).toString());
+    }
+    settings.endArray();
+    settings.beginWriteArray("ReferencePoints",
+                             pointSet.referencePoints.size());
+    for (int i = 0; i < pointSet.referencePoints.size(); ++i) {
+        settings.setArrayIndex(i);
+        settings.setValue("Point", pointSet.referencePoints.at(i).toString());
+    }
+    settings.endArray();
+    settings.sync();
+    return settings.status() == QSettings::NoError;
+}
+
+bool Robot::LoadProgram(const QString &fileName, Craft &craft) {
+    QSettings settings(fileName, QSettings::IniFormat);
+    settings.setIniCodec("UTF-8");
+    if (settings.status() != QSettings::NoError ||
+        !settings.childGroups().contains("Craft")) {
+        return false;
+    }
+    settings.beginGroup("Craft");
+    QMap<QString, QString> map;
+    for (const QString &name : settings.childKeys()) {
+        map.insert(name, settings.value(name).toString());
+    }
+    settings.endGroup();
+    PointSet points;
+    auto readPoint = [&settings](const QString &name, Point &point,
+                                 bool &isRecorded) {
+        isRecorded = settings.contains(name) &&
+                     Point::fromString(settings.value(name).toString(), point);
+        return !settings.contains(name) || isRecorded;
+    };
+    settings.beginGroup("Points");
+    bool ok = readPoint("SafePoint", points.safePoint,
+                        points.isSafePointRecorded) &&
+              readPoint("BeginPoint", points.beginPoint,
+                        points.isBeginPointRecorded) &&
+              readPoint("EndPoint", points.endPoint,
+                        points.isEndPointRecorded) &&
+              readPoint("AuxPoint", points.auxPoint,
+                        points.isAuxPointRecorded) &&
+              readPoint("BeginOffsetPoint", points.beginOffsetPoint,
+                        points.isBeginOffsetPointRecorded) &&
+              readPoint("EndOffsetPoint", points.endOffsetPoint,
+                        points.isEndOffsetPointRecorded);
+    QString cloudFile = settings.value("CloudFile").toString();
+    QString meshFile = settings.value("MeshFile").toString();
+    settings.endGroup();
+    if (!ok) {
+        return false;
+    }
+    // 程序引用的点云、模型读取失败时不加载程序，保留当前点云、模型
+    PointCloud programCloud = cloud;
+    if (!cloudFile.isEmpty() && cloudFile != cloud.FileName() &&
+        !programCloud.Load(cloudFile, cloudNeighbors)) {
+        return false;
+    }
+    Mesh programMesh = mesh;
+    if (!meshFile.isEmpty() && meshFile != mesh.FileName() &&
+        !programMesh.Load(meshFile)) {
+        return false;
+    }
+    int size = settings.beginReadArray("MidPoints");
+    for (int i = 0; i < size; ++i) {
+        settings.setArrayIndex(i);
+        Point point;
+        if (!Point::fromString(settings.value("Point").toString(), point)) {
+            settings.endArray();
+            return false;
+        }
+        points.midPoints.append(point);
+    }
+    settings.endArray();
+    size = settings.beginReadArray("ReferencePoints");
+    for (int i = 0; i < size; ++i) {
+        settings.setArrayIndex(i);
+        Point point;
+        if (!Point::fromString(settings.value("Point").toString(), point)) {
+            settings.endArray();
+            return false;
+        }
+        points.referencePoints.append(point);
+    }
+    settings.endArray();
+    points.auxBeginPoint =
+        points.beginPoint.PosRelByTool(defaultDirection, defaultOffset);
+    points.auxEndPoint =
+        points.endPoint.PosRelByTool(defaultDirection, defaultOffset);
+    pointSet = points;
+    touchPoints.clear();
+    cloud = programCloud;
+    mesh = programMesh;
+    craft = CraftStore::FromMap(map);
+    return true;
+}
+
+bool Robot::LoadCloud(const QString &fileName) {
+    PointCloud loaded;
+    if (!loaded.Load(fileName, cloudNeighbors)) {
+        return false;
+    }
+    cloud = loaded;
+    return true;
+}
+
+int Robot::CloudSize() const { return cloud.Count(); }
+
+bool Robot::LoadMesh(const QString &fileName) {
+    Mesh loaded;
+    if (!loaded.Load(fileName)) {
+        return false;
+    }
+    mesh = loaded;
+    return true;
+}
+
+int Robot::MeshSize() const { return mesh.FaceCount(); }
+
 void Robot::MoveL(const Point &point, double dVelocity, double dAcc,
                   double dRadius) {
+    if (capturePath != nullptr) {
+        PathSegment segment;
+        segment.isArc = false;
+        segment.endPoint = point;
+        segment.velocity = dVelocity;
+        segment.acc = dAcc;
+        segment.radius = dRadius;
+        segment.phase = capturePhase;
+        segment.isContact = isCaptureContact;
+        segment.isStreamed = isCaptureStreamed;
+        capturePath->append(segment);
+        return;
+    }
     if (isStop.load()) {
         return;
     }
     Point tcpPoint =
         point.PosRelByTool(defaultDirection, -(teachPos + discThickness));
+    TraceScope trace("MoveTcpL", "motion", segmentIndex.fetch_add(1) + 1);
     MoveTcpL(tcpPoint, dVelocity, dAcc, dRadius);
 }
 
 void Robot::MoveC(const Point &auxPoint, const Point &endPoint,
                   double dVelocity, double dAcc, double dRadius) {
+    if (capturePath != nullptr) {
+        PathSegment segment;
+        segment.isArc = true;
+        segment.auxPoint = auxPoint;
+        segment.endPoint = endPoint;
+        segment.velocity = dVelocity;
+        segment.acc = dAcc;
+        segment.radius = dRadius;
+        segment.phase = capturePhase;
+        segment.isContact = isCaptureContact;
+        segment.isStreamed = false;
+        capturePath->append(segment);
+        return;
+    }
     if (isStop.load()) {
         return;
     }
@@ -365,6 +1368,7 @@ void Robot::MoveC(const Point &auxPoint, const Point &endPoint,
         auxPoint.PosRelByTool(defaultDirection, -(teachPos + discThickness));
     Point endTcpPoint =
         endPoint.PosRelByTool(defaultDirection, -(teachPos + discThickness));
+    TraceScope trace("MoveTcpC", "motion", segmentIndex.fetch_add(1) + 1);
     MoveTcpC(auxTcpPoint, endTcpPoint, dVelocity, dAcc, dRadius);
 }
 
@@ -398,7 +1402,7 @@ void Robot::MoveToPoint(const QStringList &coordinates) {
     }
 }
 
-void Robot::MoveBefore(const Craft &craft, bool isAGPRun) {
+void Robot::MoveBefore(const Craft &craft) {
     // 定义空间目标位置
     Point point;
     // 定义运动速度
@@ -410,14 +1414,15 @@ void Robot::MoveBefore(const Craft &craft, bool isAGPRun) {
     // 移到安全点
     point = pointSet.safePoint;
     MoveL(point, dVelocity, dAcc, dRadius);
-    // AGP运行
-    AGPRun(craft, isAGPRun);
     if (craft.way != PolishWay::RegionArcWay_Vertical &&
         craft.way != PolishWay::RegionArcWay_Vertical_Repeat &&
         craft.way != PolishWay::CylinderWay_Horizontal_Convex &&
         craft.way != PolishWay::CylinderWay_Vertical_Convex &&
         craft.way != PolishWay::CylinderWay_Horizontal_Concave &&
-        craft.way != PolishWay::CylinderWay_Vertical_Concave) {
+        craft.way != PolishWay::CylinderWay_Vertical_Concave &&
+        craft.way != PolishWay::SphereWay &&
+        craft.way != PolishWay::CloudWay &&
+        craft.way != PolishWay::MeshWay) {
         // 移到起始辅助点
         // point = pointSet.auxBeginPoint;
         if (craft.way == PolishWay::RegionArcWay1 ||
@@ -461,6 +1466,7 @@ void Robot::MoveAfter(const Craft &craft, Point point) {
 void Robot::MoveLine(const Craft &craft) {
     // 定义运动速度
     double dVelocity = craft.moveSpeed;
+    isCaptureContact = true;
     // 定义运动加速度
     double dAcc = 100;
     // 定义过渡半径
@@ -485,6 +1491,7 @@ void Robot::MoveLine(const Craft &craft) {
 void Robot::MoveArc(const Craft &craft) {
     // 定义运动速度
     double dVelocity = craft.moveSpeed;
+    isCaptureContact = true;
     // 定义运动加速度
     double dAcc = 100;
     // 定义过渡半径
@@ -517,6 +1524,7 @@ void Robot::MoveArc(const Craft &craft) {
 Point Robot::MoveRegionArc1(const Craft &craft) {
     // 定义运动速度
     double dVelocity = craft.moveSpeed;
+    isCaptureContact = true;
     // 定义运动加速度
     double dAcc = 100;
     // 定义过渡半径
@@ -752,6 +1760,7 @@ Point Robot::MoveRegionArc1(const Craft &craft) {
 Point Robot::MoveRegionArc2(const Craft &craft) {
     // 定义运动速度
     double dVelocity = craft.moveSpeed;
+    isCaptureContact = true;
     // 定义运动加速度
     double dAcc = 100;
     // 定义过渡半径
@@ -996,6 +2005,7 @@ Point Robot::MoveRegionArc2(const Craft &craft) {
 Point Robot::MoveRegionArcHorizontal(const Craft &craft) {
     // 定义运动速度
     double dVelocity = craft.moveSpeed;
+    isCaptureContact = true;
     // 定义运动加速度
     double dAcc = 100;
     // 定义过渡半径
@@ -1355,6 +2365,7 @@ Point Robot::MoveRegionArcVertical(const Craft &craft) {
     Q_ASSERT(finalPosListUp.size() == finalPosListDown.size());
     // 定义运动速度
     double dVelocity = defaultVelocity;
+    isCaptureContact = false;
     // 定义运动加速度
     double dAcc = 2000;
     // 定义过渡半径
@@ -1384,6 +2395,7 @@ Point Robot::MoveRegionArcVertical(const Craft &craft) {
     MoveL(point, dVelocity, dAcc, dRadius);
     // 移到起始点
     dVelocity = craft.cutinSpeed;
+    isCaptureContact = false;
     for (int i = 0; i < finalPosListUp.size(); ++i) {
         moveDirection = finalPosListDown.at(i) - finalPosListUp.at(i);
         // 获取新的姿态
@@ -1398,6 +2410,7 @@ Point Robot::MoveRegionArcVertical(const Craft &craft) {
 
         if (interval > 0 && i != 0 && i != count && i % interval == 0) {
             dVelocity = craft.cutinSpeed;
+            isCaptureContact = false;
             dAcc = 2000;
             point = point.PosRelByTool(defaultDirection, defaultOffset);
             MoveL(point, dVelocity, dAcc, dRadius); // 抬起
@@ -1415,6 +2428,7 @@ Point Robot::MoveRegionArcVertical(const Craft &craft) {
         }
 
         dVelocity = craft.moveSpeed;
+        isCaptureContact = true;
         dAcc = 100;
         point.pos = finalPosListUp.at(i) + translation;
         point.rot = newRot;
@@ -1499,6 +2513,7 @@ Point Robot::MoveRegionArcVerticalRepeat(const Craft &craft) {
     Q_ASSERT(finalPosListUp.size() == finalPosListDown.size());
     // 定义运动速度
     double dVelocity = defaultVelocity;
+    isCaptureContact = false;
     // 定义运动加速度
     double dAcc = 2000;
     // 定义过渡半径
@@ -1522,6 +2537,7 @@ Point Robot::MoveRegionArcVerticalRepeat(const Craft &craft) {
     MoveL(point, dVelocity, dAcc, dRadius);
     // 移到起始点
     dVelocity = craft.cutinSpeed;
+    isCaptureContact = false;
     for (int i = 0; i < finalPosListUp.size(); ++i) {
         moveDirection = finalPosListDown.at(i) - finalPosListUp.at(i);
         // 获取新的姿态
@@ -1535,6 +2551,7 @@ Point Robot::MoveRegionArcVerticalRepeat(const Craft &craft) {
         MoveL(point, dVelocity, dAcc, dRadius);
 
         dVelocity = craft.moveSpeed;
+        isCaptureContact = true;
         dAcc = 100;
         point.pos = finalPosListUp.at(i) + translation;
         point.rot = newRot;
@@ -1750,6 +2767,7 @@ Point Robot::MoveCylinderHorizontal(const Craft &craft, bool isConvex) {
 
     // 定义运动速度
     double dVelocity = defaultVelocity;
+    isCaptureContact = false;
     // 定义运动加速度
     double dAcc = 2000;
     // 定义过渡半径
@@ -1762,11 +2780,13 @@ Point Robot::MoveCylinderHorizontal(const Craft &craft, bool isConvex) {
     MoveL(pos, dVelocity, dAcc, dRadius);
 
     dVelocity = craft.cutinSpeed;
+    isCaptureContact = false;
     pos.pos = pointSet.endPoint.pos + translation;
     pos.rot = newRot;
     MoveL(pos, dVelocity, dAcc, dRadius);
 
     dVelocity = craft.moveSpeed;
+    isCaptureContact = true;
     dAcc = 100;
     for (int i = 0; i < count + 1; ++i) {
         pos.pos = pointSet.beginPoint.pos + posOffset * i + translation;
@@ -1911,6 +2931,7 @@ Point Robot::MoveCylinderVertical(const Craft &craft, bool isConvex) {
 
     // 定义运动速度
     double dVelocity = defaultVelocity;
+    isCaptureContact = false;
     // 定义运动加速度
     double dAcc = 2000;
     // 定义过渡半径
@@ -1925,11 +2946,13 @@ Point Robot::MoveCylinderVertical(const Craft &craft, bool isConvex) {
     MoveL(pos, dVelocity, dAcc, dRadius);
 
     dVelocity = craft.cutinSpeed;
+    isCaptureContact = false;
     pos.pos = finalPosListDown.constFirst() + translationList.constFirst();
     pos.rot = newRotList.constFirst();
     MoveL(pos, dVelocity, dAcc, dRadius);
 
     dVelocity = craft.moveSpeed;
+    isCaptureContact = true;
     dAcc = 100;
     for (int i = 0; i < count + 1; ++i) {
         pos.pos = finalPosListUp.at(2 * i) + translationList.at(2 * i);
@@ -1958,6 +2981,7 @@ Point Robot::MoveCylinderVertical(const Craft &craft, bool isConvex) {
 void Robot::MoveZLine(const Craft &craft) {
     // 定义运动速度
     double dVelocity = craft.moveSpeed;
+    isCaptureContact = true;
     // 定义运动加速度
     double dAcc = 100;
     // 定义过渡半径
@@ -1986,6 +3010,7 @@ void Robot::MoveZLine(const Craft &craft) {
 void Robot::MoveSpiralLine(const Craft &craft) {
     // 定义运动速度
     double dVelocity = craft.moveSpeed;
+    isCaptureContact = true;
     // 定义运动加速度
     double dAcc = 100;
     // 定义过渡半径
@@ -2039,1942 +3064,941 @@ void Robot::MoveSpiralLine(const Craft &craft) {
     }
 }
 
-void Robot::Run(const Craft &craft, bool isAGPRun) {
-    // QThread::msleep(100);
-    double radius = craft.discRadius;
-    double angle = craft.grindAngle;
-    QVector3D rotation = pointSet.beginPoint.rot;
-    QVector3D moveDirection = pointSet.endPoint.pos - pointSet.beginPoint.pos;
-    // if (craft.way == PolishWay::RegionArcWay_Vertical_Repeat) {
-    //     moveDirection = pointSet.beginOffsetPoint.pos -
-    //     pointSet.beginPoint.pos;
-    // }
-    // 获取新的姿态
-    newRot = Point::getNewRotation(rotation, moveDirection, angle);
-    // qDebug() << rotation;
-    // qDebug() << newRot;
-    // 获取新姿态需要的平移量
-    translation = Point::getTranslation(rotation, moveDirection, radius, angle);
-    // qDebug() << moveDirection;
-    // qDebug() << translation;
-    // 获取反向姿态和平移量
-    rotation = pointSet.endPoint.rot;
-    moveDirection = pointSet.beginPoint.pos - pointSet.endPoint.pos;
-    newRotInv = Point::getNewRotation(rotation, moveDirection, angle);
-    translationInv =
-        Point::getTranslation(rotation, moveDirection, radius, angle);
-    // 开始运动
-    isStop.store(false);
-    MoveBefore(craft, isAGPRun);
-    // Point point = pointSet.auxEndPoint;
-    Point point;
-    point.pos = pointSet.endPoint.pos + translation;
-    point.rot = newRot;
-    // 选择打磨方式
-    switch (craft.way) {
-    case PolishWay::ArcWay:
-        MoveArc(craft);
-        break;
-    case PolishWay::LineWay:
-        MoveLine(craft);
-        break;
-    case PolishWay::RegionArcWay1:
-        point = MoveRegionArc1(craft);
-        break;
-    case PolishWay::RegionArcWay2:
-        point = MoveRegionArc2(craft);
-        break;
-    case PolishWay::RegionArcWay_Horizontal:
-        point = MoveRegionArcHorizontal(craft);
-        break;
-    case PolishWay::RegionArcWay_Vertical:
-        point = MoveRegionArcVertical(craft);
-        break;
-    case PolishWay::RegionArcWay_Vertical_Repeat:
-        point = MoveRegionArcVerticalRepeat(craft);
-        break;
-    case PolishWay::CylinderWay_Horizontal_Convex:
-        point = MoveCylinderHorizontal(craft, true);
-        break;
-    case PolishWay::CylinderWay_Vertical_Convex:
-        point = MoveCylinderVertical(craft, true);
-        break;
-    case PolishWay::CylinderWay_Horizontal_Concave:
-        point = MoveCylinderHorizontal(craft, false);
-        break;
-    case PolishWay::CylinderWay_Vertical_Concave:
-        point = MoveCylinderVertical(craft, false);
-        break;
-    case PolishWay::ZLineWay:
-        MoveZLine(craft);
-        break;
-    case PolishWay::SpiralLineWay:
-        MoveSpiralLine(craft);
-        break;
-    default:
-        break;
-    }
-    point = point.PosRelByTool(defaultDirection, defaultOffset);
-    MoveAfter(craft, point);
-    // 等待运动完成
-    while (true) {
-        if (!IsRobotMoved()) {
-            isStop.store(true);
-            break;
-        }
-        QThread::msleep(100);
-    }
-}
-
-HansRobot::HansRobot() {}
-
-HansRobot::~HansRobot() {
-    HRIF_GrpCloseFreeDriver(0, 0);
-    HRIF_GrpDisable(0, 0);
-}
-
-bool HansRobot::RobotConnect(QString robotIP) {
-    int nRet = -1;
-    std::string ip = robotIP.toStdString();
-    const char *hostname = ip.c_str();
-    unsigned short nPort = 10003;
-    nRet = HRIF_Connect(0, hostname, nPort);
-    if (nRet == 0) {
-        // 机器人上电
-        HRIF_Electrify(0);
-        // 机器人使能
-        HRIF_GrpEnable(0, 0);
-        // 设置速度比
-        HRIF_SetOverride(0, 0, 1.0);
-        return true;
-    }
-    return false;
-}
-
-bool HansRobot::IsRobotElectrified() {
-    // 定义需要读取的机器人状态变量
-    int nMovingState = 0;
-    int nEnableState = 0;
-    int nErrorState = 0;
-    int nErrorCode = 0;
-    int nErrorAxis = 0;
-    int nBreaking = 0;
-    int nPause = 0;
-    int nEmergencyStop = 0;
-    int nSaftyGuard = 0;
-    int nElectrify = 0;
-    int nIsConnectToBox = 0;
-    int nBlendingDone = 0;
-    int nInPos = 0;
-    // 读取状态
-    HRIF_ReadRobotState(0, 0, nMovingState, nEnableState, nErrorState,
-                        nErrorCode, nErrorAxis, nBreaking, nPause,
-                        nEmergencyStop, nSaftyGuard, nElectrify,
-                        nIsConnectToBox, nBlendingDone, nInPos);
-    return nElectrify == 1 ? true : false;
-}
-
-bool HansRobot::IsRobotEnabled() {
-    // 定义需要读取的机器人状态变量
-    int nMovingState = 0;
-    int nEnableState = 0;
-    int nErrorState = 0;
-    int nErrorCode = 0;
-    int nErrorAxis = 0;
-    int nBreaking = 0;
-    int nPause = 0;
-    int nBlendingDone = 0;
-    // 读取状态
-    HRIF_ReadRobotFlags(0, 0, nMovingState, nEnableState, nErrorState,
-                        nErrorCode, nErrorAxis, nBreaking, nPause,
-                        nBlendingDone);
-    return nEnableState == 1 ? true : false;
-}
-
-bool HansRobot::IsRobotMoved() {
-    // 定义需要读取的机器人状态变量
-    int nMovingState = 0;
-    int nEnableState = 0;
-    int nErrorState = 0;
-    int nErrorCode = 0;
-    int nErrorAxis = 0;
-    int nBreaking = 0;
-    int nPause = 0;
-    int nBlendingDone = 0;
-    // 读取状态
-    HRIF_ReadRobotFlags(0, 0, nMovingState, nEnableState, nErrorState,
-                        nErrorCode, nErrorAxis, nBreaking, nPause,
-                        nBlendingDone);
-    return nMovingState == 1 ? true : false;
-}
-
-bool HansRobot::RobotTeach(int pos) {
-    if (!isTeach) {
-        if (agp != nullptr) {
-            // 设置AGP默认参数
-            agp->Control(FUNC::RESET);
-            agp->Control(FUNC::ENABLE);
-            agp->SetMode(MODE::PosMode);
-            agp->SetPos(pos * 100);
-            agp->SetForce(200);
-            agp->SetTouchForce(0);
-            agp->SetRampTime(0);
-            if (!IsAGPEnabled()) {
-                agp->Control(FUNC::ENABLE);
-            }
-        }
-        if (!IsRobotElectrified()) {
-            // 机器人上电
-            HRIF_Electrify(0);
-            if (!IsRobotElectrified()) {
-                return isTeach;
-            }
-        }
-        if (!IsRobotEnabled()) {
-            // 机器人使能
-            HRIF_GrpEnable(0, 0);
-            QThread::msleep(1500);
-            if (!IsRobotEnabled()) {
-                return isTeach;
-            }
-        }
-        // 设置速度比
-        HRIF_SetOverride(0, 0, 1.0);
-        // 启用自由拖拽
-        int nRet = HRIF_GrpOpenFreeDriver(0, 0);
-        if (nRet == 0) {
-            isTeach = true;
-        }
-    } else {
-        // 关闭自由拖拽
-        int nRet = HRIF_GrpCloseFreeDriver(0, 0);
-        if (nRet == 0) {
-            isTeach = false;
-        }
-    }
-    return isTeach;
-}
-
-bool HansRobot::CloseFreeDriver() {
-    // 关闭自由拖拽
-    int nRet = HRIF_GrpCloseFreeDriver(0, 0);
-    if (nRet == 0) {
-        isTeach = false;
-        return true;
-    }
-    return false;
-}
-
-bool HansRobot::GetTcpPoint(Point &point) {
-    // 获取位姿信息
-    // int nRet = HRIF_ReadCmdTcpPos(0, 0, point.x, point.y, point.z, point.rx,
-    //                               point.ry, point.rz);
-    double x = 0;
-    double y = 0;
-    double z = 0;
-    double rx = 0;
-    double ry = 0;
-    double rz = 0;
-    int nRet = HRIF_ReadActTcpPos(0, 0, x, y, z, rx, ry, rz);
-    if (nRet == 0) {
-        point.pos.setX(x);
-        point.pos.setY(y);
-        point.pos.setZ(z);
-        point.rot.setX(rx);
-        point.rot.setY(ry);
-        point.rot.setZ(rz);
-        return true;
-    } else {
-        return false;
-    }
-}
-/*
-void HansRobot::MoveBefore(const Craft &craft, bool isAGPRun) {
-    // 定义运动类型
-    int nMoveType = 1;
-    // 定义空间目标位置
-    Point point;
-    // 定义关节目标位置
-    double dJ1 = 0;
-    double dJ2 = 0;
-    double dJ3 = 0;
-    double dJ4 = 0;
-    double dJ5 = 0;
-    double dJ6 = 0;
-    // 定义工具坐标变量
-    string sTcpName = "TCP_AGP";
-    // 定义用户坐标变量
-    string sUcsName = "Base";
-    // 定义运动速度
-    double dVelocity = defaultVelocity;
-    // 定义运动加速度
-    double dAcc = 2000;
-    // 定义过渡半径
-    double dRadius = 1;
-    // 定义是否使用关节角度
-    int nIsUseJoint = 1;
-    // 定义是否使用检测 DI 停止
-    int nIsSeek = 0;
-    // 定义检测的 DI 索引
-    int nIOBit = 0;
-    // 定义检测的 DI 状态
-    int nIOState = 0;
-    // 定义路点 ID
-    string strCmdID = "0";
-    // 偏移
-    OffsetDirection direction = craft.offsetDirection;
-    double offset = craft.offsetDistance;
-    // 移到安全点
-    point = pointSet.safePoint;
-    HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(), point.pos.z(),
-                  point.rot.x(), point.rot.y(), point.rot.z(), dJ1, dJ2, dJ3,
-                  dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-                  nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-    // AGP运行
-    AGPRun(craft, isAGPRun);
-    // 移到起始辅助点
-    point = pointSet.auxBeginPoint.PosRelByTool(direction, offset);
-    HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(), point.pos.z(),
-                  point.rot.x(), point.rot.y(), point.rot.z(), dJ1, dJ2, dJ3,
-                  dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-                  nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-    // 移到起始点
-    point = pointSet.beginPoint.PosRelByTool(direction, offset);
-    dVelocity = craft.cutinSpeed;
-    HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(), point.pos.z(),
-                  point.rot.x(), point.rot.y(), point.rot.z(), dJ1, dJ2, dJ3,
-                  dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-                  nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-}
-
-void HansRobot::MoveAfter(const Craft &craft, Point point) {
-    // 定义运动类型
-    int nMoveType = 1;
-    // 定义关节目标位置
-    double dJ1 = 0;
-    double dJ2 = 0;
-    double dJ3 = 0;
-    double dJ4 = 0;
-    double dJ5 = 0;
-    double dJ6 = 0;
-    // 定义工具坐标变量
-    string sTcpName = "TCP_AGP";
-    // 定义用户坐标变量
-    string sUcsName = "Base";
-    // 定义运动速度
-    double dVelocity = craft.cutinSpeed;
-    // 定义运动加速度
-    double dAcc = 2000;
-    // 定义过渡半径
-    double dRadius = 1;
-    // 定义是否使用关节角度
-    int nIsUseJoint = 1;
-    // 定义是否使用检测 DI 停止
-    int nIsSeek = 0;
-    // 定义检测的 DI 索引
-    int nIOBit = 0;
-    // 定义检测的 DI 状态
-    int nIOState = 0;
-    // 定义路点 ID
-    string strCmdID = "0";
-    // 移到结束辅助点
-    HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(), point.pos.z(),
-                  point.rot.x(), point.rot.y(), point.rot.z(), dJ1, dJ2, dJ3,
-                  dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-                  nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-    // 移到安全点
-    point = pointSet.safePoint;
-    // 定义运动速度
-    dVelocity = defaultVelocity;
-    HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(), point.pos.z(),
-                  point.rot.x(), point.rot.y(), point.rot.z(), dJ1, dJ2, dJ3,
-                  dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-                  nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-}
-
-void HansRobot::MoveLine(const Craft &craft) {
-    // 定义运动类型
-    int nMoveType = 1;
-    // 定义关节目标位置
-    double dJ1 = 0;
-    double dJ2 = 0;
-    double dJ3 = 0;
-    double dJ4 = 0;
-    double dJ5 = 0;
-    double dJ6 = 0;
-    // 定义工具坐标变量
-    string sTcpName = "TCP_AGP";
-    // 定义用户坐标变量
-    string sUcsName = "Base";
+void Robot::MoveSpline(const Craft &craft) {
     // 定义运动速度
     double dVelocity = craft.moveSpeed;
+    isCaptureContact = true;
     // 定义运动加速度
     double dAcc = 100;
     // 定义过渡半径
-    double dRadius = 1;
-    // 定义是否使用关节角度
-    int nIsUseJoint = 1;
-    // 定义是否使用检测 DI 停止
-    int nIsSeek = 0;
-    // 定义检测的 DI 索引
-    int nIOBit = 0;
-    // 定义检测的 DI 状态
-    int nIOState = 0;
-    // 定义路点 ID
-    string strCmdID = "0";
-    // 偏移
-    OffsetDirection direction = craft.offsetDirection;
-    double offset = craft.offsetDistance;
-
-    Point point;
-    for (int i = 0; i < pointSet.midPoints.size(); ++i) {
-        // 定义空间目标位置
-        point = pointSet.midPoints[i].PosRelByTool(direction, offset);
-        // 执行路点运动
-        HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
-                      point.pos.z(), point.rot.x(), point.rot.y(),
-                      point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                      sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
-                      nIOBit, nIOState, strCmdID);
+    double dRadius = craft.transitionRadius;
+    // 起始点、中间点、结束点拟合样条，按弧长等间距采样
+    QVector<QVector3D> points;
+    points.append(pointSet.beginPoint.pos + translation);
+    for (const Point &point : pointSet.midPoints) {
+        points.append(point.pos + translation);
+    }
+    points.append(pointSet.endPoint.pos + translation);
+    CubicSpline spline;
+    if (!spline.Fit(points)) {
+        return;
     }
-    // 移到结束点
-    point = pointSet.endPoint.PosRelByTool(direction, offset);
-    HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(), point.pos.z(),
-                  point.rot.x(), point.rot.y(), point.rot.z(), dJ1, dJ2, dJ3,
-                  dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-                  nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-}
-
-void HansRobot::MoveArc(const Craft &craft) {
-    // 定义运动类型
-    int nMoveType = 2;
-    // 定义关节目标位置
-    double dJ1 = 0;
-    double dJ2 = 0;
-    double dJ3 = 0;
-    double dJ4 = 0;
-    double dJ5 = 0;
-    double dJ6 = 0;
-    // 定义工具坐标变量
-    string sTcpName = "TCP_AGP";
-    // 定义用户坐标变量
-    string sUcsName = "Base";
-    // 定义运动速度
-    double dVelocity = craft.moveSpeed;
-    // 定义运动加速度
-    double dAcc = 100;
-    // 定义过渡半径
-    double dRadius = 1;
-    // 定义是否使用关节角度
-    int nIsUseJoint = 1;
-    // 定义是否使用检测 DI 停止
-    int nIsSeek = 0;
-    // 定义检测的 DI 索引
-    int nIOBit = 0;
-    // 定义检测的 DI 状态
-    int nIOState = 0;
-    // 定义路点 ID
-    string strCmdID = "0";
-    // 偏移
-    OffsetDirection direction = craft.offsetDirection;
-    double offset = craft.offsetDistance;
-    // 定义空间目标位置
-    Point posMidRel = pointSet.auxPoint.PosRelByTool(direction, offset);
-    Point posEndRel = pointSet.endPoint.PosRelByTool(direction, offset);
-    // 执行路点运动
-    HRIF_WayPoint2(0, 0, nMoveType, posEndRel.pos.x(), posEndRel.pos.y(),
-                   posEndRel.pos.z(), posEndRel.rot.x(), posEndRel.rot.y(),
-                   posEndRel.rot.z(), posMidRel.pos.x(), posMidRel.pos.y(),
-                   posMidRel.pos.z(), posMidRel.rot.x(), posMidRel.rot.y(),
-                   posMidRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                   sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
-                   nIOBit, nIOState, strCmdID);
-}
-
-// 平面圆弧
-// Position HansRobot::MoveRegionArc(double offset, OffsetDirection direction)
-// {
-//     // 定义运动类型
-//     int nMoveType = 2;
-//     // 定义关节目标位置
-//     double dJ1 = 0;
-//     double dJ2 = 0;
-//     double dJ3 = 0;
-//     double dJ4 = 0;
-//     double dJ5 = 0;
-//     double dJ6 = 0;
-//     // 定义工具坐标变量
-//     string sTcpName = "TCP_AGP";
-//     // 定义用户坐标变量
-//     string sUcsName = "Base";
-//     // 定义运动速度
-//     double dVelocity = crafts.at(currCraftIdx).moveSpeed;
-//     // 定义运动加速度
-//     double dAcc = 100;
-//     // 定义过渡半径
-//     double dRadius = 1;
-//     // 定义是否使用关节角度
-//     int nIsUseJoint = 1;
-//     // 定义是否使用检测 DI 停止
-//     int nIsSeek = 0;
-//     // 定义检测的 DI 索引
-//     int nIOBit = 0;
-//     // 定义检测的 DI 状态
-//     int nIOState = 0;
-//     // 定义路点 ID
-//     string strCmdID = "0";
-//     // 计算单次偏移量
-//     int count = crafts.at(currCraftIdx).offsetCount;
-//     Position beginOffset = (beginOffsetPoint - beginPoint) / count;
-//     Position endOffset = (endOffsetPoint - endPoint) / count;
-//     Position midOffset = (beginOffset + endOffset) / 2;
-//     // 定义空间目标位置
-//     Position posBeginRel = PosRelByTool(beginPoint, offset, direction);
-//     Position posEndRel = PosRelByTool(endPoint, offset, direction);
-//     Position posMidRel = PosRelByTool(auxPoint, offset, direction);
-//     // 正向圆弧运动
-//     HRIF_WayPoint2(0, 0, nMoveType, posEndRel.x, posEndRel.y, posEndRel.z,
-//                    posBeginRel.rx, posBeginRel.ry, posBeginRel.rz,
-//                    posMidRel.x, posMidRel.y, posMidRel.z, posBeginRel.rx,
-//                    posBeginRel.ry, posBeginRel.rz, dJ1, dJ2, dJ3, dJ4, dJ5,
-//                    dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-//                    nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-//     Position pos;
-//     for (int i = 0; i < count; ++i) {
-//         if (i % 2 == 0) {
-//             // 抬高
-//             pos = posEndRel;
-//             pos.rx = posBeginRel.rx;
-//             pos.ry = posBeginRel.ry;
-//             pos.rz = posBeginRel.rz;
-//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
-//             nMoveType = 1;
-//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
-//             pos.ry,
-//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-//                           nIsSeek, nIOBit, nIOState, strCmdID);
-//             // 改变位姿
-//             posBeginRel += beginOffset;
-//             posEndRel += endOffset;
-//             posMidRel += midOffset;
-//             pos = posEndRel;
-//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
-//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
-//             pos.ry,
-//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-//                           nIsSeek, nIOBit, nIOState, strCmdID);
-//             // 压低
-//             HRIF_WayPoint(0, 0, nMoveType, posEndRel.x, posEndRel.y,
-//                           posEndRel.z, posEndRel.rx, posEndRel.ry,
-//                           posEndRel.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6,
-//                           sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-//                           nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-//             // 反向圆弧运动
-//             nMoveType = 2;
-//             HRIF_WayPoint2(0, 0, nMoveType, posBeginRel.x, posBeginRel.y,
-//                            posBeginRel.z, posEndRel.rx, posEndRel.ry,
-//                            posEndRel.rz, posMidRel.x, posMidRel.y,
-//                            posMidRel.z, posEndRel.rx, posEndRel.ry,
-//                            posEndRel.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6,
-//                            sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-//                            nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-//         } else {
-//             // 抬高
-//             pos = posBeginRel;
-//             pos.rx = posEndRel.rx;
-//             pos.ry = posEndRel.ry;
-//             pos.rz = posEndRel.rz;
-//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
-//             nMoveType = 1;
-//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
-//             pos.ry,
-//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-//                           nIsSeek, nIOBit, nIOState, strCmdID);
-//             // 改变位姿
-//             posBeginRel += beginOffset;
-//             posEndRel += endOffset;
-//             posMidRel += midOffset;
-//             pos = posBeginRel;
-//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
-//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
-//             pos.ry,
-//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-//                           nIsSeek, nIOBit, nIOState, strCmdID);
-//             // 压低
-//             HRIF_WayPoint(0, 0, nMoveType, posBeginRel.x, posBeginRel.y,
-//                           posBeginRel.z, posBeginRel.rx, posBeginRel.ry,
-//                           posBeginRel.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6,
-//                           sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-//                           nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-//             // 正向圆弧运动
-//             nMoveType = 2;
-//             HRIF_WayPoint2(0, 0, nMoveType, posEndRel.x, posEndRel.y,
-//                            posEndRel.z, posBeginRel.rx, posBeginRel.ry,
-//                            posBeginRel.rz, posMidRel.x, posMidRel.y,
-//                            posMidRel.z, posBeginRel.rx, posBeginRel.ry,
-//                            posBeginRel.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6,
-//                            sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-//                            nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-//         }
-//     }
-//     return count % 2 == 0
-//                ? Position{posEndRel.x,    posEndRel.y,    posEndRel.z,
-//                           posBeginRel.rx, posBeginRel.ry, posBeginRel.rz}
-//                : Position{posBeginRel.x, posBeginRel.y, posBeginRel.z,
-//                           posEndRel.rx,  posEndRel.ry,  posEndRel.rz};
-// }
-
-// 柱面圆弧，辅助点姿态取平均
-// Position HansRobot::MoveRegionArc(double offset, OffsetDirection direction)
-// {
-//     // 定义运动类型
-//     int nMoveType = 2;
-//     // 定义关节目标位置
-//     double dJ1 = 0;
-//     double dJ2 = 0;
-//     double dJ3 = 0;
-//     double dJ4 = 0;
-//     double dJ5 = 0;
-//     double dJ6 = 0;
-//     // 定义工具坐标变量
-//     string sTcpName = "TCP_AGP";
-//     // 定义用户坐标变量
-//     string sUcsName = "Base";
-//     // 定义运动速度
-//     double dVelocity = crafts.at(currCraftIdx).moveSpeed;
-//     // 定义运动加速度
-//     double dAcc = 100;
-//     // 定义过渡半径
-//     double dRadius = 1;
-//     // 定义是否使用关节角度
-//     int nIsUseJoint = 1;
-//     // 定义是否使用检测 DI 停止
-//     int nIsSeek = 0;
-//     // 定义检测的 DI 索引
-//     int nIOBit = 0;
-//     // 定义检测的 DI 状态
-//     int nIOState = 0;
-//     // 定义路点 ID
-//     string strCmdID = "0";
-//     // 计算单次偏移量
-//     int count = crafts.at(currCraftIdx).offsetCount;
-//     Position beginOffset = (beginOffsetPoint - beginPoint) / count;
-//     Position endOffset = (endOffsetPoint - endPoint) / count;
-//     Position midOffset = (beginOffset + endOffset) / 2;
-//     // 定义空间目标位置
-//     Position posBeginRel = PosRelByTool(beginPoint, offset, direction);
-//     Position posEndRel = PosRelByTool(endPoint, offset, direction);
-//     Position posMidRel = PosRelByTool(auxPoint, offset, direction);
-//     // 正向圆弧运动，辅助点姿态取起始和结束点姿态的平均值
-//     HRIF_WayPoint2(0, 0, nMoveType, posEndRel.x, posEndRel.y, posEndRel.z,
-//                    posEndRel.rx, posEndRel.ry, posEndRel.rz, posMidRel.x,
-//                    posMidRel.y, posMidRel.z,
-//                    (posBeginRel.rx + posEndRel.rx) / 2,
-//                    (posBeginRel.ry + posEndRel.ry) / 2,
-//                    (posBeginRel.rz + posEndRel.rz) / 2, dJ1, dJ2, dJ3, dJ4,
-//                    dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-//                    nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-//     Position pos;
-//     for (int i = 0; i < count; ++i) {
-//         if (i % 2 == 0) { // 反向
-//             // 抬高
-//             pos = posEndRel;
-//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
-//             nMoveType = 1;
-//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
-//             pos.ry,
-//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-//                           nIsSeek, nIOBit, nIOState, strCmdID);
-//             // 改变位姿
-//             posBeginRel += beginOffset;
-//             posEndRel += endOffset;
-//             posMidRel += midOffset;
-//             pos = posEndRel;
-//             pos.rx = endOffsetPoint.rx;
-//             pos.ry = endOffsetPoint.ry;
-//             pos.rz = endOffsetPoint.rz;
-//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
-//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
-//             pos.ry,
-//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-//                           nIsSeek, nIOBit, nIOState, strCmdID);
-//             // 压低
-//             pos = posEndRel;
-//             pos.rx = endOffsetPoint.rx;
-//             pos.ry = endOffsetPoint.ry;
-//             pos.rz = endOffsetPoint.rz;
-//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
-//             pos.ry,
-//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-//                           nIsSeek, nIOBit, nIOState, strCmdID);
-//             // 反向圆弧运动
-//             nMoveType = 2;
-//             HRIF_WayPoint2(
-//                 0, 0, nMoveType, posBeginRel.x, posBeginRel.y, posBeginRel.z,
-//                 beginOffsetPoint.rx, beginOffsetPoint.ry,
-//                 beginOffsetPoint.rz, posMidRel.x, posMidRel.y, posMidRel.z,
-//                 (beginOffsetPoint.rx + endOffsetPoint.rx) / 2,
-//                 (beginOffsetPoint.ry + endOffsetPoint.ry) / 2,
-//                 (beginOffsetPoint.rz + endOffsetPoint.rz) / 2, dJ1, dJ2, dJ3,
-//                 dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-//                 nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-//         } else { // 正向
-//             // 抬高
-//             pos = posBeginRel;
-//             pos.rx = beginOffsetPoint.rx;
-//             pos.ry = beginOffsetPoint.ry;
-//             pos.rz = beginOffsetPoint.rz;
-//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
-//             nMoveType = 1;
-//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
-//             pos.ry,
-//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-//                           nIsSeek, nIOBit, nIOState, strCmdID);
-//             // 改变位姿
-//             posBeginRel += beginOffset;
-//             posEndRel += endOffset;
-//             posMidRel += midOffset;
-//             pos = posBeginRel;
-//             pos = PosRelByTool(pos, defaultOffset, defaultDirection);
-//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
-//             pos.ry,
-//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-//                           nIsSeek, nIOBit, nIOState, strCmdID);
-//             // 压低
-//             pos = posBeginRel;
-//             HRIF_WayPoint(0, 0, nMoveType, pos.x, pos.y, pos.z, pos.rx,
-//             pos.ry,
-//                           pos.rz, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-//                           sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-//                           nIsSeek, nIOBit, nIOState, strCmdID);
-//             // 正向圆弧运动
-//             nMoveType = 2;
-//             HRIF_WayPoint2(
-//                 0, 0, nMoveType, posEndRel.x, posEndRel.y, posEndRel.z,
-//                 posEndRel.rx, posEndRel.ry, posEndRel.rz, posMidRel.x,
-//                 posMidRel.y, posMidRel.z, (posBeginRel.rx + posEndRel.rx) /
-//                 2, (posBeginRel.ry + posEndRel.ry) / 2, (posBeginRel.rz +
-//                 posEndRel.rz) / 2, dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-//                 sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
-//                 nIOBit, nIOState, strCmdID);
-//         }
-//     }
-//     return count % 2 == 0 ? Position{posEndRel.x,  posEndRel.y,  posEndRel.z,
-//                                      posEndRel.rx, posEndRel.ry,
-//                                      posEndRel.rz}
-//                           : Position{posBeginRel.x,       posBeginRel.y,
-//                                      posBeginRel.z, beginOffsetPoint.rx,
-//                                      beginOffsetPoint.ry,
-//                                      beginOffsetPoint.rz};
-// }
-
-// 柱面圆弧，辅助点姿态不取平均
-Point HansRobot::MoveRegionArc1(const Craft &craft) {
-    // 定义运动类型
-    int nMoveType = 2;
-    // 定义关节目标位置
-    double dJ1 = 0;
-    double dJ2 = 0;
-    double dJ3 = 0;
-    double dJ4 = 0;
-    double dJ5 = 0;
-    double dJ6 = 0;
-    // 定义工具坐标变量
-    string sTcpName = "TCP_AGP";
-    // 定义用户坐标变量
-    string sUcsName = "Base";
-    // 定义运动速度
-    double dVelocity = craft.moveSpeed;
-    // 定义运动加速度
-    double dAcc = 100;
-    // 定义过渡半径
-    double dRadius = 1;
-    // 定义是否使用关节角度
-    int nIsUseJoint = 1;
-    // 定义是否使用检测 DI 停止
-    int nIsSeek = 0;
-    // 定义检测的 DI 索引
-    int nIOBit = 0;
-    // 定义检测的 DI 状态
-    int nIOState = 0;
-    // 定义路点 ID
-    string strCmdID = "0";
-    // 偏移
-    OffsetDirection direction = craft.offsetDirection;
-    double offset = craft.offsetDistance;
-    // 计算单次偏移量
-    int count = craft.offsetCount;
-    Point beginOffset;
-    beginOffset.pos =
-        (pointSet.beginOffsetPoint.pos - pointSet.beginPoint.pos) / count;
-    Point endOffset;
-    endOffset.pos =
-        (pointSet.endOffsetPoint.pos - pointSet.endPoint.pos) / count;
-    Point midOffset;
-    midOffset.pos = (beginOffset.pos + endOffset.pos) / 2;
-    // 定义空间目标位置
-    Point posBeginRel = pointSet.beginPoint.PosRelByTool(direction, offset);
-    Point posEndRel = pointSet.endPoint.PosRelByTool(direction, offset);
-    Point posMidRel = pointSet.auxPoint.PosRelByTool(direction, offset);
-    // 正向圆弧运动
-    HRIF_WayPoint2(0, 0, nMoveType, posEndRel.pos.x(), posEndRel.pos.y(),
-                   posEndRel.pos.z(), posEndRel.rot.x(), posEndRel.rot.y(),
-                   posEndRel.rot.z(), posMidRel.pos.x(), posMidRel.pos.y(),
-                   posMidRel.pos.z(), posMidRel.rot.x(), posMidRel.rot.y(),
-                   posMidRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                   sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
-                   nIOBit, nIOState, strCmdID);
+    QVector<QVector3D> samples = spline.Resample(splineStep);
     Point point;
-    for (int i = 0; i < count; ++i) {
-        if (i % 2 == 0) { // 反向
-            // 抬高
-            point = posEndRel;
-            point = point.PosRelByTool(defaultDirection, defaultOffset);
-            nMoveType = 1;
-            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
-                          point.pos.z(), point.rot.x(), point.rot.y(),
-                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-                          nIsSeek, nIOBit, nIOState, strCmdID);
-            // 改变位姿
-            posBeginRel += beginOffset;
-            posEndRel += endOffset;
-            posMidRel += midOffset;
-            point = posEndRel;
-            point.rot.setX(pointSet.endOffsetPoint.rot.x());
-            point.rot.setY(pointSet.endOffsetPoint.rot.y());
-            point.rot.setZ(pointSet.endOffsetPoint.rot.z());
-            point = point.PosRelByTool(defaultDirection, defaultOffset);
-            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
-                          point.pos.z(), point.rot.x(), point.rot.y(),
-                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-                          nIsSeek, nIOBit, nIOState, strCmdID);
-            // 压低
-            point = posEndRel;
-            point.rot.setX(pointSet.endOffsetPoint.rot.x());
-            point.rot.setY(pointSet.endOffsetPoint.rot.y());
-            point.rot.setZ(pointSet.endOffsetPoint.rot.z());
-            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
-                          point.pos.z(), point.rot.x(), point.rot.y(),
-                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-                          nIsSeek, nIOBit, nIOState, strCmdID);
-            // 反向圆弧运动
-            nMoveType = 2;
-            HRIF_WayPoint2(0, 0, nMoveType, posBeginRel.pos.x(),
-                           posBeginRel.pos.y(), posBeginRel.pos.z(),
-                           pointSet.beginOffsetPoint.rot.x(),
-                           pointSet.beginOffsetPoint.rot.y(),
-                           pointSet.beginOffsetPoint.rot.z(), posMidRel.pos.x(),
-                           posMidRel.pos.y(), posMidRel.pos.z(),
-                           (posMidRel.rot.x() - posBeginRel.rot.x() +
-                            pointSet.beginOffsetPoint.rot.x()),
-                           (posMidRel.rot.y() - posBeginRel.rot.y() +
-                            pointSet.beginOffsetPoint.rot.y()),
-                           (posMidRel.rot.z() - posBeginRel.rot.z() +
-                            pointSet.beginOffsetPoint.rot.z()),
-                           dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName, sUcsName,
-                           dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
-                           nIOBit, nIOState, strCmdID);
-        } else { // 正向
-            // 抬高
-            point = posBeginRel;
-            point.rot.setX(pointSet.beginOffsetPoint.rot.x());
-            point.rot.setY(pointSet.beginOffsetPoint.rot.y());
-            point.rot.setZ(pointSet.beginOffsetPoint.rot.z());
-            point = point.PosRelByTool(defaultDirection, defaultOffset);
-            nMoveType = 1;
-            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
-                          point.pos.z(), point.rot.x(), point.rot.y(),
-                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-                          nIsSeek, nIOBit, nIOState, strCmdID);
-            // 改变位姿
-            posBeginRel += beginOffset;
-            posEndRel += endOffset;
-            posMidRel += midOffset;
-            point = posBeginRel;
-            point = point.PosRelByTool(defaultDirection, defaultOffset);
-            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
-                          point.pos.z(), point.rot.x(), point.rot.y(),
-                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-                          nIsSeek, nIOBit, nIOState, strCmdID);
-            // 压低
-            point = posBeginRel;
-            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
-                          point.pos.z(), point.rot.x(), point.rot.y(),
-                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-                          nIsSeek, nIOBit, nIOState, strCmdID);
-            // 正向圆弧运动
-            nMoveType = 2;
-            HRIF_WayPoint2(
-                0, 0, nMoveType, posEndRel.pos.x(), posEndRel.pos.y(),
-                posEndRel.pos.z(), posEndRel.rot.x(), posEndRel.rot.y(),
-                posEndRel.rot.z(), posMidRel.pos.x(), posMidRel.pos.y(),
-                posMidRel.pos.z(), posMidRel.rot.x(), posMidRel.rot.y(),
-                posMidRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
-                nIOBit, nIOState, strCmdID);
-        }
-    }
-    return count % 2 == 0
-               ? Point{posEndRel.pos.x(), posEndRel.pos.y(), posEndRel.pos.z(),
-                       posEndRel.rot.x(), posEndRel.rot.y(), posEndRel.rot.z()}
-               : Point{posBeginRel.pos.x(),
-                       posBeginRel.pos.y(),
-                       posBeginRel.pos.z(),
-                       pointSet.beginOffsetPoint.rot.x(),
-                       pointSet.beginOffsetPoint.rot.y(),
-                       pointSet.beginOffsetPoint.rot.z()};
-}
-
-Point HansRobot::MoveRegionArc2(const Craft &craft) {
-    // 定义运动类型
-    int nMoveType = 2;
-    // 定义关节目标位置
-    double dJ1 = 0;
-    double dJ2 = 0;
-    double dJ3 = 0;
-    double dJ4 = 0;
-    double dJ5 = 0;
-    double dJ6 = 0;
-    // 定义工具坐标变量
-    string sTcpName = "TCP_AGP";
-    // 定义用户坐标变量
-    string sUcsName = "Base";
-    // 定义运动速度
-    double dVelocity = craft.moveSpeed;
-    // 定义运动加速度
-    double dAcc = 100;
-    // 定义过渡半径
-    double dRadius = 1;
-    // 定义是否使用关节角度
-    int nIsUseJoint = 1;
-    // 定义是否使用检测 DI 停止
-    int nIsSeek = 0;
-    // 定义检测的 DI 索引
-    int nIOBit = 0;
-    // 定义检测的 DI 状态
-    int nIOState = 0;
-    // 定义路点 ID
-    string strCmdID = "0";
-    // 偏移
-    OffsetDirection direction = craft.offsetDirection;
-    double offset = craft.offsetDistance;
-    // 计算单次偏移量
-    int count = craft.offsetCount;
-    Point beginOffset;
-    beginOffset.pos =
-        (pointSet.beginOffsetPoint.pos - pointSet.beginPoint.pos) / count;
-    Point endOffset;
-    endOffset.pos =
-        (pointSet.endOffsetPoint.pos - pointSet.endPoint.pos) / count;
-    Point midOffset;
-    midOffset.pos = (beginOffset.pos + endOffset.pos) / 2;
-    // 定义空间目标位置
-    Point posBeginRel = pointSet.beginPoint.PosRelByTool(direction, offset);
-    Point posEndRel = pointSet.endPoint.PosRelByTool(direction, offset);
-    Point posMidRel = pointSet.auxPoint.PosRelByTool(direction, offset);
-    // 正向圆弧运动
-    HRIF_WayPoint2(0, 0, nMoveType, posEndRel.pos.x(), posEndRel.pos.y(),
-                   posEndRel.pos.z(), posEndRel.rot.x(), posEndRel.rot.y(),
-                   posEndRel.rot.z(), posMidRel.pos.x(), posMidRel.pos.y(),
-                   posMidRel.pos.z(), posMidRel.rot.x(), posMidRel.rot.y(),
-                   posMidRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                   sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
-                   nIOBit, nIOState, strCmdID);
-    Point point;
-    for (int i = 0; i < count; ++i) {
-        if (i % 2 == 0) { // 反向
-            // 抬高
-            point = posEndRel;
-            point = point.PosRelByTool(defaultDirection, defaultOffset);
-            nMoveType = 1;
-            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
-                          point.pos.z(), point.rot.x(), point.rot.y(),
-                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-                          nIsSeek, nIOBit, nIOState, strCmdID);
-            // 改变位姿
-            posBeginRel += beginOffset;
-            posEndRel += endOffset;
-            posMidRel += midOffset;
-            point = posEndRel;
-            point.rot.setX(pointSet.endOffsetPoint.rot.x());
-            point.rot.setY(pointSet.endOffsetPoint.rot.y());
-            point.rot.setZ(pointSet.endOffsetPoint.rot.z());
-            point = point.PosRelByTool(defaultDirection, defaultOffset);
-            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
-                          point.pos.z(), point.rot.x(), point.rot.y(),
-                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-                          nIsSeek, nIOBit, nIOState, strCmdID);
-            // 压低
-            point = posEndRel;
-            point.rot.setX(pointSet.endOffsetPoint.rot.x());
-            point.rot.setY(pointSet.endOffsetPoint.rot.y());
-            point.rot.setZ(pointSet.endOffsetPoint.rot.z());
-            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
-                          point.pos.z(), point.rot.x(), point.rot.y(),
-                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-                          nIsSeek, nIOBit, nIOState, strCmdID);
-            // 反向圆弧运动
-            nMoveType = 2;
-            HRIF_WayPoint2(0, 0, nMoveType, posBeginRel.pos.x(),
-                           posBeginRel.pos.y(), posBeginRel.pos.z(),
-                           pointSet.beginOffsetPoint.rot.x(),
-                           pointSet.beginOffsetPoint.rot.y(),
-                           pointSet.beginOffsetPoint.rot.z(), posMidRel.pos.x(),
-                           posMidRel.pos.y(), posMidRel.pos.z(),
-                           (posMidRel.rot.x() - posBeginRel.rot.x() +
-                            pointSet.beginOffsetPoint.rot.x()),
-                           (posMidRel.rot.y() - posBeginRel.rot.y() +
-                            pointSet.beginOffsetPoint.rot.y()),
-                           (posMidRel.rot.z() - posBeginRel.rot.z() +
-                            pointSet.beginOffsetPoint.rot.z()),
-                           dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName, sUcsName,
-                           dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
-                           nIOBit, nIOState, strCmdID);
-        } else { // 正向
-            // 抬高
-            point = posBeginRel;
-            point.rot.setX(pointSet.beginOffsetPoint.rot.x());
-            point.rot.setY(pointSet.beginOffsetPoint.rot.y());
-            point.rot.setZ(pointSet.beginOffsetPoint.rot.z());
-            point = point.PosRelByTool(defaultDirection, defaultOffset);
-            nMoveType = 1;
-            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
-                          point.pos.z(), point.rot.x(), point.rot.y(),
-                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-                          nIsSeek, nIOBit, nIOState, strCmdID);
-            // 改变位姿
-            posBeginRel += beginOffset;
-            posEndRel += endOffset;
-            posMidRel += midOffset;
-            point = posBeginRel;
-            point = point.PosRelByTool(defaultDirection, defaultOffset);
-            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
-                          point.pos.z(), point.rot.x(), point.rot.y(),
-                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-                          nIsSeek, nIOBit, nIOState, strCmdID);
-            // 压低
-            point = posBeginRel;
-            HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(),
-                          point.pos.z(), point.rot.x(), point.rot.y(),
-                          point.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                          sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint,
-                          nIsSeek, nIOBit, nIOState, strCmdID);
-            // 正向圆弧运动
-            nMoveType = 2;
-            HRIF_WayPoint2(
-                0, 0, nMoveType, posEndRel.pos.x(), posEndRel.pos.y(),
-                posEndRel.pos.z(), posEndRel.rot.x(), posEndRel.rot.y(),
-                posEndRel.rot.z(), posMidRel.pos.x(), posMidRel.pos.y(),
-                posMidRel.pos.z(), posMidRel.rot.x(), posMidRel.rot.y(),
-                posMidRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
-                nIOBit, nIOState, strCmdID);
-        }
-    }
-    return count % 2 == 0
-               ? Point{posEndRel.pos.x(), posEndRel.pos.y(), posEndRel.pos.z(),
-                       posEndRel.rot.x(), posEndRel.rot.y(), posEndRel.rot.z()}
-               : Point{posBeginRel.pos.x(),
-                       posBeginRel.pos.y(),
-                       posBeginRel.pos.z(),
-                       pointSet.beginOffsetPoint.rot.x(),
-                       pointSet.beginOffsetPoint.rot.y(),
-                       pointSet.beginOffsetPoint.rot.z()};
-}
-
-void HansRobot::MoveZLine(const Craft &craft) {
-    // 定义运动类型
-    int nMoveType = 1;
-    // 定义关节目标位置
-    double dJ1 = 0;
-    double dJ2 = 0;
-    double dJ3 = 0;
-    double dJ4 = 0;
-    double dJ5 = 0;
-    double dJ6 = 0;
-    // 定义工具坐标变量
-    string sTcpName = "TCP_AGP";
-    // 定义用户坐标变量
-    string sUcsName = "Base";
-    // 定义运动速度
-    double dVelocity = craft.moveSpeed;
-    // 定义运动加速度
-    double dAcc = 100;
-    // 定义过渡半径
-    double dRadius = 1;
-    // 定义是否使用关节角度
-    int nIsUseJoint = 1;
-    // 定义是否使用检测 DI 停止
-    int nIsSeek = 0;
-    // 定义检测的 DI 索引
-    int nIOBit = 0;
-    // 定义检测的 DI 状态
-    int nIOState = 0;
-    // 定义路点 ID
-    string strCmdID = "0";
-
-    // 偏移
-    OffsetDirection direction = craft.offsetDirection;
-    double offset = craft.offsetDistance;
-    int size = craft.offsetCount + 1;
-    float factor = 1.0 / size;
-
-    Point point = pointSet.beginPoint;
-    Point pointRel;
-    Point pointOffset;
-    pointOffset.pos = pointSet.auxPoint.pos - pointSet.beginPoint.pos;
-    pointOffset.rot = pointSet.auxPoint.rot - pointSet.beginPoint.rot;
-    for (int i = 1; i <= size; ++i) {
-        point += pointOffset;
-        pointRel = point.PosRelByTool(direction, offset);
-        HRIF_WayPoint(0, 0, nMoveType, pointRel.pos.x(), pointRel.pos.y(),
-                      pointRel.pos.z(), pointRel.rot.x(), pointRel.rot.y(),
-                      pointRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                      sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
-                      nIOBit, nIOState, strCmdID);
-        point =
-            Point::scale(pointSet.beginPoint, pointSet.endPoint, factor * i);
-        pointRel = point.PosRelByTool(direction, offset);
-        HRIF_WayPoint(0, 0, nMoveType, pointRel.pos.x(), pointRel.pos.y(),
-                      pointRel.pos.z(), pointRel.rot.x(), pointRel.rot.y(),
-                      pointRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                      sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
-                      nIOBit, nIOState, strCmdID);
-    }
-}
-
-void HansRobot::MoveSpiralLine(const Craft &craft) {
-    // 定义运动类型
-    int nMoveType = 2;
-    // 定义关节目标位置
-    double dJ1 = 0;
-    double dJ2 = 0;
-    double dJ3 = 0;
-    double dJ4 = 0;
-    double dJ5 = 0;
-    double dJ6 = 0;
-    // 定义工具坐标变量
-    string sTcpName = "TCP_AGP";
-    // 定义用户坐标变量
-    string sUcsName = "Base";
-    // 定义运动速度
-    double dVelocity = craft.moveSpeed;
-    // 定义运动加速度
-    double dAcc = 100;
-    // 定义过渡半径
-    double dRadius = 1;
-    // 定义是否使用关节角度
-    int nIsUseJoint = 1;
-    // 定义是否使用检测 DI 停止
-    int nIsSeek = 0;
-    // 定义检测的 DI 索引
-    int nIOBit = 0;
-    // 定义检测的 DI 状态
-    int nIOState = 0;
-    // 定义路点 ID
-    string strCmdID = "0";
-
-    // 偏移
-    OffsetDirection direction = craft.offsetDirection;
-    double offset = craft.offsetDistance;
-    int size = craft.offsetCount + 1;
-    float factor = 1.0 / (2 * size + 2);
-
-    // 定义空间目标位置
-    Point pointEnd =
-        Point::scale(pointSet.beginPoint, pointSet.endPoint, factor * 4);
-    QVector3D O = Point::calculateCircumcenter(
-        pointSet.beginPoint.pos, pointSet.auxPoint.pos, pointEnd.pos);
-    Point pointAux =
-        Point::scale(pointSet.beginPoint, pointSet.endPoint, factor * 2);
-    QVector3D temp = (pointAux.pos - O);
-    QVector3D upOffset =
-        temp.normalized() * pointSet.beginPoint.pos.distanceToPoint(O) - temp;
-    QVector3D downOffset = temp * (-0.5);
-    pointAux.pos += upOffset;
-    Point pointEndRel = pointEnd.PosRelByTool(direction, offset);
-    Point pointAuxRel = pointAux.PosRelByTool(direction, offset);
-    // 执行路点运动
-    HRIF_WayPoint2(0, 0, nMoveType, pointEndRel.pos.x(), pointEndRel.pos.y(),
-                   pointEndRel.pos.z(), pointEndRel.rot.x(),
-                   pointEndRel.rot.y(), pointEndRel.rot.z(),
-                   pointAuxRel.pos.x(), pointAuxRel.pos.y(),
-                   pointAuxRel.pos.z(), pointAuxRel.rot.x(),
-                   pointAuxRel.rot.y(), pointAuxRel.rot.z(), dJ1, dJ2, dJ3, dJ4,
-                   dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-                   nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-    for (int i = 1; i < size; ++i) {
-        // 小圆弧
-        pointEnd = Point::scale(pointSet.beginPoint, pointSet.endPoint,
-                                factor * (2 * i));
-        pointAux = Point::scale(pointSet.beginPoint, pointSet.endPoint,
-                                factor * (2 * i + 1));
-        pointAux.pos += downOffset;
-        pointEndRel = pointEnd.PosRelByTool(direction, offset);
-        pointAuxRel = pointAux.PosRelByTool(direction, offset);
-        HRIF_WayPoint2(
-            0, 0, nMoveType, pointEndRel.pos.x(), pointEndRel.pos.y(),
-            pointEndRel.pos.z(), pointEndRel.rot.x(), pointEndRel.rot.y(),
-            pointEndRel.rot.z(), pointAuxRel.pos.x(), pointAuxRel.pos.y(),
-            pointAuxRel.pos.z(), pointAuxRel.rot.x(), pointAuxRel.rot.y(),
-            pointAuxRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-            sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek, nIOBit,
-            nIOState, strCmdID);
-        // 大圆弧
-        pointEnd = Point::scale(pointSet.beginPoint, pointSet.endPoint,
-                                factor * (2 * i + 4));
-        pointAux = Point::scale(pointSet.beginPoint, pointSet.endPoint,
-                                factor * (2 * i + 2));
-        pointAux.pos += upOffset;
-        pointEndRel = pointEnd.PosRelByTool(direction, offset);
-        pointAuxRel = pointAux.PosRelByTool(direction, offset);
-        HRIF_WayPoint2(
-            0, 0, nMoveType, pointEndRel.pos.x(), pointEndRel.pos.y(),
-            pointEndRel.pos.z(), pointEndRel.rot.x(), pointEndRel.rot.y(),
-            pointEndRel.rot.z(), pointAuxRel.pos.x(), pointAuxRel.pos.y(),
-            pointAuxRel.pos.z(), pointAuxRel.rot.x(), pointAuxRel.rot.y(),
-            pointAuxRel.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-            sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek, nIOBit,
-            nIOState, strCmdID);
-    }
-}
-
-void HansRobot::Run(const Craft &craft, bool isAGPRun) {
-    // QThread::msleep(100);
-    MoveBefore(craft, isAGPRun);
-    // 偏移
-    OffsetDirection direction = craft.offsetDirection;
-    double offset = craft.offsetDistance;
-    Point point = pointSet.auxEndPoint.PosRelByTool(direction, offset);
-    // 选择打磨方式
-    switch (craft.way) {
-    case PolishWay::ArcWay:
-        MoveArc(craft);
-        break;
-    case PolishWay::LineWay:
-        MoveLine(craft);
-        break;
-    case PolishWay::RegionArcWay1:
-        point = MoveRegionArc1(craft);
-        point = point.PosRelByTool(defaultDirection, defaultOffset);
-        break;
-    case PolishWay::RegionArcWay2:
-        point = MoveRegionArc2(craft);
-        point = point.PosRelByTool(defaultDirection, defaultOffset);
-        break;
-    case PolishWay::ZLineWay:
-        MoveZLine(craft);
-        break;
-    case PolishWay::SpiralLineWay:
-        MoveSpiralLine(craft);
-        break;
-    default:
-        break;
-    }
-    MoveAfter(craft, point);
-}
-*/
-bool HansRobot::Stop() {
-    // 机器人停止
-    isStop.store(true);
-    HRIF_GrpStop(0, 0);
-    // HRIF_StopScript(0);
-    // AGP停止
-    if (agp != nullptr) {
-        agp->SetSpeed(0);
-    }
-    // 机器人复位
-    HRIF_GrpReset(0, 0);
-    // AGP复位
-    if (agp != nullptr) {
-        agp->Control(FUNC::RESET);
+    point.rot = newRot;
+    isCaptureStreamed = true;
+    for (int i = 1; i < samples.size(); ++i) {
+        point.pos = samples.at(i);
+        MoveL(point, dVelocity, dAcc, dRadius);
     }
-    // 自由拖拽复位
-    isTeach = false;
-
-    return true;
+    isCaptureStreamed = false;
 }
 
-void HansRobot::OpenWeb(QString ip) {
-    QDesktopServices::openUrl(QUrl("http://" + ip + "/dist"));
-}
-
-void HansRobot::MoveTcpL(const Point &point, double velocity, double acc,
-                         double radius) {
-    // 定义运动类型
-    int nMoveType = 1;
-    // 定义关节目标位置
-    double dJ1 = 0;
-    double dJ2 = 0;
-    double dJ3 = 0;
-    double dJ4 = 0;
-    double dJ5 = 0;
-    double dJ6 = 0;
-    // 定义工具坐标变量
-    string sTcpName = "TCP_AGP";
-    // 定义用户坐标变量
-    string sUcsName = "Base";
-    // 定义运动速度
-    double dVelocity = velocity;
-    // 定义运动加速度
-    double dAcc = 1000;
-    // 定义过渡半径
-    double dRadius = radius;
-    // 定义是否使用关节角度
-    int nIsUseJoint = 1;
-    // 定义是否使用检测 DI 停止
-    int nIsSeek = 0;
-    // 定义检测的 DI 索引
-    int nIOBit = 0;
-    // 定义检测的 DI 状态
-    int nIOState = 0;
-    // 定义路点 ID
-    string strCmdID = "0";
-    // 直线运动
-    HRIF_WayPoint(0, 0, nMoveType, point.pos.x(), point.pos.y(), point.pos.z(),
-                  point.rot.x(), point.rot.y(), point.rot.z(), dJ1, dJ2, dJ3,
-                  dJ4, dJ5, dJ6, sTcpName, sUcsName, dVelocity, dAcc, dRadius,
-                  nIsUseJoint, nIsSeek, nIOBit, nIOState, strCmdID);
-}
-
-void HansRobot::MoveTcpC(const Point &auxPoint, const Point &endPoint,
-                         double velocity, double acc, double radius) {
-    // 定义运动类型
-    int nMoveType = 2;
-    // 定义关节目标位置
-    double dJ1 = 0;
-    double dJ2 = 0;
-    double dJ3 = 0;
-    double dJ4 = 0;
-    double dJ5 = 0;
-    double dJ6 = 0;
-    // 定义工具坐标变量
-    string sTcpName = "TCP_AGP";
-    // 定义用户坐标变量
-    string sUcsName = "Base";
+Point Robot::MoveSphere(const Craft &craft) {
+    // 打磨片半径
+    double discRadius = craft.discRadius;
+    // 打磨角度
+    double grindAngle = craft.grindAngle;
     // 定义运动速度
-    double dVelocity = velocity;
+    double dVelocity = defaultVelocity;
+    isCaptureContact = false;
     // 定义运动加速度
-    double dAcc = 1000;
+    double dAcc = 2000;
     // 定义过渡半径
-    double dRadius = radius;
-    // 定义是否使用关节角度
-    int nIsUseJoint = 1;
-    // 定义是否使用检测 DI 停止
-    int nIsSeek = 0;
-    // 定义检测的 DI 索引
-    int nIOBit = 0;
-    // 定义检测的 DI 状态
-    int nIOState = 0;
-    // 定义路点 ID
-    string strCmdID = "0";
-    // 圆弧运动
-    HRIF_WayPoint2(0, 0, nMoveType, endPoint.pos.x(), endPoint.pos.y(),
-                   endPoint.pos.z(), endPoint.rot.x(), endPoint.rot.y(),
-                   endPoint.rot.z(), auxPoint.pos.x(), auxPoint.pos.y(),
-                   auxPoint.pos.z(), auxPoint.rot.x(), auxPoint.rot.y(),
-                   auxPoint.rot.z(), dJ1, dJ2, dJ3, dJ4, dJ5, dJ6, sTcpName,
-                   sUcsName, dVelocity, dAcc, dRadius, nIsUseJoint, nIsSeek,
-                   nIOBit, nIOState, strCmdID);
-}
-/*
-DucoRobot::DucoRobot() : ducoCobot(nullptr) {}
+    double dRadius = craft.transitionRadius;
 
-DucoRobot::~DucoRobot() {
-    if (ducoCobot != nullptr) {
-        ducoCobot->end_teach_mode(true);
-        ducoCobot->disable(true);
-        ducoCobot->close();
-        delete ducoCobot;
-        ducoCobot = nullptr;
-    }
-}
+    Point pos;
+    pos.pos = pointSet.endPoint.pos + translation;
+    pos.rot = newRot;
+    // 起始点、中间点、结束点拟合球面
+    QVector<QVector3D> points;
+    points.append(pointSet.beginPoint.pos);
+    for (const Point &point : pointSet.midPoints) {
+        points.append(point.pos);
+    }
+    points.append(pointSet.endPoint.pos);
+    QVector3D center;
+    float radius = 0;
+    if (!Point::fitSphere(points, center, radius)) {
+        return pos;
+    }
+    // 球冠轴线：球心指向示教点重心；球冠半角为示教点与轴线的最大夹角
+    QVector3D centroid;
+    for (const QVector3D &point : points) {
+        centroid += point;
+    }
+    centroid /= points.size();
+    QVector3D axisZ = (centroid - center).normalized();
+    if (axisZ.isNull()) {
+        axisZ = (pointSet.beginPoint.pos - center).normalized();
+    }
+    double maxTheta = 0;
+    for (const QVector3D &point : points) {
+        double cosTheta =
+            QVector3D::dotProduct((point - center).normalized(), axisZ);
+        maxTheta = qMax(maxTheta, qAcos(qBound(-1.0, cosTheta, 1.0)));
+    }
+    // 方位角从起始点所在经线开始
+    QVector3D axisX = pointSet.beginPoint.pos - center;
+    axisX -= QVector3D::dotProduct(axisX, axisZ) * axisZ;
+    if (axisX.length() < precision) {
+        axisX = QVector3D::crossProduct(axisZ, qAbs(axisZ.x()) < 0.9
+                                                   ? QVector3D(1, 0, 0)
+                                                   : QVector3D(0, 1, 0));
+    }
+    axisX.normalize();
+    QVector3D axisY = QVector3D::crossProduct(axisZ, axisX);
+    // 示教姿态工具Z轴指向球心为凸面
+    QMatrix3x3 R = Point::toRotationMatrix(pointSet.beginPoint.rot);
+    QVector3D toolZ(R(0, 2), R(1, 2), R(2, 2));
+    bool isConvex =
+        QVector3D::dotProduct(toolZ, center - pointSet.beginPoint.pos) > 0;
+    // 行距 = 打磨片直径 × (1 - 重叠率)，换算为纬度间隔
+    double overlap = qBound(0, craft.overlapRatio, 90) / 100.0;
+    double rowStep = qMax(1.0, 2 * discRadius * (1 - overlap));
+    double endTheta = qMin(maxTheta, rowStep / radius / 2);
+    int count = qMax(1, qCeil((maxTheta - endTheta) * radius / rowStep));
+    double thetaStep = (maxTheta - endTheta) / count;
+
+    // 球面上 (θ, φ) 处的打磨位姿，θ 为与轴线夹角，φ 为方位角，沿纬线方向行进
+    auto spherePose = [&](double theta, double phi) {
+        QVector3D radial =
+            axisZ * qCos(theta) +
+            (axisX * qCos(phi) + axisY * qSin(phi)) * qSin(theta);
+        QVector3D normal = isConvex ? -radial : radial;
+        QVector3D moveDirection = axisY * qCos(phi) - axisX * qSin(phi);
+        QVector3D rotation = Point::getNormalRotation(normal, moveDirection);
+        // 获取新的姿态
+        newRot = Point::getNewRotation(rotation, moveDirection, grindAngle);
+        // 获取新姿态需要的平移量
+        translation = Point::getTranslation(rotation, moveDirection,
+                                            discRadius, grindAngle);
+        Point point;
+        point.pos = center + radial * radius + translation;
+        point.rot = newRot;
+        return point;
+    };
 
-bool DucoRobot::RobotConnect(QString robotIP) {
-    robotIPAddr = robotIP.toStdString();
-    if (ducoCobot != nullptr) {
-        delete ducoCobot;
-    }
-    ducoCobot = new DucoRPC::DucoCobot(robotIPAddr, 7003);
-    if (ducoCobot != nullptr && ducoCobot->open() == 0) {
-        // 机器人上电
-        ducoCobot->power_on(true);
-        // 设置速度比
-        ducoCobot->speed(100);
-        return true;
-    }
-    return false;
-}
+    pos = spherePose(maxTheta, 0);
+    MoveL(pos.PosRelByTool(defaultDirection, defaultOffset), dVelocity, dAcc,
+          dRadius);
+    dVelocity = craft.cutinSpeed;
+    isCaptureContact = false;
+    MoveL(pos, dVelocity, dAcc, dRadius);
 
-bool DucoRobot::RobotTeach(int pos) {
-    qDebug() << "start";
-    if (!isTeach) {
-        qDebug() << "if:" << isTeach;
-        if (agp != nullptr) {
-            // 设置AGP默认参数
-            agp->Control(FUNC::RESET);
-            agp->Control(FUNC::ENABLE);
-            agp->SetMode(MODE::PosMode);
-            agp->SetPos(pos * 100);
-            agp->SetForce(200);
-            agp->SetTouchForce(0);
-            agp->SetRampTime(0);
-            if (!IsAGPEnabled()) {
-                agp->Control(FUNC::ENABLE);
+    dVelocity = craft.moveSpeed;
+    isCaptureContact = true;
+    dAcc = 100;
+    if (isSphereSpiral) {
+        // 螺旋线：每转一圈 θ 减小一个行距，按采样间距连续下发
+        double totalPhi = 2 * M_PI * count;
+        double phi = 0;
+        isCaptureStreamed = true;
+        while (phi < totalPhi) {
+            double ringRadius =
+                radius * qSin(maxTheta - thetaStep * phi / (2 * M_PI));
+            double dPhi = M_PI / 18;
+            if (ringRadius > sphereStep) {
+                dPhi = qMin(dPhi, sphereStep / ringRadius);
             }
+            phi = qMin(totalPhi, phi + dPhi);
+            pos = spherePose(maxTheta - thetaStep * phi / (2 * M_PI), phi);
+            MoveL(pos, dVelocity, dAcc, dRadius);
         }
-        if (!IsRobotEnabled()) {
-            // 机器人使能
-            qDebug() << "robot not enable1";
-            ducoCobot->enable(true);
-            // QThread::msleep(1500);
-            if (!IsRobotEnabled()) {
-                qDebug() << "robot not enable2";
-                return isTeach;
+        isCaptureStreamed = false;
+    } else {
+        // 纬线圈：每圈四段90°圆弧（避免180°姿态插补方向不定），圈间沿经线移动
+        for (int i = 0; i <= count; ++i) {
+            double theta = maxTheta - thetaStep * i;
+            if (i != 0) {
+                pos = spherePose(theta, 0);
+                MoveL(pos, dVelocity, dAcc, dRadius);
+            }
+            for (int j = 0; j < 4; ++j) {
+                Point posAux = spherePose(theta, M_PI / 2 * j + M_PI / 4);
+                pos = spherePose(theta, M_PI / 2 * (j + 1));
+                MoveC(posAux, pos, dVelocity, dAcc, dRadius);
             }
         }
-        qDebug() << "open driver";
-        // 启用自由拖拽
-        int nRet = ducoCobot->teach_mode(false);
-        qDebug() << "open teach: " << nRet;
-        // if (nRet == 0) {
-        isTeach = true;
-        // }
-    } else {
-        qDebug() << "else:" << isTeach;
-        // 关闭自由拖拽
-        int nRet = ducoCobot->end_teach_mode(true);
-        qDebug() << "close teach: " << nRet;
-        // if (nRet == 0) {
-        isTeach = false;
-        // }
-    }
-    qDebug() << "end" << isTeach;
-    return isTeach;
-}
-
-bool DucoRobot::GetTcpPoint(Point &point) {
-    // 获取位姿信息
-    std::vector<double> data(6);
-    ducoCobot->get_tcp_pose(data);
-    point.pos.setX(data.at(0));
-    point.pos.setY(data.at(1));
-    point.pos.setZ(data.at(2));
-    point.rot.setX(data.at(3));
-    point.rot.setY(data.at(4));
-    point.rot.setZ(data.at(5));
-    qDebug() << data;
-    return true;
+    }
+
+    return pos;
 }
 
-void DucoRobot::MoveBefore(DucoRPC::DucoCobot *robot, const Craft &craft,
-                           bool isAGPRun) {
-    vector<double> p(6);
-    double v = defaultVelocity * 0.001;
-    double a = 2;
-    double rad = 0.001;
-    vector<double> q_near(6);
-    string tool = "TCP_AGP";
-    string wobj = "default";
-    bool block = true;
-    // DucoRPC::OP op;
-    // bool def_acc = true;
-    // 偏移
-    OffsetDirection direction = craft.offsetDirection;
-    double offset = craft.offsetDistance;
+Point Robot::MoveCloud(const Craft &craft) {
+    // 打磨片半径
+    double discRadius = craft.discRadius;
 
-    // 移到安全点
-    Point point = pointSet.safePoint;
-    robot->get_tcp_pose(p);
-    qDebug() << " now:" << p;
-    if (std::fabs(p[0] - point.pos.x()) > precision ||
-        std::fabs(p[1] - point.pos.y()) > precision ||
-        std::fabs(p[2] - point.pos.z()) > precision ||
-        std::fabs(p[3] - point.rot.x()) > precision ||
-        std::fabs(p[4] - point.rot.y()) > precision ||
-        std::fabs(p[5] - point.rot.z()) > precision) {
-        p[0] = point.pos.x();
-        p[1] = point.pos.y();
-        p[2] = point.pos.z();
-        p[3] = point.rot.x();
-        p[4] = point.rot.y();
-        p[5] = point.rot.z();
-        qDebug() << "move:" << p;
-        status = robot->movel(p, v, a, rad, q_near, tool, wobj, block);
-        qDebug() << "result:" << status;
-        if (status != DucoRPC::TaskState::ST_Interrupt) {
-            return;
+    Point pos;
+    pos.pos = pointSet.endPoint.pos + translation;
+    pos.rot = newRot;
+    if (cloud.IsEmpty()) {
+        return pos;
+    }
+    // 四个示教点围成的区域：行沿起始点->结束点，行间沿起始点->起始偏移点
+    QVector3D A = pointSet.beginPoint.pos;
+    QVector3D B = pointSet.endPoint.pos;
+    QVector3D C = pointSet.endOffsetPoint.pos;
+    QVector3D D = pointSet.beginOffsetPoint.pos;
+    // 投影方向取区域平面法向，与示教姿态工具Z轴同向（指向工件）
+    QMatrix3x3 R = Point::toRotationMatrix(pointSet.beginPoint.rot);
+    QVector3D toolZ(R(0, 2), R(1, 2), R(2, 2));
+    QVector3D direction = QVector3D::crossProduct(B - A, D - A).normalized();
+    if (direction.isNull()) {
+        direction = toolZ;
+    } else if (QVector3D::dotProduct(direction, toolZ) < 0) {
+        direction = -direction;
+    }
+    // 行距 = 打磨片直径 × (1 - 重叠率)
+    double overlap = qBound(0, craft.overlapRatio, 90) / 100.0;
+    double rowStep = qMax(1.0, 2 * discRadius * (1 - overlap));
+    int rowCount = qMax(
+        1, qCeil(qMax(A.distanceToPoint(D), B.distanceToPoint(C)) / rowStep));
+
+    // 逐行采样投影到点云曲面，无扫描数据处断开
+    QVector<PolishRun> runs;
+    bool isRowLinked = false; // 上一行完整到达行尾
+    for (int i = 0; i <= rowCount; ++i) {
+        double t = (double)i / rowCount;
+        QVector3D rowBegin = A + (D - A) * t;
+        QVector3D rowEnd = B + (C - B) * t;
+        // 往复路径奇数行反向
+        if (!isCloudRaster && i % 2 == 1) {
+            qSwap(rowBegin, rowEnd);
+        }
+        QVector3D rowDirection = (rowEnd - rowBegin).normalized();
+        int count =
+            qMax(1, qCeil(rowBegin.distanceToPoint(rowEnd) / cloudStep));
+        // 往复路径相邻两行完整时贴着工件换行
+        PolishRun run{QVector<Point>(), !isCloudRaster && isRowLinked};
+        isRowLinked = false;
+        for (int j = 0; j <= count; ++j) {
+            QVector3D origin = rowBegin + (rowEnd - rowBegin) * j / count;
+            QVector3D surface, normal;
+            if (!cloud.Project(origin, direction, cloudNeighbors, cloudGap,
+                               surface, normal)) {
+                if (!run.points.isEmpty()) {
+                    runs.append(run);
+                }
+                run = PolishRun{QVector<Point>(), false};
+                continue;
+            }
+            run.points.append(
+                SurfacePose(craft, surface, normal, rowDirection));
+        }
+        if (!run.points.isEmpty()) {
+            isRowLinked = true;
+            runs.append(run);
         }
     }
-    // AGP运行
-    AGPRun(craft, isAGPRun);
-    // 移到起始辅助点
-    point = pointSet.auxBeginPoint.PosRelByTool(direction, offset);
-    p[0] = point.pos.x();
-    p[1] = point.pos.y();
-    p[2] = point.pos.z();
-    p[3] = point.rot.x();
-    p[4] = point.rot.y();
-    p[5] = point.rot.z();
-    qDebug() << "move:" << p;
-    status = robot->movel(p, v, a, rad, q_near, tool, wobj, block);
-    qDebug() << "result:" << status;
-    if (status != DucoRPC::TaskState::ST_Interrupt) {
-        return;
-    }
-    // 移到起始点
-    point = pointSet.beginPoint.PosRelByTool(direction, offset);
-    v = craft.cutinSpeed * 0.001;
-    p[0] = point.pos.x();
-    p[1] = point.pos.y();
-    p[2] = point.pos.z();
-    p[3] = point.rot.x();
-    p[4] = point.rot.y();
-    p[5] = point.rot.z();
-    qDebug() << "move:" << p;
-    status = robot->movel(p, v, a, rad, q_near, tool, wobj, block);
-    qDebug() << "result:" << status;
-    if (status != DucoRPC::TaskState::ST_Interrupt) {
-        return;
-    }
+    return runs.isEmpty() ? pos : MoveRuns(craft, runs);
 }
 
-void DucoRobot::MoveAfter(DucoRPC::DucoCobot *robot, const Craft &craft,
-                          Point point) {
-    vector<double> p(6);
-    double v = craft.cutinSpeed * 0.001;
-    double a = 2;
-    double rad = 0.001;
-    vector<double> q_near(6);
-    string tool = "TCP_AGP";
-    string wobj = "default";
-    bool block = true;
-    // DucoRPC::OP op;
-    // bool def_acc = true;
+Point Robot::MoveMesh(const Craft &craft) {
+    // 打磨片半径
+    double discRadius = craft.discRadius;
 
-    // 移到结束辅助点
-    p[0] = point.pos.x();
-    p[1] = point.pos.y();
-    p[2] = point.pos.z();
-    p[3] = point.rot.x();
-    p[4] = point.rot.y();
-    p[5] = point.rot.z();
-    qDebug() << "move:" << p;
-    status = robot->movel(p, v, a, rad, q_near, tool, wobj, block);
-    qDebug() << "result:" << status;
-    if (status != DucoRPC::TaskState::ST_Interrupt) {
-        return;
-    }
-    // 移到安全点
-    point = pointSet.safePoint;
-    // 定义运动速度
-    v = defaultVelocity * 0.001;
-    p[0] = point.pos.x();
-    p[1] = point.pos.y();
-    p[2] = point.pos.z();
-    p[3] = point.rot.x();
-    p[4] = point.rot.y();
-    p[5] = point.rot.z();
-    qDebug() << "move:" << p;
-    status = robot->movel(p, v, a, rad, q_near, tool, wobj, block);
-    qDebug() << "result:" << status;
-    if (status != DucoRPC::TaskState::ST_Interrupt) {
-        return;
+    Point pos;
+    pos.pos = pointSet.endPoint.pos + translation;
+    pos.rot = newRot;
+    if (mesh.IsEmpty()) {
+        return pos;
+    }
+    // 四个示教点围成的区域：行沿起始点->结束点，行间沿起始点->起始偏移点
+    QVector3D A = pointSet.beginPoint.pos;
+    QVector3D B = pointSet.endPoint.pos;
+    QVector3D C = pointSet.endOffsetPoint.pos;
+    QVector3D D = pointSet.beginOffsetPoint.pos;
+    // 切片平面包含行方向和示教姿态工具Z轴，沿起始偏移点方向排列
+    QMatrix3x3 R = Point::toRotationMatrix(pointSet.beginPoint.rot);
+    QVector3D toolZ(R(0, 2), R(1, 2), R(2, 2));
+    QVector3D rowDirection = (B - A).normalized();
+    QVector3D planeNormal =
+        QVector3D::crossProduct(rowDirection, toolZ).normalized();
+    if (planeNormal.isNull()) {
+        return pos;
+    }
+    if (QVector3D::dotProduct(planeNormal, D - A) < 0) {
+        planeNormal = -planeNormal;
+    }
+    // 行距 = 打磨片直径 × (1 - 重叠率)
+    double overlap = qBound(0, craft.overlapRatio, 90) / 100.0;
+    double rowStep = qMax(1.0, 2 * discRadius * (1 - overlap));
+    double firstOffset = QVector3D::dotProduct(planeNormal, A);
+    double lastOffset = QVector3D::dotProduct(planeNormal, D);
+    int rowCount = qMax(1, qCeil((lastOffset - firstOffset) / rowStep));
+    QVector<double> offsets;
+    for (int i = 0; i <= rowCount; ++i) {
+        offsets.append(firstOffset + (lastOffset - firstOffset) * i / rowCount);
+    }
+    // 各切片平面并行求交
+    QVector<QVector<MeshPolyline>> slices = mesh.Slice(planeNormal, offsets);
+
+    QVector<PolishRun> runs;
+    QVector3D lastSurface; // 上一段终点（曲面上）
+    for (int i = 0; i < slices.size(); ++i) {
+        double t = (double)i / rowCount;
+        // 本行沿行方向的范围
+        double low = QVector3D::dotProduct(rowDirection, A + (D - A) * t);
+        double high = QVector3D::dotProduct(rowDirection, B + (C - B) * t);
+        if (low > high) {
+            qSwap(low, high);
+        }
+        // 往复路径奇数行反向
+        double sign = !isMeshRaster && i % 2 == 1 ? -1 : 1;
+        // 交线上在范围内且朝向工具（外法向与工具Z轴相对）的连续部分
+        QVector<QVector<int>> pieces;
+        QVector<const MeshPolyline *> owners;
+        for (const MeshPolyline &line : slices.at(i)) {
+            int size = line.points.size();
+            auto isKept = [&](int k) {
+                double s = QVector3D::dotProduct(rowDirection, line.points.at(k));
+                return s >= low && s <= high &&
+                       QVector3D::dotProduct(line.normals.at(k), toolZ) < -0.1;
+            };
+            // 闭合交线从一个舍弃点开始，避免在起点处断开
+            int start = 0;
+            if (line.isClosed) {
+                while (start < size && isKept(start)) {
+                    ++start;
+                }
+                if (start == size) {
+                    QVector<int> piece;
+                    for (int k = 0; k <= size; ++k) {
+                        piece.append(k % size);
+                    }
+                    pieces.append(piece);
+                    owners.append(&line);
+                    continue;
+                }
+            }
+            int span = line.isClosed ? size : size - start;
+            QVector<int> piece;
+            for (int n = 0; n < span; ++n) {
+                int k = (start + n) % size;
+                if (isKept(k)) {
+                    piece.append(k);
+                } else if (!piece.isEmpty()) {
+                    pieces.append(piece);
+                    owners.append(&line);
+                    piece.clear();
+                }
+            }
+            if (!piece.isEmpty()) {
+                pieces.append(piece);
+                owners.append(&line);
+            }
+        }
+        // 每段按行方向定向，再按起点在行方向上的位置排序
+        QVector<int> order;
+        for (int p = 0; p < pieces.size(); ++p) {
+            const MeshPolyline &line = *owners.at(p);
+            QVector<int> &piece = pieces[p];
+            double s0 = QVector3D::dotProduct(rowDirection,
+                                              line.points.at(piece.first()));
+            double s1 = QVector3D::dotProduct(rowDirection,
+                                              line.points.at(piece.last()));
+            if ((s1 - s0) * sign < 0) {
+                std::reverse(piece.begin(), piece.end());
+            }
+            order.append(p);
+        }
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return sign * QVector3D::dotProduct(
+                              rowDirection,
+                              owners.at(a)->points.at(pieces.at(a).first())) <
+                   sign * QVector3D::dotProduct(
+                              rowDirection,
+                              owners.at(b)->points.at(pieces.at(b).first()));
+        });
+        for (int p : order) {
+            const MeshPolyline &line = *owners.at(p);
+            const QVector<int> &piece = pieces.at(p);
+            // 按最小间距抽稀（保留末点），工具Z轴取外法向反向
+            QVector<int> kept{piece.first()};
+            for (int n = 1; n < piece.size(); ++n) {
+                if (n == piece.size() - 1 ||
+                    line.points.at(piece.at(n))
+                            .distanceToPoint(line.points.at(kept.last())) >=
+                        meshStep) {
+                    kept.append(piece.at(n));
+                }
+            }
+            if (kept.size() < 2) {
+                continue;
+            }
+            const QVector3D &first = line.points.at(kept.first());
+            // 往复路径相邻行首尾接近时贴着工件换行
+            PolishRun run{QVector<Point>(),
+                          !isMeshRaster && !runs.isEmpty() &&
+                              first.distanceToPoint(lastSurface) <=
+                                  2 * rowStep};
+            for (int n = 0; n < kept.size(); ++n) {
+                QVector3D moveDirection =
+                    line.points.at(kept.at(qMin(n + 1, kept.size() - 1))) -
+                    line.points.at(kept.at(qMax(n - 1, 0)));
+                run.points.append(SurfacePose(craft, line.points.at(kept.at(n)),
+                                              -line.normals.at(kept.at(n)),
+                                              moveDirection));
+            }
+            lastSurface = line.points.at(kept.last());
+            runs.append(run);
+        }
     }
+    return runs.isEmpty() ? pos : MoveRuns(craft, runs);
 }
 
-void DucoRobot::MoveLine(DucoRPC::DucoCobot *robot, const Craft &craft) {
-    vector<double> p(6);
-    double v = craft.moveSpeed * 0.001;
-    double a = 2;
-    double rad = 0.001;
-    vector<double> q_near(6);
-    string tool = "TCP_AGP";
-    string wobj = "default";
-    bool block = true;
-    // DucoRPC::OP op;
-    // bool def_acc = true;
-    // 偏移
-    OffsetDirection direction = craft.offsetDirection;
-    double offset = craft.offsetDistance;
-
+Point Robot::SurfacePose(const Craft &craft, const QVector3D &surface,
+                         const QVector3D &normal,
+                         const QVector3D &direction) {
+    // 工具Z轴沿法向（指向工件），行进方向取 direction 在切平面上的投影
+    QVector3D moveDirection =
+        direction - normal * QVector3D::dotProduct(direction, normal);
+    QVector3D rotation = Point::getNormalRotation(normal, moveDirection);
+    // 获取新的姿态
+    newRot = Point::getNewRotation(rotation, moveDirection, craft.grindAngle);
+    // 获取新姿态需要的平移量
+    translation = Point::getTranslation(rotation, moveDirection,
+                                        craft.discRadius, craft.grindAngle);
     Point point;
-    for (int i = 0; i < pointSet.midPoints.size(); ++i) {
-        // 定义空间目标位置
-        point = pointSet.midPoints[i].PosRelByTool(direction, offset);
-        // 执行路点运动
-        p[0] = point.pos.x();
-        p[1] = point.pos.y();
-        p[2] = point.pos.z();
-        p[3] = point.rot.x();
-        p[4] = point.rot.y();
-        p[5] = point.rot.z();
-        qDebug() << "move:" << p;
-        status = robot->movel(p, v, a, rad, q_near, tool, wobj, block);
-        qDebug() << "result:" << status;
-        if (status != DucoRPC::TaskState::ST_Interrupt) {
-            return;
-        }
-    }
-    // 移到结束点
-    point = pointSet.endPoint.PosRelByTool(direction, offset);
-    p[0] = point.pos.x();
-    p[1] = point.pos.y();
-    p[2] = point.pos.z();
-    p[3] = point.rot.x();
-    p[4] = point.rot.y();
-    p[5] = point.rot.z();
-    qDebug() << "move:" << p;
-    status = robot->movel(p, v, a, rad, q_near, tool, wobj, block);
-    qDebug() << "result:" << status;
-    if (status != DucoRPC::TaskState::ST_Interrupt) {
-        return;
-    }
+    point.pos = surface + translation;
+    point.rot = newRot;
+    return point;
 }
 
-void DucoRobot::MoveArc(DucoRPC::DucoCobot *robot, const Craft &craft) {
-    vector<double> p1(6);
-    vector<double> p2(6);
-    double v = craft.moveSpeed * 0.001;
-    double a = 2;
-    double r = 0.001;
-    int mode = 1;
-    vector<double> q_near(6);
-    string tool = "TCP_AGP";
-    string wobj = "default";
-    bool block = true;
-    // DucoRPC::OP op;
-    // bool def_acc = true;
-    // 偏移
-    OffsetDirection direction = craft.offsetDirection;
-    double offset = craft.offsetDistance;
-
-    // 定义空间目标位置
-    Point posMidRel = pointSet.auxPoint.PosRelByTool(direction, offset);
-    p1[0] = posMidRel.pos.x();
-    p1[1] = posMidRel.pos.y();
-    p1[2] = posMidRel.pos.z();
-    p1[3] = posMidRel.rot.x();
-    p1[4] = posMidRel.rot.y();
-    p1[5] = posMidRel.rot.z();
-    Point posEndRel = pointSet.endPoint.PosRelByTool(direction, offset);
-    p2[0] = posEndRel.pos.x();
-    p2[1] = posEndRel.pos.y();
-    p2[2] = posEndRel.pos.z();
-    p2[3] = posEndRel.rot.x();
-    p2[4] = posEndRel.rot.y();
-    p2[5] = posEndRel.rot.z();
-    // 执行路点运动
-    status = robot->movec(p1, p2, v, a, r, mode, q_near, tool, wobj, block);
-    qDebug() << "result:" << status;
-    if (status != DucoRPC::TaskState::ST_Interrupt) {
-        return;
+Point Robot::MoveRuns(const Craft &craft, const QVector<PolishRun> &runs) {
+    // 定义过渡半径
+    double dRadius = craft.transitionRadius;
+    Point pos;
+    for (int i = 0; i < runs.size(); ++i) {
+        const PolishRun &run = runs.at(i);
+        // 贴着工件过渡，否则抬起后重新切入
+        if (run.isLinked && i > 0) {
+            isCaptureContact = true;
+            MoveL(run.points.first(), craft.moveSpeed, 100, dRadius);
+        } else {
+            isCaptureContact = false;
+            if (i > 0) {
+                MoveL(pos.PosRelByTool(defaultDirection, defaultOffset),
+                      craft.cutinSpeed, 2000, dRadius);
+            }
+            MoveL(run.points.first().PosRelByTool(defaultDirection,
+                                                  defaultOffset),
+                  defaultVelocity, 2000, dRadius);
+            MoveL(run.points.first(), craft.cutinSpeed, 2000, dRadius);
+        }
+        isCaptureContact = true;
+        isCaptureStreamed = true;
+        for (int j = 1; j < run.points.size(); ++j) {
+            MoveL(run.points.at(j), craft.moveSpeed, 100, dRadius);
+        }
+        isCaptureStreamed = false;
+        pos = run.points.last();
     }
-}
 
-Point DucoRobot::MoveRegionArc1(const Craft &craft) { return Point(); }
-Point DucoRobot::MoveRegionArc2(const Craft &craft) { return Point(); }
-void DucoRobot::MoveZLine(const Craft &craft) {}
-void DucoRobot::MoveSpiralLine(const Craft &craft) {}
-
-bool DucoRobot::IsRobotEnabled() {
-    // 定义需要读取的机器人状态变量
-    vector<int8_t> data;
-    // 读取状态
-    ducoCobot->get_robot_state(data);
-    qDebug() << data;
-    return data[0] == DucoRPC::StateRobot::SR_Enable ? true : false;
+    return pos;
 }
 
-bool DucoRobot::IsRobotMoved() { return ducoCobot->robotmoving(); }
-
-bool DucoRobot::CloseFreeDriver() {
-    // 关闭自由拖拽
-    int nRet = ducoCobot->end_teach_mode(true);
-    qDebug() << "close teach: " << nRet;
-    // if (nRet == 0) {
-    isTeach = false;
-    return true;
+QVector<PathSegment> Robot::GeneratePath(const Craft &craft,
+                                         double speedScale) {
+    TraceScope trace("GeneratePath", "generate");
+    double radius = craft.discRadius;
+    double angle = craft.grindAngle;
+    QVector3D rotation = pointSet.beginPoint.rot;
+    QVector3D moveDirection = pointSet.endPoint.pos - pointSet.beginPoint.pos;
+    // if (craft.way == PolishWay::RegionArcWay_Vertical_Repeat) {
+    //     moveDirection = pointSet.beginOffsetPoint.pos -
+    //     pointSet.beginPoint.pos;
     // }
-    // return false;
-}
-
-void DucoRobot::Run(const Craft &craft, bool isAGPRun) {
-    DucoRPC::DucoCobot *robot = new DucoRPC::DucoCobot(robotIPAddr, 7003);
-    robot->open();
-    MoveBefore(robot, craft, isAGPRun);
-    if (status != DucoRPC::TaskState::ST_Interrupt) {
-        robot->close();
-        delete robot;
-        return;
-    }
-    // 偏移
-    OffsetDirection direction = craft.offsetDirection;
-    double offset = craft.offsetDistance;
-    Point point = pointSet.auxEndPoint.PosRelByTool(direction, offset);
+    // 获取新的姿态
+    newRot = Point::getNewRotation(rotation, moveDirection, angle);
+    // qDebug() << rotation;
+    // qDebug() << newRot;
+    // 获取新姿态需要的平移量
+    translation = Point::getTranslation(rotation, moveDirection, radius, angle);
+    // qDebug() << moveDirection;
+    // qDebug() << translation;
+    // 获取反向姿态和平移量
+    rotation = pointSet.endPoint.rot;
+    moveDirection = pointSet.beginPoint.pos - pointSet.endPoint.pos;
+    newRotInv = Point::getNewRotation(rotation, moveDirection, angle);
+    translationInv =
+        Point::getTranslation(rotation, moveDirection, radius, angle);
+    // 打磨段按 speedScale 放大移动速度
+    Craft polishCraft = craft;
+    if (speedScale != 1) {
+        polishCraft.moveSpeed = qRound(craft.moveSpeed * speedScale);
+    }
+    // MoveL/MoveC 只记录路径段
+    QVector<PathSegment> path;
+    capturePath = &path;
+    capturePhase = PathPhase::ApproachPhase;
+    isCaptureContact = false;
+    {
+        TraceScope trace("MoveBefore", "generate");
+        MoveBefore(craft);
+    }
+    capturePhase = PathPhase::PolishPhase;
+    Trace::Clock::time_point generatorBegin = Trace::Clock::now();
+    // Point point = pointSet.auxEndPoint;
+    Point point;
+    point.pos = pointSet.endPoint.pos + translation;
+    point.rot = newRot;
     // 选择打磨方式
     switch (craft.way) {
     case PolishWay::ArcWay:
-        MoveArc(robot, craft);
+        MoveArc(polishCraft);
         break;
     case PolishWay::LineWay:
-        MoveLine(robot, craft);
+        MoveLine(polishCraft);
         break;
     case PolishWay::RegionArcWay1:
-        point = MoveRegionArc1(craft);
-        point = point.PosRelByTool(defaultDirection, defaultOffset);
+        point = MoveRegionArc1(polishCraft);
         break;
     case PolishWay::RegionArcWay2:
-        point = MoveRegionArc2(craft);
-        point = point.PosRelByTool(defaultDirection, defaultOffset);
+        point = MoveRegionArc2(polishCraft);
+        break;
+    case PolishWay::RegionArcWay_Horizontal:
+        point = MoveRegionArcHorizontal(polishCraft);
+        break;
+    case PolishWay::RegionArcWay_Vertical:
+        point = MoveRegionArcVertical(polishCraft);
+        break;
+    case PolishWay::RegionArcWay_Vertical_Repeat:
+        point = MoveRegionArcVerticalRepeat(polishCraft);
+        break;
+    case PolishWay::CylinderWay_Horizontal_Convex:
+        point = MoveCylinderHorizontal(polishCraft, true);
+        break;
+    case PolishWay::CylinderWay_Vertical_Convex:
+        point = MoveCylinderVertical(polishCraft, true);
+        break;
+    case PolishWay::CylinderWay_Horizontal_Concave:
+        point = MoveCylinderHorizontal(polishCraft, false);
+        break;
+    case PolishWay::CylinderWay_Vertical_Concave:
+        point = MoveCylinderVertical(polishCraft, false);
         break;
     case PolishWay::ZLineWay:
-        MoveZLine(craft);
+        MoveZLine(polishCraft);
         break;
     case PolishWay::SpiralLineWay:
-        MoveSpiralLine(craft);
+        MoveSpiralLine(polishCraft);
+        break;
+    case PolishWay::SplineWay:
+        MoveSpline(polishCraft);
+        break;
+    case PolishWay::SphereWay:
+        point = MoveSphere(polishCraft);
+        break;
+    case PolishWay::CloudWay:
+        point = MoveCloud(polishCraft);
+        break;
+    case PolishWay::MeshWay:
+        point = MoveMesh(polishCraft);
         break;
     default:
         break;
     }
-    if (status != DucoRPC::TaskState::ST_Interrupt) {
-        robot->close();
-        delete robot;
-        return;
-    }
-    MoveAfter(robot, craft, point);
-    if (status != DucoRPC::TaskState::ST_Interrupt) {
-        robot->close();
-        delete robot;
-        return;
+    if (Trace::IsEnabled()) {
+        Trace::Complete("Generator", "generate", generatorBegin,
+                        Trace::Clock::now(), craft.way);
     }
-    while (true) {
-        if (!IsRobotMoved()) {
-            break;
-        }
+    capturePhase = PathPhase::RetractPhase;
+    isCaptureContact = false;
+    point = point.PosRelByTool(defaultDirection, defaultOffset);
+    {
+        TraceScope trace("MoveAfter", "generate");
+        MoveAfter(craft, point);
     }
-    robot->close();
-    delete robot;
+    capturePath = nullptr;
+    return path;
 }
 
-bool DucoRobot::Stop() {
-    qDebug() << "stop begin";
-    // 机器人停止
-    ducoCobot->stop(true);
-    // AGP停止
-    if (agp != nullptr) {
-        agp->SetSpeed(0);
-    }
-    qDebug() << "stop end";
-    // 机器人复位
-    ducoCobot->disable(true);
-    // AGP复位
-    if (agp != nullptr) {
-        agp->Control(FUNC::RESET);
+bool Robot::RegionCorners(QVector<QVector3D> &corners) const {
+    if (!pointSet.isBeginPointRecorded || !pointSet.isEndPointRecorded ||
+        !pointSet.isBeginOffsetPointRecorded) {
+        return false;
     }
-    // 自由拖拽复位
-    isTeach = false;
-    qDebug() << "reset end";
-
+    // 区域四角，未记录结束偏移点时按平行四边形补齐
+    corners.clear();
+    corners.append(pointSet.beginPoint.pos);
+    corners.append(pointSet.endPoint.pos);
+    corners.append(pointSet.isEndOffsetPointRecorded
+                       ? pointSet.endOffsetPoint.pos
+                       : pointSet.endPoint.pos + pointSet.beginOffsetPoint.pos -
+                             pointSet.beginPoint.pos);
+    corners.append(pointSet.beginOffsetPoint.pos);
     return true;
 }
 
-void DucoRobot::OpenWeb(QString ip) {
-    QDesktopServices::openUrl(QUrl("http://" + ip + ":7000"));
-}
-
-*/
-
-JakaRobot::JakaRobot() {}
-
-JakaRobot::~JakaRobot() {
-    jakaRobot.drag_mode_enable(FALSE);
-    // jakaRobot.disable_robot();
-    // jakaRobot.login_out();
+bool Robot::AnalyzeCoverage(const Craft &craft, CoverageMap &map) {
+    QVector<QVector3D> corners;
+    if (!RegionCorners(corners)) {
+        return false;
+    }
+    return CoverageAnalyzer::Analyze(GeneratePath(craft), corners,
+                                     craft.discRadius, coverageParams, map);
 }
 
-bool JakaRobot::RobotConnect(QString robotIP) {
-    // std::string ip = robotIP.toStdString();
-    // std::string ip = "192.168.1.20";
-    std::string ip = "10.5.5.100";
-    const char *hostname = ip.c_str();
-    // 连接机器人
-    errno_t ret = jakaRobot.login_in(hostname);
-    if (ret != ERR_SUCC) {
+bool Robot::SimulateRemoval(const Craft &craft, RemovalMap &map) {
+    QVector<QVector3D> corners;
+    if (!RegionCorners(corners)) {
         return false;
     }
-    // 机器人上电
-    // jakaRobot.power_on();
-    // 机器人使能
-    // jakaRobot.enable_robot();
-    // 设置速度比
-    // jakaRobot.set_rapidrate(1.0);
-    return true;
+    // 按实际下发的速度（含进给规划）计算停留时间
+    QVector<PathSegment> path = GeneratePath(craft);
+    PlanPath(path, craft.moveSpeed, 1.0);
+    return RemovalSimulator::Simulate(path, corners, craft.discRadius,
+                                      craft.settingForce, craft.rotateSpeed,
+                                      coverageParams, removalParams, map);
 }
 
-bool JakaRobot::GetTcpPoint(Point &point) {
-    CartesianPose tcp_pos;
-    errno_t ret = jakaRobot.get_tcp_position(&tcp_pos);
-    if (ret != ERR_SUCC) {
+double Robot::RemovalTarget() const { return removalParams.target; }
+
+// 是否为按偏移次数分行的打磨方式
+static bool IsOffsetWay(PolishWay way) {
+    switch (way) {
+    case PolishWay::RegionArcWay1:
+    case PolishWay::RegionArcWay2:
+    case PolishWay::RegionArcWay_Horizontal:
+    case PolishWay::RegionArcWay_Vertical:
+    case PolishWay::RegionArcWay_Vertical_Repeat:
+    case PolishWay::CylinderWay_Horizontal_Convex:
+    case PolishWay::CylinderWay_Vertical_Convex:
+    case PolishWay::CylinderWay_Horizontal_Concave:
+    case PolishWay::CylinderWay_Vertical_Concave:
+        return true;
+    default:
         return false;
     }
-    point.pos.setX(tcp_pos.tran.x);
-    point.pos.setY(tcp_pos.tran.y);
-    point.pos.setZ(tcp_pos.tran.z);
-    point.rot.setX(qRound(qRadiansToDegrees(tcp_pos.rpy.rx) * 1000.0) / 1000.0);
-    point.rot.setY(qRound(qRadiansToDegrees(tcp_pos.rpy.ry) * 1000.0) / 1000.0);
-    point.rot.setZ(qRound(qRadiansToDegrees(tcp_pos.rpy.rz) * 1000.0) / 1000.0);
-    return true;
 }
 
-bool JakaRobot::RobotTeach(int pos) {
-    if (!isTeach) {
-        if (agp != nullptr) {
-            // 设置AGP默认参数
-            agp->Control(FUNC::RESET);
-            agp->Control(FUNC::ENABLE);
-            agp->SetMode(MODE::PosMode);
-            agp->SetPos(pos * 100);
-            agp->SetForce(200);
-            agp->SetTouchForce(0);
-            agp->SetRampTime(0);
-            if (!IsAGPEnabled()) {
-                agp->Control(FUNC::ENABLE);
-            }
-        }
-        // if (!IsRobotElectrified()) {
-        //     // 机器人上电
-        //     jakaRobot.power_on();
-        //     if (!IsRobotElectrified()) {
-        //         return isTeach;
-        //     }
-        // }
-        if (!IsRobotEnabled()) {
-            // 机器人使能
-            jakaRobot.enable_robot();
-            // QThread::msleep(1500);
-            if (!IsRobotEnabled()) {
-                return isTeach;
-            }
-        }
-        // 启用自由拖拽
-        errno_t ret = jakaRobot.drag_mode_enable(TRUE);
-        if (ret == ERR_SUCC) {
-            isTeach = true;
+int Robot::SuggestOffsetCount(const Craft &craft) {
+    if (!IsOffsetWay(craft.way)) {
+        return -1;
+    }
+    Craft trial = craft;
+    for (int count = 1; count <= coverageParams.maxOffsetCount; ++count) {
+        trial.offsetCount = count;
+        CoverageMap map;
+        if (!AnalyzeCoverage(trial, map)) {
+            return -1;
         }
-    } else {
-        // 关闭自由拖拽
-        errno_t ret = jakaRobot.drag_mode_enable(FALSE);
-        if (ret == ERR_SUCC) {
-            isTeach = false;
+        if (map.coverage >= coverageParams.target) {
+            return count;
         }
     }
-    return isTeach;
+    return -1;
 }
 
-bool JakaRobot::CloseFreeDriver() {
-    // 关闭自由拖拽
-    errno_t ret = jakaRobot.drag_mode_enable(FALSE);
-    if (ret == ERR_SUCC) {
-        isTeach = false;
-        return true;
+bool Robot::Sweep(const Craft &craft, QVector<SweepResult> &results) {
+    results.clear();
+    QVector<QVector3D> corners;
+    if (!RegionCorners(corners)) {
+        return false;
     }
-    return false;
-}
-
-bool JakaRobot::Stop() {
-    // 机器人停止
-    jakaRobot.motion_abort();
-    // AGP停止
-    if (agp != nullptr) {
-        agp->SetSpeed(0);
+    QVector<int> offsetCounts = IsOffsetWay(craft.way)
+                                    ? sweepParams.offsetCount.Values(
+                                          craft.offsetCount)
+                                    : QVector<int>{craft.offsetCount};
+    QVector<int> grindAngles = sweepParams.grindAngle.Values(craft.grindAngle);
+    QVector<int> moveSpeeds = sweepParams.moveSpeed.Values(craft.moveSpeed);
+    QVector<int> transitionRadii =
+        sweepParams.transitionRadius.Values(craft.transitionRadius);
+    qint64 total = (qint64)offsetCounts.size() * grindAngles.size() *
+                   moveSpeeds.size() * transitionRadii.size();
+    if (total > sweepParams.maxVariants) {
+        return false;
     }
-    // 机器人复位
-    // jakaRobot.disable_robot();
-    // AGP复位
-    if (agp != nullptr) {
-        agp->Control(FUNC::RESET);
+    // 路径生成使用机器人状态，按几何串行生成并评价，速度和过渡半径再并行展开
+    QVector<SweepGeometry> geometries;
+    for (int offsetCount : offsetCounts) {
+        for (int grindAngle : grindAngles) {
+            Craft trial = craft;
+            trial.offsetCount = offsetCount;
+            trial.grindAngle = grindAngle;
+            SweepGeometry geometry;
+            geometry.offsetCount = offsetCount;
+            geometry.grindAngle = grindAngle;
+            geometry.path = GeneratePath(trial);
+            // 仿真按运行时的接触速度进行，变体再按速度比换算去除深度
+            geometry.referenceSpeed =
+                feedPlanParams.isEnabled && feedPlanParams.contactSpeed > 0
+                    ? feedPlanParams.contactSpeed
+                    : trial.moveSpeed;
+            geometry.coverage = 0;
+            if (sweepParams.isRemovalMetric) {
+                RemovalMap map;
+                QVector<PathSegment> path = geometry.path;
+                PlanPath(path, trial.moveSpeed, 1.0);
+                if (!RemovalSimulator::Simulate(
+                        path, corners, trial.discRadius, trial.settingForce,
+                        trial.rotateSpeed, coverageParams, removalParams,
+                        map)) {
+                    return false;
+                }
+                for (int c = 0; c < map.depths.size(); ++c) {
+                    if (map.grid.mask.at(c)) {
+                        geometry.depths.push_back(map.depths.at(c));
+                    }
+                }
+                std::sort(geometry.depths.begin(), geometry.depths.end());
+            } else {
+                CoverageMap map;
+                if (!CoverageAnalyzer::Analyze(geometry.path, corners,
+                                               trial.discRadius,
+                                               coverageParams, map)) {
+                    return false;
+                }
+                geometry.coverage = map.coverage;
+            }
+            geometries.append(geometry);
+        }
     }
-    // 自由拖拽复位
-    isTeach = false;
-
-    return true;
-}
-
-bool JakaRobot::IsRobotElectrified() {
-    RobotStatus robstatus;
-    jakaRobot.get_robot_status(&robstatus);
-
-    return robstatus.powered_on;
+    results = SweepEngine::Evaluate(
+        geometries, moveSpeeds, transitionRadii, sweepParams,
+        teachPos + discThickness, feedPlanParams, blendPlanParams,
+        removalParams.target);
+    SweepEngine::MarkPareto(results);
+    return !results.isEmpty();
 }
 
-bool JakaRobot::IsRobotEnabled() {
-    RobotStatus robstatus;
-    jakaRobot.get_robot_status(&robstatus);
+double Robot::SweepMinQuality() const { return sweepParams.minQuality; }
 
-    return robstatus.enabled;
+Craft Robot::SweepCraft(const Craft &craft, const SweepResult &result) {
+    Craft variant = craft;
+    variant.moveSpeed = result.moveSpeed;
+    variant.offsetCount = result.offsetCount;
+    variant.grindAngle = result.grindAngle;
+    variant.transitionRadius = result.transitionRadius;
+    variant.craftID = QString("%1-v%2-n%3-a%4-r%5")
+                          .arg(craft.craftID)
+                          .arg(result.moveSpeed)
+                          .arg(result.offsetCount)
+                          .arg(result.grindAngle)
+                          .arg(result.transitionRadius);
+    return variant;
 }
 
-bool JakaRobot::IsRobotMoved() {
-    BOOL in_pos;
-    jakaRobot.is_in_pos(&in_pos);
-
-    return !in_pos;
+void Robot::Run(const Craft &craft, bool isAGPRun) {
+    // 按 [Diagnostics] TraceDir 记录本次运行的时间线（调用方已开始记录时不重复）
+    QString traceFile;
+    QDir dir(QCoreApplication::applicationDirPath());
+    if (!traceDir.isEmpty() && !Trace::IsEnabled() && dir.mkpath(traceDir) &&
+        dir.cd(traceDir)) {
+        traceFile = dir.filePath(
+            QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") +
+            ".json");
+        Trace::Start();
+    }
+    Trace::SetThreadName("run");
+    Trace::Clock::time_point runBegin = Trace::Clock::now();
+    if (RunMetrics::IsEnabled()) {
+        RunMetrics::BeginCycle(craft.craftID);
+    }
+    // QThread::msleep(100);
+    // 力自适应进给：接触段按倍率上限下发速度，执行到接触段时由速度比调节。
+    // 无执行位置反馈时无法区分正在执行的路径段，不放大下发
+    bool isForceFeed = forceFeed.IsEnabled() && isAGPRun && agp != nullptr;
+    isForceFeedOn.store(isForceFeed);
+    feedScale = isForceFeed && isSegmentTracked ? forceFeed.SpeedScale() : 1;
+    {
+        std::lock_guard<std::mutex> lock(contactMutex);
+        contactSegments.clear();
+    }
+    if (isForceFeed) {
+        forceFeedTarget = craft.settingForce;
+        forceFeedContact = craft.contactForce;
+        isForceFeedControlling = false;
+        lastOverride = 1;
+        SetSpeedOverride(1);
+    }
+    // AGP运行
+    {
+        TraceScope trace("AGPRun", "run");
+        AGPRun(craft, isAGPRun);
+    }
+    // 生成路径，规划后统一下发
+    isStop.store(false);
+    QVector<PathSegment> path = GeneratePath(craft, feedScale);
+    PlanPath(path, craft.moveSpeed, feedScale);
+    // 开始运动
+    segmentIndex.store(0);
+    StartRecorder(craft);
+    ExecutePath(path);
+    // 等待运动完成
+    {
+        TraceScope trace("WaitMotion", "run");
+        while (true) {
+            if (!IsRobotMoved()) {
+                isStop.store(true);
+                break;
+            }
+            QThread::msleep(100);
+        }
+    }
+    StopRecorder();
+    if (isForceFeed) {
+        isForceFeedOn.store(false);
+        SetSpeedOverride(1);
+        lastOverride = 1;
+    }
+    Trace::Clock::time_point runEnd = Trace::Clock::now();
+    if (RunMetrics::IsEnabled()) {
+        RunMetrics::EndCycle(
+            std::chrono::duration<double>(runEnd - runBegin).count());
+    }
+    if (Trace::IsEnabled()) {
+        Trace::Complete("Run", "run", runBegin, runEnd);
+    }
+    if (!traceFile.isEmpty()) {
+        Trace::Stop();
+        Trace::SaveJson(traceFile);
+    }
+}
+
+void Robot::PlanPath(QVector<PathSegment> &path, double moveSpeed,
+                     double speedScale) {
+    double toolOffset = teachPos + discThickness;
+    // 路径压缩：密集点位合并为直线和圆弧，在进给、过渡规划之前完成。
+    // 连续轨迹能整体上传或伺服下发时保持原样
+    if (compressParams.isEnabled) {
+        TraceScope trace("Compress", "plan");
+        bool isStreamKept =
+            SelectExecutionMode(path) != ExecutionMode::WaypointMode;
+        PathPlanner::Compress(path, compressParams, isStreamKept);
+    }
+    // 曲率进给（力自适应进给启用时按倍率上限放大下发速度）
+    if (feedPlanParams.isEnabled) {
+        TraceScope trace("PlanFeed", "plan");
+        double contactSpeed = feedPlanParams.contactSpeed > 0
+                                  ? feedPlanParams.contactSpeed
+                                  : moveSpeed;
+        PathPlanner::PlanFeed(path, toolOffset, contactSpeed * speedScale,
+                              feedPlanParams);
+    }
+    // 过渡半径，替换工艺中统一的过渡半径
+    if (blendPlanParams.isEnabled) {
+        TraceScope trace("PlanBlend", "plan");
+        PathPlanner::PlanBlend(path, toolOffset, blendPlanParams);
+    }
+}
+
+ExecutionMode
+Robot::SelectExecutionMode(const QVector<PathSegment> &path) const {
+    bool isStreamed = std::any_of(
+        path.begin(), path.end(),
+        [](const PathSegment &segment) { return segment.isStreamed; });
+    if (!isStreamed) {
+        return ExecutionMode::WaypointMode;
+    }
+    int capabilities = Capabilities();
+    bool isPathUpload = capabilities & PathUploadCapability;
+    // 伺服下发不受控制器速度比影响，力自适应进给时不使用
+    bool isServo = (capabilities & ServoCapability) && servoPeriod > 0 &&
+                   !isForceFeedOn.load();
+    switch (executionMode) {
+    case ExecutionMode::WaypointMode:
+        return ExecutionMode::WaypointMode;
+    case ExecutionMode::PathUploadMode:
+        return isPathUpload ? ExecutionMode::PathUploadMode
+                            : ExecutionMode::WaypointMode;
+    case ExecutionMode::ServoMode:
+        return isServo ? ExecutionMode::ServoMode : ExecutionMode::WaypointMode;
+    default:
+        break;
+    }
+    // 整体上传由控制器规划，不受上位机调度抖动影响，优先使用
+    if (isPathUpload) {
+        return ExecutionMode::PathUploadMode;
+    }
+    if (isServo) {
+        return ExecutionMode::ServoMode;
+    }
+    return ExecutionMode::WaypointMode;
+}
+
+void Robot::ExecutePath(const QVector<PathSegment> &path) {
+    ExecutionMode mode = SelectExecutionMode(path);
+    TraceScope trace("ExecutePath", "run", static_cast<int>(mode));
+    for (int i = 0; i < path.size(); ++i) {
+        const PathSegment &segment = path.at(i);
+        RunMetrics::SetPendingSegments(path.size() - i);
+        // 下发前记录即将使用的路径段编号是否为接触段，供力自适应进给判断
+        MarkContactSegment(segmentIndex.load() + 1, segment.isContact);
+        // 连续轨迹段整体下发或伺服下发（含前一段终点作为起点），
+        // 失败时逐段下发
+        if (segment.isStreamed && i > 0 &&
+            mode != ExecutionMode::WaypointMode) {
+            int end = i;
+            QVector<Point> points{path.at(i - 1).endPoint};
+            double velocity = segment.velocity;
+            while (end < path.size() && path.at(end).isStreamed) {
+                points.append(path.at(end).endPoint);
+                velocity = qMin(velocity, path.at(end).velocity);
+                ++end;
+            }
+            bool isSent = mode == ExecutionMode::ServoMode
+                              ? ServoPath(points, velocity, segment.acc)
+                              : MovePath(points, velocity, segment.acc);
+            if (isSent) {
+                i = end - 1;
+                continue;
+            }
+        }
+        if (segment.isArc) {
+            MoveC(segment.auxPoint, segment.endPoint, segment.velocity,
+                  segment.acc, segment.radius);
+        } else {
+            MoveL(segment.endPoint, segment.velocity, segment.acc,
+                  segment.radius);
+        }
+    }
+    RunMetrics::SetPendingSegments(0);
 }
 
-void JakaRobot::OpenWeb(QString ip) {}
-
-void JakaRobot::MoveTcpL(const Point &point, double dVelocity, double dAcc,
-                         double dRadius) {
-    CartesianPose pos;
-    pos.tran.x = point.pos.x();
-    pos.tran.y = point.pos.y();
-    pos.tran.z = point.pos.z();
-    pos.rpy.rx = qDegreesToRadians(point.rot.x());
-    pos.rpy.ry = qDegreesToRadians(point.rot.y());
-    pos.rpy.rz = qDegreesToRadians(point.rot.z());
-
-    jakaRobot.linear_move(&pos, MoveMode::ABS, FALSE, dVelocity, dAcc, 0.1,
-                          NULL, 3.14 / 10, 12.56 / 10);
+bool Robot::MovePath(const QVector<Point> &points, double dVelocity,
+                     double dAcc) {
+    if (isStop.load()) {
+        return true;
+    }
+    QVector<Point> tcpPoints;
+    tcpPoints.reserve(points.size());
+    for (const Point &point : points) {
+        tcpPoints.append(
+            point.PosRelByTool(defaultDirection, -(teachPos + discThickness)));
+    }
+    // 整条轨迹占一个路径段编号
+    TraceScope trace("MoveTcpPath", "motion", segmentIndex.fetch_add(1) + 1);
+    if (!MoveTcpPath(tcpPoints, dVelocity, dAcc)) {
+        segmentIndex.fetch_sub(1);
+        return false;
+    }
+    return true;
 }
 
-void JakaRobot::MoveTcpC(const Point &auxPoint, const Point &endPoint,
-                         double dVelocity, double dAcc, double dRadius) {
-    CartesianPose midPos, endPos;
-    midPos.tran.x = auxPoint.pos.x();
-    midPos.tran.y = auxPoint.pos.y();
-    midPos.tran.z = auxPoint.pos.z();
-    midPos.rpy.rx = qDegreesToRadians(auxPoint.rot.x());
-    midPos.rpy.ry = qDegreesToRadians(auxPoint.rot.y());
-    midPos.rpy.rz = qDegreesToRadians(auxPoint.rot.z());
-
-    endPos.tran.x = endPoint.pos.x();
-    endPos.tran.y = endPoint.pos.y();
-    endPos.tran.z = endPoint.pos.z();
-    endPos.rpy.rx = qDegreesToRadians(endPoint.rot.x());
-    endPos.rpy.ry = qDegreesToRadians(endPoint.rot.y());
-    endPos.rpy.rz = qDegreesToRadians(endPoint.rot.z());
-
-    jakaRobot.circular_move(&endPos, &midPos, MoveMode::ABS, FALSE, dVelocity,
-                            dAcc, 0.1, NULL);
+bool Robot::ServoPath(const QVector<Point> &points, double dVelocity,
+                      double dAcc) {
+    if (isStop.load()) {
+        return true;
+    }
+    QVector<Point> tcpPoints;
+    tcpPoints.reserve(points.size());
+    for (const Point &point : points) {
+        tcpPoints.append(
+            point.PosRelByTool(defaultDirection, -(teachPos + discThickness)));
+    }
+    QVector<Point> samples =
+        PathPlanner::SampleServo(tcpPoints, dVelocity, dAcc, servoPeriod);
+    if (samples.isEmpty()) {
+        return false;
+    }
+    // 与整体下发相同，整条轨迹占一个路径段编号
+    TraceScope trace("ServoTcpPath", "motion", segmentIndex.fetch_add(1) + 1);
+    if (!ServoTcpPath(samples, servoPeriod)) {
+        segmentIndex.fetch_sub(1);
+        return false;
+    }
+    return true;
 }
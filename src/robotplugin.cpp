@@ -0,0 +1,77 @@
+﻿#include <QCoreApplication>
+#include <QDir>
+#include <QLibrary>
+#include <QRegularExpression>
+#include <QSettings>
+
+#include "robotplugin.h"
+#include "simrobot.h"
+
+typedef int (*PluginVersionFunc)();
+typedef Robot *(*CreateRobotFunc)();
+
+static const QString builtinName = "sim";
+static const QString pluginPrefix = "swr-";
+
+Robot *RobotFactory::Create(const QString &name, QString &error) {
+    if (name == builtinName) {
+        return new SimRobot();
+    }
+    // 名称只用作文件名的一部分
+    if (!QRegularExpression("^[a-z0-9_]+$").match(name).hasMatch()) {
+        error = QString("无效的机器人类型：%1").arg(name);
+        return nullptr;
+    }
+    // 插件一经加载不再卸载，创建的对象可以活到进程结束
+    QLibrary library(QDir(PluginDir()).filePath(pluginPrefix + name));
+    if (!library.load()) {
+        error = QString("无法加载机器人插件 %1：%2")
+                    .arg(name)
+                    .arg(library.errorString());
+        return nullptr;
+    }
+    PluginVersionFunc version = reinterpret_cast<PluginVersionFunc>(
+        library.resolve("SWR_RobotPluginVersion"));
+    CreateRobotFunc create =
+        reinterpret_cast<CreateRobotFunc>(library.resolve("SWR_CreateRobot"));
+    if (version == nullptr || create == nullptr) {
+        error = QString("%1 不是机器人插件").arg(library.fileName());
+        return nullptr;
+    }
+    if (version() != robotPluginVersion) {
+        error = QString("机器人插件 %1 版本不匹配（%2，需要 %3）")
+                    .arg(name)
+                    .arg(version())
+                    .arg(robotPluginVersion);
+        return nullptr;
+    }
+    Robot *robot = create();
+    if (robot == nullptr) {
+        error = QString("机器人插件 %1 创建失败").arg(name);
+    }
+    return robot;
+}
+
+QString RobotFactory::Backend(const QString &settingsFile) {
+    QSettings settings(settingsFile, QSettings::IniFormat);
+    settings.setIniCodec("UTF-8");
+    return settings.value("Robot/Backend", "hans").toString().trimmed();
+}
+
+QStringList RobotFactory::Available() {
+    QStringList names{builtinName};
+    QDir dir(PluginDir());
+    QRegularExpression pattern("^(?:lib)?" + pluginPrefix + "([a-z0-9_]+)\\.");
+    for (const QString &fileName : dir.entryList(QDir::Files, QDir::Name)) {
+        QRegularExpressionMatch match = pattern.match(fileName);
+        if (match.hasMatch() && QLibrary::isLibrary(fileName) &&
+            !names.contains(match.captured(1))) {
+            names.append(match.captured(1));
+        }
+    }
+    return names;
+}
+
+QString RobotFactory::PluginDir() {
+    return QCoreApplication::applicationDirPath() + "/robots";
+}
@@ -0,0 +1,276 @@
+﻿#include <QDateTime>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+#include "runlog.h"
+
+// 每次映射的记录数（约320KB）
+constexpr qint64 chunkRecords = 4096;
+
+RunLogWriter::RunLogWriter()
+    : chunk(nullptr), chunkOffset(0), chunkUsed(0), recordCount(0) {}
+
+RunLogWriter::~RunLogWriter() { Close(); }
+
+bool RunLogWriter::Open(const QString &fileName, const QString &craftID,
+                        float referencePos) {
+    Close();
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        return false;
+    }
+    RunLogHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, runLogMagic, sizeof(header.magic));
+    header.recordSize = sizeof(RunLogRecord);
+    header.headerSize = sizeof(RunLogHeader);
+    header.startTime = QDateTime::currentMSecsSinceEpoch();
+    header.recordCount = 0;
+    header.referencePos = referencePos;
+    QByteArray name = craftID.toUtf8().left(sizeof(header.craftID) - 1);
+    std::memcpy(header.craftID, name.constData(), name.size());
+    if (file.write((const char *)&header, sizeof(header)) != sizeof(header)) {
+        file.close();
+        return false;
+    }
+    recordCount = 0;
+    chunkOffset = sizeof(RunLogHeader);
+    chunkUsed = 0;
+    if (!MapChunk()) {
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+bool RunLogWriter::Append(const RunLogRecord &record) {
+    if (chunk == nullptr) {
+        return false;
+    }
+    if (chunkUsed == chunkRecords) {
+        // 当前块写满，映射下一块
+        chunkOffset += chunkRecords * sizeof(RunLogRecord);
+        chunkUsed = 0;
+        if (!WriteCount() || !MapChunk()) {
+            return false;
+        }
+    }
+    std::memcpy(chunk + chunkUsed * sizeof(RunLogRecord), &record,
+                sizeof(RunLogRecord));
+    ++chunkUsed;
+    ++recordCount;
+    return true;
+}
+
+void RunLogWriter::Close() {
+    if (!file.isOpen()) {
+        return;
+    }
+    if (chunk != nullptr) {
+        file.unmap(chunk);
+        chunk = nullptr;
+    }
+    // 截掉预分配的空白部分
+    file.resize(sizeof(RunLogHeader) + recordCount * sizeof(RunLogRecord));
+    WriteCount();
+    file.close();
+}
+
+bool RunLogWriter::IsOpen() const { return file.isOpen(); }
+
+qint64 RunLogWriter::Count() const { return recordCount; }
+
+bool RunLogWriter::MapChunk() {
+    if (chunk != nullptr) {
+        file.unmap(chunk);
+        chunk = nullptr;
+    }
+    qint64 size = chunkRecords * sizeof(RunLogRecord);
+    if (!file.resize(chunkOffset + size)) {
+        return false;
+    }
+    chunk = file.map(chunkOffset, size);
+    return chunk != nullptr;
+}
+
+bool RunLogWriter::WriteCount() {
+    // 换块时更新文件头中的记录数，异常退出时读取端再按有效标志补齐
+    qint64 count = recordCount;
+    return file.seek(offsetof(RunLogHeader, recordCount)) &&
+           file.write((const char *)&count, sizeof(count)) == sizeof(count);
+}
+
+RunLogReader::RunLogReader() : data(nullptr), count(0) {
+    std::memset(&header, 0, sizeof(header));
+}
+
+RunLogReader::~RunLogReader() { Close(); }
+
+bool RunLogReader::Open(const QString &fileName) {
+    Close();
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    qint64 size = file.size();
+    if (size < (qint64)sizeof(RunLogHeader) ||
+        file.read((char *)&header, sizeof(header)) != sizeof(header) ||
+        std::memcmp(header.magic, runLogMagic, sizeof(header.magic)) != 0 ||
+        header.recordSize != sizeof(RunLogRecord) ||
+        header.headerSize != sizeof(RunLogHeader)) {
+        file.close();
+        return false;
+    }
+    data = file.map(0, size);
+    if (data == nullptr) {
+        file.close();
+        return false;
+    }
+    // 文件头记录数可能落后（异常退出），按有效标志向后补齐
+    qint64 capacity = (size - header.headerSize) / header.recordSize;
+    count = qBound((qint64)0, header.recordCount, capacity);
+    while (count < capacity && (At(count).flags & RunLogFlag::RecordValid)) {
+        ++count;
+    }
+    return true;
+}
+
+void RunLogReader::Close() {
+    if (data != nullptr) {
+        file.unmap(data);
+        data = nullptr;
+    }
+    if (file.isOpen()) {
+        file.close();
+    }
+    count = 0;
+}
+
+bool RunLogReader::IsOpen() const { return data != nullptr; }
+
+const RunLogHeader &RunLogReader::Header() const { return header; }
+
+qint64 RunLogReader::Count() const { return count; }
+
+const RunLogRecord &RunLogReader::At(qint64 index) const {
+    return *(const RunLogRecord *)(data + sizeof(RunLogHeader) +
+                                   index * sizeof(RunLogRecord));
+}
+
+RunLogIndex::RunLogIndex() : duration(0), arcLength(0) {}
+
+void RunLogIndex::Build(const RunLogReader &reader, int bucketSize) {
+    Clear();
+    qint64 count = reader.Count();
+    if (count == 0) {
+        return;
+    }
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float referencePos = reader.Header().referencePos;
+    // 第0层：顺序扫描一遍映射文件
+    QVector<RunLogBucket> level;
+    level.reserve(count / bucketSize + 1);
+    double arc = 0;
+    for (qint64 first = 0; first < count; first += bucketSize) {
+        RunLogBucket bucket;
+        bucket.first = first;
+        bucket.count = qMin((qint64)bucketSize, count - first);
+        bucket.time = reader.At(first).timestamp / 1e6;
+        for (int c = 0; c < ChannelCount; ++c) {
+            bucket.min[c] = std::numeric_limits<float>::infinity();
+            bucket.max[c] = -std::numeric_limits<float>::infinity();
+        }
+        for (qint64 i = first; i < first + bucket.count; ++i) {
+            const RunLogRecord &record = reader.At(i);
+            const RunLogRecord &prev = reader.At(i > 0 ? i - 1 : 0);
+            if (i > 0) {
+                arc += Distance(record, prev);
+            }
+            if (i == first) {
+                bucket.arc = arc;
+            }
+            for (int c = 0; c < ChannelCount; ++c) {
+                float v = i > 0 ? Value(record, prev, c, referencePos) : nan;
+                if (v == v) {
+                    bucket.min[c] = qMin(bucket.min[c], v);
+                    bucket.max[c] = qMax(bucket.max[c], v);
+                }
+            }
+        }
+        level.append(bucket);
+    }
+    duration = reader.At(count - 1).timestamp / 1e6;
+    arcLength = arc;
+    levels.append(level);
+    // 逐层合并，直到只剩一个桶
+    while (levels.last().size() > 1) {
+        const QVector<RunLogBucket> &lower = levels.last();
+        QVector<RunLogBucket> upper;
+        upper.reserve(lower.size() / 2 + 1);
+        for (int i = 0; i < lower.size(); i += 2) {
+            RunLogBucket bucket = lower.at(i);
+            if (i + 1 < lower.size()) {
+                const RunLogBucket &next = lower.at(i + 1);
+                bucket.count += next.count;
+                for (int c = 0; c < ChannelCount; ++c) {
+                    bucket.min[c] = qMin(bucket.min[c], next.min[c]);
+                    bucket.max[c] = qMax(bucket.max[c], next.max[c]);
+                }
+            }
+            upper.append(bucket);
+        }
+        levels.append(upper);
+    }
+}
+
+void RunLogIndex::Clear() {
+    levels.clear();
+    duration = 0;
+    arcLength = 0;
+}
+
+int RunLogIndex::LevelCount() const { return levels.size(); }
+
+const QVector<RunLogBucket> &RunLogIndex::Level(int level) const {
+    return levels.at(level);
+}
+
+double RunLogIndex::Duration() const { return duration; }
+
+double RunLogIndex::ArcLength() const { return arcLength; }
+
+float RunLogIndex::Value(const RunLogRecord &record, const RunLogRecord &prev,
+                         int channel, float referencePos) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    bool isAGPValid = record.flags & RunLogFlag::AGPValid;
+    switch (channel) {
+    case ForceChannel:
+        return isAGPValid ? record.force : nan;
+    case SpeedChannel: {
+        double dt = (record.timestamp - prev.timestamp) / 1e6;
+        if (dt <= 0 || !(record.flags & prev.flags & RunLogFlag::TcpValid)) {
+            return nan;
+        }
+        return Distance(record, prev) / dt;
+    }
+    case SpindleChannel:
+        return isAGPValid ? record.speed : nan;
+    case DeviationChannel:
+        return isAGPValid ? record.agpPos - referencePos : nan;
+    default:
+        return nan;
+    }
+}
+
+double RunLogIndex::Distance(const RunLogRecord &record,
+                             const RunLogRecord &prev) {
+    if (!(record.flags & prev.flags & RunLogFlag::TcpValid)) {
+        return 0;
+    }
+    double dx = record.tcp[0] - prev.tcp[0];
+    double dy = record.tcp[1] - prev.tcp[1];
+    double dz = record.tcp[2] - prev.tcp[2];
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
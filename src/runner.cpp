@@ -0,0 +1,369 @@
+﻿#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <chrono>
+#include <csignal>
+#include <thread>
+
+#include "callstats.h"
+#include "craftstore.h"
+#include "metrics.h"
+#include "robot.h"
+#include "robotplugin.h"
+#include "simrobot.h"
+#include "trace.h"
+
+// 退出码
+enum ExitCode {
+    ExitSuccess = 0,      // 运行完成
+    ExitUsage = 1,        // 参数错误
+    ExitProgram = 2,      // 程序文件读取失败
+    ExitPoints = 3,       // 点位不完整
+    ExitRobotConnect = 4, // 机器人连接失败
+    ExitAGPConnect = 5,   // 打磨头连接失败
+    ExitStopped = 6,      // 运行被中断
+    ExitCoverage = 7,     // 覆盖分析失败
+    ExitRemoval = 8,      // 去除仿真失败
+    ExitSweep = 9,        // 参数扫描失败
+    ExitProbe = 10        // 探测配准失败
+};
+
+static Robot *robot = nullptr;
+static std::atomic<bool> isInterrupted(false);
+
+// 信号处理函数中只能置标志，Stop 涉及 SDK 调用和锁，并非异步信号安全
+static void OnSignal(int) { isInterrupted.store(true); }
+
+// 监视线程：轮询中断标志，在普通线程上下文中停止机器人
+class StopWatcher {
+  public:
+    StopWatcher() : isDone(false), thread([this] { Watch(); }) {}
+    ~StopWatcher() { Finish(); }
+
+    // 结束监视，须在释放机器人之前调用
+    void Finish() {
+        isDone.store(true);
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+  private:
+    void Watch() {
+        while (!isDone.load()) {
+            if (isInterrupted.load()) {
+                robot->Stop();
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+
+    std::atomic<bool> isDone;
+    std::thread thread;
+};
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("swr-run");
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("执行打磨程序文件");
+    parser.addHelpOption();
+    parser.addPositionalArgument("program", "程序文件");
+    QCommandLineOption robotOption(
+        "robot",
+        "机器人类型：sim 或插件名（duco、hans、jaka），缺省为 settings.ini [Robot] "
+        "Backend",
+        "type");
+    QCommandLineOption robotIPOption("robot-ip", "机器人IP", "ip",
+                                     "192.168.1.10");
+    QCommandLineOption agpIPOption("agp-ip", "打磨头IP", "ip",
+                                   "192.168.1.12");
+    QCommandLineOption tryRunOption("try-run", "试运行（打磨头不旋转）");
+    QCommandLineOption probeOption(
+        "probe", "运行前用打磨头触碰探测程序中的基准点，配准工件坐标系");
+    QCommandLineOption coverageOption(
+        "coverage", "只做覆盖分析，不连接设备，热力图写入 file（PNG）", "file");
+    QCommandLineOption removalOption(
+        "removal", "只做材料去除仿真，不连接设备，去除深度图写入 file（PNG）",
+        "file");
+    QCommandLineOption sweepOption(
+        "sweep", "只做工艺参数扫描，不连接设备，输出节拍-质量 Pareto 前沿");
+    QCommandLineOption sweepSaveOption(
+        "sweep-save",
+        "把扫描结果中编号为 index 的变体（fastest 为最快的可接受变体）"
+        "另存为新工艺",
+        "index");
+    QCommandLineOption craftsOption(
+        "crafts", "工艺库目录", "dir",
+        QCoreApplication::applicationDirPath() + "/crafts");
+    QCommandLineOption callStatsOption(
+        "call-stats", "统计 SDK、AGP 调用耗时，运行结束后写入 file（JSON）",
+        "file");
+    QCommandLineOption traceOption(
+        "trace",
+        "记录运行时间线，写入 file（Chrome Trace JSON，可在 Perfetto 中查看）",
+        "file");
+    QCommandLineOption metricsOption(
+        "metrics",
+        "运行期间在 127.0.0.1:port 提供 Prometheus 指标（GET /metrics）",
+        "port");
+    QCommandLineOption repeatOption(
+        "repeat", "重复运行 count 次，0 为直到中断", "count", "1");
+    QCommandLineOption settingsOption(
+        "settings", "运行参数文件", "file",
+        QCoreApplication::applicationDirPath() + "/settings.ini");
+    parser.addOption(robotOption);
+    parser.addOption(robotIPOption);
+    parser.addOption(agpIPOption);
+    parser.addOption(tryRunOption);
+    parser.addOption(probeOption);
+    parser.addOption(coverageOption);
+    parser.addOption(removalOption);
+    parser.addOption(sweepOption);
+    parser.addOption(sweepSaveOption);
+    parser.addOption(craftsOption);
+    parser.addOption(callStatsOption);
+    parser.addOption(traceOption);
+    parser.addOption(metricsOption);
+    parser.addOption(repeatOption);
+    parser.addOption(settingsOption);
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1) {
+        err << "用法：swr-run [选项] <程序文件>\n";
+        return ExitUsage;
+    }
+    QString robotType = parser.isSet(robotOption)
+                            ? parser.value(robotOption)
+                            : RobotFactory::Backend(parser.value(settingsOption));
+    QString error;
+    robot = RobotFactory::Create(robotType, error);
+    if (robot == nullptr) {
+        err << error << "\n";
+        err << "可用的机器人类型：" << RobotFactory::Available().join("、")
+            << "\n";
+        return ExitUsage;
+    }
+
+    robot->LoadSettings(parser.value(settingsOption));
+    if (parser.isSet(callStatsOption)) {
+        CallStats::SetEnabled(true);
+    }
+    bool ok = true;
+    int repeatCount = parser.value(repeatOption).toInt(&ok);
+    if (!ok || repeatCount < 0) {
+        err << "重复次数无效：" << parser.value(repeatOption) << "\n";
+        return ExitUsage;
+    }
+    MetricsServer metricsServer;
+    if (parser.isSet(metricsOption)) {
+        quint16 port = parser.value(metricsOption).toUShort(&ok);
+        if (!ok || port == 0) {
+            err << "端口无效：" << parser.value(metricsOption) << "\n";
+            return ExitUsage;
+        }
+        RunMetrics::SetEnabled(true);
+        CallStats::SetEnabled(true);
+        if (!metricsServer.Start(port)) {
+            err << "指标服务启动失败，端口：" << port << "\n";
+            return ExitUsage;
+        }
+    }
+
+    // 读取程序
+    Craft craft;
+    if (!robot->LoadProgram(args.at(0), craft)) {
+        err << "程序文件读取失败：" << args.at(0) << "\n";
+        return ExitProgram;
+    }
+    QString tip;
+    if (!robot->CheckAllPoints(craft.way, tip)) {
+        err << tip << "\n";
+        return ExitPoints;
+    }
+
+    // 覆盖分析
+    if (parser.isSet(coverageOption)) {
+        QTextStream out(stdout);
+        CoverageMap map;
+        if (!robot->AnalyzeCoverage(craft, map)) {
+            err << "覆盖分析失败（需记录起始点、结束点和起始偏移点）\n";
+            return ExitCoverage;
+        }
+        out << "coverage: " << QString::number(map.coverage, 'f', 2)
+            << " %\n";
+        out << "max passes: " << map.maxPasses << "\n";
+        out << "gaps: " << map.gaps.size() << "\n";
+        for (const CoverageGap &gap : map.gaps) {
+            out << "  " << QString::number(gap.area, 'f', 1) << " mm2 at ("
+                << QString::number(gap.center.x(), 'f', 1) << ", "
+                << QString::number(gap.center.y(), 'f', 1) << ", "
+                << QString::number(gap.center.z(), 'f', 1) << ")\n";
+        }
+        int count = robot->SuggestOffsetCount(craft);
+        if (count >= 0) {
+            out << "suggested offset count: " << count << " (current "
+                << craft.offsetCount << ")\n";
+        }
+        if (!CoverageAnalyzer::SaveHeatmap(map, parser.value(coverageOption))) {
+            err << "热力图保存失败：" << parser.value(coverageOption) << "\n";
+        }
+        return ExitSuccess;
+    }
+
+    // 材料去除仿真
+    if (parser.isSet(removalOption)) {
+        QTextStream out(stdout);
+        RemovalMap map;
+        if (!robot->SimulateRemoval(craft, map)) {
+            err << "去除仿真失败（需记录起始点、结束点和起始偏移点）\n";
+            return ExitRemoval;
+        }
+        int regionCells = map.grid.regionCells;
+        out << "removal min/mean/max: " << QString::number(map.minDepth, 'f', 3)
+            << " / " << QString::number(map.meanDepth, 'f', 3) << " / "
+            << QString::number(map.maxDepth, 'f', 3) << " um\n";
+        out << "below target: "
+            << QString::number(100.0 * map.shortCells / regionCells, 'f', 2)
+            << " %\n";
+        out << "speed scale for target: "
+            << QString::number(map.speedScale, 'f', 3) << "\n";
+        if (!RemovalSimulator::SaveHeatmap(map, robot->RemovalTarget(),
+                                           parser.value(removalOption))) {
+            err << "去除深度图保存失败：" << parser.value(removalOption)
+                << "\n";
+        }
+        return ExitSuccess;
+    }
+
+    // 工艺参数扫描
+    if (parser.isSet(sweepOption) || parser.isSet(sweepSaveOption)) {
+        QTextStream out(stdout);
+        QElapsedTimer timer;
+        timer.start();
+        QVector<SweepResult> results;
+        if (!robot->Sweep(craft, results)) {
+            err << "参数扫描失败（需记录起始点、结束点和起始偏移点，"
+                   "且组合数不超过上限）\n";
+            return ExitSweep;
+        }
+        double minQuality = robot->SweepMinQuality();
+        int fastest = SweepEngine::Fastest(results, minQuality);
+        out << "variants: " << results.size() << " ("
+            << timer.elapsed() << " ms)\n";
+        out << "index\tspeed\toffsets\tangle\tradius\ttime(s)\tquality(%)\n";
+        for (int i = 0; i < results.size(); ++i) {
+            const SweepResult &result = results.at(i);
+            if (!result.isPareto) {
+                continue;
+            }
+            out << i << "\t" << result.moveSpeed << "\t"
+                << result.offsetCount << "\t" << result.grindAngle << "\t"
+                << result.transitionRadius << "\t"
+                << QString::number(result.cycleTime, 'f', 1) << "\t"
+                << QString::number(result.quality, 'f', 2)
+                << (i == fastest ? "\t*" : "") << "\n";
+        }
+        if (fastest < 0) {
+            out << "no variant reaches " << minQuality << " %\n";
+        }
+        if (!parser.isSet(sweepSaveOption)) {
+            return ExitSuccess;
+        }
+        QString value = parser.value(sweepSaveOption);
+        bool isOk = true;
+        int index = value == "fastest" ? fastest : value.toInt(&isOk);
+        if (!isOk || index < 0 || index >= results.size()) {
+            err << "扫描结果编号无效：" << value << "\n";
+            return ExitUsage;
+        }
+        CraftStore crafts;
+        Craft variant = Robot::SweepCraft(craft, results.at(index));
+        if (!crafts.Open(parser.value(craftsOption)) ||
+            crafts.Append(variant) < 0) {
+            err << "工艺保存失败：" << parser.value(craftsOption) << "\n";
+            return ExitSweep;
+        }
+        out << "saved craft: " << variant.craftID << "\n";
+        return ExitSuccess;
+    }
+
+    // 连接设备
+    if (!robot->RobotConnect(parser.value(robotIPOption))) {
+        err << "机器人连接失败\n";
+        return ExitRobotConnect;
+    }
+    bool isSim = robotType == "sim";
+    if ((!isSim || parser.isSet(agpIPOption)) &&
+        !robot->AGPConnect(parser.value(agpIPOption))) {
+        err << "打磨头连接失败\n";
+        return ExitAGPConnect;
+    }
+
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+    StopWatcher watcher;
+
+    // 执行
+    QElapsedTimer timer;
+    timer.start();
+    robot->teachPos = craft.teachPointReferPos;
+    robot->discThickness = craft.discThickness;
+    robot->CloseFreeDriver();
+    if (parser.isSet(probeOption)) {
+        // 探测开始时会清除空闲状态的停止标志，已收到的中断须先检查
+        if (isInterrupted.load()) {
+            return ExitStopped;
+        }
+        if (!robot->ProbeReferencePoints(tip) ||
+            !robot->RegisterProgram(tip)) {
+            err << tip << "\n";
+            return isInterrupted.load() ? ExitStopped : ExitProbe;
+        }
+        QTextStream(stdout) << tip << "\n";
+    }
+    bool isAGPRun = !parser.isSet(tryRunOption);
+    if (parser.isSet(traceOption)) {
+        Trace::Start();
+    }
+    for (int i = 0; (repeatCount == 0 || i < repeatCount) &&
+                    !isInterrupted.load();
+         ++i) {
+        robot->Run(craft, isAGPRun);
+    }
+    if (isAGPRun) {
+        robot->AGPStop();
+    }
+    if (parser.isSet(traceOption)) {
+        Trace::Stop();
+        if (!Trace::SaveJson(parser.value(traceOption))) {
+            err << "时间线保存失败：" << parser.value(traceOption) << "\n";
+        } else if (Trace::DroppedEvents() > 0) {
+            err << "时间线缓冲已满，丢弃 " << Trace::DroppedEvents()
+                << " 个事件\n";
+        }
+    }
+
+    QTextStream out(stdout);
+    out << "cycle time: " << timer.elapsed() << " ms\n";
+    if (isSim) {
+        SimRobot *sim = static_cast<SimRobot *>(robot);
+        out << "motions: " << sim->MotionCount() << "\n";
+        out << "motion length: " << sim->MotionLength() << " mm\n";
+        out << "estimated motion time: " << sim->MotionTime() << " s\n";
+    }
+    watcher.Finish();
+    Robot *r = robot;
+    robot = nullptr;
+    delete r;
+    if (parser.isSet(callStatsOption) &&
+        !CallStats::SaveJson(parser.value(callStatsOption))) {
+        err << "调用统计保存失败：" << parser.value(callStatsOption) << "\n";
+    }
+    return isInterrupted.load() ? ExitStopped : ExitSuccess;
+}
@@ -0,0 +1,140 @@
+﻿#include "simrobot.h"
+
+// 梯形速度曲线下走完指定长度所需时间
+static double MotionDuration(double length, double velocity, double acc) {
+    if (length <= 0 || velocity <= 0) {
+        return 0;
+    }
+    if (acc <= 0) {
+        return length / velocity;
+    }
+    if (length > velocity * velocity / acc) {
+        return length / velocity + velocity / acc;
+    }
+    return 2 * qSqrt(length / acc);
+}
+
+SimRobot::SimRobot() : motionTime(0), motionLength(0), motionCount(0) {}
+
+SimRobot::~SimRobot() {}
+
+bool SimRobot::RobotConnect(QString robotIP) {
+    Q_UNUSED(robotIP);
+    return true;
+}
+
+bool SimRobot::GetTcpPoint(Point &point) {
+    point = tcpPoint;
+    return true;
+}
+
+bool SimRobot::RobotTeach(int pos) {
+    Q_UNUSED(pos);
+    isTeach = !isTeach;
+    return isTeach;
+}
+
+bool SimRobot::CloseFreeDriver() {
+    isTeach = false;
+    return true;
+}
+
+bool SimRobot::Stop() {
+    isStop.store(true);
+    RunMetrics::AddStop();
+    isTeach = false;
+    return true;
+}
+
+bool SimRobot::AbortMotion() { return true; }
+
+bool SimRobot::IsRobotElectrified() { return true; }
+
+bool SimRobot::IsRobotEnabled() { return true; }
+
+bool SimRobot::IsRobotMoved() { return false; }
+
+void SimRobot::OpenWeb(QString ip) { Q_UNUSED(ip); }
+
+void SimRobot::MoveTcpL(const Point &point, double dVelocity, double dAcc,
+                        double dRadius) {
+    Q_UNUSED(dRadius);
+    double length = tcpPoint.pos.distanceToPoint(point.pos);
+    motionTime += MotionDuration(length, dVelocity, dAcc);
+    motionLength += length;
+    ++motionCount;
+    tcpPoint = point;
+}
+
+void SimRobot::MoveTcpC(const Point &auxPoint, const Point &endPoint,
+                        double dVelocity, double dAcc, double dRadius) {
+    Q_UNUSED(dRadius);
+    // 三点共线时按折线计算
+    QVector3D A = tcpPoint.pos;
+    QVector3D B = auxPoint.pos;
+    QVector3D C = endPoint.pos;
+    double length = A.distanceToPoint(B) + B.distanceToPoint(C);
+    QVector3D N = QVector3D::crossProduct(B - A, C - A);
+    if (N.lengthSquared() > 1e-6) {
+        QVector3D O = Point::calculateCircumcenter(A, B, C);
+        QVector3D OA = A - O;
+        QVector3D OB = B - O;
+        QVector3D OC = C - O;
+        double radius = OA.length();
+        double angleAB = qAcos(qBound(
+            -1.0, (double)QVector3D::dotProduct(OA, OB) / (radius * radius),
+            1.0));
+        double angleBC = qAcos(qBound(
+            -1.0, (double)QVector3D::dotProduct(OB, OC) / (radius * radius),
+            1.0));
+        length = radius * (angleAB + angleBC);
+    }
+    motionTime += MotionDuration(length, dVelocity, dAcc);
+    motionLength += length;
+    ++motionCount;
+    tcpPoint = endPoint;
+}
+
+bool SimRobot::MoveTcpPath(const QVector<Point> &points, double dVelocity,
+                           double dAcc) {
+    // 连续轨迹中途不停顿，按总长度计算
+    double length = 0;
+    for (int i = 1; i < points.size(); ++i) {
+        length += points.at(i - 1).pos.distanceToPoint(points.at(i).pos);
+    }
+    motionTime += MotionDuration(length, dVelocity, dAcc);
+    motionLength += length;
+    ++motionCount;
+    if (!points.isEmpty()) {
+        tcpPoint = points.last();
+    }
+    return true;
+}
+
+int SimRobot::Capabilities() const {
+    return PathUploadCapability | ServoCapability;
+}
+
+bool SimRobot::ServoTcpPath(const QVector<Point> &points, double period) {
+    double length = 0;
+    for (const Point &point : points) {
+        length += tcpPoint.pos.distanceToPoint(point.pos);
+        tcpPoint = point;
+    }
+    motionTime += points.size() * period;
+    motionLength += length;
+    ++motionCount;
+    return true;
+}
+
+double SimRobot::MotionTime() const { return motionTime; }
+
+double SimRobot::MotionLength() const { return motionLength; }
+
+int SimRobot::MotionCount() const { return motionCount; }
+
+void SimRobot::ResetStatistics() {
+    motionTime = 0;
+    motionLength = 0;
+    motionCount = 0;
+}
@@ -0,0 +1,110 @@
+﻿#include <QtMath>
+#include <algorithm>
+
+#include "spline.h"
+
+// 弧长表每段细分数
+constexpr int arcTableDivisions = 32;
+
+CubicSpline::CubicSpline() {}
+
+bool CubicSpline::Fit(const QVector<QVector3D> &points) {
+    knots.clear();
+    values.clear();
+    moments.clear();
+    arcParams.clear();
+    arcLengths.clear();
+    // 去掉重合点，按弦长取节点参数
+    for (const QVector3D &point : points) {
+        if (!values.isEmpty() && values.last().distanceToPoint(point) < 1e-3) {
+            continue;
+        }
+        knots.append(values.isEmpty()
+                         ? 0.0
+                         : knots.last() + values.last().distanceToPoint(point));
+        values.append(point);
+    }
+    int n = values.size();
+    if (n < 2) {
+        return false;
+    }
+    // 自然边界三弯矩方程，追赶法求解
+    moments.fill(QVector3D(), n);
+    if (n > 2) {
+        QVector<double> c(n, 0);
+        QVector<QVector3D> d(n);
+        for (int i = 1; i < n - 1; ++i) {
+            double h0 = knots[i] - knots[i - 1];
+            double h1 = knots[i + 1] - knots[i];
+            QVector3D r = 6 * ((values[i + 1] - values[i]) / h1 -
+                               (values[i] - values[i - 1]) / h0);
+            double b = 2 * (h0 + h1) - h0 * c[i - 1];
+            c[i] = h1 / b;
+            d[i] = (r - h0 * d[i - 1]) / b;
+        }
+        for (int i = n - 2; i >= 1; --i) {
+            moments[i] = d[i] - c[i] * moments[i + 1];
+        }
+    }
+    // 弧长表
+    arcParams.append(0);
+    arcLengths.append(0);
+    QVector3D prev = values.first();
+    for (int i = 0; i < n - 1; ++i) {
+        for (int k = 1; k <= arcTableDivisions; ++k) {
+            double t = knots[i] + (knots[i + 1] - knots[i]) * k /
+                                      arcTableDivisions;
+            QVector3D p = Evaluate(t);
+            arcParams.append(t);
+            arcLengths.append(arcLengths.last() + prev.distanceToPoint(p));
+            prev = p;
+        }
+    }
+    return true;
+}
+
+QVector3D CubicSpline::Evaluate(double t) const {
+    if (values.isEmpty()) {
+        return QVector3D();
+    }
+    t = qBound(0.0, t, knots.last());
+    int i = std::upper_bound(knots.cbegin(), knots.cend(), t) - knots.cbegin();
+    i = qBound(1, i, knots.size() - 1);
+    double h = knots[i] - knots[i - 1];
+    double a = (knots[i] - t) / h;
+    double b = (t - knots[i - 1]) / h;
+    return a * values[i - 1] + b * values[i] +
+           ((a * a * a - a) * moments[i - 1] + (b * b * b - b) * moments[i]) *
+               (h * h / 6);
+}
+
+double CubicSpline::ParamLength() const {
+    return knots.isEmpty() ? 0 : knots.last();
+}
+
+double CubicSpline::Length() const {
+    return arcLengths.isEmpty() ? 0 : arcLengths.last();
+}
+
+QVector<QVector3D> CubicSpline::Resample(double step) const {
+    QVector<QVector3D> samples;
+    if (values.size() < 2 || step <= 0) {
+        return samples;
+    }
+    double length = Length();
+    int count = qMax(1, qCeil(length / step));
+    samples.reserve(count + 1);
+    int j = 1;
+    for (int k = 0; k <= count; ++k) {
+        // 在弧长表中查找目标弧长，表内线性插值参数
+        double s = length * k / count;
+        while (j < arcLengths.size() - 1 && arcLengths[j] < s) {
+            ++j;
+        }
+        double ds = arcLengths[j] - arcLengths[j - 1];
+        double u = ds > 0 ? (s - arcLengths[j - 1]) / ds : 0;
+        double t = arcParams[j - 1] + (arcParams[j] - arcParams[j - 1]) * u;
+        samples.append(Evaluate(t));
+    }
+    return samples;
+}
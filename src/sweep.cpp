@@ -0,0 +1,143 @@
+﻿#include <QStringList>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "sweep.h"
+
+SweepRange::SweepRange() : min(0), max(-1), step(1) {}
+
+bool SweepRange::Parse(const QString &text) {
+    *this = SweepRange();
+    QStringList fields = text.split(',', QString::SkipEmptyParts);
+    if (fields.isEmpty()) {
+        return true;
+    }
+    if (fields.size() != 1 && fields.size() != 3) {
+        return false;
+    }
+    bool isMinOk = false, isMaxOk = true, isStepOk = true;
+    min = fields.at(0).trimmed().toInt(&isMinOk);
+    max = min;
+    if (fields.size() == 3) {
+        max = fields.at(1).trimmed().toInt(&isMaxOk);
+        step = fields.at(2).trimmed().toInt(&isStepOk);
+    }
+    if (!isMinOk || !isMaxOk || !isStepOk || step <= 0 || max < min) {
+        *this = SweepRange();
+        return false;
+    }
+    return true;
+}
+
+QVector<int> SweepRange::Values(int value) const {
+    if (max < min) {
+        return {value};
+    }
+    QVector<int> values;
+    for (int v = min; v <= max; v += step) {
+        values.append(v);
+    }
+    return values;
+}
+
+SweepParams::SweepParams()
+    : isRemovalMetric(false), minQuality(99.5), maxVariants(20000) {}
+
+QVector<SweepResult>
+SweepEngine::Evaluate(const QVector<SweepGeometry> &geometries,
+                      const QVector<int> &moveSpeeds,
+                      const QVector<int> &transitionRadii,
+                      const SweepParams &params, double toolOffset,
+                      const FeedPlanParams &feed, const BlendPlanParams &blend,
+                      double removalTarget) {
+    int perGeometry = moveSpeeds.size() * transitionRadii.size();
+    int total = geometries.size() * perGeometry;
+    QVector<SweepResult> results(total);
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (int index = next++; index < total; index = next++) {
+            const SweepGeometry &geometry = geometries.at(index / perGeometry);
+            int speed = moveSpeeds.at(index % perGeometry /
+                                      transitionRadii.size());
+            int radius = transitionRadii.at(index % transitionRadii.size());
+            // 只改写接触打磨段的速度和过渡半径，空移、切入、抬起保持原样
+            QVector<PathSegment> path = geometry.path;
+            for (PathSegment &segment : path) {
+                if (segment.isContact) {
+                    segment.velocity = speed;
+                    segment.radius = radius;
+                }
+            }
+            // 进给规划启用时变体速度即接触线速度，代替 ContactSpeed
+            if (feed.isEnabled) {
+                PathPlanner::PlanFeed(path, toolOffset, speed, feed);
+            }
+            if (blend.isEnabled) {
+                PathPlanner::PlanBlend(path, toolOffset, blend);
+            }
+            SweepResult &result = results[index];
+            result.moveSpeed = speed;
+            result.offsetCount = geometry.offsetCount;
+            result.grindAngle = geometry.grindAngle;
+            result.transitionRadius = radius;
+            result.cycleTime =
+                PathPlanner::EstimateDuration(path, toolOffset);
+            result.isPareto = false;
+            if (!params.isRemovalMetric) {
+                result.quality = geometry.coverage;
+                continue;
+            }
+            // 去除深度与进给速度成反比：深度 × 参考速度 / 速度 >= 目标
+            const std::vector<float> &depths = geometry.depths;
+            result.quality = 0;
+            if (!depths.empty() && speed > 0) {
+                float threshold =
+                    removalTarget * speed / geometry.referenceSpeed;
+                auto first =
+                    std::lower_bound(depths.begin(), depths.end(), threshold);
+                result.quality =
+                    100.0 * (depths.end() - first) / depths.size();
+            }
+        }
+    };
+    int threadCount =
+        qBound(1, (int)std::thread::hardware_concurrency(), total);
+    std::vector<std::thread> threads;
+    for (int t = 1; t < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    return results;
+}
+
+void SweepEngine::MarkPareto(QVector<SweepResult> &results) {
+    // 节拍相同时质量高的在前，依次扫描，质量超过此前最高的即在前沿上
+    std::sort(results.begin(), results.end(),
+              [](const SweepResult &a, const SweepResult &b) {
+                  if (a.cycleTime != b.cycleTime) {
+                      return a.cycleTime < b.cycleTime;
+                  }
+                  return a.quality > b.quality;
+              });
+    double bestQuality = -1;
+    for (SweepResult &result : results) {
+        result.isPareto = result.quality > bestQuality;
+        if (result.isPareto) {
+            bestQuality = result.quality;
+        }
+    }
+}
+
+int SweepEngine::Fastest(const QVector<SweepResult> &results,
+                         double minQuality) {
+    for (int i = 0; i < results.size(); ++i) {
+        if (results.at(i).isPareto && results.at(i).quality >= minQuality) {
+            return i;
+        }
+    }
+    return -1;
+}
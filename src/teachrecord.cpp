@@ -0,0 +1,41 @@
+﻿#include "teachrecord.h"
+
+TeachParams::TeachParams() : interval(5), duration(120), step(2) {}
+
+TeachBuffer::TeachBuffer() : head(0), count(0), dropped(0) {}
+
+void TeachBuffer::Reset(int capacity) {
+    // 预先分配，采样线程写入时不再申请内存
+    samples.resize(qMax(1, capacity));
+    head = 0;
+    count = 0;
+    dropped = 0;
+}
+
+void TeachBuffer::Push(const TeachSample &sample) {
+    if (samples.isEmpty()) {
+        return;
+    }
+    samples[head] = sample;
+    head = (head + 1) % samples.size();
+    if (count < samples.size()) {
+        ++count;
+    } else {
+        ++dropped;
+    }
+}
+
+int TeachBuffer::Size() const { return count; }
+
+int TeachBuffer::Dropped() const { return dropped; }
+
+QVector<TeachSample> TeachBuffer::Samples() const {
+    QVector<TeachSample> result;
+    result.reserve(count);
+    // 写满时最早的采样位于 head
+    int first = count < samples.size() ? 0 : head;
+    for (int i = 0; i < count; ++i) {
+        result.append(samples.at((first + i) % samples.size()));
+    }
+    return result;
+}
@@ -0,0 +1,179 @@
+﻿#include <QFile>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "trace.h"
+
+// 每个线程最多记录的事件数，超出后丢弃
+constexpr int bufferCapacity = 1 << 16;
+
+struct TraceEvent {
+    const char *name;
+    const char *category;
+    qint64 begin;    // 相对开始记录时刻，ns
+    qint64 duration; // ns
+    qint64 arg;
+};
+
+// 单个线程的事件缓冲，只有所属线程写入，size 以 release 发布
+struct TraceBuffer {
+    std::vector<TraceEvent> events;
+    std::atomic<int> size;
+    std::atomic<int> dropped;
+    std::atomic<bool> isOwned; // 所属线程是否仍在运行
+    std::atomic<const char *> threadName;
+    int tid;
+};
+
+static std::atomic<bool> isTracing(false);
+static std::atomic<Trace::Clock::rep> epoch(0);
+static std::mutex buffersMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> buffers;
+static int nextTid = 1;
+static thread_local TraceBuffer *localBuffer = nullptr;
+
+// 线程退出时释放缓冲的所有权，数据保留到下次开始记录
+struct BufferOwner {
+    ~BufferOwner() {
+        if (localBuffer != nullptr) {
+            localBuffer->isOwned.store(false);
+        }
+    }
+};
+static thread_local BufferOwner bufferOwner;
+
+static TraceBuffer *LocalBuffer() {
+    if (localBuffer == nullptr) {
+        (void)bufferOwner;
+        std::unique_ptr<TraceBuffer> buffer(new TraceBuffer);
+        buffer->events.resize(bufferCapacity);
+        buffer->size.store(0);
+        buffer->dropped.store(0);
+        buffer->isOwned.store(true);
+        buffer->threadName.store(nullptr);
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffer->tid = nextTid++;
+        localBuffer = buffer.get();
+        buffers.push_back(std::move(buffer));
+    }
+    return localBuffer;
+}
+
+void Trace::Start() {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    // 已退出线程的缓冲不再需要
+    std::vector<std::unique_ptr<TraceBuffer>> owned;
+    for (std::unique_ptr<TraceBuffer> &buffer : buffers) {
+        if (buffer->isOwned.load()) {
+            buffer->size.store(0);
+            buffer->dropped.store(0);
+            owned.push_back(std::move(buffer));
+        }
+    }
+    buffers.swap(owned);
+    epoch.store(Clock::now().time_since_epoch().count());
+    isTracing.store(true);
+}
+
+void Trace::Stop() { isTracing.store(false); }
+
+bool Trace::IsEnabled() { return isTracing.load(std::memory_order_relaxed); }
+
+void Trace::SetThreadName(const char *name) {
+    if (IsEnabled()) {
+        LocalBuffer()->threadName.store(name);
+    }
+}
+
+void Trace::Complete(const char *name, const char *category,
+                     Clock::time_point begin, Clock::time_point end,
+                     qint64 arg) {
+    TraceBuffer *buffer = LocalBuffer();
+    int index = buffer->size.load(std::memory_order_relaxed);
+    if (index >= bufferCapacity) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Clock::rep origin = epoch.load(std::memory_order_relaxed);
+    TraceEvent &event = buffer->events[index];
+    event.name = name;
+    event.category = category;
+    event.begin = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      begin.time_since_epoch() - Clock::duration(origin))
+                      .count();
+    event.duration =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+            .count();
+    event.arg = arg;
+    buffer->size.store(index + 1, std::memory_order_release);
+}
+
+int Trace::DroppedEvents() {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    int dropped = 0;
+    for (const std::unique_ptr<TraceBuffer> &buffer : buffers) {
+        dropped += buffer->dropped.load();
+    }
+    return dropped;
+}
+
+// JSON 字符串（含引号）
+static QByteArray JsonString(const char *text) {
+    QByteArray escaped("\"");
+    for (const char *c = text; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\') {
+            escaped += '\\';
+        }
+        if ((unsigned char)*c >= 0x20) {
+            escaped += *c;
+        }
+    }
+    return escaped + '"';
+}
+
+// ns 换算为 μs 文本
+static QByteArray Micros(qint64 nanoseconds) {
+    return QByteArray::number(nanoseconds / 1000.0, 'f', 3);
+}
+
+bool Trace::SaveJson(const QString &fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool isFirst = true;
+    QByteArray line;
+    for (const std::unique_ptr<TraceBuffer> &buffer : buffers) {
+        QByteArray tid = QByteArray::number(buffer->tid);
+        const char *threadName = buffer->threadName.load();
+        if (threadName != nullptr) {
+            line = "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" +
+                   tid + ",\"args\":{\"name\":" + JsonString(threadName) +
+                   "}}";
+            file.write(isFirst ? line : ",\n" + line);
+            isFirst = false;
+        }
+        int size = buffer->size.load(std::memory_order_acquire);
+        for (int i = 0; i < size; ++i) {
+            const TraceEvent &event = buffer->events.at(i);
+            line = "{\"name\":" + JsonString(event.name) +
+                   ",\"cat\":" + JsonString(event.category) +
+                   ",\"ph\":\"X\",\"ts\":" + Micros(event.begin) +
+                   ",\"dur\":" + Micros(event.duration) +
+                   ",\"pid\":1,\"tid\":" + tid;
+            if (event.arg >= 0) {
+                line += ",\"args\":{\"arg\":" + QByteArray::number(event.arg) +
+                        "}";
+            }
+            line += "}";
+            file.write(isFirst ? line : ",\n" + line);
+            isFirst = false;
+        }
+    }
+    file.write("\n]}\n");
+    return file.error() == QFile::NoError;
+}
@@ -0,0 +1,81 @@
+﻿#include <QApplication>
+#include <QComboBox>
+#include <QDateTime>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QLabel>
+#include <QMainWindow>
+#include <QMessageBox>
+#include <QStatusBar>
+#include <QToolBar>
+
+#include "logplot.h"
+
+// 运行记录查看器 swr-view
+class ViewerWindow : public QMainWindow {
+  public:
+    ViewerWindow() {
+        plot = new LogPlot(this);
+        setCentralWidget(plot);
+
+        QToolBar *toolBar = addToolBar("工具");
+        toolBar->addAction("打开", [this] {
+            QString fileName = QFileDialog::getOpenFileName(
+                this, "打开运行记录", logDir, "运行记录 (*.swrlog)");
+            if (!fileName.isEmpty()) {
+                OpenLog(fileName);
+            }
+        });
+        toolBar->addSeparator();
+        toolBar->addWidget(new QLabel("横轴："));
+        QComboBox *cmbAxis = new QComboBox();
+        cmbAxis->addItem("时间");
+        cmbAxis->addItem("弧长");
+        toolBar->addWidget(cmbAxis);
+        connect(cmbAxis,
+                static_cast<void (QComboBox::*)(int)>(
+                    &QComboBox::currentIndexChanged),
+                [this](int index) { plot->SetAxisMode(index); });
+        toolBar->addAction("全部", [this] { plot->ResetView(); });
+
+        logDir = QCoreApplication::applicationDirPath() + "/logs";
+        resize(1200, 800);
+    }
+
+    bool OpenLog(const QString &fileName) {
+        if (!plot->Open(fileName)) {
+            QMessageBox::critical(this, "提示", "运行记录读取失败");
+            return false;
+        }
+        logDir = QFileInfo(fileName).absolutePath();
+        const RunLogHeader &header = plot->Reader().Header();
+        QString craftID = QString::fromUtf8(
+            header.craftID, qstrnlen(header.craftID, sizeof(header.craftID)));
+        setWindowTitle(QFileInfo(fileName).fileName() + " - swr-view");
+        statusBar()->showMessage(
+            QString("工艺：%1  开始：%2  记录数：%3  参考位置：%4 mm")
+                .arg(craftID)
+                .arg(QDateTime::fromMSecsSinceEpoch(header.startTime)
+                         .toString("yyyy-MM-dd HH:mm:ss"))
+                .arg(plot->Reader().Count())
+                .arg(header.referencePos));
+        return true;
+    }
+
+  private:
+    LogPlot *plot;  // 曲线
+    QString logDir; // 上次打开的目录
+};
+
+int main(int argc, char *argv[]) {
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("swr-view");
+    ViewerWindow window;
+    window.setWindowTitle("swr-view");
+    const QStringList args = app.arguments();
+    if (args.size() > 1) {
+        window.OpenLog(args.at(1));
+    }
+    window.show();
+    return app.exec();
+}
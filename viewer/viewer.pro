@@ -0,0 +1,13 @@
+QT += core gui widgets
+
+TARGET = swr-view
+
+include(../common.pri)
+include(../core.pri)
+
+SOURCES += \
+    ../src/logplot.cpp \
+    ../src/viewer.cpp
+
+HEADERS += \
+    ../inc/logplot.h